@@ -4,7 +4,9 @@
 #include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <optional>
 #include <stdexcept>
+#include <string_view>
 
 #include <wujihandcpp/data/hand.hpp>
 #include <wujihandcpp/data/joint.hpp>
@@ -14,12 +16,23 @@
 #include <wujihandcpp/utility/logging.hpp>
 
 #include "json_helpers.hpp"
+#include "serde.hpp"
 
 namespace wujihand_bridge {
 
 using namespace wujihandcpp;
 using json = nlohmann::json;
 
+/// Oldest cached SDO value a GET query or publish may return. Consumers polling the same
+/// telemetry within this window share a single bus read.
+static const device::MaxAge kTelemetryMaxAge{std::chrono::milliseconds(100)};
+
+/// Refresh period of the subscribed telemetry (see start_telemetry_subscriptions()). GET
+/// queries of these resources accept twice that age, so they are served from the SDK cache
+/// without touching the bus.
+static constexpr std::chrono::milliseconds kSubscribedTelemetryPeriod{500};
+static const device::MaxAge kSubscribedTelemetryMaxAge{2 * kSubscribedTelemetryPeriod};
+
 // ---------------------------------------------------------------------------
 // Timestamp utility
 // ---------------------------------------------------------------------------
@@ -32,13 +45,21 @@ static int64_t get_timestamp_us() {
     return us.count();
 }
 
-/// Wrap a JSON data value with a host-side timestamp.
-/// Output: {"timestamp_us": <int64>, "data": <value>}
-static json wrap_with_timestamp(const json& value, int64_t timestamp_us = 0) {
-    if (timestamp_us == 0) {
-        timestamp_us = get_timestamp_us();
+/// Value of `name` in the parameters of a Zenoh selector ("a=1;b=2", '&' also accepted).
+static std::optional<std::string_view>
+    selector_parameter(std::string_view parameters, std::string_view name) {
+    while (!parameters.empty()) {
+        auto end = parameters.find_first_of(";&");
+        auto parameter = parameters.substr(0, end);
+        parameters =
+            end == std::string_view::npos ? std::string_view{} : parameters.substr(end + 1);
+
+        auto equals = parameter.find('=');
+        if (parameter.substr(0, equals) == name)
+            return equals == std::string_view::npos ? std::string_view{}
+                                                    : parameter.substr(equals + 1);
     }
-    return json{{"timestamp_us", timestamp_us}, {"data", value}};
+    return std::nullopt;
 }
 
 // ---------------------------------------------------------------------------
@@ -134,19 +155,26 @@ const std::vector<ResourceDef>& HandBridge::resource_defs() {
 // Constructor / Destructor
 // ---------------------------------------------------------------------------
 HandBridge::HandBridge(
-    device::Hand& hand, std::string serial_number, double pub_rate)
+    device::Hand& hand, std::string serial_number, double pub_rate, SerdeFormat serde_format,
+    PublishMode pub_mode, uint64_t pub_every)
     : hand_(hand)
     , sn_(std::move(serial_number))
-    , pub_rate_(pub_rate) {
-    if (pub_rate_ <= 0.0) {
+    , pub_rate_(pub_rate)
+    , pub_mode_(pub_mode)
+    , pub_every_(pub_every)
+    , serde_format_(serde_format) {
+    if (pub_mode_ == PublishMode::TIMER ? !(pub_rate_ > 0.0) : !(pub_rate_ >= 0.0)) {
         throw std::invalid_argument("pub_rate must be positive");
     }
+    if (pub_every_ == 0) {
+        throw std::invalid_argument("pub_every must be at least 1");
+    }
 
     // Sanitize SN: replace '.' with '_' for Zenoh key expressions
     sanitized_sn_ = sn_;
     std::replace(sanitized_sn_.begin(), sanitized_sn_.end(), '.', '_');
 
-    // Allow multi-thread access (we protect with our own mutexes)
+    // Realtime target updates arrive on Zenoh threads
     hand_.disable_thread_safe_check();
 }
 
@@ -161,6 +189,13 @@ std::string HandBridge::key(const std::string& suffix) const {
     return "wuji/" + sanitized_sn_ + "/" + suffix;
 }
 
+bool HandBridge::resource_can_set(const std::string& path) {
+    for (const auto& r : resource_defs())
+        if (r.path == path)
+            return r.can_set;
+    return false;
+}
+
 // ---------------------------------------------------------------------------
 // build_capability
 // ---------------------------------------------------------------------------
@@ -169,8 +204,9 @@ std::string HandBridge::build_capability() const {
     for (const auto& r : resource_defs()) {
         json schema = r.json_schema;
 
-        // Wrap SUB resource schemas with timestamp envelope (matches Python bridge)
-        if (r.can_sub) {
+        // Wrap SUB resource schemas with timestamp envelope (matches Python bridge). Binary
+        // samples carry the timestamp in their header instead.
+        if (r.can_sub && serde_format_ != SerdeFormat::BINARY) {
             schema = {
                 {"title", r.json_schema.value("title", "") + "Timestamped"},
                 {"type", "object"},
@@ -181,6 +217,12 @@ std::string HandBridge::build_capability() const {
                 }},
                 {"required", json::array({"timestamp_us", "data"})},
             };
+            if (pub_mode_ == PublishMode::FEEDBACK) {
+                schema["properties"]["sequence"] = {
+                    {"type", "integer"},
+                    {"description", "PDO feedback frame number; gaps are frames not published"},
+                };
+            }
         }
 
         resources.push_back({
@@ -192,7 +234,7 @@ std::string HandBridge::build_capability() const {
             {"can_pub", false},
             {"can_exec", false},
             {"internal", false},
-            {"serde_format", "json"},
+            {"serde_format", serde_format_name(serde_format_)},
             {"json_schema", schema},
         });
     }
@@ -204,6 +246,9 @@ std::string HandBridge::build_capability() const {
         {"serial_number", sn_},
         {"nodes", json::array()},
         {"resources", resources},
+        // GET queries may ask for any of these with the `serde_format` selector parameter, and
+        // SET / PUT payloads may use any of them
+        {"serde_formats", json::array({"json", "cbor", "binary"})},
     };
     return capability.dump();
 }
@@ -224,6 +269,9 @@ void HandBridge::start() {
     // 2. Start realtime controller (before status/queryables so reads work)
     start_realtime_controller();
 
+    // 2b. Keep slowly changing telemetry fresh in the SDK cache
+    start_telemetry_subscriptions();
+
     // 3. Status: online
     session_->put(zenoh::KeyExpr(key("@status")), zenoh::Bytes("online"));
     log_info("Status: online");
@@ -266,8 +314,12 @@ void HandBridge::start() {
         zenoh::KeyExpr(key("joint/target_position")),
         [this](zenoh::Sample& sample) {
             try {
-                auto value = json::parse(sample.get_payload().as_string());
-                write_resource("joint/target_position", value);
+                auto payload = sample.get_payload().as_string();
+                double positions[5][4];
+                if (decode_binary_5x4(payload, positions))
+                    write_target_position(positions);
+                else
+                    write_resource("joint/target_position", decode_payload(payload));
             } catch (const std::exception& e) {
                 log_error(std::string("target_position subscriber error: ") + e.what());
             }
@@ -276,11 +328,18 @@ void HandBridge::start() {
     log_info("target_position subscriber declared (fire-and-forget path)");
 
     // 7. Start publisher jthread
-    if (!publishers_.empty()) {
+    if (!publishers_.empty() && pub_mode_ == PublishMode::TIMER) {
         pub_thread_ = std::jthread([this](std::stop_token st) {
             publish_loop(std::move(st));
         });
         log_info("Publisher loop started at " + std::to_string(pub_rate_) + " Hz");
+    } else if (!publishers_.empty()) {
+        pub_thread_ = std::jthread([this](std::stop_token st) {
+            publish_on_feedback_loop(std::move(st));
+        });
+        log_info(
+            "Publisher loop started on every " + std::to_string(pub_every_) + " feedback frame(s)"
+            + (pub_rate_ > 0.0 ? ", capped at " + std::to_string(pub_rate_) + " Hz" : ""));
     }
 
     log_info("Hand Zenoh Bridge fully started");
@@ -296,8 +355,9 @@ void HandBridge::stop() {
         pub_thread_.join();
     }
 
-    // 2. Release controller
+    // 2. Release controller and telemetry subscriptions
     stop_realtime_controller();
+    telemetry_subscriptions_.clear();
 
     // 3. Put status offline
     if (session_.has_value()) {
@@ -318,20 +378,37 @@ void HandBridge::stop() {
     log_info("Bridge stopped");
 }
 
+// ---------------------------------------------------------------------------
+// start_telemetry_subscriptions
+// ---------------------------------------------------------------------------
+void HandBridge::start_telemetry_subscriptions() {
+    // The SDK interleaves these reads with other SDO traffic at low priority, so GET queries of
+    // the resources below no longer issue bus reads of their own. The values only need to stay
+    // cached: error code changes are already logged by the SDK.
+    auto& subscriptions = telemetry_subscriptions_;
+    const auto period = kSubscribedTelemetryPeriod;
+    subscriptions.push_back(hand_.subscribe<data::hand::InputVoltage>(period, [](int, float) {}));
+    subscriptions.push_back(hand_.subscribe<data::hand::Temperature>(period, [](int, float) {}));
+    subscriptions.push_back(hand_.subscribe<data::joint::Temperature>(period, [](int, float) {}));
+    subscriptions.push_back(hand_.subscribe<data::joint::BusVoltage>(period, [](int, float) {}));
+    subscriptions.push_back(
+        hand_.subscribe<data::joint::ErrorCode>(period, [](int, uint32_t) {}));
+    log_info("Telemetry subscriptions started");
+}
+
 // ---------------------------------------------------------------------------
 // start_realtime_controller
 // ---------------------------------------------------------------------------
 void HandBridge::start_realtime_controller() {
     log_info("Starting realtime controller...");
 
+    // Creating the controller writes joint settings too, so the lock covers it as well
+    std::lock_guard lock(sdo_write_mutex_);
     filter::LowPass lp(cutoff_freq_);
     controller_ = hand_.realtime_controller<true>(lp);
 
     // Enable all joints
-    {
-        std::lock_guard lock(hand_mutex_);
-        hand_.write<data::joint::Enabled>(true);
-    }
+    hand_.write<data::joint::Enabled>(true);
 
     log_info("Realtime controller started, joints enabled");
 }
@@ -340,14 +417,24 @@ void HandBridge::start_realtime_controller() {
 // stop_realtime_controller
 // ---------------------------------------------------------------------------
 void HandBridge::stop_realtime_controller() {
+    // Detaching the controller may write joint settings too, so the lock covers it as well
+    std::lock_guard lock(sdo_write_mutex_);
     if (controller_) {
         log_info("Stopping realtime controller...");
+        try {
+            auto statistics = controller_->target_statistics();
+            log_info(
+                "Targets received: " + std::to_string(statistics.published) + ", applied: "
+                + std::to_string(statistics.applied) + ", superseded by a newer target: "
+                + std::to_string(statistics.superseded));
+        } catch (const std::logic_error&) {
+            // Firmware-filter mode sends each target as it comes
+        }
         controller_.reset();
     }
 
     // Disable all joints
     try {
-        std::lock_guard lock(hand_mutex_);
         hand_.write<data::joint::Enabled>(false);
         log_info("Joints disabled");
     } catch (const std::exception& e) {
@@ -375,10 +462,19 @@ void HandBridge::handle_resource_query(zenoh::Query& query, const ResourceDef& r
             query.reply_err(zenoh::Bytes("GET not supported"));
             return;
         }
+        auto format = serde_format_;
+        if (auto requested = selector_parameter(query.get_parameters(), "serde_format")) {
+            auto parsed = parse_serde_format(*requested);
+            if (!parsed) {
+                query.reply_err(zenoh::Bytes("Unknown serde_format: " + std::string(*requested)));
+                return;
+            }
+            format = *parsed;
+        }
         try {
             auto value = read_resource(res.path);
             query.reply(zenoh::KeyExpr(key_str),
-                        zenoh::Bytes(value.dump()));
+                        zenoh::Bytes(encode_reply(value, format, get_timestamp_us())));
         } catch (const std::exception& e) {
             log_error("GET " + res.path + " failed: " + e.what());
             query.reply_err(zenoh::Bytes(std::string(e.what())));
@@ -390,7 +486,7 @@ void HandBridge::handle_resource_query(zenoh::Query& query, const ResourceDef& r
             return;
         }
         try {
-            auto value = json::parse(payload_str);
+            auto value = decode_payload(payload_str);
             write_resource(res.path, value);
             query.reply(zenoh::KeyExpr(key_str),
                         zenoh::Bytes("\"ok\""));
@@ -404,118 +500,89 @@ void HandBridge::handle_resource_query(zenoh::Query& query, const ResourceDef& r
 // ---------------------------------------------------------------------------
 // read_resource
 // ---------------------------------------------------------------------------
-json HandBridge::read_resource(const std::string& path) {
+ResourceValue HandBridge::read_resource(const std::string& path) {
     // Atomic reads from controller (no lock needed)
     if (path == "joint/actual_position" && controller_) {
-        return atomic_array_to_json(controller_->get_joint_actual_position());
+        return ResourceValue::array(controller_->get_joint_actual_position());
     }
     if (path == "joint/actual_effort" && controller_) {
-        return atomic_array_to_json(controller_->get_joint_actual_effort());
+        return ResourceValue::array(controller_->get_joint_actual_effort());
     }
 
-    // SDO reads require hand_mutex_
-    std::lock_guard lock(hand_mutex_);
+    // Cached reads share one SDO read among concurrent queries and never fail as busy, so only
+    // resources that can also be written still take their lock (a write must not collide with a
+    // refresh of the same storage units).
+    std::unique_lock<std::mutex> lock;
+    if (resource_can_set(path))
+        lock = std::unique_lock(sdo_write_mutex_);
 
     if (path == "input_voltage") {
-        return static_cast<double>(hand_.read<data::hand::InputVoltage>());
+        return ResourceValue::scalar(static_cast<double>(
+            hand_.read<data::hand::InputVoltage>(kSubscribedTelemetryMaxAge)));
     }
     if (path == "temperature") {
-        return static_cast<double>(hand_.read<data::hand::Temperature>());
+        return ResourceValue::scalar(
+            static_cast<double>(hand_.read<data::hand::Temperature>(kSubscribedTelemetryMaxAge)));
     }
     if (path == "handedness") {
-        return static_cast<int>(hand_.read<data::hand::Handedness>());
+        return ResourceValue::scalar(
+            static_cast<int32_t>(hand_.read<data::hand::Handedness>(kTelemetryMaxAge)));
     }
     if (path == "firmware_version") {
-        return static_cast<uint32_t>(hand_.read<data::hand::FirmwareVersion>());
+        return ResourceValue::scalar(
+            static_cast<uint32_t>(hand_.read<data::hand::FirmwareVersion>(kTelemetryMaxAge)));
     }
 
-    // Per-joint array reads with Latch for batch efficiency
+    // Per-joint array reads: one bulk read of the whole hand, then a bulk copy of the cache
     if (path == "joint/actual_position") {
-        // Fallback when no controller
-        hand_.read<data::joint::ActualPosition>();
+        // Fallback when no controller. Positions change continuously, so always refresh (but
+        // still share the refresh with concurrent queries).
+        hand_.read<data::joint::ActualPosition>(device::MaxAge{std::chrono::milliseconds(0)});
         double result[5][4];
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                result[i][j] = hand_.finger(i).joint(j).get<data::joint::ActualPosition>();
-        return double_array_to_json(result);
+        hand_.get_many<data::joint::ActualPosition>(&result[0][0]);
+        return ResourceValue::array(result);
     }
 
     if (path == "joint/temperature") {
-        device::Latch latch;
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                hand_.finger(i).joint(j).read_async<data::joint::Temperature>(latch);
-        latch.wait();
+        hand_.read<data::joint::Temperature>(kSubscribedTelemetryMaxAge);
         float result[5][4];
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                result[i][j] = hand_.finger(i).joint(j).get<data::joint::Temperature>();
-        return scalar_array_to_json(result);
+        hand_.get_many<data::joint::Temperature>(&result[0][0]);
+        return ResourceValue::array(result);
     }
 
     if (path == "joint/error_code") {
-        device::Latch latch;
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                hand_.finger(i).joint(j).read_async<data::joint::ErrorCode>(latch);
-        latch.wait();
+        hand_.read<data::joint::ErrorCode>(kSubscribedTelemetryMaxAge);
         uint32_t result[5][4];
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                result[i][j] = hand_.finger(i).joint(j).get<data::joint::ErrorCode>();
-        return scalar_array_to_json(result);
+        hand_.get_many<data::joint::ErrorCode>(&result[0][0]);
+        return ResourceValue::array(result);
     }
 
     if (path == "joint/effort_limit") {
-        device::Latch latch;
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                hand_.finger(i).joint(j).read_async<data::joint::EffortLimit>(latch);
-        latch.wait();
+        hand_.read<data::joint::EffortLimit>(kTelemetryMaxAge);
         double result[5][4];
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                result[i][j] = hand_.finger(i).joint(j).get<data::joint::EffortLimit>();
-        return double_array_to_json(result);
+        hand_.get_many<data::joint::EffortLimit>(&result[0][0]);
+        return ResourceValue::array(result);
     }
 
     if (path == "joint/upper_limit") {
-        device::Latch latch;
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                hand_.finger(i).joint(j).read_async<data::joint::UpperLimit>(latch);
-        latch.wait();
+        hand_.read<data::joint::UpperLimit>(kTelemetryMaxAge);
         double result[5][4];
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                result[i][j] = hand_.finger(i).joint(j).get<data::joint::UpperLimit>();
-        return double_array_to_json(result);
+        hand_.get_many<data::joint::UpperLimit>(&result[0][0]);
+        return ResourceValue::array(result);
     }
 
     if (path == "joint/lower_limit") {
-        device::Latch latch;
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                hand_.finger(i).joint(j).read_async<data::joint::LowerLimit>(latch);
-        latch.wait();
+        hand_.read<data::joint::LowerLimit>(kTelemetryMaxAge);
         double result[5][4];
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                result[i][j] = hand_.finger(i).joint(j).get<data::joint::LowerLimit>();
-        return double_array_to_json(result);
+        hand_.get_many<data::joint::LowerLimit>(&result[0][0]);
+        return ResourceValue::array(result);
     }
 
     if (path == "joint/bus_voltage") {
-        device::Latch latch;
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                hand_.finger(i).joint(j).read_async<data::joint::BusVoltage>(latch);
-        latch.wait();
+        hand_.read<data::joint::BusVoltage>(kSubscribedTelemetryMaxAge);
         float result[5][4];
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                result[i][j] = hand_.finger(i).joint(j).get<data::joint::BusVoltage>();
-        return scalar_array_to_json(result);
+        hand_.get_many<data::joint::BusVoltage>(&result[0][0]);
+        return ResourceValue::array(result);
     }
 
     throw std::runtime_error("Unknown GET resource: " + path);
@@ -525,25 +592,16 @@ json HandBridge::read_resource(const std::string& path) {
 // write_resource
 // ---------------------------------------------------------------------------
 void HandBridge::write_resource(const std::string& path, const json& value) {
-    // target_position: direct to controller (atomic, no lock needed)
+    // target_position: direct to the controller's latest-wins mailbox, no lock needed
     if (path == "joint/target_position") {
         double pos[5][4];
         json_to_array(value, pos);
-        for (int i = 0; i < 5; i++) {
-            for (int j = 0; j < 4; j++) {
-                if (!std::isfinite(pos[i][j])) {
-                    throw std::invalid_argument("target_position contains non-finite values");
-                }
-            }
-        }
-        if (controller_) {
-            controller_->set_joint_target_position(pos);
-        }
+        write_target_position(pos);
         return;
     }
 
     // All other writes need SDO access
-    std::lock_guard lock(hand_mutex_);
+    std::lock_guard lock(sdo_write_mutex_);
 
     if (path == "joint/control_mode") {
         device::Latch latch;
@@ -588,6 +646,19 @@ void HandBridge::write_resource(const std::string& path, const json& value) {
     throw std::runtime_error("Unknown SET resource: " + path);
 }
 
+void HandBridge::write_target_position(const double (&positions)[5][4]) {
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 4; j++) {
+            if (!std::isfinite(positions[i][j])) {
+                throw std::invalid_argument("target_position contains non-finite values");
+            }
+        }
+    }
+    if (controller_) {
+        controller_->set_joint_target_position(positions);
+    }
+}
+
 // ---------------------------------------------------------------------------
 // publish_loop
 // ---------------------------------------------------------------------------
@@ -597,25 +668,60 @@ void HandBridge::publish_loop(std::stop_token stop_token) {
         std::chrono::duration<double>(1.0 / pub_rate_));
 
     auto next_tick = clock::now();
+    uint64_t sequence = 0;
 
     while (!stop_token.stop_requested()) {
         next_tick += period;
+        sequence++;
 
         // Capture a single timestamp for all resources in this cycle
-        auto timestamp_us = get_timestamp_us();
-
-        for (size_t idx = 0; idx < pub_paths_.size(); idx++) {
-            try {
-                auto value = read_resource(pub_paths_[idx]);
-                auto envelope = wrap_with_timestamp(value, timestamp_us);
-                publishers_[idx].put(zenoh::Bytes(envelope.dump()));
-            } catch (const std::exception& e) {
-                log_error("Publish error for " + pub_paths_[idx] + ": " + e.what());
-            }
-        }
+        publish_resources(get_timestamp_us(), sequence);
 
         std::this_thread::sleep_until(next_tick);
     }
 }
 
+void HandBridge::publish_on_feedback_loop(std::stop_token stop_token) {
+    using clock = std::chrono::steady_clock;
+    const auto min_interval = pub_rate_ > 0.0
+                                ? std::chrono::duration_cast<clock::duration>(
+                                      std::chrono::duration<double>(1.0 / pub_rate_))
+                                : clock::duration::zero();
+    // Bounds how long a stop request waits when no feedback arrives
+    constexpr std::chrono::milliseconds kWaitTimeout{100};
+
+    uint64_t version = hand_.realtime_feedback_version();
+    uint64_t published_version = version;
+    auto next_allowed = clock::now();
+
+    while (!stop_token.stop_requested()) {
+        version = hand_.wait_realtime_feedback(version, kWaitTimeout);
+        if (version - published_version < pub_every_)
+            continue;
+
+        // Over the rate cap: skip frames until one arrives after the interval
+        auto now = clock::now();
+        if (now < next_allowed)
+            continue;
+
+        // The feedback version numbers the frames, so consumers can see which ones were skipped
+        publish_resources(get_timestamp_us(), version);
+        published_version = version;
+        next_allowed = now + min_interval;
+    }
+}
+
+void HandBridge::publish_resources(int64_t timestamp_us, uint64_t sequence) {
+    const bool with_sequence = pub_mode_ == PublishMode::FEEDBACK;
+    for (size_t idx = 0; idx < pub_paths_.size(); idx++) {
+        try {
+            auto value = read_resource(pub_paths_[idx]);
+            publishers_[idx].put(zenoh::Bytes(
+                encode_sample(value, serde_format_, timestamp_us, sequence, with_sequence)));
+        } catch (const std::exception& e) {
+            log_error("Publish error for " + pub_paths_[idx] + ": " + e.what());
+        }
+    }
+}
+
 } // namespace wujihand_bridge
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -12,6 +13,8 @@
 
 #include <wujihandcpp/device/hand.hpp>
 
+#include "serde.hpp"
+
 namespace wujihand_bridge {
 
 /// Resource definition matching the Python bridge protocol.
@@ -23,11 +26,19 @@ struct ResourceDef {
     nlohmann::json json_schema;
 };
 
+/// When the publisher thread publishes the SUB resources.
+enum class PublishMode {
+    TIMER,    // Every 1 / pub_rate seconds, whatever the feedback arrays hold
+    FEEDBACK, // As every pub_every-th PDO feedback frame arrives, at most pub_rate times a second
+};
+
 /// C++ Zenoh bridge for WujiHand, mirroring the Python hand_zenoh_bridge.py.
 class HandBridge {
 public:
     HandBridge(
-        wujihandcpp::device::Hand& hand, std::string serial_number, double pub_rate);
+        wujihandcpp::device::Hand& hand, std::string serial_number, double pub_rate,
+        SerdeFormat serde_format = SerdeFormat::JSON, PublishMode pub_mode = PublishMode::TIMER,
+        uint64_t pub_every = 1);
 
     ~HandBridge();
 
@@ -56,24 +67,39 @@ private:
     // Resource queryable handler
     void handle_resource_query(zenoh::Query& query, const ResourceDef& res);
 
-    // Read a resource, return JSON value
-    nlohmann::json read_resource(const std::string& path);
+    // Read a resource, return its value before encoding
+    ResourceValue read_resource(const std::string& path);
 
     // Write a resource from JSON value
     void write_resource(const std::string& path, const nlohmann::json& value);
 
-    // Publisher loop (runs in jthread)
+    // Hand targets to the controller (the target_position fast path)
+    void write_target_position(const double (&positions)[5][4]);
+
+    // Publisher loops (run in jthread)
     void publish_loop(std::stop_token stop_token);
+    void publish_on_feedback_loop(std::stop_token stop_token);
+
+    // Publish every SUB resource once
+    void publish_resources(int64_t timestamp_us, uint64_t sequence);
+
+    static bool resource_can_set(const std::string& path);
 
     // Start / stop realtime controller
     void start_realtime_controller();
     void stop_realtime_controller();
 
+    // Subscribe to the telemetry served from the SDK cache
+    void start_telemetry_subscriptions();
+
     // Members
     wujihandcpp::device::Hand& hand_;
     std::string sn_;
     std::string sanitized_sn_;
-    double pub_rate_;
+    double pub_rate_; // A cap in FEEDBACK mode, where 0 means none
+    PublishMode pub_mode_;
+    uint64_t pub_every_;
+    SerdeFormat serde_format_; // Of published samples, and of GET replies by default
     double cutoff_freq_ = 5.0; // LowPass filter for smooth interpolation
 
     // Zenoh resources
@@ -87,8 +113,14 @@ private:
     // Realtime controller
     std::unique_ptr<wujihandcpp::device::IController> controller_;
 
-    // Thread safety
-    std::mutex hand_mutex_;    // Protects SDO read/write operations
+    // Periodic telemetry reads, run by the SDK's SDO scheduler
+    std::vector<wujihandcpp::device::Subscription> telemetry_subscriptions_;
+
+    // Thread safety: SDO submission is thread-safe and GET queries use merged cached reads, so
+    // they run concurrently. Writes, reads of writable resources, and starting or stopping the
+    // controller (which writes joint settings of its own) all hold this one lock: resources
+    // share storage units, so per-resource locks would not keep their operations apart.
+    std::mutex sdo_write_mutex_;
 
     // Publisher thread
     std::jthread pub_thread_;
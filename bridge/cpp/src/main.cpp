@@ -20,10 +20,14 @@ static void signal_handler(int /*sig*/) {
 static void print_usage(const char* prog) {
     std::cerr << "Usage: " << prog << " [options]\n"
               << "Options:\n"
-              << "  --sn <serial>     Hand serial number filter\n"
-              << "  --pub-rate <hz>   Position publish rate in Hz (required, e.g. 1000)\n"
-              << "  --log-level <lvl> Log level: trace/debug/info/warn/err/off (default: info)\n"
-              << "  --help            Show this help\n";
+              << "  --sn <serial>      Hand serial number filter\n"
+              << "  --pub-rate <hz>    Position publish rate in Hz (required in timer mode,\n"
+              << "                     e.g. 1000); a rate cap in feedback mode (default: none)\n"
+              << "  --pub-mode <mode>  Publish on: timer/feedback (default: timer)\n"
+              << "  --pub-every <n>    Feedback mode: publish every n-th frame (default: 1)\n"
+              << "  --serde-format <f> Payload format: json/cbor/binary (default: json)\n"
+              << "  --log-level <lvl>  Log level: trace/debug/info/warn/err/off (default: info)\n"
+              << "  --help             Show this help\n";
 }
 
 static wujihandcpp::logging::Level parse_log_level(const std::string& s) {
@@ -40,6 +44,9 @@ int main(int argc, char* argv[]) {
     // Parse arguments
     const char* sn_filter = nullptr;
     double pub_rate = 0.0;
+    auto serde_format = wujihand_bridge::SerdeFormat::JSON;
+    auto pub_mode = wujihand_bridge::PublishMode::TIMER;
+    long long pub_every = 1;
     std::string log_level_str = "info";
 
     for (int i = 1; i < argc; i++) {
@@ -47,6 +54,27 @@ int main(int argc, char* argv[]) {
             sn_filter = argv[++i];
         } else if (std::strcmp(argv[i], "--pub-rate") == 0 && i + 1 < argc) {
             pub_rate = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--pub-mode") == 0 && i + 1 < argc) {
+            ++i;
+            if (std::strcmp(argv[i], "timer") == 0) {
+                pub_mode = wujihand_bridge::PublishMode::TIMER;
+            } else if (std::strcmp(argv[i], "feedback") == 0) {
+                pub_mode = wujihand_bridge::PublishMode::FEEDBACK;
+            } else {
+                std::cerr << "Error: unknown --pub-mode " << argv[i] << "\n";
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--pub-every") == 0 && i + 1 < argc) {
+            pub_every = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--serde-format") == 0 && i + 1 < argc) {
+            auto parsed = wujihand_bridge::parse_serde_format(argv[++i]);
+            if (!parsed) {
+                std::cerr << "Error: unknown --serde-format " << argv[i] << "\n";
+                print_usage(argv[0]);
+                return 1;
+            }
+            serde_format = *parsed;
         } else if (std::strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
             log_level_str = argv[++i];
         } else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
@@ -59,11 +87,21 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    if (pub_rate <= 0.0) {
+    if (pub_mode == wujihand_bridge::PublishMode::TIMER && pub_rate <= 0.0) {
         std::cerr << "Error: --pub-rate is required (e.g. --pub-rate 1000)\n";
         print_usage(argv[0]);
         return 1;
     }
+    if (pub_rate < 0.0) {
+        std::cerr << "Error: --pub-rate must not be negative\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (pub_every < 1) {
+        std::cerr << "Error: --pub-every must be at least 1\n";
+        print_usage(argv[0]);
+        return 1;
+    }
 
     // Configure logging
     wujihandcpp::logging::set_log_to_console(true);
@@ -99,7 +137,8 @@ int main(int argc, char* argv[]) {
         wujihandcpp::logging::Level::INFO, info_msg.c_str(), info_msg.size());
 
     // Create and start bridge
-    wujihand_bridge::HandBridge bridge(hand, sn, pub_rate);
+    wujihand_bridge::HandBridge bridge(
+        hand, sn, pub_rate, serde_format, pub_mode, static_cast<uint64_t>(pub_every));
     bridge.start();
 
     info_msg = "Bridge running. Press Ctrl+C to stop.";
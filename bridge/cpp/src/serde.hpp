@@ -0,0 +1,320 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <nlohmann/json.hpp>
+
+namespace wujihand_bridge {
+
+/// Payload encoding of resource values. JSON is the default; CBOR carries the same structure in
+/// fewer bytes; BINARY packs the values behind a fixed header and needs no parsing at all.
+enum class SerdeFormat { JSON, CBOR, BINARY };
+
+inline const char* serde_format_name(SerdeFormat format) {
+    if (format == SerdeFormat::CBOR)
+        return "cbor";
+    if (format == SerdeFormat::BINARY)
+        return "binary";
+    return "json";
+}
+
+inline std::optional<SerdeFormat> parse_serde_format(std::string_view name) {
+    if (name == "json")
+        return SerdeFormat::JSON;
+    if (name == "cbor")
+        return SerdeFormat::CBOR;
+    if (name == "binary")
+        return SerdeFormat::BINARY;
+    return std::nullopt;
+}
+
+enum class ElementType : uint8_t {
+    FLOAT64 = 1,
+    FLOAT32 = 2,
+    UINT32 = 3,
+    INT32 = 4,
+    UINT16 = 5,
+    BOOL = 6, // One byte, 0 or 1
+};
+
+inline size_t element_size(ElementType type) {
+    if (type == ElementType::FLOAT64)
+        return 8;
+    if (type == ElementType::UINT16)
+        return 2;
+    if (type == ElementType::BOOL)
+        return 1;
+    return 4;
+}
+
+template <typename T>
+constexpr ElementType element_type_of() {
+    if constexpr (std::is_same_v<T, double>)
+        return ElementType::FLOAT64;
+    else if constexpr (std::is_same_v<T, float>)
+        return ElementType::FLOAT32;
+    else if constexpr (std::is_same_v<T, uint32_t>)
+        return ElementType::UINT32;
+    else if constexpr (std::is_same_v<T, int32_t>)
+        return ElementType::INT32;
+    else if constexpr (std::is_same_v<T, uint16_t>)
+        return ElementType::UINT16;
+    else {
+        static_assert(std::is_same_v<T, bool>, "Unsupported element type");
+        return ElementType::BOOL;
+    }
+}
+
+/// A resource value before encoding: a scalar, or a 5x4 array, of one element type.
+struct ResourceValue {
+    ElementType type = ElementType::FLOAT64;
+    uint8_t rows = 0, cols = 0; // 0 x 0 for a scalar
+    alignas(8) unsigned char data[5 * 4 * 8] = {};
+
+    size_t count() const { return rows ? size_t{rows} * cols : 1; }
+
+    size_t byte_size() const { return count() * element_size(type); }
+
+    template <typename T>
+    static ResourceValue scalar(T value) {
+        ResourceValue result;
+        result.type = element_type_of<T>();
+        std::memcpy(result.data, &value, sizeof(T));
+        return result;
+    }
+
+    template <typename T>
+    static ResourceValue array(const T (&values)[5][4]) {
+        ResourceValue result;
+        result.type = element_type_of<T>();
+        result.rows = 5;
+        result.cols = 4;
+        std::memcpy(result.data, values, sizeof(values));
+        return result;
+    }
+
+    static ResourceValue array(const std::atomic<double> (&values)[5][4]) {
+        double loaded[5][4];
+        for (int i = 0; i < 5; i++)
+            for (int j = 0; j < 4; j++)
+                loaded[i][j] = values[i][j].load(std::memory_order_relaxed);
+        return array(loaded);
+    }
+
+    /// Element `index` (row-major), converted to T.
+    template <typename T>
+    T at(size_t index) const {
+        const unsigned char* element = data + index * element_size(type);
+        if (type == ElementType::FLOAT64)
+            return static_cast<T>(load<double>(element));
+        if (type == ElementType::FLOAT32)
+            return static_cast<T>(load<float>(element));
+        if (type == ElementType::UINT32)
+            return static_cast<T>(load<uint32_t>(element));
+        if (type == ElementType::INT32)
+            return static_cast<T>(load<int32_t>(element));
+        if (type == ElementType::UINT16)
+            return static_cast<T>(load<uint16_t>(element));
+        return static_cast<T>(*element != 0);
+    }
+
+private:
+    template <typename T>
+    static T load(const unsigned char* element) {
+        T value;
+        std::memcpy(&value, element, sizeof(T));
+        return value;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Binary format
+// ---------------------------------------------------------------------------
+
+static_assert(
+    std::endian::native == std::endian::little,
+    "The binary format is little-endian and written with memcpy");
+
+/// Header of a binary payload, followed by rows x cols (or one, for a scalar) packed
+/// little-endian elements in row-major order.
+struct BinaryHeader {
+    char magic[2];        // "WJ"
+    uint8_t version;      // binary_version
+    uint8_t element_type; // ElementType
+    uint8_t rows, cols;   // 0 x 0 for a scalar
+    uint16_t reserved;
+    uint64_t sequence;    // Publish cycle, or feedback frame number; 0 in GET replies
+    int64_t timestamp_us; // UTC microseconds since epoch
+};
+static_assert(sizeof(BinaryHeader) == 24, "");
+
+constexpr uint8_t binary_version = 1;
+
+inline bool is_binary_payload(std::string_view payload) {
+    return payload.size() >= sizeof(BinaryHeader) && payload[0] == 'W' && payload[1] == 'J';
+}
+
+inline std::string
+    encode_binary(const ResourceValue& value, int64_t timestamp_us, uint64_t sequence) {
+    const BinaryHeader header{
+        .magic = {'W', 'J'},
+        .version = binary_version,
+        .element_type = static_cast<uint8_t>(value.type),
+        .rows = value.rows,
+        .cols = value.cols,
+        .reserved = 0,
+        .sequence = sequence,
+        .timestamp_us = timestamp_us,
+    };
+    std::string payload(sizeof(header) + value.byte_size(), '\0');
+    std::memcpy(payload.data(), &header, sizeof(header));
+    std::memcpy(payload.data() + sizeof(header), value.data, value.byte_size());
+    return payload;
+}
+
+inline ResourceValue decode_binary(std::string_view payload, BinaryHeader* header_out = nullptr) {
+    if (!is_binary_payload(payload))
+        throw std::invalid_argument("binary payload: missing header");
+
+    BinaryHeader header;
+    std::memcpy(&header, payload.data(), sizeof(header));
+    if (header.version != binary_version)
+        throw std::invalid_argument(
+            "binary payload: unsupported version " + std::to_string(header.version));
+    if (header.element_type < static_cast<uint8_t>(ElementType::FLOAT64)
+        || header.element_type > static_cast<uint8_t>(ElementType::BOOL))
+        throw std::invalid_argument(
+            "binary payload: unknown element type " + std::to_string(header.element_type));
+    if (header.rows > 5 || header.cols > 4 || (header.rows == 0) != (header.cols == 0))
+        throw std::invalid_argument(
+            "binary payload: unsupported shape " + std::to_string(header.rows) + "x"
+            + std::to_string(header.cols));
+
+    ResourceValue value;
+    value.type = static_cast<ElementType>(header.element_type);
+    value.rows = header.rows;
+    value.cols = header.cols;
+    if (payload.size() != sizeof(header) + value.byte_size())
+        throw std::invalid_argument(
+            "binary payload: expected " + std::to_string(sizeof(header) + value.byte_size())
+            + " bytes, got " + std::to_string(payload.size()));
+    std::memcpy(value.data, payload.data() + sizeof(header), value.byte_size());
+
+    if (header_out)
+        *header_out = header;
+    return value;
+}
+
+// ---------------------------------------------------------------------------
+// JSON / CBOR
+// ---------------------------------------------------------------------------
+
+inline nlohmann::json element_to_json(const ResourceValue& value, size_t index) {
+    if (value.type == ElementType::FLOAT64)
+        return value.at<double>(index);
+    if (value.type == ElementType::FLOAT32)
+        return value.at<float>(index);
+    if (value.type == ElementType::UINT32)
+        return value.at<uint32_t>(index);
+    if (value.type == ElementType::INT32)
+        return value.at<int32_t>(index);
+    if (value.type == ElementType::UINT16)
+        return value.at<uint16_t>(index);
+    return value.at<bool>(index);
+}
+
+/// The value as the JSON number or 2D array the resource schemas describe.
+inline nlohmann::json to_json(const ResourceValue& value) {
+    if (!value.rows)
+        return element_to_json(value, 0);
+
+    nlohmann::json result = nlohmann::json::array();
+    for (size_t i = 0; i < value.rows; i++) {
+        nlohmann::json row = nlohmann::json::array();
+        for (size_t j = 0; j < value.cols; j++)
+            row.push_back(element_to_json(value, i * value.cols + j));
+        result.push_back(std::move(row));
+    }
+    return result;
+}
+
+inline std::string encode_json(const nlohmann::json& j, SerdeFormat format) {
+    if (format == SerdeFormat::CBOR) {
+        std::string payload;
+        nlohmann::json::to_cbor(j, payload);
+        return payload;
+    }
+    return j.dump();
+}
+
+// ---------------------------------------------------------------------------
+// Payloads
+// ---------------------------------------------------------------------------
+
+/// Payload of a published sample. JSON and CBOR wrap the value in the {timestamp_us, data}
+/// envelope, with the sequence only if `with_sequence`; the binary header always carries both.
+inline std::string encode_sample(
+    const ResourceValue& value, SerdeFormat format, int64_t timestamp_us, uint64_t sequence,
+    bool with_sequence = false) {
+    if (format == SerdeFormat::BINARY)
+        return encode_binary(value, timestamp_us, sequence);
+
+    nlohmann::json envelope = {{"timestamp_us", timestamp_us}, {"data", to_json(value)}};
+    if (with_sequence)
+        envelope["sequence"] = sequence;
+    return encode_json(envelope, format);
+}
+
+/// Payload of a GET reply: the bare value in JSON and CBOR, behind its header in binary.
+inline std::string
+    encode_reply(const ResourceValue& value, SerdeFormat format, int64_t timestamp_us) {
+    if (format == SerdeFormat::BINARY)
+        return encode_binary(value, timestamp_us, 0);
+    return encode_json(to_json(value), format);
+}
+
+/// Decodes a client payload in any format: binary by its magic, CBOR by its leading array or
+/// map byte (never valid at the start of JSON text), JSON otherwise. A CBOR scalar is taken for
+/// CBOR only if it is not valid JSON text, so the one-byte CBOR integers -17 to -26 read as the
+/// JSON digits they are spelled with.
+inline nlohmann::json decode_payload(std::string_view payload) {
+    if (is_binary_payload(payload))
+        return to_json(decode_binary(payload));
+
+    auto first = payload.empty() ? 0 : static_cast<unsigned char>(payload[0]);
+    if (first >= 0x80 && first <= 0xbf)
+        return nlohmann::json::from_cbor(payload.begin(), payload.end());
+
+    auto result = nlohmann::json::parse(payload.begin(), payload.end(), nullptr, false);
+    if (!result.is_discarded())
+        return result;
+    result = nlohmann::json::from_cbor(payload.begin(), payload.end(), true, false);
+    if (!result.is_discarded())
+        return result;
+    return nlohmann::json::parse(payload.begin(), payload.end()); // Throws the JSON error
+}
+
+/// Decodes a binary 5x4 float64 or float32 payload without going through JSON. Returns false
+/// for payloads in other formats.
+inline bool decode_binary_5x4(std::string_view payload, double (&out)[5][4]) {
+    if (!is_binary_payload(payload))
+        return false;
+
+    auto value = decode_binary(payload);
+    if (value.rows != 5 || value.cols != 4
+        || (value.type != ElementType::FLOAT64 && value.type != ElementType::FLOAT32))
+        throw std::invalid_argument("binary payload: expected a 5x4 float64 or float32 array");
+    for (size_t k = 0; k < 5 * 4; k++)
+        out[k / 4][k % 4] = value.at<double>(k);
+    return true;
+}
+
+} // namespace wujihand_bridge
@@ -0,0 +1,83 @@
+// Measures the CPU cost of the bridge's payload formats: encoding a published 5x4 position
+// sample (what the publisher thread pays per resource and cycle) and decoding a 5x4 target
+// position (what a target_position PUT pays before reaching the controller). Together they are
+// the serialization share of the bridge's end-to-end latency.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "json_helpers.hpp"
+#include "serde.hpp"
+
+using namespace wujihand_bridge;
+using Clock = std::chrono::steady_clock;
+
+static volatile double g_sink;
+
+static void report(const char* what, const char* format, size_t bytes, std::vector<int64_t>& ns) {
+    std::sort(ns.begin(), ns.end());
+    auto at = [&ns](double quantile) {
+        return ns[static_cast<size_t>(quantile * static_cast<double>(ns.size() - 1))];
+    };
+    std::printf(
+        "%-8s %-7s %5zu bytes   p50 %7lld ns   p99 %7lld ns\n", what, format, bytes,
+        static_cast<long long>(at(0.5)), static_cast<long long>(at(0.99)));
+}
+
+template <typename F>
+static std::vector<int64_t> measure(int iterations, F&& f) {
+    std::vector<int64_t> samples;
+    samples.reserve(iterations);
+    for (int i = 0; i < iterations; i++) {
+        auto start = Clock::now();
+        f();
+        samples.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+    return samples;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 100000;
+    if (iterations <= 0) {
+        std::fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    double positions[5][4];
+    for (int i = 0; i < 5; i++)
+        for (int j = 0; j < 4; j++)
+            positions[i][j] = std::sin(0.1 * (4 * i + j) + 0.123456789);
+    const auto value = ResourceValue::array(positions);
+    const int64_t timestamp_us = 1773822692412074;
+
+    for (auto format : {SerdeFormat::JSON, SerdeFormat::CBOR, SerdeFormat::BINARY}) {
+        const char* name = serde_format_name(format);
+        uint64_t sequence = 0;
+
+        auto payload = encode_sample(value, format, timestamp_us, sequence);
+        auto encode = measure(iterations, [&] {
+            auto sample = encode_sample(value, format, timestamp_us, ++sequence);
+            g_sink = static_cast<double>(sample.size());
+        });
+        report("encode", name, payload.size(), encode);
+
+        // Targets as a client sends them: the bare array in JSON and CBOR
+        auto target = format == SerdeFormat::BINARY ? encode_binary(value, timestamp_us, 0)
+                                                    : encode_json(to_json(value), format);
+        auto decode = measure(iterations, [&] {
+            double decoded[5][4];
+            if (!decode_binary_5x4(target, decoded))
+                json_to_array(decode_payload(target), decoded);
+            g_sink = decoded[4][3];
+        });
+        report("decode", name, target.size(), decode);
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include <cstdint>
+#include <cstring>
+
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "json_helpers.hpp"
+#include "serde.hpp"
+
+namespace wujihand_bridge {
+
+namespace {
+
+// Distinct, exactly representable values for every element, including negative ones where the
+// type has them
+template <typename T>
+T element(size_t index) {
+    if constexpr (std::is_same_v<T, bool>)
+        return index % 3 == 1;
+    else if constexpr (std::is_floating_point_v<T>)
+        return static_cast<T>(0.25 * static_cast<double>(index) - 2.0);
+    else if constexpr (std::is_signed_v<T>)
+        return static_cast<T>(100 * static_cast<int>(index) - 1000);
+    else
+        return static_cast<T>(1000 * index + 7);
+}
+
+template <typename T>
+ResourceValue make_array() {
+    T values[5][4];
+    for (size_t k = 0; k < 5 * 4; k++)
+        values[k / 4][k % 4] = element<T>(k);
+    return ResourceValue::array(values);
+}
+
+void expect_same_value(const ResourceValue& actual, const ResourceValue& expected) {
+    EXPECT_EQ(actual.type, expected.type);
+    EXPECT_EQ(actual.rows, expected.rows);
+    EXPECT_EQ(actual.cols, expected.cols);
+    EXPECT_EQ(std::memcmp(actual.data, expected.data, expected.byte_size()), 0);
+}
+
+std::string binary_payload(uint8_t element_type, uint8_t rows, uint8_t cols, size_t data_size) {
+    const BinaryHeader header{
+        .magic = {'W', 'J'},
+        .version = binary_version,
+        .element_type = element_type,
+        .rows = rows,
+        .cols = cols,
+        .reserved = 0,
+        .sequence = 0,
+        .timestamp_us = 0,
+    };
+    std::string payload(sizeof(header) + data_size, '\0');
+    std::memcpy(payload.data(), &header, sizeof(header));
+    return payload;
+}
+
+} // namespace
+
+template <typename T>
+class SerdeRoundTripTest : public testing::Test {};
+
+using ElementTypes = testing::Types<double, float, uint32_t, int32_t, uint16_t, bool>;
+TYPED_TEST_SUITE(SerdeRoundTripTest, ElementTypes);
+
+TYPED_TEST(SerdeRoundTripTest, BinaryKeepsValuesAndHeader) {
+    for (const auto& value : {make_array<TypeParam>(), ResourceValue::scalar(element<TypeParam>(5))}) {
+        auto payload = encode_binary(value, 1'700'000'000'000'000, 42);
+        EXPECT_EQ(payload.size(), sizeof(BinaryHeader) + value.byte_size());
+
+        BinaryHeader header;
+        auto decoded = decode_binary(payload, &header);
+        expect_same_value(decoded, value);
+        EXPECT_EQ(header.sequence, 42u);
+        EXPECT_EQ(header.timestamp_us, 1'700'000'000'000'000);
+        EXPECT_EQ(decode_payload(payload), to_json(value));
+    }
+}
+
+TYPED_TEST(SerdeRoundTripTest, JsonAndCborRepliesDecodeToTheSameValue) {
+    for (const auto& value : {make_array<TypeParam>(), ResourceValue::scalar(element<TypeParam>(5))})
+        for (auto format : {SerdeFormat::JSON, SerdeFormat::CBOR}) {
+            auto decoded = decode_payload(encode_reply(value, format, 0));
+            EXPECT_EQ(decoded, to_json(value)) << serde_format_name(format);
+        }
+}
+
+TYPED_TEST(SerdeRoundTripTest, SamplesCarryTheEnvelope) {
+    auto value = make_array<TypeParam>();
+    for (auto format : {SerdeFormat::JSON, SerdeFormat::CBOR}) {
+        auto decoded = decode_payload(encode_sample(value, format, 123, 9, true));
+        EXPECT_EQ(decoded["timestamp_us"], 123) << serde_format_name(format);
+        EXPECT_EQ(decoded["sequence"], 9) << serde_format_name(format);
+        EXPECT_EQ(decoded["data"], to_json(value)) << serde_format_name(format);
+
+        decoded = decode_payload(encode_sample(value, format, 123, 9));
+        EXPECT_FALSE(decoded.contains("sequence")) << serde_format_name(format);
+    }
+
+    BinaryHeader header;
+    expect_same_value(
+        decode_binary(encode_sample(value, SerdeFormat::BINARY, 123, 9), &header), value);
+    EXPECT_EQ(header.sequence, 9u);
+    EXPECT_EQ(header.timestamp_us, 123);
+}
+
+TEST(SerdeTest, ParsesFormatNames) {
+    for (auto format : {SerdeFormat::JSON, SerdeFormat::CBOR, SerdeFormat::BINARY})
+        EXPECT_EQ(parse_serde_format(serde_format_name(format)), format);
+    EXPECT_EQ(parse_serde_format("msgpack"), std::nullopt);
+}
+
+TEST(SerdeTest, DecodesTargetsOfEveryFormat) {
+    double expected[5][4];
+    for (size_t k = 0; k < 5 * 4; k++)
+        expected[k / 4][k % 4] = element<double>(k);
+    auto value = ResourceValue::array(expected);
+
+    double decoded[5][4] = {};
+    ASSERT_TRUE(decode_binary_5x4(encode_binary(value, 0, 0), decoded));
+    EXPECT_EQ(std::memcmp(decoded, expected, sizeof(expected)), 0);
+
+    // Float32 targets are widened
+    ASSERT_TRUE(decode_binary_5x4(encode_binary(make_array<float>(), 0, 0), decoded));
+    EXPECT_EQ(std::memcmp(decoded, expected, sizeof(expected)), 0);
+
+    // Other formats go through JSON
+    for (auto format : {SerdeFormat::JSON, SerdeFormat::CBOR}) {
+        auto payload = encode_reply(value, format, 0);
+        EXPECT_FALSE(decode_binary_5x4(payload, decoded));
+        double from_json[5][4] = {};
+        json_to_array(decode_payload(payload), from_json);
+        EXPECT_EQ(std::memcmp(from_json, expected, sizeof(expected)), 0);
+    }
+}
+
+TEST(SerdeTest, RejectsMalformedBinaryPayloads) {
+    const auto float64 = static_cast<uint8_t>(ElementType::FLOAT64);
+    auto valid = binary_payload(float64, 5, 4, 5 * 4 * 8);
+    EXPECT_NO_THROW(decode_binary(valid));
+
+    auto bad_magic = valid;
+    bad_magic[1] = 'X';
+    EXPECT_THROW(decode_binary(bad_magic), std::invalid_argument);
+    EXPECT_THROW(decode_payload(bad_magic), nlohmann::json::exception);
+
+    auto bad_version = valid;
+    bad_version[2] = static_cast<char>(binary_version + 1);
+    EXPECT_THROW(decode_binary(bad_version), std::invalid_argument);
+
+    EXPECT_THROW(decode_binary(binary_payload(0, 5, 4, 5 * 4 * 8)), std::invalid_argument);
+    EXPECT_THROW(decode_binary(binary_payload(7, 5, 4, 5 * 4 * 8)), std::invalid_argument);
+
+    EXPECT_THROW(decode_binary(binary_payload(float64, 6, 4, 6 * 4 * 8)), std::invalid_argument);
+    EXPECT_THROW(decode_binary(binary_payload(float64, 5, 5, 5 * 5 * 8)), std::invalid_argument);
+    EXPECT_THROW(decode_binary(binary_payload(float64, 0, 4, 8)), std::invalid_argument);
+    EXPECT_THROW(decode_binary(binary_payload(float64, 5, 0, 8)), std::invalid_argument);
+
+    EXPECT_THROW(decode_binary(valid.substr(0, valid.size() - 1)), std::invalid_argument);
+    EXPECT_THROW(decode_binary(valid + '\0'), std::invalid_argument);
+    EXPECT_THROW(decode_binary(binary_payload(float64, 0, 0, 4)), std::invalid_argument);
+    EXPECT_THROW(decode_binary(valid.substr(0, sizeof(BinaryHeader) - 1)), std::invalid_argument);
+    EXPECT_THROW(decode_binary(""), std::invalid_argument);
+}
+
+TEST(SerdeTest, RejectsTargetsThatAreNot5x4) {
+    double out[5][4];
+    const auto float64 = static_cast<uint8_t>(ElementType::FLOAT64);
+
+    EXPECT_THROW(decode_binary_5x4(binary_payload(float64, 0, 0, 8), out), std::invalid_argument);
+    EXPECT_THROW(
+        decode_binary_5x4(binary_payload(float64, 4, 4, 4 * 4 * 8), out), std::invalid_argument);
+    EXPECT_THROW(
+        decode_binary_5x4(binary_payload(float64, 5, 3, 5 * 3 * 8), out), std::invalid_argument);
+    EXPECT_THROW(
+        decode_binary_5x4(encode_binary(make_array<uint32_t>(), 0, 0), out), std::invalid_argument);
+    EXPECT_THROW(
+        decode_binary_5x4(encode_binary(make_array<bool>(), 0, 0), out), std::invalid_argument);
+
+    EXPECT_THROW(json_to_array(decode_payload("[[1, 2, 3, 4]]"), out), std::invalid_argument);
+    EXPECT_THROW(
+        json_to_array(decode_payload(R"([[1,2,3],[1,2,3],[1,2,3],[1,2,3],[1,2,3]])"), out),
+        std::invalid_argument);
+    EXPECT_THROW(json_to_array(decode_payload("1.5"), out), std::invalid_argument);
+    EXPECT_THROW(decode_payload("[1, 2"), nlohmann::json::exception);
+}
+
+} // namespace wujihand_bridge
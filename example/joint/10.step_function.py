@@ -0,0 +1,47 @@
+import ctypes
+import math
+import time
+
+import numpy as np
+import wujihandpy
+
+# A step function compiled to native code runs on the PDO thread every control period, without
+# the GIL. It may be written in C and loaded with ctypes, or compiled with numba:
+#
+#     from numba import cfunc, carray, types
+#
+#     @cfunc(types.void(types.CPointer(types.float64), types.CPointer(types.float64),
+#                       types.voidptr))
+#     def step(actual, target, state):
+#         ...
+#
+# Here a C library built from the following source is loaded:
+#
+#     // cc -O2 -shared -fPIC -o libstep.so step.c
+#     #include <math.h>
+#     void step(const double* actual, double* target, void* state) {
+#         double* phase = (double*)state;
+#         *phase += 2 * M_PI * 0.5 / 500;  // 0.5 Hz at a 500 Hz control rate
+#         double y = (1 - cos(*phase)) * 0.8;
+#         for (int i = 0; i < 20; i++)
+#             target[i] = (i >= 4 && i % 4 != 1) ? y : 0;
+#     }
+
+
+def main():
+    library = ctypes.CDLL("./libstep.so")
+    phase = np.zeros(1, dtype=np.float64)
+
+    hand = wujihandpy.Hand()
+    hand.write_joint_enabled(True)
+
+    with hand.realtime_controller(enable_upstream=True, step=library.step, state=phase):
+        for _ in range(10):
+            time.sleep(1.0)
+            print(f"phase = {phase[0] % (2 * math.pi):.2f} rad")
+
+    hand.write_joint_enabled(False)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,6 +1,5 @@
 import wujihandpy
 import numpy as np
-import time
 import math
 
 
@@ -29,10 +28,10 @@ def run(hand: wujihandpy.Hand):
     ) as controller:
         # Filtered duplex realtime control (100Hz -> 1kHz)
         update_rate = 100.0
-        update_period = 1.0 / update_rate
 
         x = 0
-        while True:
+        # Waits for each tick with the GIL released: steadier than time.sleep()
+        for actual in hand.realtime_loop(update_rate):
             y = (1 - math.cos(x)) * 0.8
 
             target = np.array(
@@ -51,7 +50,7 @@ def run(hand: wujihandpy.Hand):
 
             # Print control error
             # Realtime APIs never block
-            error = target - controller.get_joint_actual_position()
+            error = target - actual
             effort = controller.get_joint_actual_effort()
             effort_pct = effort / effort_limit * 100
 
@@ -59,7 +58,6 @@ def run(hand: wujihandpy.Hand):
             print(f"error: {error[1, :]}  effort%: {effort_pct[1, :]}")
 
             x += math.pi / update_rate
-            time.sleep(update_period)
 
 
 if __name__ == "__main__":
@@ -0,0 +1,57 @@
+import wujihandpy
+import numpy as np
+import time
+
+
+def bench(name, function, iterations=100000):
+    # Warm up
+    for _ in range(1000):
+        function()
+
+    start = time.perf_counter_ns()
+    for _ in range(iterations):
+        function()
+    elapsed = time.perf_counter_ns() - start
+
+    print(f"{name:<52} {elapsed / iterations:8.0f} ns/call")
+
+
+def main():
+    hand = wujihandpy.Hand()
+
+    with hand.realtime_controller(
+        enable_upstream=True, filter=wujihandpy.filter.LowPass(cutoff_freq=5.0)
+    ) as controller:
+        # Allocates a new array on every call
+        bench("controller.get_joint_actual_position()", controller.get_joint_actual_position)
+
+        # Fills a caller-owned array in place
+        position = np.empty((5, 4), dtype=np.float64)
+        bench(
+            "controller.get_joint_actual_position(out=position)",
+            lambda: controller.get_joint_actual_position(out=position),
+        )
+
+        # Refreshes the controller's snapshot; the views are always the same arrays
+        bench("controller.refresh()", controller.refresh)
+        view = controller.joint_actual_position
+        bench("controller.refresh() + view[1, 2]", lambda: (controller.refresh(), view[1, 2]))
+
+        # Cached values of the last SDO read
+        hand.read_joint_actual_position()
+        bench("hand.get_joint_actual_position()", hand.get_joint_actual_position)
+        bench(
+            "hand.get_joint_actual_position(out=position)",
+            lambda: hand.get_joint_actual_position(out=position),
+        )
+
+        error_code = np.empty((5, 4), dtype=np.uint32)
+        bench("hand.realtime_get_joint_error_code()", hand.realtime_get_joint_error_code)
+        bench(
+            "hand.realtime_get_joint_error_code(out=error_code)",
+            lambda: hand.realtime_get_joint_error_code(out=error_code),
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <wujihand_server/protocol.hpp>
+#include <wujihandcpp/utility/shared_state.hpp>
+
+namespace wujihand_server {
+
+/// A request the server answered with anything but Status::OK.
+class ServerError : public std::runtime_error {
+public:
+    ServerError(Status status, const std::string& message)
+        : std::runtime_error(message)
+        , status_(status) {}
+
+    Status status() const noexcept { return status_; }
+
+private:
+    Status status_;
+};
+
+/// Connection to wujihand-server. Commands are synchronous round trips over the socket; targets
+/// go through the shared memory mailbox and feedback comes from the state segment, neither of
+/// which involves the server's command thread. Not thread-safe, except set_targets(), which may
+/// run on one other thread.
+class Client {
+public:
+    explicit Client(
+        const std::string& name = "client", const std::string& socket_path = default_socket_path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path))
+            throw std::invalid_argument("Invalid socket path: " + socket_path);
+        socket_path.copy(address.sun_path, socket_path.size());
+
+        fd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (fd_ < 0)
+            throw_system_error("create socket");
+        if (::connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            auto error = errno;
+            ::close(fd_);
+            errno = error;
+            throw_system_error("connect to " + socket_path);
+        }
+
+        try {
+            hello(name);
+        } catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    ~Client() { close(); }
+
+    /// Round trip without side effects.
+    void ping() { call(make_request(Op::PING)); }
+
+    /// Takes the lease on the joints. It lasts while renew(), set_targets() or sdo_write() are
+    /// called within `ttl`, until release(), or until this client disconnects. Throws
+    /// ServerError with Status::BUSY (and the holder's name) if another client holds it.
+    void acquire(std::chrono::milliseconds ttl = std::chrono::milliseconds(1000)) {
+        Request request = make_request(Op::ACQUIRE);
+        request.timeout_ms = static_cast<uint32_t>(ttl.count());
+        token_ = call(request).token;
+    }
+
+    void renew() {
+        Request request = make_request(Op::RENEW);
+        request.token = token_;
+        call(request);
+    }
+
+    void release() {
+        Request request = make_request(Op::RELEASE);
+        request.token = token_;
+        token_ = 0;
+        call(request);
+    }
+
+    /// Name of the client holding the lease, empty if none.
+    std::string lease_holder() { return call(make_request(Op::STATUS)).message; }
+
+    std::vector<uint8_t> sdo_read(
+        int finger_id, int joint_id, uint16_t index, uint8_t sub_index,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(500)) {
+        Request request = make_sdo_request(Op::SDO_READ, finger_id, joint_id, index, sub_index);
+        request.timeout_ms = static_cast<uint32_t>(timeout.count());
+        auto response = call(request);
+        return std::vector<uint8_t>(response.data, response.data + response.size);
+    }
+
+    /// Needs the lease.
+    void sdo_write(
+        int finger_id, int joint_id, uint16_t index, uint8_t sub_index, const void* data,
+        size_t size, std::chrono::milliseconds timeout = std::chrono::milliseconds(500)) {
+        if (size > max_sdo_size)
+            throw std::invalid_argument("SDO data too large");
+        Request request = make_sdo_request(Op::SDO_WRITE, finger_id, joint_id, index, sub_index);
+        request.token = token_;
+        request.timeout_ms = static_cast<uint32_t>(timeout.count());
+        request.size = static_cast<uint8_t>(size);
+        std::memcpy(request.data, data, size);
+        call(request);
+    }
+
+    /// Writes joint targets to this client's target slot and wakes the server. The server only
+    /// applies them while this client holds the lease. Does not block or allocate.
+    void set_targets(const double (&positions)[5][4]) noexcept {
+        auto& slot = *target_;
+        auto lock = slot.lock.load(std::memory_order_relaxed);
+        slot.lock.store(lock + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.sequence = ++target_sequence_;
+        std::memcpy(slot.position, positions, sizeof(slot.position));
+        slot.lock.store(lock + 2, std::memory_order_release);
+
+        mailbox_->doorbell.fetch_add(1, std::memory_order_release);
+        futex_wake(mailbox_->doorbell);
+    }
+
+    /// Reader of the feedback the server publishes; see wujihandcpp/utility/shared_state.hpp.
+    std::unique_ptr<wujihandcpp::shared_state::SharedStateReader> open_feedback() const {
+        return std::unique_ptr<wujihandcpp::shared_state::SharedStateReader>(
+            new wujihandcpp::shared_state::SharedStateReader(
+                state_segment_name(shm_name_).c_str()));
+    }
+
+    const std::string& shm_name() const noexcept { return shm_name_; }
+    bool holds_lease_token() const noexcept { return token_ != 0; }
+
+private:
+    void hello(const std::string& name) {
+        Request request = make_request(Op::HELLO);
+        std::strncpy(request.name, name.c_str(), sizeof(request.name) - 1);
+        int target_fd = -1;
+        auto response = call(request, &target_fd);
+        shm_name_ = response.message;
+
+        if (target_fd < 0)
+            throw std::runtime_error("wujihand-server passed no target slot");
+        void* target =
+            ::mmap(nullptr, sizeof(TargetSlot), PROT_READ | PROT_WRITE, MAP_SHARED, target_fd, 0);
+        ::close(target_fd);
+        if (target == MAP_FAILED)
+            throw_system_error("map the target slot");
+        target_ = static_cast<TargetSlot*>(target);
+
+        auto mailbox_name = "/" + mailbox_segment_name(shm_name_);
+        int fd = ::shm_open(mailbox_name.c_str(), O_RDWR | O_CLOEXEC, 0);
+        if (fd < 0)
+            throw_system_error("open " + mailbox_name);
+        void* mapping =
+            ::mmap(nullptr, sizeof(TargetMailbox), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+            throw_system_error("map " + mailbox_name);
+        mailbox_ = static_cast<TargetMailbox*>(mapping);
+        if (mailbox_->magic.load(std::memory_order_acquire) != mailbox_magic
+            || mailbox_->version != protocol_version)
+            throw std::runtime_error("Unsupported wujihand-server mailbox " + mailbox_name);
+    }
+
+    void close() noexcept {
+        if (target_)
+            ::munmap(target_, sizeof(TargetSlot));
+        if (mailbox_)
+            ::munmap(mailbox_, sizeof(TargetMailbox));
+        if (fd_ >= 0)
+            ::close(fd_); // Also ends a lease we hold
+        target_ = nullptr;
+        mailbox_ = nullptr;
+        fd_ = -1;
+    }
+
+    Request make_request(Op op) {
+        Request request{};
+        request.op = op;
+        request.id = ++request_id_;
+        return request;
+    }
+
+    Request make_sdo_request(Op op, int finger_id, int joint_id, uint16_t index, uint8_t sub) {
+        Request request = make_request(op);
+        request.finger_id = finger_id;
+        request.joint_id = joint_id;
+        request.index = index;
+        request.sub_index = sub;
+        return request;
+    }
+
+    // Stores a descriptor passed with the response in `passed_fd`, and closes any other.
+    Response call(const Request& request, int* passed_fd = nullptr) {
+        if (::send(fd_, &request, sizeof(request), MSG_NOSIGNAL) != sizeof(request))
+            throw_system_error("send request to wujihand-server");
+
+        Response response;
+        do {
+            iovec data;
+            data.iov_base = &response;
+            data.iov_len = sizeof(response);
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+            msghdr message{};
+            message.msg_iov = &data;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+
+            auto size = ::recvmsg(fd_, &message, MSG_CMSG_CLOEXEC);
+            for (auto header = size > 0 ? CMSG_FIRSTHDR(&message) : nullptr; header;
+                 header = CMSG_NXTHDR(&message, header))
+                if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+                    int fd;
+                    std::memcpy(&fd, CMSG_DATA(header), sizeof(fd));
+                    if (passed_fd && response.id == request.id && *passed_fd < 0)
+                        *passed_fd = fd;
+                    else
+                        ::close(fd);
+                }
+            if (size == 0)
+                throw std::runtime_error("wujihand-server closed the connection");
+            if (size != static_cast<ssize_t>(sizeof(response)))
+                throw_system_error("receive response from wujihand-server");
+        } while (response.id != request.id);
+
+        response.message[sizeof(response.message) - 1] = '\0';
+        if (response.status != Status::OK)
+            throw ServerError(
+                response.status, std::string("wujihand-server: ") + response.message);
+        return response;
+    }
+
+    [[noreturn]] static void throw_system_error(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), "Failed to " + what);
+    }
+
+    int fd_ = -1;
+    std::string shm_name_;
+    TargetSlot* target_ = nullptr;
+    TargetMailbox* mailbox_ = nullptr;
+    uint64_t token_ = 0;
+    uint32_t request_id_ = 0;
+    uint64_t target_sequence_ = 0;
+};
+
+} // namespace wujihand_server
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace wujihand_server {
+
+// Wire format shared by wujihand-server and its clients. Both run on the same machine, so
+// structs travel as-is (host byte order) over a SOCK_SEQPACKET Unix socket: one Request per
+// message, answered by one Response with the same id. Bump protocol_version on any change.
+
+constexpr uint32_t protocol_version = 2;
+
+constexpr const char* default_socket_path = "/tmp/wujihand-server.sock";
+constexpr const char* default_shm_name = "wujihand";
+
+enum class Op : uint32_t {
+    HELLO = 1,     // Response: slot (id of this connection), message = shm name, and the
+                   // connection's target slot descriptor (SCM_RIGHTS)
+    PING = 2,      // Round trip only
+    ACQUIRE = 3,   // timeout_ms = lease TTL. Response: token, or BUSY with the holder's name
+    RENEW = 4,     // token
+    RELEASE = 5,   // token
+    SDO_READ = 6,  // finger_id, joint_id, index, sub_index, timeout_ms. Response: size, data
+    SDO_WRITE = 7, // token, finger_id, joint_id, index, sub_index, size, data, timeout_ms
+    STATUS = 8,    // Response: message = lease holder's name (empty if none), slot = its slot
+};
+
+enum class Status : int32_t {
+    OK = 0,
+    BUSY = 1,      // The lease is held by another client
+    NOT_OWNER = 2, // The token is not (or no longer) the current lease
+    TIMEOUT = 3,
+    INVALID = 4,   // Malformed request or out-of-range argument
+    ERROR = 5,     // Device or transport error; see message
+};
+
+constexpr size_t max_sdo_size = 64;
+constexpr size_t max_name_size = 32;
+constexpr size_t max_message_size = 96;
+
+struct Request {
+    Op op;
+    uint32_t id; // Echoed in the response
+    uint64_t token;
+    int32_t finger_id; // -1 for hand-level objects
+    int32_t joint_id;
+    uint32_t timeout_ms;
+    uint16_t index;
+    uint8_t sub_index;
+    uint8_t size;
+    char name[max_name_size]; // HELLO: client name, shown to others while it holds the lease
+    uint8_t data[max_sdo_size];
+};
+
+struct Response {
+    Op op;
+    uint32_t id;
+    Status status;
+    int32_t slot;
+    uint64_t token;
+    uint32_t size;
+    uint32_t reserved;
+    uint8_t data[max_sdo_size];
+    char message[max_message_size]; // NUL-terminated
+};
+
+// Targets. The HELLO response passes each connection a sealed memfd holding one TargetSlot,
+// which only the server and that client map: each slot has a single writer (seqlock), and no
+// client can write the targets of another. After writing, a client bumps `doorbell` in the
+// shared memory segment /dev/shm/<shm name>-targets and wakes the server with futex_wake(); the
+// server only applies the slot of the current lease holder.
+
+constexpr uint64_t mailbox_magic = 0x0047524154484A57; // "WJHTARG\0"
+constexpr uint32_t max_connection_count = 16;
+
+struct alignas(64) TargetSlot {
+    std::atomic<uint64_t> lock; // Odd while being written
+    uint64_t sequence;          // +1 per write; the server applies each sequence at most once
+    double position[5][4];
+};
+
+struct alignas(64) TargetMailbox {
+    std::atomic<uint64_t> magic; // Stored last, with release ordering
+    uint32_t version;
+    std::atomic<uint32_t> doorbell; // futex word
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+inline std::string state_segment_name(const std::string& shm_name) { return shm_name + "-state"; }
+
+inline std::string mailbox_segment_name(const std::string& shm_name) {
+    return shm_name + "-targets";
+}
+
+// Cross-process futex on a word in shared memory (no FUTEX_PRIVATE_FLAG).
+inline void futex_wake(std::atomic<uint32_t>& word) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+// Returns once `word` differs from `expected`, after a wake-up, a signal or `timeout`.
+inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, const timespec* timeout) {
+    ::syscall(
+        SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+}
+
+} // namespace wujihand_server
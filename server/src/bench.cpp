@@ -0,0 +1,125 @@
+// Measures what wujihand-server adds on top of a direct Hand call, with a loopback backend in
+// place of the device: command round trips over the socket and the delay from a client's
+// set_targets() to the backend.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <wujihand_server/client.hpp>
+#include <wujihandcpp/utility/logging.hpp>
+
+#include "command_server.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch())
+        .count();
+}
+
+class LoopbackBackend : public wujihand_server::Backend {
+public:
+    std::vector<uint8_t> sdo_read(
+        int, int, uint16_t index, uint8_t sub_index, std::chrono::milliseconds) override {
+        return {static_cast<uint8_t>(index), static_cast<uint8_t>(index >> 8), sub_index, 0};
+    }
+
+    void sdo_write(
+        int, int, uint16_t, uint8_t, const uint8_t*, size_t, std::chrono::milliseconds) override {}
+
+    // Clients stamp position[0][0] with the time of their set_targets() call
+    void set_targets(const double (&positions)[5][4]) noexcept override {
+        auto latency = now_ns() - static_cast<int64_t>(positions[0][0]);
+        latency_ns.store(latency, std::memory_order::relaxed);
+        applied.fetch_add(1, std::memory_order::release);
+    }
+
+    std::atomic<int64_t> latency_ns{0};
+    std::atomic<uint64_t> applied{0};
+};
+
+static void report(const char* what, std::vector<int64_t>& samples) {
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double quantile) {
+        return samples[static_cast<size_t>(quantile * static_cast<double>(samples.size() - 1))]
+             / 1000.0;
+    };
+    std::printf(
+        "%-28s p50 %8.2f us   p99 %8.2f us   max %8.2f us\n", what, at(0.5), at(0.99), at(1.0));
+}
+
+template <typename F>
+static std::vector<int64_t> measure(int iterations, F&& f) {
+    std::vector<int64_t> samples;
+    samples.reserve(iterations);
+    for (int i = 0; i < iterations; i++) {
+        auto start = now_ns();
+        f();
+        samples.push_back(now_ns() - start);
+    }
+    return samples;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+    if (iterations <= 0) {
+        std::fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    wujihandcpp::logging::set_log_level(wujihandcpp::logging::Level::WARN);
+
+    auto pid = std::to_string(::getpid());
+    auto socket_path = "/tmp/wujihand-server-bench-" + pid + ".sock";
+    auto shm_name = "wujihand-server-bench-" + pid;
+
+    LoopbackBackend backend;
+    wujihand_server::CommandServer server{backend, socket_path, shm_name};
+    server.start();
+
+    {
+        wujihand_server::Client client{"bench", socket_path};
+        client.acquire();
+        double positions[5][4] = {};
+
+        // Baseline: what an in-process caller pays to hand targets to the backend
+        auto direct = measure(iterations, [&] {
+            positions[0][0] = static_cast<double>(now_ns());
+            backend.set_targets(positions);
+        });
+        report("direct set_targets", direct);
+
+        auto ping = measure(iterations, [&] { client.ping(); });
+        report("ping round trip", ping);
+
+        auto sdo = measure(iterations, [&] { client.sdo_read(0, 0, 0x05, 1); });
+        report("sdo_read round trip", sdo);
+
+        // One target in flight at a time, so every write wakes the data plane
+        std::vector<int64_t> handoff;
+        handoff.reserve(iterations);
+        for (int i = 0; i < iterations; i++) {
+            auto applied = backend.applied.load(std::memory_order::acquire);
+            positions[0][0] = static_cast<double>(now_ns());
+            client.set_targets(positions);
+            while (backend.applied.load(std::memory_order::acquire) == applied)
+                std::this_thread::yield();
+            handoff.push_back(backend.latency_ns.load(std::memory_order::relaxed));
+        }
+        report("set_targets to backend", handoff);
+
+        client.release();
+    }
+
+    server.stop();
+    return 0;
+}
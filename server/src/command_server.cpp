@@ -0,0 +1,525 @@
+#include "command_server.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <wujihandcpp/device/latch.hpp>
+#include <wujihandcpp/utility/logging.hpp>
+
+namespace wujihand_server {
+
+using namespace wujihandcpp;
+
+// How often blocked threads look at their stop token
+static constexpr int kPollIntervalMs = 100;
+
+// A lease without an explicit TTL
+static constexpr std::chrono::milliseconds kDefaultLeaseTtl{1000};
+
+static void log_info(const std::string& msg) {
+    logging::log(logging::Level::INFO, msg.c_str(), msg.size());
+}
+
+static void log_warn(const std::string& msg) {
+    logging::log(logging::Level::WARN, msg.c_str(), msg.size());
+}
+
+[[noreturn]] static void throw_system_error(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), "Failed to " + what);
+}
+
+static void copy_string(char* destination, size_t capacity, const std::string& source) {
+    auto size = std::min(source.size(), capacity - 1);
+    std::memcpy(destination, source.data(), size);
+    destination[size] = '\0';
+}
+
+// Maps a zeroed TargetSlot in a new memfd, sealed so that the client it is passed to can write
+// the slot but not shrink it under the server's mapping. Returns null, with errno set, on failure.
+static TargetSlot* create_target_slot(int& fd) {
+    fd = ::memfd_create("wujihand-target-slot", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0)
+        return nullptr;
+
+    void* mapping = MAP_FAILED;
+    if (::ftruncate(fd, sizeof(TargetSlot)) == 0
+        && ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == 0)
+        mapping = ::mmap(nullptr, sizeof(TargetSlot), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        auto error = errno;
+        ::close(fd);
+        errno = error;
+        return nullptr;
+    }
+    return static_cast<TargetSlot*>(mapping);
+}
+
+// Sends `response`, with descriptor `fd` attached unless it is -1.
+static bool send_response(int socket, const Response& response, int fd) {
+    iovec data{.iov_base = const_cast<Response*>(&response), .iov_len = sizeof(response)};
+    msghdr message{};
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    if (fd >= 0) {
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        auto header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(header), &fd, sizeof(int));
+    }
+    return ::sendmsg(socket, &message, MSG_NOSIGNAL) >= 0;
+}
+
+// ---------------------------------------------------------------------------
+// LeaseArbiter
+// ---------------------------------------------------------------------------
+
+Status LeaseArbiter::acquire(
+    int slot, const std::string& name, std::chrono::milliseconds ttl, uint64_t& token,
+    std::string& holder_name) {
+    std::lock_guard guard{mutex_};
+    auto now = std::chrono::steady_clock::now();
+    if (active(now) && slot_ != slot) {
+        holder_name = name_;
+        return Status::BUSY;
+    }
+
+    if (!active(now) || slot_ != slot) {
+        do
+            token_ = random_();
+        while (token_ == 0);
+        epoch_++;
+        slot_ = slot;
+        name_ = name;
+    }
+    ttl_ = ttl.count() > 0 ? ttl : kDefaultLeaseTtl;
+    expires_ = now + ttl_;
+    token = token_;
+    return Status::OK;
+}
+
+Status LeaseArbiter::renew(uint64_t token) {
+    std::lock_guard guard{mutex_};
+    auto now = std::chrono::steady_clock::now();
+    if (token == 0 || token != token_ || !active(now))
+        return Status::NOT_OWNER;
+    expires_ = now + ttl_;
+    return Status::OK;
+}
+
+Status LeaseArbiter::release(uint64_t token) {
+    std::lock_guard guard{mutex_};
+    if (token == 0 || token != token_)
+        return Status::NOT_OWNER;
+    token_ = 0;
+    slot_ = -1;
+    return Status::OK;
+}
+
+void LeaseArbiter::release_slot(int slot) {
+    std::lock_guard guard{mutex_};
+    if (token_ != 0 && slot_ == slot) {
+        token_ = 0;
+        slot_ = -1;
+    }
+}
+
+LeaseArbiter::Holder LeaseArbiter::holder() {
+    std::lock_guard guard{mutex_};
+    if (!active(std::chrono::steady_clock::now()))
+        return {};
+    return {.slot = slot_, .epoch = epoch_};
+}
+
+void LeaseArbiter::refresh(uint64_t epoch) {
+    std::lock_guard guard{mutex_};
+    auto now = std::chrono::steady_clock::now();
+    if (active(now) && epoch == epoch_)
+        expires_ = now + ttl_;
+}
+
+std::pair<std::string, int> LeaseArbiter::holder_info() {
+    std::lock_guard guard{mutex_};
+    if (!active(std::chrono::steady_clock::now()))
+        return {"", -1};
+    return {name_, slot_};
+}
+
+// ---------------------------------------------------------------------------
+// CommandServer
+// ---------------------------------------------------------------------------
+
+// Removes the socket a previous server left at `address`, and returns whether there was one.
+// Refuses anything else at the path, and a socket a live server still accepts connections on.
+static bool remove_stale_socket(const sockaddr_un& address) {
+    const std::string path = address.sun_path;
+    struct stat status;
+    if (::lstat(path.c_str(), &status) != 0) {
+        if (errno == ENOENT)
+            return false;
+        throw_system_error("stat " + path);
+    }
+    if (!S_ISSOCK(status.st_mode))
+        throw std::runtime_error("Refusing to replace " + path + ": not a Unix socket");
+
+    int probe = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (probe < 0)
+        throw_system_error("create socket");
+    int result = ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    auto error = errno;
+    ::close(probe);
+    if (result == 0)
+        throw std::runtime_error("Another server is already serving on " + path);
+    if (error != ECONNREFUSED) {
+        errno = error;
+        throw_system_error("probe " + path);
+    }
+
+    if (::unlink(path.c_str()) != 0 && errno != ENOENT)
+        throw_system_error("remove stale socket " + path);
+    return true;
+}
+
+CommandServer::CommandServer(Backend& backend, std::string socket_path, std::string shm_name)
+    : backend_(backend)
+    , socket_path_(std::move(socket_path))
+    , shm_name_(std::move(shm_name)) {}
+
+CommandServer::~CommandServer() { stop(); }
+
+void CommandServer::open() {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path_.empty() || socket_path_.size() >= sizeof(address.sun_path))
+        throw std::invalid_argument("Invalid socket path: " + socket_path_);
+    socket_path_.copy(address.sun_path, socket_path_.size());
+
+    // Only the leftovers of a server that is gone are replaced: its socket, and then its mailbox
+    auto mailbox_name = "/" + mailbox_segment_name(shm_name_);
+    if (remove_stale_socket(address))
+        ::shm_unlink(mailbox_name.c_str());
+
+    // Target mailbox
+    int fd = ::shm_open(mailbox_name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0660);
+    if (fd < 0)
+        throw_system_error("create " + mailbox_name);
+    if (::ftruncate(fd, sizeof(TargetMailbox)) != 0) {
+        ::close(fd);
+        throw_system_error("resize " + mailbox_name);
+    }
+    void* mapping =
+        ::mmap(nullptr, sizeof(TargetMailbox), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        throw_system_error("map " + mailbox_name);
+    mailbox_ = static_cast<TargetMailbox*>(mapping);
+    mailbox_->version = protocol_version;
+    mailbox_->magic.store(mailbox_magic, std::memory_order::release);
+
+    // Command socket
+    listen_fd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0)
+        throw_system_error("create socket");
+    if (::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        auto error = errno;
+        ::close(listen_fd_); // Not ours to unlink in stop(): the path may be another server's
+        listen_fd_ = -1;
+        errno = error;
+        throw_system_error("bind to " + socket_path_);
+    }
+    ::chmod(socket_path_.c_str(), 0660);
+    if (::listen(listen_fd_, 16) != 0)
+        throw_system_error("listen on " + socket_path_);
+}
+
+void CommandServer::start() {
+    if (listen_fd_ < 0)
+        open();
+
+    data_plane_thread_ =
+        std::jthread{[this](const std::stop_token& stop_token) { data_plane_loop(stop_token); }};
+    accept_thread_ =
+        std::jthread{[this](const std::stop_token& stop_token) { accept_loop(stop_token); }};
+
+    log_info("Serving commands on " + socket_path_ + ", shared memory " + shm_name_);
+}
+
+void CommandServer::stop() {
+    accept_thread_ = {};
+    {
+        std::lock_guard guard{connections_mutex_};
+        connections_.clear(); // Each jthread requests stop and joins
+    }
+    if (data_plane_thread_.joinable()) {
+        data_plane_thread_.request_stop();
+        mailbox_->doorbell.fetch_add(1, std::memory_order::release);
+        futex_wake(mailbox_->doorbell);
+        data_plane_thread_.join();
+    }
+    for (int slot = 0; slot < static_cast<int>(max_connection_count); slot++) {
+        if (targets_[slot])
+            ::munmap(targets_[slot], sizeof(TargetSlot));
+        targets_[slot] = nullptr;
+        slot_used_[slot] = false;
+    }
+
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        ::unlink(socket_path_.c_str());
+        listen_fd_ = -1;
+    }
+    if (mailbox_) {
+        ::munmap(mailbox_, sizeof(TargetMailbox));
+        ::shm_unlink(("/" + mailbox_segment_name(shm_name_)).c_str());
+        mailbox_ = nullptr;
+    }
+}
+
+void CommandServer::accept_loop(const std::stop_token& stop_token) {
+    while (!stop_token.stop_requested()) {
+        pollfd listening{.fd = listen_fd_, .events = POLLIN, .revents = 0};
+        if (::poll(&listening, 1, kPollIntervalMs) <= 0)
+            continue;
+
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0)
+            continue;
+
+        std::lock_guard guard{connections_mutex_};
+        reap_connections();
+        int slot = allocate_slot();
+        if (slot < 0) {
+            log_warn("Rejected a client: all " + std::to_string(max_connection_count)
+                     + " connection slots are in use");
+            ::close(fd);
+            continue;
+        }
+        int target_fd;
+        auto target = create_target_slot(target_fd);
+        if (!target) {
+            log_warn("Rejected a client: failed to create its target slot: "
+                     + std::string(std::strerror(errno)));
+            slot_used_[slot] = false;
+            ::close(fd);
+            continue;
+        }
+        {
+            std::lock_guard targets_guard{targets_mutex_};
+            targets_[slot] = target;
+        }
+
+        auto& connection = connections_.emplace_back();
+        connection.fd = fd;
+        connection.slot = slot;
+        connection.target_fd = target_fd;
+        connection.name = "client-" + std::to_string(slot);
+        connection.thread = std::jthread{[this, &connection](const std::stop_token& token) {
+            serve(token, connection);
+        }};
+    }
+}
+
+void CommandServer::serve(const std::stop_token& stop_token, Connection& connection) {
+    while (!stop_token.stop_requested()) {
+        pollfd readable{.fd = connection.fd, .events = POLLIN, .revents = 0};
+        if (::poll(&readable, 1, kPollIntervalMs) <= 0)
+            continue;
+
+        Request request;
+        auto size = ::recv(connection.fd, &request, sizeof(request), 0);
+        if (size <= 0)
+            break; // Closed by the client
+        Response response;
+        if (static_cast<size_t>(size) != sizeof(request)) {
+            response = Response{};
+            response.status = Status::INVALID;
+            copy_string(response.message, sizeof(response.message), "Malformed request");
+        } else
+            response = handle(request, connection);
+        bool hello = response.op == Op::HELLO && response.status == Status::OK;
+        if (!send_response(connection.fd, response, hello ? connection.target_fd : -1))
+            break;
+    }
+
+    lease_.release_slot(connection.slot);
+    ::close(connection.target_fd);
+    ::close(connection.fd);
+    connection.done.store(true, std::memory_order::release);
+}
+
+Response CommandServer::handle(const Request& request, Connection& connection) {
+    Response response{};
+    response.op = request.op;
+    response.id = request.id;
+    response.status = Status::OK;
+    response.slot = -1;
+
+    if (request.op == Op::HELLO) {
+        std::string name{request.name, strnlen(request.name, sizeof(request.name))};
+        if (!name.empty())
+            connection.name = std::move(name);
+        response.slot = connection.slot;
+        copy_string(response.message, sizeof(response.message), shm_name_);
+    } else if (request.op == Op::PING) {
+        // Nothing to do: measures the command channel round trip
+    } else if (request.op == Op::ACQUIRE) {
+        std::string holder;
+        response.status = lease_.acquire(
+            connection.slot, connection.name, std::chrono::milliseconds{request.timeout_ms},
+            response.token, holder);
+        if (response.status == Status::OK)
+            log_info("Lease granted to " + connection.name);
+        else
+            copy_string(response.message, sizeof(response.message), "Lease held by " + holder);
+    } else if (request.op == Op::RENEW) {
+        response.status = lease_.renew(request.token);
+    } else if (request.op == Op::RELEASE) {
+        response.status = lease_.release(request.token);
+        if (response.status == Status::OK)
+            log_info("Lease released by " + connection.name);
+    } else if (request.op == Op::STATUS) {
+        auto [name, slot] = lease_.holder_info();
+        response.slot = slot;
+        copy_string(response.message, sizeof(response.message), name);
+    } else if (request.op == Op::SDO_READ) {
+        response = handle_sdo(request);
+    } else if (request.op == Op::SDO_WRITE) {
+        // Writes command the device too, so they need the lease and count as activity
+        response.status = lease_.renew(request.token);
+        if (response.status == Status::OK)
+            response = handle_sdo(request);
+    } else {
+        response.status = Status::INVALID;
+        copy_string(response.message, sizeof(response.message), "Unknown operation");
+    }
+
+    if (response.status == Status::NOT_OWNER)
+        copy_string(response.message, sizeof(response.message), "Lease not held");
+    return response;
+}
+
+Response CommandServer::handle_sdo(const Request& request) {
+    Response response{};
+    response.op = request.op;
+    response.id = request.id;
+    response.slot = -1;
+
+    auto fail = [&response](Status status, const char* message) {
+        response.status = status;
+        copy_string(response.message, sizeof(response.message), message);
+        return response;
+    };
+    if (request.size > max_sdo_size)
+        return fail(Status::INVALID, "SDO data too large");
+
+    auto timeout = std::chrono::milliseconds{request.timeout_ms ? request.timeout_ms : 500};
+    try {
+        if (request.op == Op::SDO_READ) {
+            auto data = backend_.sdo_read(
+                request.finger_id, request.joint_id, request.index, request.sub_index, timeout);
+            if (data.size() > max_sdo_size)
+                return fail(Status::ERROR, "SDO value too large for the protocol");
+            response.size = static_cast<uint32_t>(data.size());
+            std::copy(data.begin(), data.end(), response.data);
+        } else
+            backend_.sdo_write(
+                request.finger_id, request.joint_id, request.index, request.sub_index,
+                request.data, request.size, timeout);
+        response.status = Status::OK;
+    } catch (const device::TimeoutError& e) {
+        return fail(Status::TIMEOUT, e.what());
+    } catch (const std::invalid_argument& e) {
+        return fail(Status::INVALID, e.what());
+    } catch (const std::exception& e) {
+        return fail(Status::ERROR, e.what());
+    }
+    return response;
+}
+
+// Applies each new target of the lease holder's slot. Waits on the doorbell futex, so a client
+// write reaches the backend after one wake-up rather than a polling period.
+void CommandServer::data_plane_loop(const std::stop_token& stop_token) {
+    auto& doorbell = mailbox_->doorbell;
+    uint64_t applied_epoch = 0;
+    uint64_t applied_sequence = 0;
+
+    while (!stop_token.stop_requested()) {
+        auto rung = doorbell.load(std::memory_order::acquire);
+
+        LeaseArbiter::Holder holder;
+        bool read = false;
+        uint64_t sequence = 0;
+        double positions[5][4];
+        {
+            std::lock_guard guard{targets_mutex_};
+            holder = lease_.holder();
+            if (holder.slot >= 0 && targets_[holder.slot]) {
+                auto& slot = *targets_[holder.slot];
+                for (int attempt = 0; attempt < 16 && !read; attempt++) {
+                    auto before = slot.lock.load(std::memory_order::acquire);
+                    if (before & 1)
+                        continue;
+                    sequence = slot.sequence;
+                    std::memcpy(positions, slot.position, sizeof(positions));
+                    std::atomic_thread_fence(std::memory_order::acquire);
+                    read = slot.lock.load(std::memory_order::relaxed) == before;
+                }
+            }
+        }
+
+        if (holder.slot >= 0 && holder.epoch != applied_epoch) {
+            applied_epoch = holder.epoch;
+            applied_sequence = 0;
+        }
+        if (read && sequence > applied_sequence) {
+            applied_sequence = sequence;
+            backend_.set_targets(positions);
+            lease_.refresh(holder.epoch); // Streaming targets keeps the lease
+        }
+
+        timespec timeout{.tv_sec = 0, .tv_nsec = kPollIntervalMs * 1'000'000L};
+        futex_wait(doorbell, rung, &timeout);
+    }
+}
+
+int CommandServer::allocate_slot() {
+    for (int slot = 0; slot < static_cast<int>(max_connection_count); slot++)
+        if (!slot_used_[slot]) {
+            slot_used_[slot] = true;
+            return slot;
+        }
+    return -1;
+}
+
+void CommandServer::reap_connections() {
+    for (auto it = connections_.begin(); it != connections_.end();) {
+        if (it->done.load(std::memory_order::acquire)) {
+            {
+                // The connection's lease ended before it was done; see targets_
+                std::lock_guard guard{targets_mutex_};
+                ::munmap(targets_[it->slot], sizeof(TargetSlot));
+                targets_[it->slot] = nullptr;
+            }
+            slot_used_[it->slot] = false;
+            it = connections_.erase(it);
+        } else
+            ++it;
+    }
+}
+
+} // namespace wujihand_server
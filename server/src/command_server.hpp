@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <random>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <wujihand_server/protocol.hpp>
+
+namespace wujihand_server {
+
+/// What the server does with device requests. HandBackend talks to a wujihandcpp Hand; the
+/// benchmark uses a loopback.
+class Backend {
+public:
+    virtual ~Backend() = default;
+
+    /// May throw wujihandcpp::device::TimeoutError, std::invalid_argument or any std::exception.
+    virtual std::vector<uint8_t> sdo_read(
+        int finger_id, int joint_id, uint16_t index, uint8_t sub_index,
+        std::chrono::milliseconds timeout) = 0;
+
+    virtual void sdo_write(
+        int finger_id, int joint_id, uint16_t index, uint8_t sub_index, const uint8_t* data,
+        size_t size, std::chrono::milliseconds timeout) = 0;
+
+    /// Runs on the data plane thread with the targets of the lease holder.
+    virtual void set_targets(const double (&positions)[5][4]) noexcept = 0;
+};
+
+/// Who may command the joints. One client at a time holds the lease; it lasts while the client
+/// renews it, streams targets or issues SDO writes within its TTL, and ends at once when the
+/// client releases it or disconnects.
+class LeaseArbiter {
+public:
+    struct Holder {
+        int slot = -1;
+        uint64_t epoch = 0; // Changes with every grant
+    };
+
+    Status acquire(
+        int slot, const std::string& name, std::chrono::milliseconds ttl, uint64_t& token,
+        std::string& holder_name);
+
+    /// Extends the lease by its TTL if `token` is current.
+    Status renew(uint64_t token);
+
+    Status release(uint64_t token);
+
+    /// Ends the lease of `slot`, if it holds one (the connection closed).
+    void release_slot(int slot);
+
+    /// The current holder, or slot -1 if the lease is free or expired.
+    Holder holder();
+
+    /// Extends the lease of grant `epoch` by its TTL if it is still current.
+    void refresh(uint64_t epoch);
+
+    /// Name and slot of the current holder; empty and -1 if none.
+    std::pair<std::string, int> holder_info();
+
+private:
+    bool active(std::chrono::steady_clock::time_point now) const {
+        return token_ != 0 && now < expires_;
+    }
+
+    std::mutex mutex_;
+    std::mt19937_64 random_{std::random_device{}()};
+    uint64_t token_ = 0;
+    uint64_t epoch_ = 0;
+    int slot_ = -1;
+    std::string name_;
+    std::chrono::milliseconds ttl_{0};
+    std::chrono::steady_clock::time_point expires_;
+};
+
+/// Command channel (SOCK_SEQPACKET Unix socket, one thread per connection) and target data
+/// plane (a shared memory slot per connection, one thread woken through a futex) of
+/// wujihand-server.
+class CommandServer {
+public:
+    CommandServer(Backend& backend, std::string socket_path, std::string shm_name);
+    ~CommandServer();
+
+    CommandServer(const CommandServer&) = delete;
+    CommandServer& operator=(const CommandServer&) = delete;
+
+    /// Creates the socket and the mailbox without serving yet. Replaces the socket and mailbox a
+    /// server that is gone left behind, but refuses a path that is not a socket or that a live
+    /// server still accepts connections on. Throws std::runtime_error or std::system_error.
+    /// Call it before taking over anything else a live server would own.
+    void open();
+
+    /// Starts serving, calling open() first unless it was called already.
+    void start();
+
+    /// Closes every connection and removes the socket and the mailbox. Idempotent.
+    void stop();
+
+    const std::string& shm_name() const { return shm_name_; }
+
+private:
+    struct Connection {
+        int fd;
+        int slot;
+        int target_fd; // memfd of the connection's TargetSlot, passed to the client at HELLO
+        std::string name;
+        std::atomic<bool> done{false}; // Set by the connection thread when it exits
+        std::jthread thread;
+    };
+
+    void accept_loop(const std::stop_token& stop_token);
+    void serve(const std::stop_token& stop_token, Connection& connection);
+    Response handle(const Request& request, Connection& connection);
+    Response handle_sdo(const Request& request);
+    void data_plane_loop(const std::stop_token& stop_token);
+
+    int allocate_slot();
+    void reap_connections();
+
+    Backend& backend_;
+    std::string socket_path_;
+    std::string shm_name_;
+
+    int listen_fd_ = -1;
+    TargetMailbox* mailbox_ = nullptr;
+    LeaseArbiter lease_;
+
+    std::mutex connections_mutex_;
+    std::list<Connection> connections_;
+    bool slot_used_[max_connection_count] = {};
+
+    // Mapped target slot of each connection. Replaced by the accept thread only once the
+    // connection's lease has ended, so the data plane reads the slot of the current holder as
+    // long as it checks the lease under the mutex.
+    std::mutex targets_mutex_;
+    TargetSlot* targets_[max_connection_count] = {};
+
+    std::jthread accept_thread_;
+    std::jthread data_plane_thread_;
+};
+
+} // namespace wujihand_server
@@ -0,0 +1,180 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <wujihandcpp/data/joint.hpp>
+#include <wujihandcpp/device/controller.hpp>
+#include <wujihandcpp/device/hand.hpp>
+#include <wujihandcpp/filter/low_pass.hpp>
+#include <wujihandcpp/utility/logging.hpp>
+
+#include "command_server.hpp"
+
+using namespace wujihandcpp;
+
+static std::atomic<bool> g_running{true};
+
+static void signal_handler(int /*sig*/) {
+    g_running.store(false, std::memory_order_relaxed);
+}
+
+static void log_info(const std::string& msg) {
+    logging::log(logging::Level::INFO, msg.c_str(), msg.size());
+}
+
+static void log_error(const std::string& msg) {
+    logging::log(logging::Level::ERR, msg.c_str(), msg.size());
+}
+
+static void print_usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options]\n"
+              << "Options:\n"
+              << "  --sn <serial>          Hand serial number filter\n"
+              << "  --socket <path>        Command socket (default: "
+              << wujihand_server::default_socket_path << ")\n"
+              << "  --shm-name <name>      Shared memory name prefix (default: "
+              << wujihand_server::default_shm_name << ")\n"
+              << "  --history <n>          Feedback snapshots kept, power of two (default: 1024)\n"
+              << "  --filter-cutoff <hz>   Target low-pass cutoff frequency (default: 5.0)\n"
+              << "  --log-level <lvl>      trace/debug/info/warn/err/off (default: info)\n"
+              << "  --help                 Show this help\n";
+}
+
+static logging::Level parse_log_level(const std::string& s) {
+    if (s == "trace") return logging::Level::TRACE;
+    if (s == "debug") return logging::Level::DEBUG;
+    if (s == "info") return logging::Level::INFO;
+    if (s == "warn") return logging::Level::WARN;
+    if (s == "err" || s == "error") return logging::Level::ERR;
+    if (s == "off") return logging::Level::OFF;
+    return logging::Level::INFO;
+}
+
+/// Serves requests with a Hand. Targets go to a realtime controller, so they are filtered and
+/// sent on the next PDO cycle like those of any in-process caller.
+class HandBackend : public wujihand_server::Backend {
+public:
+    HandBackend(device::Hand& hand, std::unique_ptr<device::IController> controller)
+        : hand_(hand)
+        , controller_(std::move(controller)) {}
+
+    std::vector<uint8_t> sdo_read(
+        int finger_id, int joint_id, uint16_t index, uint8_t sub_index,
+        std::chrono::milliseconds timeout) override {
+        return hand_.raw_sdo_read(finger_id, joint_id, index, sub_index, timeout);
+    }
+
+    void sdo_write(
+        int finger_id, int joint_id, uint16_t index, uint8_t sub_index, const uint8_t* data,
+        size_t size, std::chrono::milliseconds timeout) override {
+        hand_.raw_sdo_write(finger_id, joint_id, index, sub_index, data, size, timeout);
+    }
+
+    void set_targets(const double (&positions)[5][4]) noexcept override {
+        try {
+            controller_->set_joint_target_position(positions);
+        } catch (const std::exception& e) {
+            log_error(std::string("Failed to set targets: ") + e.what());
+        }
+    }
+
+    void reset_controller() { controller_.reset(); }
+
+private:
+    device::Hand& hand_;
+    std::unique_ptr<device::IController> controller_;
+};
+
+int main(int argc, char* argv[]) {
+    // Parse arguments
+    const char* sn_filter = nullptr;
+    std::string socket_path = wujihand_server::default_socket_path;
+    std::string shm_name = wujihand_server::default_shm_name;
+    size_t history = 1024;
+    double filter_cutoff = 5.0;
+    std::string log_level_str = "info";
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--sn") == 0 && i + 1 < argc) {
+            sn_filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--shm-name") == 0 && i + 1 < argc) {
+            shm_name = argv[++i];
+        } else if (std::strcmp(argv[i], "--history") == 0 && i + 1 < argc) {
+            history = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--filter-cutoff") == 0 && i + 1 < argc) {
+            filter_cutoff = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            log_level_str = argv[++i];
+        } else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (filter_cutoff <= 0.0) {
+        std::cerr << "Error: --filter-cutoff must be positive\n";
+        return 1;
+    }
+
+    // Configure logging
+    logging::set_log_to_console(true);
+    logging::set_log_level(parse_log_level(log_level_str));
+
+    // Install signal handlers
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+
+    // Caught here, so that everything started so far is stopped again on the way out
+    try {
+        log_info("Connecting to hand...");
+        device::Hand hand(sn_filter);
+
+        HandBackend backend{
+            hand, hand.realtime_controller<true>(filter::LowPass(filter_cutoff))};
+
+        // Before the state segment is created: a live server owning the socket or the mailbox
+        // is refused here, and then its state segment must be left alone as well
+        wujihand_server::CommandServer server{backend, socket_path, shm_name};
+        server.open();
+
+        hand.start_state_publisher(
+            wujihand_server::state_segment_name(shm_name).c_str(), history);
+        hand.write<data::joint::Enabled>(true);
+        log_info("Realtime controller started, joints enabled");
+
+        server.start();
+
+        log_info("Server running. Press Ctrl+C to stop.");
+        while (g_running.load(std::memory_order_relaxed))
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        // Graceful shutdown: no more client targets, then stop the controller and the joints
+        server.stop();
+        backend.reset_controller();
+        try {
+            hand.write<data::joint::Enabled>(false);
+            log_info("Joints disabled");
+        } catch (const std::exception& e) {
+            log_error(std::string("Failed to disable joints: ") + e.what());
+        }
+        hand.stop_state_publisher();
+    } catch (const std::exception& e) {
+        log_error(std::string("Error: ") + e.what());
+        return 1;
+    }
+
+    log_info("Exiting.");
+    return 0;
+}
@@ -0,0 +1,250 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <wujihand_server/client.hpp>
+
+#include "command_server.hpp"
+
+namespace wujihand_server {
+namespace {
+
+using namespace std::chrono_literals;
+
+class RecordingBackend : public Backend {
+public:
+    std::vector<uint8_t>
+        sdo_read(int, int, uint16_t index, uint8_t sub_index, std::chrono::milliseconds) override {
+        return {static_cast<uint8_t>(index), static_cast<uint8_t>(index >> 8), sub_index};
+    }
+
+    void sdo_write(
+        int, int, uint16_t index, uint8_t, const uint8_t*, size_t,
+        std::chrono::milliseconds) override {
+        std::lock_guard guard{mutex_};
+        written_indices_.push_back(index);
+    }
+
+    void set_targets(const double (&positions)[5][4]) noexcept override {
+        std::lock_guard guard{mutex_};
+        applied_.push_back(positions[0][0]);
+    }
+
+    std::vector<double> applied() {
+        std::lock_guard guard{mutex_};
+        return applied_;
+    }
+
+    std::vector<uint16_t> written_indices() {
+        std::lock_guard guard{mutex_};
+        return written_indices_;
+    }
+
+    // Waits until `count` targets were applied, or a second passed
+    bool wait_applied(size_t count) {
+        for (int i = 0; i < 1000; i++) {
+            if (applied().size() >= count)
+                return true;
+            std::this_thread::sleep_for(1ms);
+        }
+        return false;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<double> applied_;
+    std::vector<uint16_t> written_indices_;
+};
+
+class CommandServerTest : public testing::Test {
+protected:
+    CommandServerTest()
+        : socket_path_("/tmp/wujihand-server-test-" + std::to_string(::getpid()) + ".sock")
+        , shm_name_("wujihand-server-test-" + std::to_string(::getpid()))
+        , server_(backend_, socket_path_, shm_name_) {
+        server_.start();
+    }
+
+    ~CommandServerTest() override { server_.stop(); }
+
+    std::unique_ptr<Client> connect(const std::string& name) {
+        return std::make_unique<Client>(name, socket_path_);
+    }
+
+    static void targets(double (&positions)[5][4], double value) {
+        for (auto& finger : positions)
+            for (auto& joint : finger)
+                joint = value;
+    }
+
+    RecordingBackend backend_;
+    std::string socket_path_;
+    std::string shm_name_;
+    CommandServer server_;
+};
+
+} // namespace
+
+TEST_F(CommandServerTest, AppliesOnlyTheTargetsOfTheLeaseHolder) {
+    auto holder = connect("teleop");
+    auto other = connect("script");
+    holder->acquire();
+
+    double positions[5][4];
+    targets(positions, 2.0);
+    other->set_targets(positions);
+    targets(positions, 1.0);
+    holder->set_targets(positions);
+    ASSERT_TRUE(backend_.wait_applied(1));
+
+    targets(positions, 3.0);
+    other->set_targets(positions);
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(backend_.applied(), std::vector<double>{1.0});
+}
+
+// The shared segment only holds the doorbell: the target slots are private to each connection,
+// so no client can write the holder's targets and keep its lease alive.
+TEST_F(CommandServerTest, TargetSlotsAreNotShared) {
+    auto client = connect("teleop");
+    EXPECT_EQ(
+        std::filesystem::file_size("/dev/shm/" + mailbox_segment_name(shm_name_)),
+        sizeof(TargetMailbox));
+}
+
+TEST_F(CommandServerTest, LeaseIsExclusiveAndEndsWithTheConnection) {
+    auto first = connect("teleop");
+    auto second = connect("script");
+    first->acquire();
+    EXPECT_EQ(second->lease_holder(), "teleop");
+
+    try {
+        second->acquire();
+        FAIL() << "acquire() succeeded while another client held the lease";
+    } catch (const ServerError& e) {
+        EXPECT_EQ(e.status(), Status::BUSY);
+        EXPECT_NE(std::string(e.what()).find("teleop"), std::string::npos);
+    }
+
+    first.reset();
+    for (int i = 0; i < 100 && !second->lease_holder().empty(); i++)
+        std::this_thread::sleep_for(10ms);
+    second->acquire();
+    EXPECT_EQ(second->lease_holder(), "script");
+}
+
+TEST_F(CommandServerTest, SdoWritesNeedTheLease) {
+    auto client = connect("script");
+    uint8_t value = 1;
+    try {
+        client->sdo_write(-1, -1, 0x5090, 0, &value, 1);
+        FAIL() << "sdo_write() succeeded without the lease";
+    } catch (const ServerError& e) {
+        EXPECT_EQ(e.status(), Status::NOT_OWNER);
+    }
+    EXPECT_TRUE(backend_.written_indices().empty());
+
+    EXPECT_EQ(client->sdo_read(-1, -1, 0x5090, 2), (std::vector<uint8_t>{0x90, 0x50, 2}));
+
+    client->acquire();
+    client->sdo_write(-1, -1, 0x5090, 0, &value, 1);
+    EXPECT_EQ(backend_.written_indices(), std::vector<uint16_t>{0x5090});
+
+    client->release();
+    EXPECT_THROW(client->renew(), ServerError);
+}
+
+TEST_F(CommandServerTest, RejectsMalformedAndUnknownRequests) {
+    int fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    socket_path_.copy(address.sun_path, socket_path_.size());
+    ASSERT_EQ(::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+
+    auto round_trip = [fd](const void* request, size_t size) {
+        Response response{};
+        EXPECT_EQ(::send(fd, request, size, 0), static_cast<ssize_t>(size));
+        EXPECT_EQ(
+            ::recv(fd, &response, sizeof(response), 0), static_cast<ssize_t>(sizeof(response)));
+        return response;
+    };
+
+    char truncated[8] = {};
+    EXPECT_EQ(round_trip(truncated, sizeof(truncated)).status, Status::INVALID);
+
+    Request request{};
+    request.op = static_cast<Op>(99);
+    request.id = 7;
+    auto response = round_trip(&request, sizeof(request));
+    EXPECT_EQ(response.status, Status::INVALID);
+    EXPECT_EQ(response.id, 7u);
+
+    request.op = Op::SDO_READ;
+    request.size = max_sdo_size + 1;
+    EXPECT_EQ(round_trip(&request, sizeof(request)).status, Status::INVALID);
+
+    ::close(fd);
+}
+
+TEST_F(CommandServerTest, SecondServerLeavesTheLiveOneAlone) {
+    RecordingBackend other_backend;
+    CommandServer other{other_backend, socket_path_, shm_name_};
+    EXPECT_THROW(other.start(), std::runtime_error);
+
+    auto client = connect("teleop");
+    client->acquire();
+    EXPECT_EQ(
+        std::filesystem::file_size("/dev/shm/" + mailbox_segment_name(shm_name_)),
+        sizeof(TargetMailbox));
+}
+
+TEST_F(CommandServerTest, RefusesToReplaceAFileThatIsNotASocket) {
+    auto path = socket_path_ + ".txt";
+    std::ofstream{path} << "not a socket";
+
+    RecordingBackend other_backend;
+    CommandServer other{other_backend, path, shm_name_ + "-other"};
+    EXPECT_THROW(other.start(), std::runtime_error);
+
+    std::ifstream file{path};
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>{file}, {}), "not a socket");
+    std::filesystem::remove(path);
+}
+
+TEST_F(CommandServerTest, ReplacesTheLeftoversOfAServerThatIsGone) {
+    server_.stop();
+
+    // A socket nobody listens on and a mailbox of the wrong size, as a crash leaves them
+    int fd = ::socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    socket_path_.copy(address.sun_path, socket_path_.size());
+    ASSERT_EQ(::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    ::close(fd);
+    auto mailbox = "/dev/shm/" + mailbox_segment_name(shm_name_);
+    std::ofstream{mailbox} << "stale";
+
+    server_.start();
+    auto client = connect("teleop");
+    client->acquire();
+    EXPECT_EQ(std::filesystem::file_size(mailbox), sizeof(TargetMailbox));
+}
+
+} // namespace wujihand_server
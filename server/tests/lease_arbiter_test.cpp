@@ -0,0 +1,94 @@
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "command_server.hpp"
+
+namespace wujihand_server {
+
+using namespace std::chrono_literals;
+
+TEST(LeaseArbiterTest, GrantsOneSlotAndReportsTheHolderToOthers) {
+    LeaseArbiter lease;
+    EXPECT_EQ(lease.holder().slot, -1);
+
+    uint64_t token = 0;
+    std::string holder_name;
+    ASSERT_EQ(lease.acquire(3, "teleop", 1000ms, token, holder_name), Status::OK);
+    EXPECT_NE(token, 0u);
+    EXPECT_EQ(lease.holder().slot, 3);
+    EXPECT_EQ(lease.holder_info(), (std::pair<std::string, int>{"teleop", 3}));
+
+    uint64_t other_token = 0;
+    EXPECT_EQ(lease.acquire(5, "logger", 1000ms, other_token, holder_name), Status::BUSY);
+    EXPECT_EQ(holder_name, "teleop");
+    EXPECT_EQ(other_token, 0u);
+
+    // The holder acquiring again keeps its grant
+    uint64_t again = 0;
+    auto epoch = lease.holder().epoch;
+    ASSERT_EQ(lease.acquire(3, "teleop", 1000ms, again, holder_name), Status::OK);
+    EXPECT_EQ(again, token);
+    EXPECT_EQ(lease.holder().epoch, epoch);
+}
+
+TEST(LeaseArbiterTest, ExpiresAfterTtlUnlessRenewed) {
+    LeaseArbiter lease;
+    uint64_t token = 0;
+    std::string holder_name;
+    ASSERT_EQ(lease.acquire(0, "a", 200ms, token, holder_name), Status::OK);
+
+    std::this_thread::sleep_for(120ms);
+    EXPECT_EQ(lease.renew(token), Status::OK);
+    std::this_thread::sleep_for(120ms);
+    EXPECT_EQ(lease.holder().slot, 0) << "renew() extends the lease by its TTL";
+
+    std::this_thread::sleep_for(200ms);
+    EXPECT_EQ(lease.holder().slot, -1);
+    EXPECT_EQ(lease.holder_info(), (std::pair<std::string, int>{"", -1}));
+    EXPECT_EQ(lease.renew(token), Status::NOT_OWNER);
+
+    uint64_t next = 0;
+    ASSERT_EQ(lease.acquire(1, "b", 200ms, next, holder_name), Status::OK);
+    EXPECT_NE(next, token);
+    EXPECT_EQ(lease.release(token), Status::NOT_OWNER);
+}
+
+TEST(LeaseArbiterTest, RefreshOnlyExtendsTheCurrentGrant) {
+    LeaseArbiter lease;
+    uint64_t token = 0;
+    std::string holder_name;
+    ASSERT_EQ(lease.acquire(0, "a", 200ms, token, holder_name), Status::OK);
+    auto first = lease.holder().epoch;
+    ASSERT_EQ(lease.release(token), Status::OK);
+    ASSERT_EQ(lease.acquire(1, "b", 200ms, token, holder_name), Status::OK);
+    EXPECT_NE(lease.holder().epoch, first);
+
+    std::this_thread::sleep_for(120ms);
+    lease.refresh(first); // A target of the previous holder
+    std::this_thread::sleep_for(120ms);
+    EXPECT_EQ(lease.holder().slot, -1);
+}
+
+TEST(LeaseArbiterTest, ReleaseNeedsTheTokenAndReleaseSlotTheHolder) {
+    LeaseArbiter lease;
+    uint64_t token = 0;
+    std::string holder_name;
+    ASSERT_EQ(lease.acquire(2, "a", 1000ms, token, holder_name), Status::OK);
+
+    EXPECT_EQ(lease.release(0), Status::NOT_OWNER);
+    EXPECT_EQ(lease.release(token + 1), Status::NOT_OWNER);
+    EXPECT_EQ(lease.renew(0), Status::NOT_OWNER);
+
+    lease.release_slot(4); // Another connection closing leaves the lease alone
+    EXPECT_EQ(lease.holder().slot, 2);
+
+    lease.release_slot(2);
+    EXPECT_EQ(lease.holder().slot, -1);
+    EXPECT_EQ(lease.renew(token), Status::NOT_OWNER);
+    EXPECT_EQ(lease.release(token), Status::NOT_OWNER);
+}
+
+} // namespace wujihand_server
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+
+#include <atomic>
+#include <format>
+#include <memory>
+#include <system_error>
+#include <utility>
+
+#include <pybind11/pybind11.h>
+
+#ifdef __linux__
+# include <sys/eventfd.h>
+# include <unistd.h>
+#endif
+
+#ifdef WUJIHANDPY_TESTING
+# include <chrono>
+# include <thread>
+# include <vector>
+#endif
+
+namespace py = pybind11;
+
+namespace async_completion {
+
+class CompletionQueue;
+
+// Resolves an asyncio future once `waiting_count` SDO operations have completed. The operations
+// complete on SDO threads without the GIL; the future is resolved on its event loop's thread.
+class Completion {
+public:
+    Completion(const Completion&) = delete;
+    Completion& operator=(const Completion&) = delete;
+
+    // Call with GIL
+    virtual ~Completion() = default;
+
+    py::object& future() { return future_; }
+
+    // Call without GIL. The last call hands the completion over to the event loop.
+    void count_down(bool success) noexcept {
+        if (!success)
+            error_count_.fetch_add(1, std::memory_order::relaxed);
+
+        if (waiting_count_.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            capture();
+            post();
+        }
+    }
+
+    // Call with GIL, on the event loop thread. Does nothing if the future was cancelled.
+    void deliver() noexcept {
+        try {
+            if (future_.attr("done")().cast<bool>())
+                return;
+
+            const int error_count = error_count_.load(std::memory_order::relaxed);
+            if (error_count) {
+                py::object timeout_error_type =
+                    py::reinterpret_borrow<py::object>(PyExc_TimeoutError);
+                future_.attr("set_exception")(timeout_error_type(
+                    error_count == 1
+                        ? "Operation timed out while waiting for completion"
+                        : std::format(
+                              "{} operations timed out while waiting for completion",
+                              error_count)));
+                return;
+            }
+
+            try {
+                future_.attr("set_result")(result());
+            } catch (py::error_already_set& e) {
+                future_.attr("set_exception")(e.value());
+            }
+        } catch (py::error_already_set& e) {
+            e.discard_as_unraisable(future_);
+        }
+    }
+
+protected:
+    // Call with GIL. Binds to the current event loop.
+    explicit Completion(int waiting_count);
+
+    // Call without GIL, on the thread of the operation that completed last, before the
+    // completion is handed over to the event loop. Copy the results of the operations here: other
+    // operations may change them before the loop gets to deliver.
+    virtual void capture() noexcept {}
+
+    // Call with GIL, on the event loop thread. Builds the result from what capture() copied.
+    virtual py::object result() = 0;
+
+private:
+    friend class CompletionQueue;
+
+    void post() noexcept;
+
+    py::object loop_;
+    py::object future_;
+    std::shared_ptr<CompletionQueue> queue_; // Null if the loop cannot watch an eventfd
+
+    std::atomic<int> waiting_count_;
+    std::atomic<int> error_count_;
+
+    Completion* next_ = nullptr;
+};
+
+#ifdef __linux__
+
+// The completions of one event loop. SDO threads push finished completions onto a lock-free
+// stack and write the eventfd only when the stack was empty; the loop, watching the eventfd
+// with add_reader(), then delivers every completion that has accumulated in one callback.
+// A burst of completions thus costs one loop wakeup and one GIL acquisition, taken by the loop
+// thread, instead of one of each per completion on the SDO thread.
+class CompletionQueue {
+public:
+    CompletionQueue()
+        : fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+        if (fd_ < 0)
+            throw std::system_error(errno, std::generic_category(), "Failed to create eventfd");
+    }
+
+    CompletionQueue(const CompletionQueue&) = delete;
+    CompletionQueue& operator=(const CompletionQueue&) = delete;
+
+    // May run on an SDO thread, which must not take the GIL as the interpreter may be finalizing.
+    // It has no need to: every queued completion holds a reference, so the stack is empty here.
+    ~CompletionQueue() { ::close(fd_); }
+
+    int fd() const { return fd_; }
+
+    // Call from any thread, without GIL
+    void push(Completion* completion) noexcept {
+        auto head = head_.load(std::memory_order::relaxed);
+        do
+            completion->next_ = head;
+        while (!head_.compare_exchange_weak(
+            head, completion, std::memory_order::release, std::memory_order::relaxed));
+
+        // A non-empty stack already has a wakeup pending
+        if (!head) {
+            uint64_t one = 1;
+            [[maybe_unused]] auto written = ::write(fd_, &one, sizeof(one));
+        }
+    }
+
+    // Call with GIL, on the event loop thread (the add_reader() callback)
+    void drain() {
+        // Reset the eventfd before taking the stack: a push onto the emptied stack writes it
+        // again, so no completion is left without a wakeup.
+        uint64_t count;
+        [[maybe_unused]] auto read = ::read(fd_, &count, sizeof(count));
+
+        // Deliver in completion order
+        Completion* completions = nullptr;
+        auto completion = head_.exchange(nullptr, std::memory_order::acquire);
+        while (completion) {
+            auto next = completion->next_;
+            completion->next_ = completions;
+            completions = completion;
+            completion = next;
+        }
+
+        while (completions) {
+            std::unique_ptr<Completion> current{completions};
+            completions = completions->next_;
+            current->deliver();
+        }
+    }
+
+    // Call with GIL, once the loop no longer watches the eventfd (it was closed). Completions
+    // still queued are released undelivered, as their loop cannot resolve futures any more.
+    // Those pushed later are leaked, along with the queue they hold.
+    void close() {
+        auto completion = head_.exchange(nullptr, std::memory_order::acquire);
+        while (completion) {
+            auto next = completion->next_;
+            delete completion;
+            completion = next;
+        }
+    }
+
+private:
+    int fd_;
+    std::atomic<Completion*> head_ = nullptr;
+};
+
+// The completion queue of `loop`, registered with loop.add_reader() on first use. Null for loops
+// that cannot watch file descriptors (such as the proactor loop) or cannot be weakly referenced.
+inline std::shared_ptr<CompletionQueue> queue_for(const py::object& loop) {
+    using Holder = std::shared_ptr<CompletionQueue>;
+    // Leaked: must not be destroyed after the interpreter
+    static py::object& queues =
+        *new py::object(py::module_::import("weakref").attr("WeakKeyDictionary")());
+
+    py::object cached = queues.attr("get")(loop);
+    if (!cached.is_none())
+        return *static_cast<Holder*>(py::reinterpret_borrow<py::capsule>(cached).get_pointer());
+
+    // Owned by the add_reader() callback, which the loop releases when it is closed
+    struct Reader {
+        explicit Reader(std::shared_ptr<CompletionQueue> queue)
+            : queue(std::move(queue)) {}
+        ~Reader() { queue->close(); }
+
+        std::shared_ptr<CompletionQueue> queue;
+    };
+
+    auto queue = std::make_shared<CompletionQueue>();
+    try {
+        auto reader = std::make_shared<Reader>(queue);
+        loop.attr("add_reader")(
+            queue->fd(), py::cpp_function([reader] { reader->queue->drain(); }));
+    } catch (py::error_already_set& e) {
+        if (!e.matches(PyExc_NotImplementedError))
+            throw;
+        queue.reset();
+    }
+
+    py::capsule holder(new Holder(queue), [](void* ptr) { delete static_cast<Holder*>(ptr); });
+    try {
+        queues.attr("__setitem__")(loop, holder);
+    } catch (py::error_already_set& e) {
+        if (!e.matches(PyExc_TypeError))
+            throw;
+        if (queue)
+            loop.attr("remove_reader")(queue->fd());
+        return nullptr;
+    }
+    return queue;
+}
+
+#endif
+
+inline Completion::Completion(int waiting_count)
+    : waiting_count_(waiting_count)
+    , error_count_(0) {
+    loop_ = py::module_::import("asyncio").attr("get_event_loop")();
+    future_ = loop_.attr("create_future")();
+#ifdef __linux__
+    queue_ = queue_for(loop_);
+#endif
+}
+
+inline void Completion::post() noexcept {
+#ifdef __linux__
+    if (queue_) {
+        // The queue owns this completion from here on, and may deliver (and delete) it at once
+        auto queue = queue_;
+        queue->push(this);
+        return;
+    }
+#endif
+
+    py::gil_scoped_acquire acquire;
+    try {
+        loop_.attr("call_soon_threadsafe")(py::cpp_function([this] {
+            std::unique_ptr<Completion> current{this};
+            current->deliver();
+        }));
+    } catch (py::error_already_set& e) {
+        // The loop was closed: nothing left to resolve the future on
+        e.discard_as_unraisable(future_);
+        delete this;
+    }
+}
+
+#ifdef WUJIHANDPY_TESTING
+
+// Completions of operations run by a thread of their own, as SDO threads run them, so that the
+// tests can exercise this file without a device. Each resolves to its index.
+class TestCompletion final : public Completion {
+public:
+    explicit TestCompletion(int index)
+        : Completion(1)
+        , index_(index) {}
+
+private:
+    void capture() noexcept override { captured_index_ = index_; }
+
+    py::object result() override { return py::int_(captured_index_); }
+
+    int index_;
+    int captured_index_ = -1;
+};
+
+// Returns `count` futures of the current event loop. After `delay` seconds, another thread
+// completes their operations in order, the first `failure_count` of them with a timeout.
+inline py::list complete_later(int count, int failure_count, double delay) {
+    std::vector<Completion*> completions;
+    py::list futures;
+    for (int i = 0; i < count; i++) {
+        completions.push_back(new TestCompletion(i));
+        futures.append(completions.back()->future());
+    }
+
+    std::thread([completions = std::move(completions), failure_count, delay] {
+        std::this_thread::sleep_for(std::chrono::duration<double>(delay));
+        for (size_t i = 0; i < completions.size(); i++)
+            completions[i]->count_down(static_cast<int>(i) >= failure_count);
+    }).detach();
+    return futures;
+}
+
+inline void init_module(py::module_& m) {
+    auto async_completion = m.def_submodule("_async_completion");
+
+    async_completion.def(
+        "complete_later", &complete_later, py::arg("count"), py::arg("failure_count") = 0,
+        py::arg("delay") = 0.0);
+}
+
+#endif
+
+} // namespace async_completion
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+// Delivers items produced on an SDK thread (subscription values, joint error events) to a Python
+// callback from a Python thread of its own. The SDK thread only queues the items here: it never
+// waits for the GIL, so neither a slow callback nor a thread holding the GIL delays it.
+//
+// At most `capacity` items are queued. Beyond that the oldest are dropped, so a callback that
+// falls behind still ends up with the latest items, and the drops are reported as a
+// RuntimeWarning on the delivery thread.
+template <typename Item>
+class CallbackRelay {
+public:
+    // Calls the Python callback with one item
+    using Deliver = void (*)(const py::function& callback, const Item& item);
+
+    static constexpr size_t capacity = 256;
+
+    // Call without GIL, on the SDK thread
+    void push(const Item& item) {
+        {
+            std::lock_guard guard{mutex_};
+            if (closed_)
+                return;
+            if (items_.size() == capacity) {
+                items_.pop_front();
+                dropped_++;
+            }
+            items_.push_back(item);
+        }
+        changed_.notify_one();
+    }
+
+    // Call with GIL. Starts the delivery thread, named `name`, which keeps the relay alive until
+    // it exits. `what` names the items and the callback in the drop warning.
+    static void start(
+        std::shared_ptr<CallbackRelay> relay, py::function callback, Deliver deliver,
+        const char* name, const char* what) {
+        auto target = py::cpp_function(
+            [relay = std::move(relay), callback = std::move(callback), deliver, what] {
+                relay->run(callback, deliver, what);
+            });
+        py::module_::import("threading")
+            .attr("Thread")(py::arg("target") = target, py::arg("name") = name)
+            .attr("start")();
+    }
+
+    // Call with GIL. Discards the items still queued: once this returns, the callback is not
+    // called again (a call already running finishes), and the delivery thread exits.
+    void close() {
+        {
+            std::lock_guard guard{mutex_};
+            closed_ = true;
+            items_.clear();
+        }
+        changed_.notify_one();
+    }
+
+private:
+    // The delivery thread, with GIL. Also exits once the main thread has finished, so that the
+    // interpreter does not wait for it at exit.
+    void run(const py::function& callback, Deliver deliver, const char* what) {
+        auto main_thread = py::module_::import("threading").attr("main_thread")();
+        std::vector<Item> items;
+        while (true) {
+            uint64_t dropped;
+            {
+                py::gil_scoped_release release;
+                std::unique_lock lock{mutex_};
+                changed_.wait_for(lock, std::chrono::milliseconds(100), [this] {
+                    return closed_ || !items_.empty();
+                });
+                items.assign(items_.begin(), items_.end());
+                items_.clear();
+                dropped = std::exchange(dropped_, 0);
+            }
+
+            if (dropped
+                && PyErr_WarnFormat(
+                       PyExc_RuntimeWarning, 1, "%llu %s dropped: the callback fell behind",
+                       static_cast<unsigned long long>(dropped), what)
+                       < 0)
+                py::error_already_set().discard_as_unraisable(callback);
+            for (const auto& item : items) {
+                // close() runs with GIL, so it cannot slip in between this check and the call
+                if (closed_)
+                    return;
+                try {
+                    deliver(callback, item);
+                } catch (py::error_already_set& e) {
+                    e.discard_as_unraisable(callback);
+                }
+            }
+
+            if (closed_ || !main_thread.attr("is_alive")().cast<bool>())
+                return;
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<Item> items_;
+    uint64_t dropped_ = 0;
+    std::atomic<bool> closed_ = false; // Written under mutex_, read with or without it
+};
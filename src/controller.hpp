@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 #include <atomic>
 #include <memory>
@@ -9,8 +10,11 @@
 #include <utility>
 
 #include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 #include <wujihandcpp/device/hand.hpp>
 
+#include "out_array.hpp"
+
 namespace py = pybind11;
 
 class IControllerWrapper final {
@@ -18,6 +22,16 @@ public:
     explicit IControllerWrapper(std::unique_ptr<wujihandcpp::device::IController> controller)
         : controller_(std::move(controller)) {}
 
+    // Controller running a native step function. Holds the function's Python object and its
+    // state, with the state's buffer exported, until the controller is closed.
+    IControllerWrapper(
+        std::unique_ptr<wujihandcpp::device::IController> controller, py::object step,
+        py::object state, std::unique_ptr<py::buffer_info> state_buffer)
+        : step_(std::move(step))
+        , state_(std::move(state))
+        , state_buffer_(std::move(state_buffer))
+        , controller_(std::move(controller)) {}
+
     IControllerWrapper(const IControllerWrapper&) = delete;
     IControllerWrapper& operator=(const IControllerWrapper&) = delete;
     IControllerWrapper(IControllerWrapper&&) noexcept = default;
@@ -25,39 +39,35 @@ public:
 
     ~IControllerWrapper() = default;
 
-    py::array_t<double> get_joint_actual_position() {
-        if (!controller_)
-            throw std::runtime_error("Controller is closed.");
-
-        const auto& positions = controller_->get_joint_actual_position();
-
-        auto buffer = new double[5 * 4];
-        for (size_t i = 0; i < 5; i++)
-            for (size_t j = 0; j < 4; j++)
-                buffer[4 * i + j] = positions[i][j].load(std::memory_order::relaxed);
-        py::capsule free(buffer, [](void* ptr) { delete[] static_cast<double*>(ptr); });
-
-        return py::array_t<double>({5, 4}, buffer, free);
+    py::array_t<double> get_joint_actual_position(std::optional<py::array> out) {
+        return load(controller().get_joint_actual_position(), out);
     }
 
-    py::array_t<double> get_joint_actual_effort() {
-        if (!controller_)
-            throw std::runtime_error("Controller is closed.");
+    py::array_t<double> get_joint_actual_effort(std::optional<py::array> out) {
+        return load(controller().get_joint_actual_effort(), out);
+    }
 
-        const auto& efforts = controller_->get_joint_actual_effort();
+    // Copies the latest feedback into the snapshot buffers behind joint_actual_position() and
+    // joint_actual_effort(). Allocation-free, and the views only change here, so Python code
+    // between two refreshes always sees the same values.
+    void refresh() {
+        auto& snapshot = this->snapshot();
+        load(controller().get_joint_actual_position(), &snapshot.position[0][0]);
+        load(controller().get_joint_actual_effort(), &snapshot.effort[0][0]);
+    }
 
-        auto buffer = new double[5 * 4];
-        for (size_t i = 0; i < 5; i++)
-            for (size_t j = 0; j < 4; j++)
-                buffer[4 * i + j] = efforts[i][j].load(std::memory_order::relaxed);
-        py::capsule free(buffer, [](void* ptr) { delete[] static_cast<double*>(ptr); });
+    py::array joint_actual_position() {
+        snapshot();
+        return position_view_;
+    }
 
-        return py::array_t<double>({5, 4}, buffer, free);
+    py::array joint_actual_effort() {
+        snapshot();
+        return effort_view_;
     }
 
     void set_joint_target_position(const py::array_t<double>& array) {
-        if (!controller_)
-            throw std::runtime_error("Controller is closed.");
+        auto& controller = this->controller();
 
         if (array.ndim() != 2 || array.shape()[0] != 5 || array.shape()[1] != 4)
             throw std::runtime_error("Array shape must be {5, 4}!");
@@ -68,7 +78,7 @@ public:
             for (size_t j = 0; j < 4; ++j)
                 target_positions[i][j] = r(i, j);
 
-        controller_->set_joint_target_position(target_positions);
+        controller.set_joint_target_position(target_positions);
     }
 
     void close() {
@@ -77,12 +87,103 @@ public:
                 controller_->detach();
             } catch (...) {
                 controller_.reset();
+                release_step();
                 throw;
             }
             controller_.reset();
+            release_step();
         }
     }
 
 private:
+    // Buffers of refresh(). The views own them through their base capsule, so views kept by
+    // Python code stay valid after the controller is gone.
+    struct Snapshot {
+        double position[5][4];
+        double effort[5][4];
+    };
+
+    wujihandcpp::device::IController& controller() {
+        if (!controller_)
+            throw std::runtime_error("Controller is closed.");
+        return *controller_;
+    }
+
+    Snapshot& snapshot() {
+        if (!snapshot_) {
+            auto snapshot = new Snapshot{};
+            py::capsule owner(snapshot, [](void* ptr) { delete static_cast<Snapshot*>(ptr); });
+            position_view_ = read_only_view(snapshot->position, owner);
+            effort_view_ = read_only_view(snapshot->effort, owner);
+            snapshot_ = snapshot;
+        }
+        return *snapshot_;
+    }
+
+    static py::array read_only_view(double (&values)[5][4], const py::capsule& owner) {
+        py::array_t<double> view({5, 4}, &values[0][0], owner);
+        view.attr("flags").attr("writeable") = false;
+        return view;
+    }
+
+    static void load(const std::atomic<double> (&values)[5][4], double* buffer) {
+        for (size_t i = 0; i < 5; i++)
+            for (size_t j = 0; j < 4; j++)
+                buffer[4 * i + j] = values[i][j].load(std::memory_order::relaxed);
+    }
+
+    // Into `out` if given, otherwise into a new array
+    static py::array_t<double>
+        load(const std::atomic<double> (&values)[5][4], std::optional<py::array>& out) {
+        if (out) {
+            load(values, out_array_data<double>(*out, {5, 4}));
+            return py::reinterpret_borrow<py::array_t<double>>(*out);
+        }
+
+        auto buffer = new double[5 * 4];
+        load(values, buffer);
+        py::capsule free(buffer, [](void* ptr) { delete[] static_cast<double*>(ptr); });
+
+        return py::array_t<double>({5, 4}, buffer, free);
+    }
+
+    // The PDO thread no longer calls the step function
+    void release_step() {
+        state_buffer_.reset();
+        state_ = py::object();
+        step_ = py::object();
+    }
+
+    // Declared before controller_, which detaches when destroyed
+    py::object step_;
+    py::object state_;
+    std::unique_ptr<py::buffer_info> state_buffer_;
+
     std::unique_ptr<wujihandcpp::device::IController> controller_;
+
+    Snapshot* snapshot_ = nullptr; // Owned by the views
+    py::array position_view_;
+    py::array effort_view_;
 };
+
+// Address of a native step function: an int, a ctypes function pointer, or an object with an
+// `address` attribute such as a numba cfunc. Get the address of a cffi function with
+// int(ffi.cast("uintptr_t", function)).
+inline wujihandcpp::device::StepFunction step_function_address(const py::object& step) {
+    uintptr_t address;
+    try {
+        if (py::isinstance<py::int_>(step))
+            address = step.cast<uintptr_t>();
+        else if (py::hasattr(step, "address"))
+            address = step.attr("address").cast<uintptr_t>();
+        else {
+            auto ctypes = py::module_::import("ctypes");
+            auto pointer = ctypes.attr("cast")(step, ctypes.attr("c_void_p"));
+            address = pointer.attr("value").cast<uintptr_t>();
+        }
+    } catch (const std::exception&) {
+        throw py::type_error(
+            "step must be a function address: an int, a ctypes function pointer or a numba cfunc");
+    }
+    return reinterpret_cast<wujihandcpp::device::StepFunction>(address);
+}
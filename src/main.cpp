@@ -7,12 +7,15 @@
 #include <wujihandcpp/device/joint.hpp>
 #include <wujihandcpp/device/latch.hpp>
 
+#include "async_completion.hpp"
 #include "controller.hpp"
 #include "filter.hpp"
 #include "logging.hpp"
+#include "metrics.hpp"
 #ifdef WUJIHANDPY_ENABLE_TACTILE
 #include "tactile.hpp"
 #endif
+#include "trace.hpp"
 #include "wrapper.hpp"
 
 namespace py = pybind11;
@@ -63,16 +66,142 @@ PYBIND11_MODULE(_core, m) {
             "__exit__", [](IControllerWrapper& self, const py::object&, const py::object&,
                            const py::object&) { self.close(); })
         .def("close", &IControllerWrapper::close)
-        .def("get_joint_actual_position", &IControllerWrapper::get_joint_actual_position)
-        .def("get_joint_actual_effort", &IControllerWrapper::get_joint_actual_effort)
+        .def(
+            "get_joint_actual_position", &IControllerWrapper::get_joint_actual_position,
+            py::arg("out") = py::none())
+        .def(
+            "get_joint_actual_effort", &IControllerWrapper::get_joint_actual_effort,
+            py::arg("out") = py::none())
+        .def(
+            "refresh", &IControllerWrapper::refresh,
+            "Copy the latest feedback into the arrays of joint_actual_position and "
+            "joint_actual_effort. Does not allocate.")
+        .def_property_readonly(
+            "joint_actual_position", &IControllerWrapper::joint_actual_position,
+            "Read-only view of the positions at the last refresh(). Always the same array.")
+        .def_property_readonly(
+            "joint_actual_effort", &IControllerWrapper::joint_actual_effort,
+            "Read-only view of the efforts at the last refresh(). Always the same array.")
         .def(
             "set_joint_target_position", &IControllerWrapper::set_joint_target_position,
             py::arg("value_array"));
 
+    py::class_<RealtimeLoop>(m, "RealtimeLoop")
+        .def("__iter__", [](RealtimeLoop& self) -> RealtimeLoop& { return self; })
+        .def(
+            "__next__", &RealtimeLoop::next,
+            "Wait for the next tick, with the GIL released, and return the latest joint "
+            "positions. Always the same read-only array.")
+        .def_property_readonly("rate", &RealtimeLoop::rate)
+        .def_property_readonly(
+            "index", &RealtimeLoop::index,
+            "Index of the current tick, counting skipped ticks. The current tick was scheduled "
+            "index / rate seconds after the first.")
+        .def_property_readonly(
+            "overrun_count", &RealtimeLoop::overrun_count,
+            "Ticks skipped because a tick woke up more than one period late. A loop body that "
+            "runs past its period delays the following ticks instead.")
+        .def_property_readonly(
+            "lateness", &RealtimeLoop::lateness,
+            "Seconds between the scheduled time of the current tick and the wakeup.")
+        .def_property_readonly(
+            "joint_actual_position", &RealtimeLoop::joint_actual_position,
+            "The array returned by every iteration.");
+
+    py::class_<wujihandcpp::device::JointErrorEvent>(m, "JointErrorEvent")
+        .def_property_readonly(
+            "timestamp",
+            [](const wujihandcpp::device::JointErrorEvent& self) {
+                // steady_clock is CLOCK_MONOTONIC, the clock of time.monotonic()
+                return std::chrono::duration<double>(self.timestamp.time_since_epoch()).count();
+            })
+        .def_readonly("finger", &wujihandcpp::device::JointErrorEvent::finger)
+        .def_readonly("joint", &wujihandcpp::device::JointErrorEvent::joint)
+        .def_readonly("error_code", &wujihandcpp::device::JointErrorEvent::error_code)
+        .def_readonly("set_bits", &wujihandcpp::device::JointErrorEvent::set_bits)
+        .def_readonly("cleared_bits", &wujihandcpp::device::JointErrorEvent::cleared_bits)
+        .def_property_readonly(
+            "descriptions",
+            [](const wujihandcpp::device::JointErrorEvent& self) {
+                std::vector<std::string> descriptions;
+                for (int bit = 0; bit < 32; bit++)
+                    if (self.set_bits & (uint32_t{1} << bit)) {
+                        auto description =
+                            wujihandcpp::protocol::Handler::joint_error_description(bit);
+                        descriptions.push_back(
+                            description ? description : std::format("Unknown error bit {}", bit));
+                    }
+                return descriptions;
+            })
+        .def("__repr__", [](const wujihandcpp::device::JointErrorEvent& self) {
+            return std::format(
+                "JointErrorEvent(finger={}, joint={}, error_code=0x{:X}, set_bits=0x{:X}, "
+                "cleared_bits=0x{:X})",
+                self.finger, self.joint, self.error_code, self.set_bits, self.cleared_bits);
+        });
+
+    using SdoLatency = wujihandcpp::protocol::Handler::SdoLatency;
+    py::class_<SdoLatency>(m, "SdoLatency")
+        .def_readonly("count", &SdoLatency::count)
+        .def_readonly("timeout_count", &SdoLatency::timeout_count)
+        .def_readonly("mean_queue_ns", &SdoLatency::mean_queue_ns)
+        .def_readonly("mean_ns", &SdoLatency::mean_ns)
+        .def_readonly("p50_ns", &SdoLatency::p50_ns)
+        .def_readonly("p90_ns", &SdoLatency::p90_ns)
+        .def_readonly("p99_ns", &SdoLatency::p99_ns)
+        .def_readonly("max_ns", &SdoLatency::max_ns)
+        .def("__repr__", [](const SdoLatency& self) {
+            return std::format(
+                "SdoLatency(count={}, timeout_count={}, p50_ns={}, p99_ns={}, max_ns={})",
+                self.count, self.timeout_count, self.p50_ns, self.p99_ns, self.max_ns);
+        });
+
+    using RealtimeStatistics = wujihandcpp::protocol::Handler::RealtimeStatistics;
+    auto realtime_statistics = py::class_<RealtimeStatistics>(m, "RealtimeStatistics");
+    py::class_<RealtimeStatistics::Distribution>(realtime_statistics, "Distribution")
+        .def_readonly("mean_ns", &RealtimeStatistics::Distribution::mean_ns)
+        .def_readonly("p50_ns", &RealtimeStatistics::Distribution::p50_ns)
+        .def_readonly("p99_ns", &RealtimeStatistics::Distribution::p99_ns)
+        .def_readonly("max_ns", &RealtimeStatistics::Distribution::max_ns)
+        .def("__repr__", [](const RealtimeStatistics::Distribution& self) {
+            return std::format(
+                "Distribution(mean_ns={}, p50_ns={}, p99_ns={}, max_ns={})", self.mean_ns,
+                self.p50_ns, self.p99_ns, self.max_ns);
+        });
+    realtime_statistics.def_readonly("period_ns", &RealtimeStatistics::period_ns)
+        .def_readonly("tick_count", &RealtimeStatistics::tick_count)
+        .def_readonly("overrun_count", &RealtimeStatistics::overrun_count)
+        .def_readonly("lateness", &RealtimeStatistics::lateness)
+        .def_readonly("step", &RealtimeStatistics::step)
+        .def_readonly("submit", &RealtimeStatistics::submit)
+        .def("__repr__", [](const RealtimeStatistics& self) {
+            return std::format(
+                "RealtimeStatistics(period_ns={}, tick_count={}, overrun_count={}, "
+                "lateness_p99_ns={}, step_p99_ns={}, submit_p99_ns={})",
+                self.period_ns, self.tick_count, self.overrun_count, self.lateness.p99_ns,
+                self.step.p99_ns, self.submit.p99_ns);
+        });
+
+    py::class_<SubscriptionWrapper>(m, "Subscription")
+        .def("__enter__", [](SubscriptionWrapper& self) -> SubscriptionWrapper& { return self; })
+        .def(
+            "__exit__", [](SubscriptionWrapper& self, const py::object&, const py::object&,
+                           const py::object&) { self.unsubscribe(); })
+        .def_property_readonly("active", &SubscriptionWrapper::active)
+        .def("unsubscribe", &SubscriptionWrapper::unsubscribe);
+
+#ifdef WUJIHANDPY_TESTING
+    async_completion::init_module(m);
+#endif
+
     filter::init_module(m);
 
     logging::init_module(m);
 
+    trace::init_module(m);
+
+    metrics::init_module(m);
+
 #ifdef WUJIHANDPY_ENABLE_TACTILE
     tactile_binding::init_module(m);
 #endif
@@ -119,6 +248,23 @@ PYBIND11_MODULE(_core, m) {
     hand.def(
         "realtime_controller", &Hand::realtime_controller, py::arg("enable_upstream"),
         py::arg("filter"), py::keep_alive<0, 1>());
+    hand.def(
+        "realtime_controller", &Hand::realtime_step_controller, py::arg("enable_upstream"),
+        py::arg("step"), py::arg("state") = py::none(), py::keep_alive<0, 1>(),
+        "Run a native step function `void step(const double* actual, double* target, void* "
+        "state)` on the PDO thread every control period, without the GIL. `actual` holds the "
+        "latest 5x4 joint positions (NULL without upstream); `target` holds the previous targets, "
+        "to be overwritten with the new ones. `step` is a ctypes function pointer, a numba cfunc "
+        "or an int address; `state` is None, an int address or a writable buffer such as a numpy "
+        "array, passed as `state`. Both are kept alive until the controller is closed.");
+
+    hand.def(
+        "realtime_loop", &Hand::realtime_loop, py::arg("rate"), py::keep_alive<0, 1>(),
+        "Iterate at `rate` Hz: every iteration waits for the next tick with the GIL released and "
+        "yields the latest joint positions from the PDO feedback (only updated while a realtime "
+        "controller with upstream enabled is attached). An iteration that comes back late starts "
+        "the next tick right away; once a tick wakes up more than a period late, the ticks it "
+        "missed are skipped and counted in overrun_count.");
 
     hand.def("start_latency_test", &Hand::start_latency_test);
     hand.def("stop_latency_test", &Hand::stop_latency_test);
@@ -126,8 +272,9 @@ PYBIND11_MODULE(_core, m) {
     // Thread safety check control
     hand.def(
         "disable_thread_safe_check", &Hand::disable_thread_safe_check,
-        "Disable thread safety check to allow multi-threaded usage. "
-        "When disabled, user must ensure thread-safe access using external mutex.");
+        "Disable the construction-thread check of realtime controller and latency test "
+        "operations. SDO reads and writes are thread-safe without it. When disabled, "
+        "user must ensure thread-safe access to those operations using external mutex.");
 
     // Raw SDO operations for debugging
     hand.def(
@@ -136,6 +283,48 @@ PYBIND11_MODULE(_core, m) {
     hand.def(
         "raw_sdo_write", &Hand::raw_sdo_write, py::arg("finger_id"), py::arg("joint_id"),
         py::arg("index"), py::arg("sub_index"), py::arg("data"), py::arg("timeout") = 0.5);
+    hand.def(
+        "raw_sdo_read_many", &Hand::raw_sdo_read_many, py::arg("finger_id"), py::arg("joint_id"),
+        py::arg("objects"), py::arg("timeout") = 0.5,
+        "Read many (index, sub_index) objects in one batch. Returns one bytes object per entry, "
+        "or None for entries that timed out.");
+
+    // Joint error events
+    hand.def(
+        "realtime_get_joint_error_code", &Hand::realtime_get_joint_error_code,
+        py::arg("out") = py::none(),
+        "Error codes from the PDO feedback, updated at the PDO rate while a realtime controller "
+        "with upstream enabled is running.");
+    hand.def(
+        "poll_joint_error_events", &Hand::poll_joint_error_events, py::arg("max_count") = 64,
+        "Return pending joint error events, oldest first. Does not block.");
+    hand.def("dropped_joint_error_events", &Hand::dropped_joint_error_events);
+
+    // Realtime loop health
+    hand.def(
+        "realtime_statistics", &Hand::realtime_statistics,
+        "Scheduling lateness, step() execution time, RPDO submit time and overruns of the "
+        "realtime loop since the current (or last) realtime controller was attached.");
+
+    // SDO latency
+    hand.def(
+        "sdo_latency", &Hand::sdo_latency, py::arg("finger_id"), py::arg("joint_id") = 0,
+        "SDO round-trip latency of joint (finger_id, joint_id), or of the hand-level objects if "
+        "finger_id is -1. Cumulative since the hand was opened.");
+
+    hand.def(
+        "on_joint_error", &Hand::on_joint_error, py::arg("callback"),
+        "Call `callback(event)` for every joint error event, in order, from a thread of its own, "
+        "or remove the callback with None.");
+
+    // Shared memory publication
+    hand.def(
+        "start_state_publisher", &Hand::start_state_publisher, py::arg("name") = "wujihand",
+        py::arg("capacity") = 1024,
+        "Publish every PDO feedback frame, with a history of `capacity` snapshots, to the shared "
+        "memory segment `name` (/dev/shm/<name>). Read it from other processes with "
+        "wujihandpy.shared_state.SharedStateReader. Linux only.");
+    hand.def("stop_state_publisher", &Hand::stop_state_publisher);
 
     // Product SN
     hand.def(
@@ -165,4 +354,18 @@ PYBIND11_MODULE(_core, m) {
     register_py_interface<data::joint::TargetPosition>("target_position", hand, finger, joint);
     register_py_interface<data::joint::UpperLimit>("upper_limit", hand, finger, joint);
     register_py_interface<data::joint::LowerLimit>("lower_limit", hand, finger, joint);
+
+    // Batch reads of the data registered above
+    hand.def(
+        "read_many", &Hand::read_many, py::arg("names"), py::arg("timeout") = 0.5,
+        "Read every data in `names` (the read_* suffixes, such as \"joint_temperature\") in one "
+        "batch that waits for a single SDO round trip. Returns {name: value}.");
+    finger.def(
+        "read_many", &Finger::read_many, py::arg("names"), py::arg("timeout") = 0.5,
+        "Read every data in `names` (the read_* suffixes, such as \"joint_temperature\") in one "
+        "batch that waits for a single SDO round trip. Returns {name: value}.");
+    joint.def(
+        "read_many", &Joint::read_many, py::arg("names"), py::arg("timeout") = 0.5,
+        "Read every data in `names` (the read_* suffixes, such as \"joint_temperature\") in one "
+        "batch that waits for a single SDO round trip. Returns {name: value}.");
 }
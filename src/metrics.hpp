@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <wujihandcpp/utility/metrics.hpp>
+
+namespace py = pybind11;
+
+namespace metrics {
+
+inline const char* type_name(wujihandcpp::metrics::Type type) {
+    using Type = wujihandcpp::metrics::Type;
+    if (type == Type::COUNTER)
+        return "counter";
+    else if (type == Type::GAUGE)
+        return "gauge";
+    else
+        return "histogram";
+}
+
+inline py::list snapshot() {
+    py::list result;
+    for (auto& sample : wujihandcpp::metrics::snapshot()) {
+        py::dict entry;
+        entry["name"] = sample.name;
+        entry["help"] = sample.help;
+        entry["labels"] = sample.labels;
+        entry["type"] = type_name(sample.type);
+        entry["value"] = sample.value;
+        if (sample.type == wujihandcpp::metrics::Type::HISTOGRAM) {
+            entry["count"] = sample.count;
+            py::list buckets;
+            for (size_t i = 0; i < sample.bucket_bounds.size(); i++)
+                buckets.append(py::make_tuple(sample.bucket_bounds[i], sample.bucket_counts[i]));
+            entry["buckets"] = buckets;
+        }
+        result.append(entry);
+    }
+    return result;
+}
+
+inline void start_exporter(const std::string& target, double period) {
+    wujihandcpp::metrics::start_exporter(target.c_str(), period);
+}
+
+inline void init_module(py::module_& m) {
+    auto metrics = m.def_submodule("metrics");
+
+    metrics.def("snapshot", &snapshot);
+    metrics.def("prometheus_text", &wujihandcpp::metrics::prometheus_text);
+    metrics.def("start_exporter", &start_exporter, py::arg("target"), py::arg("period") = 10.0);
+    metrics.def(
+        "stop_exporter", &wujihandcpp::metrics::stop_exporter,
+        py::call_guard<py::gil_scoped_release>());
+}
+
+} // namespace metrics
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <format>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+// Data pointer of an `out=` array that values of type T with `shape` can be stored into in place:
+// same dtype, C-contiguous and writeable. Never converts or copies, since the caller expects to
+// find the values in its own array.
+template <typename T>
+T* out_array_data(py::array& out, std::initializer_list<py::ssize_t> shape) {
+    if (!py::isinstance<py::array_t<T, py::array::c_style>>(out))
+        throw py::type_error(std::format(
+            "out must be a C-contiguous array of dtype {}",
+            py::str(py::dtype::of<T>()).cast<std::string>()));
+
+    bool shape_matches = out.ndim() == static_cast<py::ssize_t>(shape.size());
+    py::ssize_t axis = 0;
+    for (auto extent : shape)
+        shape_matches = shape_matches && out.shape(axis++) == extent;
+    if (!shape_matches) {
+        std::string expected;
+        for (auto extent : shape)
+            expected += (expected.empty() ? "" : ", ") + std::to_string(extent);
+        throw py::value_error("out shape must be {" + expected + "}!");
+    }
+
+    if (!out.writeable())
+        throw std::invalid_argument("out must be writeable");
+    return static_cast<T*>(out.mutable_data());
+}
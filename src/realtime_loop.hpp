@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+// Paces a Python control loop. Each iteration waits, with the GIL released, for the next tick of
+// a fixed-rate schedule, then copies the latest PDO feedback into a reused read-only array and
+// yields it. Ticks are scheduled like the PDO loop's TickExecutor: one period after another from
+// the first iteration. A loop body that runs past the next tick only delays it, and the ticks
+// after it run late until the loop catches up; only once a tick wakes up more than a period late
+// are the ticks it missed skipped and counted as overruns, instead of being run in a burst.
+class RealtimeLoop final {
+public:
+    using clock_t = std::chrono::steady_clock;
+
+    RealtimeLoop(const std::atomic<double> (&positions)[5][4], double rate)
+        : positions_(positions) {
+        if (!std::isfinite(rate) || rate <= 0.0)
+            throw std::invalid_argument("rate must be positive and finite");
+        rate_ = rate;
+        period_ = std::chrono::duration_cast<clock_t::duration>(
+            std::chrono::duration<double>(1.0 / rate));
+
+        // The view owns the buffer through its base capsule, so it outlives the loop if kept
+        auto buffer = new double[5][4]{};
+        py::capsule owner(buffer, [](void* ptr) { delete[] static_cast<double (*)[4]>(ptr); });
+        py::array_t<double> view({5, 4}, &buffer[0][0], owner);
+        view.attr("flags").attr("writeable") = false;
+        buffer_ = buffer;
+        position_view_ = std::move(view);
+    }
+
+    RealtimeLoop(const RealtimeLoop&) = delete;
+    RealtimeLoop& operator=(const RealtimeLoop&) = delete;
+
+    // Blocks until the next tick and returns the positions at that tick. Always the same array.
+    py::array next() {
+        if (!started_) {
+            started_ = true;
+            scheduled_time_ = clock_t::now();
+        } else {
+            py::gil_scoped_release release;
+
+            // Judged by when the last tick woke up, not by when its loop body came back
+            scheduled_time_ += period_;
+            index_++;
+            while (wakeup_time_ > scheduled_time_) {
+                scheduled_time_ += period_;
+                index_++;
+                overrun_count_++;
+            }
+            std::this_thread::sleep_until(scheduled_time_);
+        }
+
+        wakeup_time_ = clock_t::now();
+        lateness_ = std::chrono::duration<double>(wakeup_time_ - scheduled_time_).count();
+
+        // Raises KeyboardInterrupt here, since the sleep itself cannot be interrupted
+        if (PyErr_CheckSignals() != 0)
+            throw py::error_already_set();
+
+        for (size_t i = 0; i < 5; i++)
+            for (size_t j = 0; j < 4; j++)
+                buffer_[i][j] = positions_[i][j].load(std::memory_order::relaxed);
+        return position_view_;
+    }
+
+    double rate() const { return rate_; }
+
+    // Index of the current tick, counting skipped ones: the time since the first tick is
+    // index / rate.
+    uint64_t index() const { return index_; }
+
+    uint64_t overrun_count() const { return overrun_count_; }
+
+    // Seconds between the scheduled time of the current tick and the wakeup
+    double lateness() const { return lateness_; }
+
+    py::array joint_actual_position() const { return position_view_; }
+
+private:
+    const std::atomic<double> (&positions_)[5][4];
+
+    double rate_;
+    clock_t::duration period_;
+
+    double (*buffer_)[4];
+    py::array position_view_;
+
+    bool started_ = false;
+    clock_t::time_point scheduled_time_, wakeup_time_;
+    uint64_t index_ = 0;
+    uint64_t overrun_count_ = 0;
+    double lateness_ = 0.0;
+};
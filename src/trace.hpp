@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+
+#include <pybind11/pybind11.h>
+#include <wujihandcpp/utility/trace.hpp>
+
+namespace py = pybind11;
+
+namespace trace {
+
+inline void set_enabled(bool value) noexcept { wujihandcpp::trace::set_enabled(value); }
+
+inline void set_spans_enabled(bool value) noexcept {
+    wujihandcpp::trace::set_spans_enabled(value);
+}
+
+inline void dump(const std::string& path) {
+    bool success;
+    {
+        py::gil_scoped_release release;
+        success = wujihandcpp::trace::dump(path.c_str());
+    }
+    if (!success)
+        throw std::runtime_error("Failed to write trace dump to " + path);
+}
+
+inline void init_module(py::module_& m) {
+    auto trace = m.def_submodule("trace");
+
+    trace.def("set_enabled", &set_enabled, py::arg("value"));
+    trace.def("set_spans_enabled", &set_spans_enabled, py::arg("value"));
+    trace.def("dump", &dump, py::arg("path"));
+}
+
+} // namespace trace
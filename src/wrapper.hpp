@@ -3,13 +3,18 @@
 #include <cmath>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <exception>
 #include <format>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <pybind11/numpy.h>
@@ -18,12 +23,59 @@
 #include <pybind11/stl.h>
 #include <wujihandcpp/data/hand.hpp>
 #include <wujihandcpp/data/joint.hpp>
+#include <wujihandcpp/device/error_event.hpp>
 #include <wujihandcpp/device/latch.hpp>
+#include <wujihandcpp/device/subscription.hpp>
 
+#include "async_completion.hpp"
+#include "callback_relay.hpp"
 #include "filter.hpp"
+#include "out_array.hpp"
+#include "realtime_loop.hpp"
 
 namespace py = pybind11;
 
+// One value of a subscription, on its way to the Python callback
+struct SubscriptionValue {
+    int index;
+    wujihandcpp::protocol::Handler::Buffer8 value;
+};
+
+using SubscriptionRelay = CallbackRelay<SubscriptionValue>;
+using JointErrorRelay = CallbackRelay<wujihandcpp::device::JointErrorEvent>;
+
+// Python handle of a device::Subscription and the relay delivering its values. Unsubscribing
+// may wait for the SDO thread, so it runs with the GIL released.
+class SubscriptionWrapper {
+public:
+    SubscriptionWrapper(
+        wujihandcpp::device::Subscription subscription, std::shared_ptr<SubscriptionRelay> relay)
+        : subscription_(std::move(subscription))
+        , relay_(std::move(relay)) {}
+
+    SubscriptionWrapper(const SubscriptionWrapper&) = delete;
+    SubscriptionWrapper& operator=(const SubscriptionWrapper&) = delete;
+
+    ~SubscriptionWrapper() { unsubscribe(); }
+
+    bool active() const { return subscription_.active(); }
+
+    // Call with GIL. The callback is not called again once this returns.
+    void unsubscribe() {
+        if (!subscription_.active())
+            return;
+        {
+            py::gil_scoped_release release;
+            subscription_.reset();
+        }
+        relay_->close();
+    }
+
+private:
+    wujihandcpp::device::Subscription subscription_;
+    std::shared_ptr<SubscriptionRelay> relay_;
+};
+
 template <typename T>
 class Wrapper : private T {
 public:
@@ -62,6 +114,19 @@ public:
     explicit Wrapper(T&& t)
         : T(std::move(t)) {}
 
+    ~Wrapper() {
+        if constexpr (std::is_same_v<T, wujihandcpp::device::Hand>) {
+            // Members go before the base: stop the SDO thread pushing to the relay first
+            if (joint_error_relay_) {
+                {
+                    py::gil_scoped_release release;
+                    T::set_joint_error_callback(nullptr);
+                }
+                joint_error_relay_->close();
+            }
+        }
+    }
+
     auto finger(int index) -> std::unique_ptr<Wrapper<wujihandcpp::device::Finger>> {
         return std::make_unique<Wrapper<wujihandcpp::device::Finger>>(T::finger(index));
     }
@@ -102,16 +167,80 @@ public:
         return get<Data>();
     }
 
+    // Reads every data in `names` (the read_* suffixes, such as "joint_temperature") in one
+    // batch: all reads enter the SDO scheduler before the single wait, with the GIL released
+    // once. Returns {name: value}, the values being those of the matching get_* calls.
+    py::dict read_many(const std::vector<std::string>& names, double timeout) {
+        std::vector<std::pair<const std::string*, const BatchReader*>> reads;
+        for (const auto& name : names) {
+            auto reader = batch_readers().find(name);
+            if (reader == batch_readers().end())
+                throw py::key_error(std::format("No readable data named '{}'", name));
+            bool duplicate = std::any_of(reads.begin(), reads.end(), [&name](const auto& read) {
+                return *read.first == name;
+            });
+            if (!duplicate)
+                reads.emplace_back(&name, &reader->second);
+        }
+
+        {
+            py::gil_scoped_release release;
+            wujihandcpp::device::Latch latch;
+            std::exception_ptr rejected;
+            for (const auto& [name, reader] : reads) {
+                try {
+                    reader->read_async(*this, latch, seconds_to_duration(timeout));
+                } catch (...) {
+                    rejected = std::current_exception();
+                    break;
+                }
+            }
+            // Even if a read was rejected, those already submitted must finish with the latch
+            if (rejected) {
+                latch.try_wait();
+                std::rethrow_exception(rejected);
+            }
+            latch.wait();
+        }
+
+        py::dict result;
+        for (const auto& [name, reader] : reads)
+            result[py::str(*name)] = reader->get(*this);
+        return result;
+    }
+
     template <typename Data>
     py::object read_async(double timeout) {
-        FutureLatch* latch = FutureLatch::create(*this, data_count<Data>());
+        auto latch = ReadFutureLatch<Data>::create(*this);
+        auto future = latch->future();
         T::template read_async<Data>(
-            [latch](bool success) {
-                latch->count_down(success, [](Wrapper& wrapper) { return wrapper.get<Data>(); });
-            },
+            [latch = latch.get()](bool success) { latch->count_down(success); },
             seconds_to_duration(timeout));
 
-        return latch->future();
+        latch.release(); // Submitted: the last count_down() hands it over to the event loop
+        return future;
+    }
+
+    // The callback runs on a Python thread of its own (see SubscriptionRelay). It receives
+    // (value), (joint_id, value) or (finger_id, joint_id, value), depending on whether Data is
+    // per joint and how many joints this object covers.
+    template <typename Data>
+    std::unique_ptr<SubscriptionWrapper> subscribe(double period, py::function callback) {
+        auto relay = std::make_shared<SubscriptionRelay>();
+        wujihandcpp::device::Subscription subscription;
+        {
+            py::gil_scoped_release release;
+            // The SDO thread only queues the values, until the delivery thread starts below
+            subscription = T::template subscribe<Data>(
+                seconds_to_duration(period),
+                [relay](int index, typename Data::ValueType value) {
+                    relay->push({index, wujihandcpp::protocol::Handler::Buffer8{value}});
+                });
+        }
+        SubscriptionRelay::start(
+            relay, std::move(callback), deliver_subscription_value<Data>,
+            "wujihandpy-subscription", "subscription value(s)");
+        return std::make_unique<SubscriptionWrapper>(std::move(subscription), std::move(relay));
     }
 
     template <typename Data>
@@ -127,73 +256,40 @@ public:
 
     template <typename Data>
     void write(py::array_t<typename Data::ValueType> array, double timeout) {
+        typename Data::ValueType values[data_count<Data>()];
+        copy_value_array<Data>(array, values);
+
         py::gil_scoped_release release;
         wujihandcpp::device::Latch latch;
-
-        if constexpr (
-            std::is_same_v<T, wujihandcpp::device::Finger>
-            && std::is_same_v<typename Data::Base, wujihandcpp::device::Joint>) {
-            if (array.ndim() != 1 || array.shape()[0] != 4)
-                throw std::runtime_error("Array shape must be {4}!");
-            auto r = array.template unchecked<1>();
-            for (int j = 0; j < 4; j++)
-                T::joint(j).template write_async<Data>(latch, r(j), seconds_to_duration(timeout));
-        } else if constexpr (
-            std::is_same_v<T, wujihandcpp::device::Hand>
-            && std::is_same_v<typename Data::Base, wujihandcpp::device::Joint>) {
-            if (array.ndim() != 2 || array.shape()[0] != 5 || array.shape()[1] != 4)
-                throw std::runtime_error("Array shape must be {5, 4}!");
-            auto r = array.template unchecked<2>();
-            for (int i = 0; i < 5; i++)
-                for (int j = 0; j < 4; j++)
-                    T::finger(i).joint(j).template write_async<Data>(
-                        latch, r(i, j), seconds_to_duration(timeout));
-        }
-
+        T::template write_many_async<Data>(latch, values, seconds_to_duration(timeout));
         latch.wait();
     }
 
     template <typename Data>
     py::object write_async(typename Data::ValueType value, double timeout) {
-        FutureLatch* latch = FutureLatch::create(*this, data_count<Data>());
+        auto latch = FutureLatch::create(data_count<Data>());
+        auto future = latch->future();
         T::template write_async<Data>(
-            [latch](bool success) {
-                latch->count_down(success, [](Wrapper&) { return py::none(); });
-            },
-            value, seconds_to_duration(timeout));
+            [latch = latch.get()](bool success) { latch->count_down(success); }, value,
+            seconds_to_duration(timeout));
 
-        return latch->future();
+        latch.release(); // Submitted: the last count_down() hands it over to the event loop
+        return future;
     }
 
     template <typename Data>
     py::object write_async(py::array_t<typename Data::ValueType> array, double timeout) {
-        FutureLatch* latch = FutureLatch::create(*this, data_count<Data>());
-        auto callback = [latch](bool success) {
-            latch->count_down(success, [](Wrapper&) { return py::none(); });
-        };
+        typename Data::ValueType values[data_count<Data>()];
+        copy_value_array<Data>(array, values);
 
-        if constexpr (
-            std::is_same_v<T, wujihandcpp::device::Finger>
-            && std::is_same_v<typename Data::Base, wujihandcpp::device::Joint>) {
-            if (array.ndim() != 1 || array.shape()[0] != 4)
-                throw std::runtime_error("Array shape must be {4}!");
-            auto r = array.template unchecked<1>();
-            for (int j = 0; j < 4; j++)
-                T::joint(j).template write_async<Data>(
-                    callback, r(j), seconds_to_duration(timeout));
-        } else if constexpr (
-            std::is_same_v<T, wujihandcpp::device::Hand>
-            && std::is_same_v<typename Data::Base, wujihandcpp::device::Joint>) {
-            if (array.ndim() != 2 || array.shape()[0] != 5 || array.shape()[1] != 4)
-                throw std::runtime_error("Array shape must be {5, 4}!");
-            auto r = array.template unchecked<2>();
-            for (int i = 0; i < 5; i++)
-                for (int j = 0; j < 4; j++)
-                    T::finger(i).joint(j).template write_async<Data>(
-                        callback, r(i, j), seconds_to_duration(timeout));
-        }
+        auto latch = FutureLatch::create(data_count<Data>());
+        auto future = latch->future();
+        auto callback = [latch = latch.get()](bool success) { latch->count_down(success); };
 
-        return latch->future();
+        T::template write_many_async<Data>(callback, values, seconds_to_duration(timeout));
+
+        latch.release(); // Submitted: the last count_down() hands it over to the event loop
+        return future;
     }
 
     template <typename Data>
@@ -201,6 +297,8 @@ public:
         T::template write_async_unchecked<Data>(value, seconds_to_duration(timeout));
     }
 
+    // Joint by joint rather than through write_many_async(): the bulk write is a checked one, and
+    // raises for a unit another operation holds, where an unchecked write only stores the value.
     template <typename Data>
     void write_async_unchecked(py::array_t<typename Data::ValueType> array, double timeout) {
         if constexpr (
@@ -234,11 +332,15 @@ public:
     requires(
         std::is_same_v<T, wujihandcpp::device::Finger>
         && std::is_same_v<typename Data::Base, wujihandcpp::device::Joint>)
-    auto get() {
+    auto get(std::optional<py::array> out = std::nullopt) {
         using ValueType = Data::ValueType;
+        if (out) {
+            T::template get_many<Data>(out_array_data<ValueType>(*out, {4}));
+            return py::reinterpret_borrow<py::array_t<ValueType>>(*out);
+        }
+
         auto buffer = new ValueType[4];
-        for (int j = 0; j < 4; j++)
-            buffer[j] = T::joint(j).template get<Data>();
+        T::template get_many<Data>(buffer);
 
         py::capsule free(buffer, [](void* ptr) { delete[] static_cast<ValueType*>(ptr); });
 
@@ -249,12 +351,15 @@ public:
     requires(
         std::is_same_v<T, wujihandcpp::device::Hand>
         && std::is_same_v<typename Data::Base, wujihandcpp::device::Joint>)
-    auto get() {
+    auto get(std::optional<py::array> out = std::nullopt) {
         using ValueType = Data::ValueType;
+        if (out) {
+            T::template get_many<Data>(out_array_data<ValueType>(*out, {5, 4}));
+            return py::reinterpret_borrow<py::array_t<ValueType>>(*out);
+        }
+
         auto buffer = new ValueType[5 * 4];
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                buffer[4 * i + j] = T::finger(i).joint(j).template get<Data>();
+        T::template get_many<Data>(buffer);
 
         py::capsule free(buffer, [](void* ptr) { delete[] static_cast<ValueType*>(ptr); });
 
@@ -272,9 +377,12 @@ public:
         std::is_same_v<T, wujihandcpp::device::Finger>
         && std::is_same_v<typename Data::Base, wujihandcpp::device::Joint>)
     auto get_effort_limit_as_ampere() {
+        typename Data::ValueType values[4];
+        T::template get_many<Data>(values);
+
         auto buffer = new double[4];
         for (int j = 0; j < 4; j++)
-            buffer[j] = T::joint(j).template get<Data>() / 1000.0;
+            buffer[j] = values[j] / 1000.0;
 
         py::capsule free(buffer, [](void* ptr) { delete[] static_cast<double*>(ptr); });
 
@@ -286,10 +394,12 @@ public:
         std::is_same_v<T, wujihandcpp::device::Hand>
         && std::is_same_v<typename Data::Base, wujihandcpp::device::Joint>)
     auto get_effort_limit_as_ampere() {
+        typename Data::ValueType values[5 * 4];
+        T::template get_many<Data>(values);
+
         auto buffer = new double[5 * 4];
-        for (int i = 0; i < 5; i++)
-            for (int j = 0; j < 4; j++)
-                buffer[4 * i + j] = T::finger(i).joint(j).template get<Data>() / 1000.0;
+        for (int k = 0; k < 5 * 4; k++)
+            buffer[k] = values[k] / 1000.0;
 
         py::capsule free(buffer, [](void* ptr) { delete[] static_cast<double*>(ptr); });
 
@@ -300,6 +410,34 @@ public:
         return filter.create_controller(*this, enable_upstream);
     }
 
+    std::unique_ptr<RealtimeLoop> realtime_loop(double rate)
+        requires std::is_same_v<T, wujihandcpp::device::Hand> {
+        return std::make_unique<RealtimeLoop>(T::realtime_get_joint_actual_position(), rate);
+    }
+
+    // `state` is None, an int address, or a writable buffer (numpy array, ctypes structure...)
+    IControllerWrapper
+        realtime_step_controller(bool enable_upstream, py::object step, py::object state)
+            requires std::is_same_v<T, wujihandcpp::device::Hand> {
+        auto function = step_function_address(step);
+
+        void* state_pointer = nullptr;
+        std::unique_ptr<py::buffer_info> state_buffer;
+        if (py::isinstance<py::int_>(state))
+            state_pointer = reinterpret_cast<void*>(state.cast<uintptr_t>());
+        else if (!state.is_none()) {
+            if (!PyObject_CheckBuffer(state.ptr()))
+                throw py::type_error("state must be None, an int address or a writable buffer");
+            state_buffer = std::make_unique<py::buffer_info>(
+                py::reinterpret_borrow<py::buffer>(state).request(true));
+            state_pointer = state_buffer->ptr;
+        }
+
+        return IControllerWrapper(
+            T::realtime_controller(function, state_pointer, enable_upstream), std::move(step),
+            std::move(state), std::move(state_buffer));
+    }
+
     void start_latency_test() { T::start_latency_test(); }
     void stop_latency_test() { T::stop_latency_test(); }
 
@@ -333,6 +471,126 @@ public:
             seconds_to_duration(timeout));
     }
 
+    // Reads many objects in one batch. Entries that time out are None; a disconnect raises.
+    py::list raw_sdo_read_many(
+        int finger_id, int joint_id, const std::vector<std::pair<uint16_t, uint8_t>>& objects,
+        double timeout) requires std::is_same_v<T, wujihandcpp::device::Hand> {
+        std::vector<wujihandcpp::protocol::Handler::SdoAddress> addresses;
+        addresses.reserve(objects.size());
+        for (const auto& [index, sub_index] : objects)
+            addresses.push_back({index, sub_index});
+
+        std::vector<std::optional<std::vector<uint8_t>>> results;
+        results.reserve(objects.size());
+        {
+            py::gil_scoped_release release;
+            auto futures = T::raw_sdo_read_many(
+                finger_id, joint_id, std::move(addresses),
+                wujihandcpp::device::deadline_after(seconds_to_duration(timeout)));
+            for (auto& future : futures) {
+                try {
+                    results.emplace_back(future.get());
+                } catch (const wujihandcpp::device::TimeoutError&) {
+                    results.emplace_back(std::nullopt);
+                }
+            }
+        }
+
+        py::list list;
+        for (const auto& result : results) {
+            if (result)
+                list.append(
+                    py::bytes(reinterpret_cast<const char*>(result->data()), result->size()));
+            else
+                list.append(py::none());
+        }
+        return list;
+    }
+
+    // Joint error events - only available for Hand
+    py::array_t<uint32_t> realtime_get_joint_error_code(std::optional<py::array> out)
+        requires std::is_same_v<T, wujihandcpp::device::Hand> {
+        const auto& codes = T::realtime_get_joint_error_code();
+
+        uint32_t* buffer;
+        if (out)
+            buffer = out_array_data<uint32_t>(*out, {5, 4});
+        else
+            buffer = new uint32_t[5 * 4];
+        for (size_t i = 0; i < 5; i++)
+            for (size_t j = 0; j < 4; j++)
+                buffer[4 * i + j] = codes[i][j].load(std::memory_order::relaxed);
+        if (out)
+            return py::reinterpret_borrow<py::array_t<uint32_t>>(*out);
+        py::capsule free(buffer, [](void* ptr) { delete[] static_cast<uint32_t*>(ptr); });
+
+        return py::array_t<uint32_t>({5, 4}, buffer, free);
+    }
+
+    std::vector<wujihandcpp::device::JointErrorEvent> poll_joint_error_events(size_t max_count)
+        requires std::is_same_v<T, wujihandcpp::device::Hand> {
+        std::vector<wujihandcpp::device::JointErrorEvent> events(max_count);
+        events.resize(T::poll_joint_error_events(events.data(), max_count));
+        return events;
+    }
+
+    uint64_t dropped_joint_error_events() requires std::is_same_v<T, wujihandcpp::device::Hand> {
+        return T::dropped_joint_error_events();
+    }
+
+    wujihandcpp::protocol::Handler::RealtimeStatistics realtime_statistics()
+        requires std::is_same_v<T, wujihandcpp::device::Hand> {
+        return T::realtime_statistics();
+    }
+
+    wujihandcpp::protocol::Handler::SdoLatency sdo_latency(int finger_id, int joint_id)
+        requires std::is_same_v<T, wujihandcpp::device::Hand> {
+        return T::sdo_latency(finger_id, joint_id);
+    }
+
+    void start_state_publisher(const std::string& name, size_t capacity)
+        requires std::is_same_v<T, wujihandcpp::device::Hand> {
+        py::gil_scoped_release release;
+        T::start_state_publisher(name.c_str(), capacity);
+    }
+
+    void stop_state_publisher() requires std::is_same_v<T, wujihandcpp::device::Hand> {
+        py::gil_scoped_release release;
+        T::stop_state_publisher();
+    }
+
+    // The callback runs on a Python thread of its own (see JointErrorRelay), never on the SDO
+    // thread.
+    void on_joint_error(std::optional<py::function> callback)
+        requires std::is_same_v<T, wujihandcpp::device::Hand> {
+        std::shared_ptr<JointErrorRelay> relay;
+        if (callback) {
+            relay = std::make_shared<JointErrorRelay>();
+            JointErrorRelay::start(
+                relay, std::move(*callback),
+                [](const py::function& callback,
+                   const wujihandcpp::device::JointErrorEvent& event) { callback(event); },
+                "wujihandpy-joint-error", "joint error event(s)");
+        }
+
+        {
+            py::gil_scoped_release release;
+            if (relay)
+                T::set_joint_error_callback(
+                    [](wujihandcpp::protocol::Handler::Buffer8 context,
+                       const wujihandcpp::device::JointErrorEvent& event) {
+                        context.as<JointErrorRelay*>()->push(event);
+                    },
+                    wujihandcpp::protocol::Handler::Buffer8{relay.get()});
+            else
+                T::set_joint_error_callback(nullptr);
+        }
+        // The SDO thread no longer pushes to the previous relay: its callback is not called again
+        if (joint_error_relay_)
+            joint_error_relay_->close();
+        joint_error_relay_ = std::move(relay);
+    }
+
     // Get Product SN (0x5202)
     std::string get_product_sn() requires std::is_same_v<T, wujihandcpp::device::Hand> {
         py::gil_scoped_release release;
@@ -342,6 +600,14 @@ public:
     template <typename Data>
     static void register_py_interface(py::class_<Wrapper>& py_class, const std::string& name) {
         if constexpr (Data::readable) {
+            batch_readers()[name] = BatchReader{
+                .read_async =
+                    [](Wrapper& wrapper, wujihandcpp::device::Latch& latch,
+                       std::chrono::steady_clock::duration timeout) {
+                        static_cast<T&>(wrapper).template read_async<Data>(latch, timeout);
+                    },
+                .get = [](Wrapper& wrapper) -> py::object { return py::cast(wrapper.get<Data>()); },
+            };
             py_class.def(("read_" + name).c_str(), &Wrapper::read<Data>, py::arg("timeout") = 0.5);
             py_class.def(
                 ("read_" + name + "_async").c_str(), &Wrapper::read_async<Data>,
@@ -349,7 +615,14 @@ public:
             py_class.def(
                 ("read_" + name + "_unchecked").c_str(), &Wrapper::read_async_unchecked<Data>,
                 py::arg("timeout") = 0.5);
-            py_class.def(("get_" + name).c_str(), &Wrapper::get<Data>);
+            if constexpr (std::is_same_v<typename Data::Base, T>)
+                py_class.def(("get_" + name).c_str(), &Wrapper::get<Data>);
+            else
+                py_class.def(
+                    ("get_" + name).c_str(), &Wrapper::get<Data>, py::arg("out") = py::none());
+            py_class.def(
+                ("subscribe_" + name).c_str(), &Wrapper::subscribe<Data>, py::arg("period"),
+                py::arg("callback"), py::keep_alive<0, 1>());
         }
         if constexpr (Data::writable) {
             using V = Data::ValueType;
@@ -383,62 +656,74 @@ public:
     }
 
 private:
-    struct FutureLatch {
-        // Call with GIL
-        static FutureLatch* create(Wrapper& hand, int waiting_count) {
-            return new FutureLatch(hand, waiting_count);
-        }
+    std::shared_ptr<JointErrorRelay> joint_error_relay_; // Hand only, see on_joint_error()
 
-        // Call without GIL
-        template <typename F>
-        void count_down(bool success, const F& make_result) {
-            if (!success)
-                error_count_.fetch_add(1, std::memory_order_relaxed);
-
-            const int old = waiting_count_.fetch_sub(1, std::memory_order_acq_rel);
-            if (old == 1) {
-                // This is the last completion. Safely interact with Python.
-                py::gil_scoped_acquire acquire;
-                const int error_count = error_count_.load(std::memory_order_relaxed);
-                if (error_count) {
-                    py::object timeout_error_type =
-                        py::reinterpret_borrow<py::object>(PyExc_TimeoutError);
-                    call_threadsafe_(
-                        future_.attr("set_exception"),
-                        timeout_error_type(
-                            error_count == 1
-                                ? "Operation timed out while waiting for completion"
-                                : std::format(
-                                      "{} operations timed out while waiting for completion",
-                                      error_count)));
-                } else {
-                    call_threadsafe_(future_.attr("set_result"), make_result(wrapper));
-                }
-                delete this;
-            }
-        }
-
-        py::object& future() { return future_; }
+    // Calls the callback of subscribe<Data>() with one value, on its SubscriptionRelay thread
+    template <typename Data>
+    static void
+        deliver_subscription_value(const py::function& callback, const SubscriptionValue& value) {
+        auto index = value.index;
+        auto scalar = py::numpy_scalar{value.value.as<typename Data::ValueType>()};
+        if constexpr (std::is_same_v<typename Data::Base, T>)
+            callback(scalar);
+        else if constexpr (std::is_same_v<T, wujihandcpp::device::Finger>)
+            callback(index, scalar);
+        else
+            callback(index / 4, index % 4, scalar);
+    }
 
-    private:
-        explicit FutureLatch(Wrapper& hand, int waiting_count)
-            : wrapper(hand)
-            , waiting_count_(waiting_count)
-            , error_count_(0) {
-            py::object loop = py::module::import("asyncio").attr("get_event_loop")();
-            future_ = loop.attr("create_future")();
-            call_threadsafe_ = loop.attr("call_soon_threadsafe");
+    // Resolves the future of a write_async() call with None once all its operations are done
+    class FutureLatch final : public async_completion::Completion {
+    public:
+        // Call with GIL. The caller owns it until the operations are submitted.
+        static std::unique_ptr<FutureLatch> create(int waiting_count) {
+            return std::unique_ptr<FutureLatch>{new FutureLatch(waiting_count)};
         }
 
-        Wrapper& wrapper;
+    private:
+        explicit FutureLatch(int waiting_count)
+            : Completion(waiting_count) {}
 
-        py::object future_;
-        py::object call_threadsafe_;
+        py::object result() override { return py::none(); }
+    };
 
-        std::atomic<int> waiting_count_;
-        std::atomic<int> error_count_;
+    // How read_many() reads one data and gets its value, by name
+    struct BatchReader {
+        void (*read_async)(
+            Wrapper&, wujihandcpp::device::Latch&, std::chrono::steady_clock::duration);
+        py::object (*get)(Wrapper&);
     };
 
+    static std::unordered_map<std::string, BatchReader>& batch_readers() {
+        static std::unordered_map<std::string, BatchReader> readers;
+        return readers;
+    }
+
+    // Validates the shape of a per-joint value array and flattens it in [finger][joint] order,
+    // the layout expected by the bulk DataOperator APIs.
+    template <typename Data>
+    static void copy_value_array(
+        const py::array_t<typename Data::ValueType>& array, typename Data::ValueType* values) {
+        if constexpr (
+            std::is_same_v<T, wujihandcpp::device::Finger>
+            && std::is_same_v<typename Data::Base, wujihandcpp::device::Joint>) {
+            if (array.ndim() != 1 || array.shape()[0] != 4)
+                throw std::runtime_error("Array shape must be {4}!");
+            auto r = array.template unchecked<1>();
+            for (int j = 0; j < 4; j++)
+                values[j] = r(j);
+        } else if constexpr (
+            std::is_same_v<T, wujihandcpp::device::Hand>
+            && std::is_same_v<typename Data::Base, wujihandcpp::device::Joint>) {
+            if (array.ndim() != 2 || array.shape()[0] != 5 || array.shape()[1] != 4)
+                throw std::runtime_error("Array shape must be {5, 4}!");
+            auto r = array.template unchecked<2>();
+            for (int i = 0; i < 5; i++)
+                for (int j = 0; j < 4; j++)
+                    values[4 * i + j] = r(i, j);
+        }
+    }
+
     template <typename Data>
     static constexpr int data_count() {
         if constexpr (std::is_same_v<typename Data::Base, T>)
@@ -452,4 +737,41 @@ private:
             && std::is_same_v<typename Data::Base, wujihandcpp::device::Joint>)
             return 5 * 4;
     }
+
+    // Resolves the future of a read_async() call with the values read, as get_*() would return
+    // them. They are copied as the last read completes, before a later read can change them.
+    template <typename Data>
+    class ReadFutureLatch final : public async_completion::Completion {
+    public:
+        // Call with GIL. The caller owns it until the operations are submitted.
+        static std::unique_ptr<ReadFutureLatch> create(Wrapper& wrapper) {
+            return std::unique_ptr<ReadFutureLatch>{new ReadFutureLatch(wrapper)};
+        }
+
+    private:
+        static constexpr int count = data_count<Data>();
+
+        explicit ReadFutureLatch(Wrapper& wrapper)
+            : Completion(count)
+            , wrapper_(wrapper) {}
+
+        void capture() noexcept override {
+            if constexpr (count == 1)
+                values_[0] = wrapper_.T::template get<Data>();
+            else
+                wrapper_.T::template get_many<Data>(values_.data());
+        }
+
+        py::object result() override {
+            if constexpr (count == 1)
+                return py::cast(py::numpy_scalar{values_[0]});
+            else if constexpr (count == 4)
+                return py::array_t<typename Data::ValueType>({4}, values_.data());
+            else
+                return py::array_t<typename Data::ValueType>({5, 4}, values_.data());
+        }
+
+        Wrapper& wrapper_;
+        std::array<typename Data::ValueType, count> values_{};
+    };
 };
@@ -4,9 +4,22 @@ import sys
 from typing import TYPE_CHECKING, Optional, SupportsIndex
 
 from . import _core
-# `filter` and `logging` are wujihandpy submodules; the same-name shadowing
-# of Python builtins is intentional and part of the public API surface.
-from ._core import Finger, Joint, IController, filter, logging  # noqa: F401, A004
+# `filter`, `logging` and `trace` are wujihandpy submodules; the same-name
+# shadowing of Python builtins is intentional and part of the public API surface.
+from ._core import (  # noqa: F401, A004
+    Finger,
+    IController,
+    Joint,
+    JointErrorEvent,
+    RealtimeLoop,
+    RealtimeStatistics,
+    SdoLatency,
+    Subscription,
+    filter,
+    logging,
+    metrics,
+    trace,
+)
 from ._upgrade_check import trigger_check_in_background
 from ._version import __version__
 
@@ -127,9 +140,16 @@ __all__ = [
     "Hand",
     "Finger",
     "Joint",
+    "JointErrorEvent",
     "IController",
+    "RealtimeLoop",
+    "RealtimeStatistics",
+    "SdoLatency",
+    "Subscription",
     "filter",
     "logging",
+    "metrics",
+    "trace",
 ]
 if _HAS_TACTILE:
     __all__ += [
@@ -1,35 +1,38 @@
 from __future__ import annotations
+import collections.abc
 import sys
 import numpy
 import numpy.typing
 import typing
 from . import filter
 from . import logging
+from . import metrics
+from . import trace
 if sys.platform == 'linux':
     from . import tactile
-    __all__: list[str] = ['Finger', 'Hand', 'IController', 'Joint', 'filter', 'logging', 'tactile']
+    __all__: list[str] = ['Finger', 'Hand', 'IController', 'Joint', 'JointErrorEvent', 'Subscription', 'filter', 'logging', 'metrics', 'tactile', 'trace']
 else:
-    __all__: list[str] = ['Finger', 'Hand', 'IController', 'Joint', 'filter', 'logging']
+    __all__: list[str] = ['Finger', 'Hand', 'IController', 'Joint', 'JointErrorEvent', 'Subscription', 'filter', 'logging', 'metrics', 'trace']
 class Finger:
-    def get_joint_actual_position(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_actual_position(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
-    def get_joint_bus_voltage(self) -> numpy.typing.NDArray[numpy.float32]:
+    def get_joint_bus_voltage(self, out: numpy.typing.NDArray[numpy.float32] | None = None) -> numpy.typing.NDArray[numpy.float32]:
         ...
-    def get_joint_current_limit(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_current_limit(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
-    def get_joint_effort_limit(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_effort_limit(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
-    def get_joint_error_code(self) -> numpy.typing.NDArray[numpy.uint32]:
+    def get_joint_error_code(self, out: numpy.typing.NDArray[numpy.uint32] | None = None) -> numpy.typing.NDArray[numpy.uint32]:
         ...
-    def get_joint_firmware_date(self) -> numpy.typing.NDArray[numpy.uint32]:
+    def get_joint_firmware_date(self, out: numpy.typing.NDArray[numpy.uint32] | None = None) -> numpy.typing.NDArray[numpy.uint32]:
         ...
-    def get_joint_firmware_version(self) -> numpy.typing.NDArray[numpy.uint32]:
+    def get_joint_firmware_version(self, out: numpy.typing.NDArray[numpy.uint32] | None = None) -> numpy.typing.NDArray[numpy.uint32]:
         ...
-    def get_joint_lower_limit(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_lower_limit(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
-    def get_joint_temperature(self) -> numpy.typing.NDArray[numpy.float32]:
+    def get_joint_temperature(self, out: numpy.typing.NDArray[numpy.float32] | None = None) -> numpy.typing.NDArray[numpy.float32]:
         ...
-    def get_joint_upper_limit(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_upper_limit(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
     def joint(self, index: typing.SupportsInt | typing.SupportsIndex) -> Joint:
         ...
@@ -93,6 +96,30 @@ class Finger:
         ...
     def read_joint_upper_limit_unchecked(self, timeout: typing.SupportsFloat = 0.5) -> None:
         ...
+    def read_many(self, names: collections.abc.Sequence[str], timeout: typing.SupportsFloat = 0.5) -> dict[str, typing.Any]:
+        """
+        Read every data in `names` (the read_* suffixes, such as "joint_temperature") in one batch that waits for a single SDO round trip. Returns {name: value}.
+        """
+    def subscribe_joint_actual_position(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_bus_voltage(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, numpy.float32], None]) -> Subscription:
+        ...
+    def subscribe_joint_current_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_effort_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_error_code(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_joint_firmware_date(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_joint_firmware_version(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_joint_lower_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_temperature(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, numpy.float32], None]) -> Subscription:
+        ...
+    def subscribe_joint_upper_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, numpy.float64], None]) -> Subscription:
+        ...
     @typing.overload
     def write_joint_control_mode(self, value: typing.SupportsInt | typing.SupportsIndex, timeout: typing.SupportsFloat = 0.5) -> None:
         ...
@@ -265,8 +292,10 @@ class Hand:
         ...
     def disable_thread_safe_check(self) -> None:
         """
-        Disable thread safety check to allow multi-threaded usage. When disabled, user must ensure thread-safe access using external mutex.
+        Disable the construction-thread check of realtime controller and latency test operations. SDO reads and writes are thread-safe without it. When disabled, user must ensure thread-safe access to those operations using external mutex.
         """
+    def dropped_joint_error_events(self) -> int:
+        ...
     def finger(self, index: typing.SupportsInt | typing.SupportsIndex) -> Finger:
         ...
     def get_firmware_date(self) -> numpy.uint32:
@@ -279,25 +308,25 @@ class Hand:
         ...
     def get_input_voltage(self) -> numpy.float32:
         ...
-    def get_joint_actual_position(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_actual_position(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
-    def get_joint_bus_voltage(self) -> numpy.typing.NDArray[numpy.float32]:
+    def get_joint_bus_voltage(self, out: numpy.typing.NDArray[numpy.float32] | None = None) -> numpy.typing.NDArray[numpy.float32]:
         ...
-    def get_joint_current_limit(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_current_limit(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
-    def get_joint_effort_limit(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_effort_limit(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
-    def get_joint_error_code(self) -> numpy.typing.NDArray[numpy.uint32]:
+    def get_joint_error_code(self, out: numpy.typing.NDArray[numpy.uint32] | None = None) -> numpy.typing.NDArray[numpy.uint32]:
         ...
-    def get_joint_firmware_date(self) -> numpy.typing.NDArray[numpy.uint32]:
+    def get_joint_firmware_date(self, out: numpy.typing.NDArray[numpy.uint32] | None = None) -> numpy.typing.NDArray[numpy.uint32]:
         ...
-    def get_joint_firmware_version(self) -> numpy.typing.NDArray[numpy.uint32]:
+    def get_joint_firmware_version(self, out: numpy.typing.NDArray[numpy.uint32] | None = None) -> numpy.typing.NDArray[numpy.uint32]:
         ...
-    def get_joint_lower_limit(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_lower_limit(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
-    def get_joint_temperature(self) -> numpy.typing.NDArray[numpy.float32]:
+    def get_joint_temperature(self, out: numpy.typing.NDArray[numpy.float32] | None = None) -> numpy.typing.NDArray[numpy.float32]:
         ...
-    def get_joint_upper_limit(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_upper_limit(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
     def get_product_sn(self) -> str:
         """
@@ -307,8 +336,20 @@ class Hand:
         ...
     def get_temperature(self) -> numpy.float32:
         ...
+    def on_joint_error(self, callback: collections.abc.Callable[[JointErrorEvent], None] | None) -> None:
+        """
+        Call `callback(event)` for every joint error event, in order, from a thread of its own, or remove the callback with None.
+        """
+    def poll_joint_error_events(self, max_count: typing.SupportsInt | typing.SupportsIndex = 64) -> list[JointErrorEvent]:
+        """
+        Return pending joint error events, oldest first. Does not block.
+        """
     def raw_sdo_read(self, finger_id: typing.SupportsInt | typing.SupportsIndex, joint_id: typing.SupportsInt | typing.SupportsIndex, index: typing.SupportsInt | typing.SupportsIndex, sub_index: typing.SupportsInt | typing.SupportsIndex, timeout: typing.SupportsFloat = 0.5) -> bytes:
         ...
+    def raw_sdo_read_many(self, finger_id: typing.SupportsInt | typing.SupportsIndex, joint_id: typing.SupportsInt | typing.SupportsIndex, objects: collections.abc.Sequence[tuple[typing.SupportsInt | typing.SupportsIndex, typing.SupportsInt | typing.SupportsIndex]], timeout: typing.SupportsFloat = 0.5) -> list[bytes | None]:
+        """
+        Read many (index, sub_index) objects in one batch. Returns one bytes object per entry, or None for entries that timed out.
+        """
     def raw_sdo_write(self, finger_id: typing.SupportsInt | typing.SupportsIndex, joint_id: typing.SupportsInt | typing.SupportsIndex, index: typing.SupportsInt | typing.SupportsIndex, sub_index: typing.SupportsInt | typing.SupportsIndex, data: bytes, timeout: typing.SupportsFloat = 0.5) -> None:
         ...
     def read_firmware_date(self, timeout: typing.SupportsFloat = 0.5) -> numpy.uint32:
@@ -401,6 +442,10 @@ class Hand:
         ...
     def read_joint_upper_limit_unchecked(self, timeout: typing.SupportsFloat = 0.5) -> None:
         ...
+    def read_many(self, names: collections.abc.Sequence[str], timeout: typing.SupportsFloat = 0.5) -> dict[str, typing.Any]:
+        """
+        Read every data in `names` (the read_* suffixes, such as "joint_temperature") in one batch that waits for a single SDO round trip. Returns {name: value}.
+        """
     def read_system_time(self, timeout: typing.SupportsFloat = 0.5) -> numpy.uint32:
         ...
     def read_system_time_async(self, timeout: typing.SupportsFloat = 0.5) -> typing.Awaitable[numpy.uint32]:
@@ -413,12 +458,74 @@ class Hand:
         ...
     def read_temperature_unchecked(self, timeout: typing.SupportsFloat = 0.5) -> None:
         ...
+    @typing.overload
     def realtime_controller(self, enable_upstream: bool, filter: filter.IFilter) -> IController:
         ...
+    @typing.overload
+    def realtime_controller(self, enable_upstream: bool, step: typing.Any, state: typing.Any = None) -> IController:
+        """
+        Run a native step function `void step(const double* actual, double* target, void* state)` on the PDO thread every control period, without the GIL. `actual` holds the latest 5x4 joint positions (NULL without upstream); `target` holds the previous targets, to be overwritten with the new ones. `step` is a ctypes function pointer, a numba cfunc or an int address; `state` is None, an int address or a writable buffer such as a numpy array, passed as `state`. Both are kept alive until the controller is closed.
+        """
+    def realtime_get_joint_error_code(self, out: numpy.typing.NDArray[numpy.uint32] | None = None) -> numpy.typing.NDArray[numpy.uint32]:
+        """
+        Error codes from the PDO feedback, updated at the PDO rate while a realtime controller with upstream enabled is running.
+        """
+    def realtime_loop(self, rate: typing.SupportsFloat) -> RealtimeLoop:
+        """
+        Iterate at `rate` Hz: every iteration waits for the next tick with the GIL released and yields the latest joint positions from the PDO feedback (only updated while a realtime controller with upstream enabled is attached). An iteration that comes back late starts the next tick right away; once a tick wakes up more than a period late, the ticks it missed are skipped and counted in overrun_count.
+        """
+    def realtime_statistics(self) -> RealtimeStatistics:
+        """
+        Scheduling lateness, step() execution time, RPDO submit time and overruns of the realtime loop since the current (or last) realtime controller was attached.
+        """
+    def sdo_latency(self, finger_id: typing.SupportsInt | typing.SupportsIndex, joint_id: typing.SupportsInt | typing.SupportsIndex = 0) -> SdoLatency:
+        """
+        SDO round-trip latency of joint (finger_id, joint_id), or of the hand-level objects if finger_id is -1. Cumulative since the hand was opened.
+        """
     def start_latency_test(self) -> None:
         ...
+    def start_state_publisher(self, name: str = 'wujihand', capacity: typing.SupportsInt | typing.SupportsIndex = 1024) -> None:
+        """
+        Publish every PDO feedback frame, with a history of `capacity` snapshots, to the shared memory segment `name` (/dev/shm/<name>). Read it from other processes with wujihandpy.shared_state.SharedStateReader. Linux only.
+        """
     def stop_latency_test(self) -> None:
         ...
+    def stop_state_publisher(self) -> None:
+        ...
+    def subscribe_firmware_date(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_firmware_version(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_full_system_firmware_version(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_handedness(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.uint8], None]) -> Subscription:
+        ...
+    def subscribe_input_voltage(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.float32], None]) -> Subscription:
+        ...
+    def subscribe_joint_actual_position(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, int, numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_bus_voltage(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, int, numpy.float32], None]) -> Subscription:
+        ...
+    def subscribe_joint_current_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, int, numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_effort_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, int, numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_error_code(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, int, numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_joint_firmware_date(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, int, numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_joint_firmware_version(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, int, numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_joint_lower_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, int, numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_temperature(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, int, numpy.float32], None]) -> Subscription:
+        ...
+    def subscribe_joint_upper_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[int, int, numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_system_time(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_temperature(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.float32], None]) -> Subscription:
+        ...
     @typing.overload
     def write_joint_control_mode(self, value: typing.SupportsInt | typing.SupportsIndex, timeout: typing.SupportsFloat = 0.5) -> None:
         ...
@@ -552,12 +659,26 @@ class IController:
         ...
     def close(self) -> None:
         ...
-    def get_joint_actual_effort(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_actual_effort(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
-    def get_joint_actual_position(self) -> numpy.typing.NDArray[numpy.float64]:
+    def get_joint_actual_position(self, out: numpy.typing.NDArray[numpy.float64] | None = None) -> numpy.typing.NDArray[numpy.float64]:
         ...
+    def refresh(self) -> None:
+        """
+        Copy the latest feedback into the arrays of joint_actual_position and joint_actual_effort. Does not allocate.
+        """
     def set_joint_target_position(self, value_array: typing.Annotated[numpy.typing.ArrayLike, numpy.float64]) -> None:
         ...
+    @property
+    def joint_actual_effort(self) -> numpy.typing.NDArray[numpy.float64]:
+        """
+        Read-only view of the efforts at the last refresh(). Always the same array.
+        """
+    @property
+    def joint_actual_position(self) -> numpy.typing.NDArray[numpy.float64]:
+        """
+        Read-only view of the positions at the last refresh(). Always the same array.
+        """
 class Joint:
     def get_joint_actual_position(self) -> numpy.float64:
         ...
@@ -639,6 +760,30 @@ class Joint:
         ...
     def read_joint_upper_limit_unchecked(self, timeout: typing.SupportsFloat = 0.5) -> None:
         ...
+    def read_many(self, names: collections.abc.Sequence[str], timeout: typing.SupportsFloat = 0.5) -> dict[str, typing.Any]:
+        """
+        Read every data in `names` (the read_* suffixes, such as "joint_temperature") in one batch that waits for a single SDO round trip. Returns {name: value}.
+        """
+    def subscribe_joint_actual_position(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_bus_voltage(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.float32], None]) -> Subscription:
+        ...
+    def subscribe_joint_current_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_effort_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_error_code(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_joint_firmware_date(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_joint_firmware_version(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.uint32], None]) -> Subscription:
+        ...
+    def subscribe_joint_lower_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.float64], None]) -> Subscription:
+        ...
+    def subscribe_joint_temperature(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.float32], None]) -> Subscription:
+        ...
+    def subscribe_joint_upper_limit(self, period: typing.SupportsFloat, callback: collections.abc.Callable[[numpy.float64], None]) -> Subscription:
+        ...
     def write_joint_control_mode(self, value: typing.SupportsInt | typing.SupportsIndex, timeout: typing.SupportsFloat = 0.5) -> None:
         ...
     def write_joint_control_mode_async(self, value: typing.SupportsInt | typing.SupportsIndex, timeout: typing.SupportsFloat = 0.5) -> typing.Awaitable[None]:
@@ -681,3 +826,130 @@ class Joint:
         ...
     def write_joint_target_position_unchecked(self, value: typing.SupportsFloat | typing.SupportsIndex, timeout: typing.SupportsFloat = 0.5) -> None:
         ...
+class JointErrorEvent:
+    def __repr__(self) -> str:
+        ...
+    @property
+    def cleared_bits(self) -> int:
+        ...
+    @property
+    def descriptions(self) -> list[str]:
+        ...
+    @property
+    def error_code(self) -> int:
+        ...
+    @property
+    def finger(self) -> int:
+        ...
+    @property
+    def joint(self) -> int:
+        ...
+    @property
+    def set_bits(self) -> int:
+        ...
+    @property
+    def timestamp(self) -> float:
+        ...
+class RealtimeLoop:
+    def __iter__(self) -> RealtimeLoop:
+        ...
+    def __next__(self) -> numpy.typing.NDArray[numpy.float64]:
+        """
+        Wait for the next tick, with the GIL released, and return the latest joint positions. Always the same read-only array.
+        """
+    @property
+    def index(self) -> int:
+        """
+        Index of the current tick, counting skipped ticks. The current tick was scheduled index / rate seconds after the first.
+        """
+    @property
+    def joint_actual_position(self) -> numpy.typing.NDArray[numpy.float64]:
+        """
+        The array returned by every iteration.
+        """
+    @property
+    def lateness(self) -> float:
+        """
+        Seconds between the scheduled time of the current tick and the wakeup.
+        """
+    @property
+    def overrun_count(self) -> int:
+        """
+        Ticks skipped because a tick woke up more than one period late. A loop body that runs past its period delays the following ticks instead.
+        """
+    @property
+    def rate(self) -> float:
+        ...
+class RealtimeStatistics:
+    class Distribution:
+        def __repr__(self) -> str:
+            ...
+        @property
+        def max_ns(self) -> int:
+            ...
+        @property
+        def mean_ns(self) -> int:
+            ...
+        @property
+        def p50_ns(self) -> int:
+            ...
+        @property
+        def p99_ns(self) -> int:
+            ...
+    def __repr__(self) -> str:
+        ...
+    @property
+    def lateness(self) -> RealtimeStatistics.Distribution:
+        ...
+    @property
+    def overrun_count(self) -> int:
+        ...
+    @property
+    def period_ns(self) -> int:
+        ...
+    @property
+    def step(self) -> RealtimeStatistics.Distribution:
+        ...
+    @property
+    def submit(self) -> RealtimeStatistics.Distribution:
+        ...
+    @property
+    def tick_count(self) -> int:
+        ...
+class SdoLatency:
+    def __repr__(self) -> str:
+        ...
+    @property
+    def count(self) -> int:
+        ...
+    @property
+    def max_ns(self) -> int:
+        ...
+    @property
+    def mean_ns(self) -> int:
+        ...
+    @property
+    def mean_queue_ns(self) -> int:
+        ...
+    @property
+    def p50_ns(self) -> int:
+        ...
+    @property
+    def p90_ns(self) -> int:
+        ...
+    @property
+    def p99_ns(self) -> int:
+        ...
+    @property
+    def timeout_count(self) -> int:
+        ...
+class Subscription:
+    def __enter__(self) -> Subscription:
+        ...
+    def __exit__(self, arg0: typing.Any, arg1: typing.Any, arg2: typing.Any) -> None:
+        ...
+    def unsubscribe(self) -> None:
+        ...
+    @property
+    def active(self) -> bool:
+        ...
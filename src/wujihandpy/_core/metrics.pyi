@@ -0,0 +1,11 @@
+from __future__ import annotations
+import typing
+__all__: list[str] = ['prometheus_text', 'snapshot', 'start_exporter', 'stop_exporter']
+def prometheus_text() -> str:
+    ...
+def snapshot() -> list[dict[str, typing.Any]]:
+    ...
+def start_exporter(target: str, period: float = 10.0) -> None:
+    ...
+def stop_exporter() -> None:
+    ...
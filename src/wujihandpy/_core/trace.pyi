@@ -0,0 +1,8 @@
+from __future__ import annotations
+__all__: list[str] = ['dump', 'set_enabled', 'set_spans_enabled']
+def dump(path: str) -> None:
+    ...
+def set_enabled(value: bool) -> None:
+    ...
+def set_spans_enabled(value: bool) -> None:
+    ...
@@ -0,0 +1,180 @@
+"""Reader for hand state published to shared memory by ``Hand.start_state_publisher``.
+
+The publishing process writes every PDO feedback frame into a POSIX shared
+memory segment (``/dev/shm/<name>``): a header followed by a ring of the most
+recent snapshots, each guarded by its own seqlock. Any number of processes on
+the same machine can read it without talking to the publisher::
+
+    # Process owning the hand
+    hand.start_state_publisher("wujihand")
+
+    # Any other process
+    from wujihandpy.shared_state import SharedStateReader
+    reader = SharedStateReader("wujihand")
+    state = reader.read_latest()
+    if state is not None:
+        print(state["sequence"], state["position"])
+
+Snapshots are numpy records with the fields of ``HAND_STATE_DTYPE``. For
+copy-free access, ``reader.slots`` is a read-only structured array mapped over
+the whole ring; a slot is consistent while its ``lock`` equals twice its
+``state["sequence"]`` both before and after the read.
+
+The layout mirrors wujihandcpp/include/wujihandcpp/utility/shared_state.hpp.
+Only numpy and the standard library are used, so this file also works on its
+own on a machine without the native wujihandpy module. Linux only.
+"""
+
+from __future__ import annotations
+
+import mmap
+import os
+from typing import Optional
+
+import numpy
+
+MAGIC = 0x0045544154534A57  # "WJSTATE\0"
+VERSION = 1
+
+HAS_EFFORT_AND_ERROR_CODE = 1 << 0
+
+# A write takes well under a microsecond, far less than this many failed attempts
+_MAX_READ_ATTEMPTS = 1000
+
+HEADER_DTYPE = numpy.dtype(
+    {
+        "names": [
+            "magic",
+            "version",
+            "header_size",
+            "slot_size",
+            "capacity",
+            "publisher_pid",
+            "publishing",
+            "head",
+        ],
+        "formats": ["<u8", "<u4", "<u4", "<u4", "<u4", "<u4", "<u4", "<u8"],
+        "offsets": [0, 8, 12, 16, 20, 24, 28, 32],
+        "itemsize": 64,
+    }
+)
+
+HAND_STATE_DTYPE = numpy.dtype(
+    [
+        ("sequence", "<u8"),
+        ("steady_time_ns", "<u8"),
+        ("system_time_ns", "<u8"),
+        ("flags", "<u4"),
+        ("reserved", "<u4"),
+        ("position", "<f8", (5, 4)),
+        ("effort", "<f8", (5, 4)),
+        ("error_code", "<u4", (5, 4)),
+    ]
+)
+
+SLOT_DTYPE = numpy.dtype(
+    {
+        "names": ["lock", "state"],
+        "formats": ["<u8", HAND_STATE_DTYPE],
+        "offsets": [0, 8],
+        "itemsize": 448,
+    }
+)
+
+assert HEADER_DTYPE.itemsize == 64 and HAND_STATE_DTYPE.itemsize == 432
+
+
+def _path(name: str) -> str:
+    return "/dev/shm/" + name.lstrip("/")
+
+
+class SharedStateReader:
+    """Read-only view of a published segment.
+
+    A publisher that restarts creates a new segment under the same name; this
+    reader keeps the old one, whose ``publishing`` turns False. Open a new
+    reader then.
+    """
+
+    def __init__(self, name: str = "wujihand") -> None:
+        path = _path(name)
+        with open(path, "rb") as file:
+            size = os.fstat(file.fileno()).st_size
+            if size < HEADER_DTYPE.itemsize:
+                raise ValueError(f"shared state {path} is truncated")
+            self._mapping = mmap.mmap(file.fileno(), size, access=mmap.ACCESS_READ)
+
+        self._header = numpy.ndarray((), HEADER_DTYPE, buffer=self._mapping)
+        header = self._header
+        capacity = int(header["capacity"])
+        if (
+            int(header["magic"]) != MAGIC
+            or int(header["version"]) != VERSION
+            or int(header["header_size"]) != HEADER_DTYPE.itemsize
+            or int(header["slot_size"]) != SLOT_DTYPE.itemsize
+            or capacity == 0
+            or capacity & (capacity - 1)
+            or size < HEADER_DTYPE.itemsize + capacity * SLOT_DTYPE.itemsize
+        ):
+            raise ValueError(
+                f"shared state {path} has an unsupported layout "
+                f"(version {int(header['version'])})"
+            )
+
+        self.slots = numpy.ndarray(
+            (capacity,), SLOT_DTYPE, buffer=self._mapping, offset=HEADER_DTYPE.itemsize
+        )
+        self._locks = self.slots["lock"]
+
+    @property
+    def capacity(self) -> int:
+        return len(self.slots)
+
+    @property
+    def head(self) -> int:
+        """Sequence number of the newest snapshot, 0 if none was published yet."""
+        return int(self._header["head"])
+
+    @property
+    def publishing(self) -> bool:
+        return bool(self._header["publishing"])
+
+    @property
+    def publisher_pid(self) -> int:
+        return int(self._header["publisher_pid"])
+
+    def read(self, sequence: int) -> Optional[numpy.void]:
+        """Copy of the snapshot with the given sequence number, or None if it is
+        not published yet, was overwritten or is being overwritten right now."""
+        if sequence <= 0 or sequence > self.head:
+            return None
+        index = (sequence - 1) & (self.capacity - 1)
+        if int(self._locks[index]) != 2 * sequence:
+            return None
+        state = self.slots[index]["state"].copy()
+        if int(self._locks[index]) != 2 * sequence:
+            return None
+        return state
+
+    def read_latest(self) -> Optional[numpy.void]:
+        """Copy of the newest snapshot, or None if none was published yet or if
+        a bounded number of attempts all failed (a publisher that died while
+        writing leaves its slot locked for good)."""
+        for _ in range(_MAX_READ_ATTEMPTS):
+            sequence = self.head
+            if sequence == 0:
+                return None
+            state = self.read(sequence)
+            if state is not None:
+                return state
+        return None
+
+    def close(self) -> None:
+        del self.slots, self._locks, self._header
+        self._mapping.close()
+
+    def __enter__(self) -> SharedStateReader:
+        return self
+
+    def __exit__(self, *exc_info) -> None:
+        self.close()
@@ -0,0 +1,354 @@
+"""Offline decoder for wujihandcpp trace dumps (``*.wjtrace``).
+
+The SDK keeps the recent hot-path events of every thread in binary ring buffers
+and writes them out on ``wujihandpy.trace.dump(path)`` or on transport and frame
+parsing errors (next to the log files). This module turns a dump into readable
+text or Chrome trace-event JSON (chrome://tracing, https://ui.perfetto.dev).
+
+In span mode (``WUJI_TRACE_SPANS=1`` or ``wujihandpy.trace.set_spans_enabled``)
+the dump also holds begin and end records of the USB receive callback, the SDO
+and PDO ticks, the tactile reader and the user callbacks; the Chrome output
+shows them as nested slices on each thread's timeline.
+
+Usage::
+
+    python -m wujihandpy.trace_decoder dump.wjtrace
+    python -m wujihandpy.trace_decoder dump.wjtrace --format chrome -o trace.json
+
+Only the standard library is used, so this file also works on its own on a
+machine without wujihandpy installed.
+"""
+
+from __future__ import annotations
+
+import argparse
+import datetime
+import json
+import struct
+import sys
+from typing import IO, Dict, Iterator, List, NamedTuple, Optional, Sequence
+
+MAGIC = b"WJTRACE\0"
+VERSION = 1
+
+_FILE_HEADER = struct.Struct("<8sIIQQII")
+_THREAD_HEADER = struct.Struct("<II16s")
+_RECORD = struct.Struct("<QHHIQQ")
+
+# Event ids, mirroring wujihandcpp/src/trace/trace.hpp.
+SDO_SUBMIT = 1
+SDO_COMPLETE = 2
+RAW_SDO_SUBMIT = 3
+RAW_SDO_COMPLETE = 4
+PDO_TICK = 5
+USB_SUBMIT = 6
+USB_COMPLETE = 7
+TACTILE_FRAME = 8
+TRANSPORT_ERROR = 9
+RX_PARSE_ERROR = 10
+SPAN_BEGIN = 11
+SPAN_END = 12
+
+EVENTS = {
+    SDO_SUBMIT: "sdo_submit",
+    SDO_COMPLETE: "sdo_complete",
+    RAW_SDO_SUBMIT: "raw_sdo_submit",
+    RAW_SDO_COMPLETE: "raw_sdo_complete",
+    PDO_TICK: "pdo_tick",
+    USB_SUBMIT: "usb_submit",
+    USB_COMPLETE: "usb_complete",
+    TACTILE_FRAME: "tactile_frame",
+    TRANSPORT_ERROR: "transport_error",
+    RX_PARSE_ERROR: "rx_parse_error",
+    SPAN_BEGIN: "span_begin",
+    SPAN_END: "span_end",
+}
+
+# Span ids, mirroring Span in wujihandcpp/src/trace/trace.hpp.
+SPANS = {
+    1: "usb_receive",
+    2: "sdo_tick",
+    3: "pdo_step",
+    4: "pdo_submit",
+    5: "tactile_frame",
+    6: "tactile_callback",
+    7: "sdo_callback",
+    8: "subscription_callback",
+    9: "joint_error_callback",
+}
+
+_USB_RECEIVE = 1
+_SDO_CALLBACK = 7
+_SUBSCRIPTION_CALLBACK = 8
+_JOINT_ERROR_CALLBACK = 9
+
+_PARSE_ERRORS = [
+    "truncated",
+    "invalid_header_type",
+    "invalid_sdo_command",
+    "unknown_sdo_object",
+    "invalid_pdo_read_id",
+]
+
+
+class Record(NamedTuple):
+    timestamp: int  # steady clock, ns
+    event: int
+    a: int
+    b: int
+    c: int
+    d: int
+
+
+class Thread(NamedTuple):
+    thread_id: int
+    name: str
+    records: List[Record]
+
+
+class TraceDump(NamedTuple):
+    steady_time_ns: int
+    system_time_ns: int
+    process_id: int
+    threads: List[Thread]
+
+
+def read_dump(data: bytes) -> TraceDump:
+    """Parses the contents of a dump file. Raises ValueError if it is malformed."""
+    if len(data) < _FILE_HEADER.size:
+        raise ValueError("trace dump truncated: missing file header")
+    magic, version, record_size, steady_ns, system_ns, pid, thread_count = (
+        _FILE_HEADER.unpack_from(data, 0)
+    )
+    if magic != MAGIC:
+        raise ValueError("not a wujihandcpp trace dump")
+    if version != VERSION or record_size != _RECORD.size:
+        raise ValueError(
+            f"unsupported trace dump version {version} (record size {record_size})"
+        )
+
+    offset = _FILE_HEADER.size
+    threads = []
+    for _ in range(thread_count):
+        if len(data) < offset + _THREAD_HEADER.size:
+            raise ValueError("trace dump truncated: missing thread header")
+        thread_id, record_count, raw_name = _THREAD_HEADER.unpack_from(data, offset)
+        offset += _THREAD_HEADER.size
+
+        end = offset + record_count * _RECORD.size
+        if len(data) < end:
+            raise ValueError("trace dump truncated: missing records")
+        records = [Record(*fields) for fields in _RECORD.iter_unpack(data[offset:end])]
+        offset = end
+
+        name = raw_name.split(b"\0", 1)[0].decode("utf-8", "replace")
+        threads.append(Thread(thread_id, name, records))
+
+    return TraceDump(steady_ns, system_ns, pid, threads)
+
+
+def describe(record: Record) -> str:
+    """Human-readable arguments of one record."""
+    event, a, b, c, d = record.event, record.a, record.b, record.c, record.d
+    if event == SDO_SUBMIT:
+        return f"storage={b} mode={'write' if a else 'read'}"
+    if event == SDO_COMPLETE:
+        return f"storage={b} success={bool(a)}"
+    if event == RAW_SDO_SUBMIT:
+        return f"object=0x{b >> 8:04X}.{b & 0xFF} mode={'write' if a else 'read'}"
+    if event == RAW_SDO_COMPLETE:
+        return f"object=0x{b >> 8:04X}.{b & 0xFF} success={bool(a)}"
+    if event == PDO_TICK:
+        return f"frame={b} lateness={c / 1000:.1f}us"
+    if event == USB_SUBMIT:
+        return f"endpoint=0x{a:02X} length={b} transfer=0x{c:x}"
+    if event == USB_COMPLETE:
+        return f"endpoint=0x{a:02X} length={b} transfer=0x{c:x} status={d}"
+    if event == TACTILE_FRAME:
+        return f"hand={a} sequence={b} device_time={c}ms"
+    if event == RX_PARSE_ERROR:
+        error = _PARSE_ERRORS[a] if a < len(_PARSE_ERRORS) else str(a)
+        return f"error={error} offset={b}"
+    if event == TRANSPORT_ERROR:
+        return ""
+    if event == SPAN_BEGIN:
+        return f"span={span_name(a)} {_span_detail(a, b)}".rstrip()
+    if event == SPAN_END:
+        return f"span={span_name(a)}"
+    return f"a={a} b={b} c={c} d={d}"
+
+
+def span_name(span: int) -> str:
+    return SPANS.get(span, f"span_{span}")
+
+
+def _span_detail(span: int, detail: int) -> str:
+    if span == _USB_RECEIVE:
+        return f"length={detail}"
+    if span in (_SDO_CALLBACK, _SUBSCRIPTION_CALLBACK):
+        return f"storage={detail}"
+    if span == _JOINT_ERROR_CALLBACK:
+        return f"finger={detail >> 8} joint={detail & 0xFF}"
+    return ""
+
+
+def _merged(dump: TraceDump) -> List[tuple]:
+    merged = [(record, thread) for thread in dump.threads for record in thread.records]
+    merged.sort(key=lambda item: item[0].timestamp)
+    return merged
+
+
+def format_text(dump: TraceDump) -> Iterator[str]:
+    """Yields one line per record, across all threads, in time order."""
+    for record, thread in _merged(dump):
+        wall_ns = dump.system_time_ns + record.timestamp - dump.steady_time_ns
+        wall = datetime.datetime.fromtimestamp(wall_ns // 1_000_000_000)
+        name = EVENTS.get(record.event, f"event_{record.event}")
+        yield (
+            f"{wall:%Y-%m-%d %H:%M:%S}.{wall_ns % 1_000_000_000:09d} "
+            f"[{thread.thread_id} {thread.name}] {name} {describe(record)}"
+        ).rstrip()
+
+
+def to_chrome_trace(dump: TraceDump) -> Dict:
+    """Converts a dump to the Chrome trace-event format.
+
+    Every record becomes an instant event. SDO operations, raw SDO operations
+    and USB transfers also become async spans from submit to completion. Span
+    mode records become duration slices on their thread instead; an end whose
+    begin was overwritten in the ring buffer is dropped, and a begin without an
+    end is closed at the thread's last record.
+    """
+    merged = _merged(dump)
+    origin = merged[0][0].timestamp if merged else 0
+    pid = dump.process_id
+
+    events: List[Dict] = []
+    for thread in dump.threads:
+        events.append(
+            {
+                "ph": "M",
+                "name": "thread_name",
+                "pid": pid,
+                "tid": thread.thread_id,
+                "args": {"name": thread.name or str(thread.thread_id)},
+            }
+        )
+
+    open_spans: Dict[int, List[int]] = {thread.thread_id: [] for thread in dump.threads}
+    last_ts: Dict[int, float] = {}
+
+    for record, thread in merged:
+        ts = (record.timestamp - origin) / 1000
+        last_ts[thread.thread_id] = ts
+
+        if record.event in (SPAN_BEGIN, SPAN_END):
+            stack = open_spans[thread.thread_id]
+            if record.event == SPAN_BEGIN:
+                stack.append(record.a)
+                slice_event = _slice("B", record.a, ts, pid, thread.thread_id)
+                slice_event["cat"] = "span"
+                detail = _span_detail(record.a, record.b)
+                if detail:
+                    slice_event["args"] = {"detail": detail}
+                events.append(slice_event)
+            elif record.a in stack:
+                # Spans nested inside this one whose end records were lost end with it
+                while True:
+                    open_span = stack.pop()
+                    events.append(_slice("E", open_span, ts, pid, thread.thread_id))
+                    if open_span == record.a:
+                        break
+            continue
+
+        name = EVENTS.get(record.event, f"event_{record.event}")
+        events.append(
+            {
+                "ph": "i",
+                "s": "t",
+                "name": name,
+                "ts": ts,
+                "pid": pid,
+                "tid": thread.thread_id,
+                "args": {"detail": describe(record)},
+            }
+        )
+
+        span = _span(record)
+        if span is not None:
+            phase, category, async_name, span_id = span
+            events.append(
+                {
+                    "ph": phase,
+                    "cat": category,
+                    "name": async_name,
+                    "id": span_id,
+                    "ts": ts,
+                    "pid": pid,
+                    "tid": thread.thread_id,
+                }
+            )
+
+    for thread_id, stack in open_spans.items():
+        while stack:
+            events.append(_slice("E", stack.pop(), last_ts[thread_id], pid, thread_id))
+
+    origin_system_ns = dump.system_time_ns + origin - dump.steady_time_ns
+    return {
+        "traceEvents": events,
+        "displayTimeUnit": "ns",
+        "otherData": {"system_time_ns_at_origin": origin_system_ns},
+    }
+
+
+def _slice(phase: str, span: int, ts: float, pid: int, tid: int) -> Dict:
+    return {"ph": phase, "name": span_name(span), "ts": ts, "pid": pid, "tid": tid}
+
+
+def _span(record: Record) -> Optional[tuple]:
+    event, a, b, c = record.event, record.a, record.b, record.c
+    if event in (SDO_SUBMIT, SDO_COMPLETE):
+        phase = "b" if event == SDO_SUBMIT else "e"
+        return phase, "sdo", f"sdo storage {b}", f"sdo:{b}"
+    if event in (RAW_SDO_SUBMIT, RAW_SDO_COMPLETE):
+        phase = "b" if event == RAW_SDO_SUBMIT else "e"
+        return phase, "raw_sdo", f"raw sdo 0x{b >> 8:04X}.{b & 0xFF}", f"raw_sdo:{b}"
+    if event in (USB_SUBMIT, USB_COMPLETE):
+        phase = "b" if event == USB_SUBMIT else "e"
+        direction = "in" if a & 0x80 else "out"
+        return phase, "usb", f"usb {direction}", f"usb:{c:x}"
+    return None
+
+
+def main(argv: Optional[Sequence[str]] = None) -> int:
+    parser = argparse.ArgumentParser(
+        prog="python -m wujihandpy.trace_decoder",
+        description="Decode a wujihandcpp trace dump (*.wjtrace).",
+    )
+    parser.add_argument("dump", help="trace dump file")
+    parser.add_argument("--format", choices=("text", "chrome"), default="text")
+    parser.add_argument("-o", "--output", help="output file (default: stdout)")
+    args = parser.parse_args(argv)
+
+    with open(args.dump, "rb") as file:
+        try:
+            dump = read_dump(file.read())
+        except ValueError as ex:
+            print(f"{args.dump}: {ex}", file=sys.stderr)
+            return 1
+
+    output: IO[str] = open(args.output, "w") if args.output else sys.stdout
+    try:
+        if args.format == "chrome":
+            json.dump(to_chrome_trace(dump), output)
+        else:
+            for line in format_text(dump):
+                output.write(line + "\n")
+    finally:
+        if output is not sys.stdout:
+            output.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
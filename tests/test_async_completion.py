@@ -0,0 +1,141 @@
+"""Tests for the delivery of *_async results to asyncio futures.
+
+`_core._async_completion.complete_later` completes operations from a thread
+of its own, as the SDO thread does, so no hardware is needed. It is a test-only
+hook, built into the extension with `-DWUJIHANDPY_TESTING=ON`.
+"""
+
+from __future__ import annotations
+
+import asyncio
+import sys
+import time
+
+import pytest
+
+from wujihandpy import _core
+
+if not hasattr(_core, "_async_completion"):
+    pytest.skip(
+        "extension built without -DWUJIHANDPY_TESTING=ON",
+        allow_module_level=True,
+    )
+
+complete_later = _core._async_completion.complete_later
+
+
+@pytest.fixture
+def unraisable(monkeypatch):
+    """Collects the exceptions discarded as unraisable."""
+    collected = []
+    monkeypatch.setattr(sys, "unraisablehook", collected.append)
+    return collected
+
+
+class CountingLoop(asyncio.SelectorEventLoop):
+    """Records the file descriptors it is asked to watch."""
+
+    def __init__(self):
+        super().__init__()
+        self.readers = []
+
+    def add_reader(self, fd, callback, *args):
+        self.readers.append(fd)
+        super().add_reader(fd, callback, *args)
+
+
+class NoReaderLoop(asyncio.SelectorEventLoop):
+    """Cannot watch file descriptors, like the proactor loop."""
+
+    def add_reader(self, fd, callback, *args):
+        raise NotImplementedError
+
+
+def run(loop, coroutine):
+    try:
+        return loop.run_until_complete(coroutine)
+    finally:
+        loop.close()
+
+
+async def burst(count, **kwargs):
+    futures = complete_later(count, **kwargs)
+    order = []
+    for future in futures:
+        future.add_done_callback(lambda future: order.append(future.result()))
+    results = await asyncio.gather(*futures)
+    return results, order
+
+
+def test_burst_resolves_every_future_in_completion_order(unraisable):
+    results, order = asyncio.run(burst(1000, delay=0.05))
+    assert results == list(range(1000))
+    assert order == list(range(1000))
+    assert unraisable == []
+
+
+@pytest.mark.skipif(not sys.platform.startswith("linux"), reason="eventfd is Linux-only")
+def test_loop_watches_one_eventfd_for_all_completions():
+    loop = CountingLoop()
+
+    async def main():
+        first, _ = await burst(100)
+        second, _ = await burst(100, delay=0.01)
+        return first + second
+
+    assert run(loop, main()) == list(range(100)) * 2
+    assert len(loop.readers) == 1
+
+
+def test_loop_without_add_reader_falls_back_to_call_soon_threadsafe(unraisable):
+    results, order = run(NoReaderLoop(), burst(200, delay=0.02))
+    assert results == list(range(200))
+    assert order == list(range(200))
+    assert unraisable == []
+
+
+def test_failed_operations_raise_timeout_error():
+    async def main():
+        return await asyncio.gather(
+            *complete_later(3, failure_count=2), return_exceptions=True
+        )
+
+    first, second, third = asyncio.run(main())
+    assert isinstance(first, TimeoutError)
+    assert isinstance(second, TimeoutError)
+    assert third == 2
+
+
+@pytest.mark.parametrize("make_loop", [asyncio.new_event_loop, NoReaderLoop])
+@pytest.mark.parametrize("completed_first", [False, True])
+def test_cancelled_futures_are_skipped(make_loop, completed_first, unraisable):
+    async def main():
+        if completed_first:
+            # Cancel once every operation has completed, before the loop delivers
+            futures = complete_later(500)
+            time.sleep(0.1)
+        else:
+            futures = complete_later(500, delay=0.02)
+        for future in futures[::2]:
+            future.cancel()
+        await asyncio.gather(*futures, return_exceptions=True)
+        return futures
+
+    futures = run(make_loop(), main())
+    for index, future in enumerate(futures):
+        if index % 2 == 0:
+            assert future.cancelled()
+        else:
+            assert future.result() == index
+    assert unraisable == []
+
+
+def test_completions_after_loop_closed_are_dropped():
+    loop = asyncio.new_event_loop()
+
+    async def start():
+        return complete_later(100, delay=0.1)
+
+    futures = run(loop, start())
+    time.sleep(0.3)
+    assert not any(future.done() for future in futures)
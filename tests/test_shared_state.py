@@ -0,0 +1,121 @@
+"""Tests for wujihandpy.shared_state."""
+
+from __future__ import annotations
+
+import os
+
+import numpy
+import pytest
+
+from wujihandpy.shared_state import (
+    HAS_EFFORT_AND_ERROR_CODE,
+    HEADER_DTYPE,
+    MAGIC,
+    SLOT_DTYPE,
+    SharedStateReader,
+)
+
+pytestmark = pytest.mark.skipif(not os.path.isdir("/dev/shm"), reason="needs /dev/shm")
+
+
+class FakePublisher:
+    """Writes segments the way wujihandcpp's StatePublisher does."""
+
+    def __init__(self, name, capacity):
+        self.path = "/dev/shm/" + name
+        self.capacity = capacity
+        size = HEADER_DTYPE.itemsize + capacity * SLOT_DTYPE.itemsize
+        self.data = numpy.zeros(size, numpy.uint8)
+        self.header = self.data[: HEADER_DTYPE.itemsize].view(HEADER_DTYPE)[0]
+        self.slots = self.data[HEADER_DTYPE.itemsize :].view(SLOT_DTYPE)
+        self.header["magic"] = MAGIC
+        self.header["version"] = 1
+        self.header["header_size"] = HEADER_DTYPE.itemsize
+        self.header["slot_size"] = SLOT_DTYPE.itemsize
+        self.header["capacity"] = capacity
+        self.header["publisher_pid"] = os.getpid()
+        self.header["publishing"] = 1
+        self.flush()
+
+    def publish(self, sequence, position):
+        slot = self.slots[(sequence - 1) % self.capacity]
+        slot["lock"] = 2 * sequence
+        slot["state"]["sequence"] = sequence
+        slot["state"]["flags"] = HAS_EFFORT_AND_ERROR_CODE
+        slot["state"]["position"] = position
+        slot["state"]["error_code"] = numpy.arange(20).reshape(5, 4)
+        self.header["head"] = sequence
+        self.flush()
+
+    def flush(self):
+        with open(self.path, "wb") as file:
+            file.write(self.data.tobytes())
+
+
+@pytest.fixture
+def publisher():
+    name = f"wujihand-pytest-{os.getpid()}"
+    fake = FakePublisher(name, 4)
+    yield name, fake
+    os.unlink(fake.path)
+
+
+def test_dtypes_match_the_cpp_layout():
+    assert HEADER_DTYPE.itemsize == 64
+    assert SLOT_DTYPE.itemsize == 448
+    assert SLOT_DTYPE.fields["state"][0].fields["position"][1] == 32
+    assert SLOT_DTYPE.fields["state"][0].fields["error_code"][1] == 352
+
+
+def test_reads_latest_and_history(publisher):
+    name, fake = publisher
+    for sequence in range(1, 7):
+        fake.publish(sequence, float(sequence))
+
+    with SharedStateReader(name) as reader:
+        assert reader.capacity == 4
+        assert reader.publishing
+        assert reader.publisher_pid == os.getpid()
+        assert reader.head == 6
+
+        latest = reader.read_latest()
+        assert latest["sequence"] == 6
+        assert latest["position"].shape == (5, 4)
+        assert (latest["position"] == 6.0).all()
+        assert latest["error_code"][2, 1] == 9
+
+        assert reader.read(3)["position"][0, 0] == 3.0
+        assert reader.read(2) is None  # Overwritten
+        assert reader.read(7) is None  # Not published yet
+
+        # Copy-free view over the ring
+        assert reader.slots["state"]["position"].shape == (4, 5, 4)
+
+
+def test_empty_segment_has_no_snapshot(publisher):
+    name, _ = publisher
+    with SharedStateReader(name) as reader:
+        assert reader.read_latest() is None
+
+
+def test_rejects_foreign_segment(publisher):
+    name, fake = publisher
+    fake.header["version"] = 2
+    fake.flush()
+    with pytest.raises(ValueError):
+        SharedStateReader(name)
+
+
+def test_missing_segment_raises():
+    with pytest.raises(FileNotFoundError):
+        SharedStateReader("wujihand-pytest-missing")
+
+
+def test_read_latest_gives_up_on_slot_left_locked(publisher):
+    name, fake = publisher
+    fake.publish(1, 1.0)
+    # The publisher died while writing snapshot 5 into the slot of snapshot 1
+    fake.slots[0]["lock"] = 2 * 5 + 1
+    fake.flush()
+    with SharedStateReader(name) as reader:
+        assert reader.read_latest() is None
@@ -0,0 +1,178 @@
+"""Tests for wujihandpy.trace_decoder."""
+
+from __future__ import annotations
+
+import json
+import struct
+
+import pytest
+
+from wujihandpy.trace_decoder import (
+    PDO_TICK,
+    SDO_COMPLETE,
+    SDO_SUBMIT,
+    SPAN_BEGIN,
+    SPAN_END,
+    USB_COMPLETE,
+    USB_SUBMIT,
+    format_text,
+    main,
+    read_dump,
+    to_chrome_trace,
+)
+
+STEADY_NS = 5_000_000_000
+SYSTEM_NS = 1_700_000_000_000_000_000
+
+
+def make_dump(threads, magic=b"WJTRACE\0", version=1):
+    data = struct.pack("<8sIIQQII", magic, version, 32, STEADY_NS, SYSTEM_NS, 1234, len(threads))
+    for thread_id, name, records in threads:
+        data += struct.pack("<II16s", thread_id, len(records), name)
+        for record in records:
+            data += struct.pack("<QHHIQQ", *record)
+    return data
+
+
+SAMPLE = make_dump(
+    [
+        (
+            10,
+            b"wuji-sdo",
+            [
+                (STEADY_NS - 3000, SDO_SUBMIT, 0, 7, 0, 0),
+                (STEADY_NS - 1000, SDO_COMPLETE, 1, 7, 0, 0),
+            ],
+        ),
+        (
+            11,
+            b"wuji-usb",
+            [
+                (STEADY_NS - 2500, USB_SUBMIT, 0x01, 64, 0xBEEF, 0),
+                (STEADY_NS - 2000, USB_COMPLETE, 0x01, 64, 0xBEEF, 0),
+                (STEADY_NS - 1500, PDO_TICK, 0, 42, 2500, 0),
+            ],
+        ),
+    ]
+)
+
+
+def test_read_dump():
+    dump = read_dump(SAMPLE)
+    assert dump.process_id == 1234
+    assert [(t.thread_id, t.name, len(t.records)) for t in dump.threads] == [
+        (10, "wuji-sdo", 2),
+        (11, "wuji-usb", 3),
+    ]
+    assert dump.threads[1].records[0].c == 0xBEEF
+
+
+def test_read_dump_rejects_bad_magic():
+    with pytest.raises(ValueError):
+        read_dump(make_dump([], magic=b"NOTTRACE"))
+
+
+def test_read_dump_rejects_unknown_version():
+    with pytest.raises(ValueError):
+        read_dump(make_dump([], version=2))
+
+
+def test_read_dump_rejects_truncated_records():
+    with pytest.raises(ValueError):
+        read_dump(SAMPLE[:-1])
+
+
+def test_format_text_merges_threads_in_time_order():
+    lines = list(format_text(read_dump(SAMPLE)))
+    assert len(lines) == 5
+    assert "[10 wuji-sdo] sdo_submit storage=7 mode=read" in lines[0]
+    assert "[11 wuji-usb] usb_submit endpoint=0x01 length=64" in lines[1]
+    assert "pdo_tick frame=42 lateness=2.5us" in lines[3]
+    assert "sdo_complete storage=7 success=True" in lines[4]
+
+
+def test_to_chrome_trace_pairs_spans():
+    events = to_chrome_trace(read_dump(SAMPLE))["traceEvents"]
+    names = [e for e in events if e["ph"] == "M"]
+    assert {e["args"]["name"] for e in names} == {"wuji-sdo", "wuji-usb"}
+
+    spans = [(e["ph"], e["id"], e["ts"]) for e in events if e["ph"] in ("b", "e")]
+    assert spans == [
+        ("b", "sdo:7", 0.0),
+        ("b", "usb:beef", 0.5),
+        ("e", "usb:beef", 1.0),
+        ("e", "sdo:7", 2.0),
+    ]
+
+
+SPAN_SAMPLE = make_dump(
+    [
+        (
+            20,
+            b"wuji-pdo",
+            [
+                (STEADY_NS - 9000, SPAN_END, 4, 0, 0, 0),  # Begin lost to the ring buffer
+                (STEADY_NS - 8000, SPAN_BEGIN, 3, 0, 0, 0),
+                (STEADY_NS - 7000, SPAN_END, 3, 0, 0, 0),
+                (STEADY_NS - 6000, SPAN_BEGIN, 4, 0, 0, 0),
+                (STEADY_NS - 5000, PDO_TICK, 0, 43, 1000, 0),
+                (STEADY_NS - 4000, SPAN_END, 4, 0, 0, 0),
+            ],
+        ),
+        (
+            21,
+            b"wuji-usb",
+            [
+                (STEADY_NS - 8500, SPAN_BEGIN, 1, 64, 0, 0),
+                (STEADY_NS - 8200, SPAN_BEGIN, 8, 12, 0, 0),
+                (STEADY_NS - 7500, SPAN_END, 1, 0, 0, 0),  # Inner end lost
+                (STEADY_NS - 3000, SPAN_BEGIN, 1, 32, 0, 0),  # Never ended
+            ],
+        ),
+    ]
+)
+
+
+def test_format_text_describes_spans():
+    lines = list(format_text(read_dump(SPAN_SAMPLE)))
+    assert "span_begin span=usb_receive length=64" in lines[1]
+    assert "span_begin span=subscription_callback storage=12" in lines[2]
+    assert "span_end span=pdo_step" in lines[5]
+
+
+def test_to_chrome_trace_emits_thread_slices():
+    events = to_chrome_trace(read_dump(SPAN_SAMPLE))["traceEvents"]
+
+    def slices(tid):
+        return [
+            (e["ph"], e["name"], e["ts"])
+            for e in events
+            if e["ph"] in ("B", "E") and e["tid"] == tid
+        ]
+
+    assert slices(20) == [
+        ("B", "pdo_step", 1.0),
+        ("E", "pdo_step", 2.0),
+        ("B", "pdo_submit", 3.0),
+        ("E", "pdo_submit", 5.0),
+    ]
+    assert slices(21) == [
+        ("B", "usb_receive", 0.5),
+        ("B", "subscription_callback", 0.8),
+        ("E", "subscription_callback", 1.5),
+        ("E", "usb_receive", 1.5),
+        ("B", "usb_receive", 6.0),
+        ("E", "usb_receive", 6.0),
+    ]
+
+    # Span records are not duplicated as instant events
+    assert [e["name"] for e in events if e["ph"] == "i"] == ["pdo_tick"]
+
+
+def test_main_writes_chrome_json(tmp_path):
+    dump_path = tmp_path / "dump.wjtrace"
+    dump_path.write_bytes(SAMPLE)
+    out_path = tmp_path / "trace.json"
+
+    assert main([str(dump_path), "--format", "chrome", "-o", str(out_path)]) == 0
+    assert json.loads(out_path.read_text())["traceEvents"]
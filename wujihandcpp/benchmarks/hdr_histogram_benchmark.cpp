@@ -0,0 +1,70 @@
+// Per-record cost and quantile error of HdrHistogram next to the TDigest it replaced on the
+// realtime paths, on the same round-trip-time-like samples. Not run by ctest.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "utility/hdr_histogram.hpp"
+#include "utility/tdigest.hpp"
+
+using wujihandcpp::utility::HdrHistogram;
+using wujihandcpp::utility::TDigest;
+
+namespace {
+
+// Log-normal around 1 ms with a long tail, in nanoseconds
+std::vector<uint64_t> make_samples(size_t count) {
+    std::mt19937_64 generator{42};
+    std::lognormal_distribution<double> distribution{std::log(1e6), 0.5};
+    std::vector<uint64_t> samples(count);
+    for (auto& sample : samples)
+        sample = static_cast<uint64_t>(distribution(generator));
+    return samples;
+}
+
+template <typename F>
+double measure_ns_per_record(const std::vector<uint64_t>& samples, F&& record) {
+    auto begin = std::chrono::steady_clock::now();
+    for (auto sample : samples)
+        record(sample);
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    return std::chrono::duration<double, std::nano>(elapsed).count()
+         / static_cast<double>(samples.size());
+}
+
+} // namespace
+
+int main() {
+    auto samples = make_samples(1'000'000);
+
+    HdrHistogram<> histogram;
+    TDigest<> digest{100}; // As TickExecutor used
+    double hdr_ns =
+        measure_ns_per_record(samples, [&histogram](uint64_t sample) { histogram.record(sample); });
+    double tdigest_ns = measure_ns_per_record(
+        samples, [&digest](uint64_t sample) { digest.insert(static_cast<double>(sample)); });
+    digest.merge();
+    std::printf(
+        "Record cost: HdrHistogram %.1f ns, TDigest %.1f ns (mean over %zu records)\n", hdr_ns,
+        tdigest_ns, samples.size());
+
+    auto sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    auto snapshot = histogram.snapshot();
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+        auto exact = static_cast<double>(
+            sorted[static_cast<size_t>(q * static_cast<double>(sorted.size())) - 1]);
+        auto hdr_error = std::abs(static_cast<double>(snapshot.quantile(q)) - exact) / exact;
+        auto tdigest_error = std::abs(digest.quantile(q * 100) - exact) / exact;
+        std::printf(
+            "q=%.3f  exact %.0f ns  HdrHistogram error %.3f%%  TDigest error %.3f%%\n", q, exact,
+            hdr_error * 100, tdigest_error * 100);
+    }
+}
@@ -0,0 +1,68 @@
+#include <cstdint>
+#include <cstdio>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <wujihandcpp/data/joint.hpp>
+#include <wujihandcpp/device/hand.hpp>
+#include <wujihandcpp/device/latch.hpp>
+
+using namespace wujihandcpp;
+
+// SDO submission contention benchmark.
+// Runs 1..8 threads that each issue blocking reads of their own joint's temperature against a
+// single Hand, with no external mutex, and reports total throughput and mean round-trip time.
+int main() {
+    device::Hand hand;
+
+    constexpr auto run_time = std::chrono::seconds(3);
+
+    std::printf("threads   ops/s   mean RTT (ms)   errors\n");
+    for (int thread_count = 1; thread_count <= 8; thread_count++) {
+        std::atomic<bool> running{true};
+        std::atomic<uint64_t> total_ops{0}, total_errors{0};
+        std::atomic<int64_t> total_ns{0};
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < thread_count; t++) {
+            threads.emplace_back([&, t] {
+                auto joint = hand.finger(t % 5).joint(t / 5);
+                uint64_t ops = 0, errors = 0;
+                int64_t ns = 0;
+                while (running.load(std::memory_order_relaxed)) {
+                    auto begin = std::chrono::steady_clock::now();
+                    try {
+                        joint.read<data::joint::Temperature>();
+                    } catch (const device::TimeoutError&) {
+                        errors++;
+                    }
+                    ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - begin)
+                              .count();
+                    ops++;
+                }
+                total_ops += ops;
+                total_errors += errors;
+                total_ns += ns;
+            });
+        }
+
+        std::this_thread::sleep_for(run_time);
+        running.store(false, std::memory_order_relaxed);
+        for (auto& thread : threads)
+            thread.join();
+
+        auto ops = total_ops.load();
+        std::printf(
+            "%7d %7.1f %15.3f %8llu\n", thread_count,
+            static_cast<double>(ops) / std::chrono::duration<double>(run_time).count(),
+            ops ? static_cast<double>(total_ns.load()) / static_cast<double>(ops) / 1e6 : 0.0,
+            static_cast<unsigned long long>(total_errors.load()));
+    }
+
+    std::cout << "Program exited correctly.\n";
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+namespace wujihandcpp {
+namespace device {
+
+/// Thrown instead of TimeoutError when an operation failed because its token was cancelled.
+class CancelledError : public std::runtime_error {
+public:
+    using runtime_error::runtime_error;
+};
+
+class CancellationSource;
+
+/// Cheap, copyable view of a CancellationSource. A default-constructed token is never
+/// cancelled. The SDO thread polls the token of every in-flight operation once per tick, so a
+/// cancelled operation leaves the scheduler (and frees its storage unit or raw SDO slot) within
+/// one tick, completing as failed.
+class CancellationToken {
+public:
+    CancellationToken() noexcept = default;
+
+    bool cancelled() const noexcept {
+        return flag_ && flag_->load(std::memory_order_acquire);
+    }
+
+    void throw_if_cancelled() const {
+        if (cancelled())
+            throw CancelledError("Operation cancelled");
+    }
+
+private:
+    friend class CancellationSource;
+
+    explicit CancellationToken(const std::atomic<bool>* flag) noexcept
+        : flag_(flag) {}
+
+    const std::atomic<bool>* flag_ = nullptr;
+};
+
+/// Owns the cancellation flag. Must outlive every operation started with one of its tokens.
+class CancellationSource {
+public:
+    CancellationSource() noexcept = default;
+
+    CancellationSource(const CancellationSource&) = delete;
+    CancellationSource& operator=(const CancellationSource&) = delete;
+
+    void cancel() noexcept { cancelled_.store(true, std::memory_order_release); }
+
+    bool cancelled() const noexcept { return cancelled_.load(std::memory_order_acquire); }
+
+    CancellationToken token() const noexcept { return CancellationToken{&cancelled_}; }
+
+private:
+    std::atomic<bool> cancelled_{false};
+};
+
+/// Timeout that never expires (deadline_after() maps it to time_point::max()).
+static constexpr std::chrono::steady_clock::duration infinite_timeout =
+    std::chrono::steady_clock::duration::max();
+
+/// Converts a relative timeout into an absolute deadline. A negative timeout gives a deadline
+/// that has already passed, so the operation fails fast; infinite_timeout, or any timeout that
+/// would overflow, never expires. Compute the deadline once and pass it to every step of a
+/// composed operation to bound the whole sequence instead of each step.
+inline std::chrono::steady_clock::time_point
+    deadline_after(std::chrono::steady_clock::duration timeout) {
+    auto now = std::chrono::steady_clock::now();
+    if (timeout < std::chrono::steady_clock::duration::zero())
+        return now + timeout; // Cannot overflow: steady_clock counts up from its epoch
+    if (now > std::chrono::steady_clock::time_point::max() - timeout)
+        return std::chrono::steady_clock::time_point::max();
+    return now + timeout;
+}
+
+} // namespace device
+} // namespace wujihandcpp
@@ -1,11 +1,24 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 
+#include "wujihandcpp/utility/latest_mailbox.hpp"
+
 namespace wujihandcpp {
 namespace device {
 
+/// Targets handed to a controller that applies them on the PDO thread: each control period
+/// applies the newest target set since the previous one, and the targets it replaced are
+/// superseded, never applied.
+struct TargetStatistics {
+    uint64_t published;  // set_joint_target_position() calls
+    uint64_t applied;    // Targets applied by a control period
+    uint64_t superseded; // Targets replaced by a newer one before a control period applied them
+};
+
 class IController {
 public:
     virtual ~IController() = default;
@@ -20,6 +33,10 @@ public:
 
     virtual void set_joint_target_position(const double (&positions)[5][4]) = 0;
 
+    virtual TargetStatistics target_statistics() {
+        throw std::logic_error("Targets are not applied per control period.");
+    }
+
     /// Explicitly detach from the hand. May throw on transport errors.
     /// Derived classes should call this in their destructor (swallowing exceptions).
     virtual void detach() {}
@@ -37,6 +54,37 @@ public:
     virtual JointPositions step(JointPositions* actual) noexcept = 0;
 };
 
+/// Control law in native code (C, or a ctypes, cffi or numba cfunc callback), called on the PDO
+/// thread once per control period. `actual` points to the joint positions of the latest feedback
+/// as [5][4] row-major doubles, or is null without upstream. `target` holds the previous targets
+/// and receives the new ones. `state` is the pointer given at registration. It must not block.
+extern "C" typedef void (*StepFunction)(const double* actual, double* target, void* state);
+
+/// Realtime controller running a StepFunction, with no filter in between.
+class StepFunctionController : public IRealtimeController {
+public:
+    explicit StepFunctionController(
+        const double (&initial)[5][4], StepFunction function, void* state)
+        : function_(function)
+        , state_(state) {
+        for (size_t i = 0; i < 5; ++i)
+            for (size_t j = 0; j < 4; ++j)
+                target_.value[i][j] = initial[i][j];
+    }
+
+    void setup(double frequency) noexcept override { (void)frequency; }
+
+    JointPositions step(JointPositions* actual) noexcept override {
+        function_(actual ? &actual->value[0][0] : nullptr, &target_.value[0][0], state_);
+        return target_;
+    }
+
+private:
+    StepFunction function_;
+    void* state_;
+    JointPositions target_;
+};
+
 template <typename FilterT, bool upstream_enabled>
 class FilteredController;
 
@@ -55,6 +103,13 @@ public:
     JointPositions step(JointPositions* actual) noexcept override {
         (void)actual;
 
+        // Only the newest target reaches the filter, however many arrived since the last step
+        if (const JointPositions* target = targets_.take()) {
+            for (size_t i = 0; i < 5; i++)
+                for (size_t j = 0; j < 4; j++)
+                    units_[i][j].input(static_cast<const FilterT&>(filter_), target->value[i][j]);
+        }
+
         JointPositions result;
         for (size_t i = 0; i < 5; i++)
             for (size_t j = 0; j < 4; j++)
@@ -62,15 +117,29 @@ public:
         return result;
     }
 
+    // Call from any thread. Latest wins: see utility::LatestMailbox.
     void set(const double (&positions)[5][4]) {
+        JointPositions target;
         for (size_t i = 0; i < 5; i++)
             for (size_t j = 0; j < 4; j++)
-                units_[i][j].input(static_cast<const FilterT&>(filter_), positions[i][j]);
+                target.value[i][j] = positions[i][j];
+        targets_.publish(target);
+    }
+
+    TargetStatistics target_statistics() const {
+        typename utility::LatestMailbox<JointPositions>::Statistics mailbox =
+            targets_.statistics();
+        TargetStatistics result;
+        result.published = mailbox.published;
+        result.applied = mailbox.taken;
+        result.superseded = mailbox.superseded;
+        return result;
     }
 
 private:
     FilterT filter_;
     typename FilterT::Unit units_[5][4];
+    utility::LatestMailbox<JointPositions> targets_;
 };
 
 template <typename FilterT>
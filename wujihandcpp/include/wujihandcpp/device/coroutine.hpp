@@ -0,0 +1,443 @@
+#pragma once
+
+// C++20 coroutine support for SDO operations. Included by data_operator.hpp only when the
+// consumer is compiled with coroutine support, so the rest of the public headers stay C++11.
+
+#include <cstddef>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "wujihandcpp/device/cancellation.hpp"
+#include "wujihandcpp/device/latch.hpp"
+#include "wujihandcpp/protocol/handler.hpp"
+
+namespace wujihandcpp {
+namespace device {
+
+template <typename T>
+class DataOperator;
+
+/// Intrusive queue node used to hand a suspended coroutine to an Executor without allocating.
+struct ResumeNode {
+    std::coroutine_handle<> handle;
+    ResumeNode* next = nullptr;
+};
+
+/// Decides on which thread a coroutine awaiting an SDO operation is resumed.
+/// post() is called from the thread that completes the operation (usually the SDO thread) and
+/// must not block.
+class Executor {
+public:
+    virtual void post(ResumeNode& node) noexcept = 0;
+
+protected:
+    ~Executor() = default;
+};
+
+/// Resumes the coroutine directly on the completing thread (the SDO thread). Cheapest option,
+/// but the resumed code must not block, or it stalls every other SDO operation.
+class InlineExecutor final : public Executor {
+public:
+    void post(ResumeNode& node) noexcept override { node.handle.resume(); }
+};
+
+inline Executor& inline_executor() noexcept {
+    static InlineExecutor executor;
+    return executor;
+}
+
+/// Run loop driven by one user thread: any thread may post, the owner calls poll() or
+/// run_until() to resume posted coroutines in posting order.
+class LoopExecutor final : public Executor {
+public:
+    void post(ResumeNode& node) noexcept override {
+        auto head = head_.load(std::memory_order_relaxed);
+        do {
+            node.next = head;
+        } while (!head_.compare_exchange_weak(
+            head, &node, std::memory_order_release, std::memory_order_relaxed));
+        head_.notify_one();
+    }
+
+    /// Resumes every coroutine posted so far and returns how many were resumed.
+    size_t poll() {
+        ResumeNode* node = head_.exchange(nullptr, std::memory_order_acquire);
+
+        // Posted nodes form a LIFO stack; reverse it to resume in posting order
+        ResumeNode* ordered = nullptr;
+        while (node) {
+            auto next = node->next;
+            node->next = ordered;
+            ordered = node;
+            node = next;
+        }
+
+        size_t count = 0;
+        while (ordered) {
+            // A resumed coroutine may re-post the same node, so read the link first
+            auto next = ordered->next;
+            ordered->handle.resume();
+            ordered = next;
+            count++;
+        }
+        return count;
+    }
+
+    /// Blocks the calling thread, resuming posted coroutines, until `done()` returns true.
+    /// `done()` is only checked again after a post, so every co_await of the coroutines it waits
+    /// for must resume through this executor: one resumed on another thread may finish there and
+    /// leave run_until() waiting forever.
+    template <typename F>
+    void run_until(F&& done) {
+        while (!done()) {
+            head_.wait(nullptr, std::memory_order_acquire);
+            poll();
+        }
+    }
+
+private:
+    std::atomic<ResumeNode*> head_{nullptr};
+};
+
+/// Lazily started coroutine returning T. Either co_await it from another coroutine, or call
+/// start() and drive it from an executor until done().
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+template <typename T>
+class TaskPromiseBase {
+public:
+    template <typename U>
+    void return_value(U&& value) {
+        new (&value_) T(std::forward<U>(value));
+        has_value_ = true;
+    }
+
+    T take() { return std::move(*std::launder(reinterpret_cast<T*>(&value_))); }
+
+    ~TaskPromiseBase() {
+        if (has_value_)
+            std::launder(reinterpret_cast<T*>(&value_))->~T();
+    }
+
+private:
+    alignas(T) unsigned char value_[sizeof(T)];
+    bool has_value_ = false;
+};
+
+template <>
+class TaskPromiseBase<void> {
+public:
+    void return_void() noexcept {}
+    void take() noexcept {}
+};
+
+} // namespace detail
+
+template <typename T>
+class Task {
+public:
+    struct promise_type : detail::TaskPromiseBase<T> {
+        Task get_return_object() noexcept {
+            return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<>
+                await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                auto continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+    };
+
+    Task(Task&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    /// Runs the coroutine up to its first suspension point. Call at most once, and not on a
+    /// task that is being awaited.
+    void start() { handle_.resume(); }
+
+    bool done() const noexcept { return handle_.done(); }
+
+    /// Result of a finished task; rethrows the exception it exited with.
+    T get() {
+        if (handle_.promise().exception)
+            std::rethrow_exception(handle_.promise().exception);
+        return handle_.promise().take();
+    }
+
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            bool await_ready() noexcept { return handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            T await_resume() {
+                if (handle.promise().exception)
+                    std::rethrow_exception(handle.promise().exception);
+                return handle.promise().take();
+            }
+            std::coroutine_handle<promise_type> handle;
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+        : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+// Counts outstanding operations of one co_await and posts the awaiting coroutine once all are
+// done. Armed with one extra count held by await_suspend itself, so operations completing
+// before await_suspend returns resume the coroutine inline instead of through the executor.
+class CompletionGroup : public ResumeNode {
+public:
+    void arm(std::coroutine_handle<> awaiting, Executor& executor, int count) noexcept {
+        handle = awaiting;
+        executor_ = &executor;
+        pending_.store(count + 1, std::memory_order_relaxed);
+    }
+
+    void complete() noexcept {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            executor_->post(*this);
+    }
+
+    // Drops counts of operations that were never started.
+    void abandon(int count) noexcept { pending_.fetch_sub(count, std::memory_order_relaxed); }
+
+    // Releases await_suspend's own count. Returns true if the coroutine must stay suspended.
+    bool release_guard() noexcept {
+        return pending_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+private:
+    Executor* executor_ = nullptr;
+    std::atomic<int> pending_{0};
+};
+
+// One bulk SDO operation on a storage range, built on Handler::read_many/write_many. Lives in
+// the awaiting coroutine's frame, so no allocation is needed per operation.
+class SdoOperation {
+public:
+    SdoOperation(const SdoOperation&) = delete;
+    SdoOperation& operator=(const SdoOperation&) = delete;
+
+    // Submits the operation; `group` is completed once every unit has finished. Throws without
+    // submitting anything if a unit of the range is busy.
+    void start(CompletionGroup& group) {
+        group_ = &group;
+        remaining_.store(range_.count, std::memory_order_relaxed);
+        error_count_.store(0, std::memory_order_relaxed);
+
+        protocol::Handler::Buffer8 context{this};
+        if (data_)
+            handler_->write_many(data_, range_, deadline_, token_, &on_complete, context);
+        else
+            handler_->read_many(range_, deadline_, token_, &on_complete, context);
+    }
+
+    void rethrow_if_failed() {
+        if (int error_count = error_count_.load(std::memory_order_relaxed)) {
+            handler_->throw_if_transport_error();
+            token_.throw_if_cancelled();
+            if (error_count == 1)
+                throw TimeoutError("Operation timed out while waiting for completion");
+            else
+                throw TimeoutError(
+                    std::to_string(error_count)
+                    + " operations timed out while waiting for completion");
+        }
+    }
+
+    Executor& executor() const noexcept { return *executor_; }
+
+protected:
+    SdoOperation(
+        protocol::Handler& handler, protocol::Handler::StorageRange range,
+        std::chrono::steady_clock::time_point deadline, CancellationToken token,
+        Executor& executor, const protocol::Handler::Buffer8* data) noexcept
+        : handler_(&handler)
+        , range_(range)
+        , deadline_(deadline)
+        , token_(token)
+        , executor_(&executor)
+        , data_(data) {}
+
+    bool suspend(std::coroutine_handle<> awaiting) {
+        group_storage_.arm(awaiting, *executor_, 1);
+        start(group_storage_);
+        return group_storage_.release_guard();
+    }
+
+    protocol::Handler* handler_;
+    protocol::Handler::StorageRange range_;
+
+private:
+    static void on_complete(protocol::Handler::Buffer8 context, bool success) {
+        auto self = context.as<SdoOperation*>();
+        if (!success)
+            self->error_count_.fetch_add(1, std::memory_order_relaxed);
+        if (self->remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            self->group_->complete();
+    }
+
+    std::chrono::steady_clock::time_point deadline_;
+    CancellationToken token_;
+    Executor* executor_;
+    const protocol::Handler::Buffer8* data_;
+
+    CompletionGroup* group_ = nullptr;
+    CompletionGroup group_storage_;
+    std::atomic<int> remaining_{0};
+    std::atomic<int> error_count_{0};
+};
+
+} // namespace detail
+
+/// Awaitable returned by read_co(). Yields the value for a single-unit read, void otherwise
+/// (fetch the values with get()/get_many() afterwards).
+template <typename Value>
+class ReadAwaitable : public detail::SdoOperation {
+public:
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> awaiting) { return suspend(awaiting); }
+
+    Value await_resume() {
+        rethrow_if_failed();
+        return result(std::is_void<Value>{});
+    }
+
+private:
+    template <typename U>
+    friend class DataOperator;
+
+    ReadAwaitable(
+        protocol::Handler& handler, protocol::Handler::StorageRange range,
+        std::chrono::steady_clock::time_point deadline, CancellationToken token,
+        Executor& executor) noexcept
+        : SdoOperation(handler, range, deadline, token, executor, nullptr) {}
+
+    void result(std::true_type) {}
+    Value result(std::false_type) { return handler_->get(range_.first).template as<Value>(); }
+};
+
+/// Awaitable returned by write_co(). Holds the values to write for its `count` units.
+template <int count>
+class WriteAwaitable : public detail::SdoOperation {
+public:
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> awaiting) { return suspend(awaiting); }
+    void await_resume() { rethrow_if_failed(); }
+
+private:
+    template <typename U>
+    friend class DataOperator;
+
+    WriteAwaitable(
+        protocol::Handler& handler, protocol::Handler::StorageRange range,
+        std::chrono::steady_clock::time_point deadline, CancellationToken token,
+        Executor& executor, protocol::Handler::Buffer8 value) noexcept
+        : SdoOperation(handler, range, deadline, token, executor, values_) {
+        for (auto& buffer : values_)
+            buffer = value;
+    }
+
+    protocol::Handler::Buffer8 values_[count];
+};
+
+/// Awaits several SDO operations started together, e.g. one per joint. Resumes on the first
+/// operation's executor once all are done; rethrows the first failure in argument order.
+template <size_t count>
+class WhenAllAwaitable {
+public:
+    explicit WhenAllAwaitable(std::array<detail::SdoOperation*, count> operations) noexcept
+        : operations_(operations) {}
+
+    bool await_ready() const noexcept { return count == 0; }
+
+    bool await_suspend(std::coroutine_handle<> awaiting) {
+        group_.arm(awaiting, operations_[0]->executor(), static_cast<int>(count));
+
+        size_t started = 0;
+        try {
+            for (auto operation : operations_) {
+                operation->start(group_);
+                started++;
+            }
+        } catch (...) {
+            // Operations already started still reference group_, so stay suspended until they
+            // finish and report the error from await_resume().
+            exception_ = std::current_exception();
+            group_.abandon(static_cast<int>(count - started));
+        }
+        return group_.release_guard();
+    }
+
+    void await_resume() {
+        if (exception_)
+            std::rethrow_exception(exception_);
+        for (auto operation : operations_)
+            operation->rethrow_if_failed();
+    }
+
+private:
+    std::array<detail::SdoOperation*, count> operations_;
+    detail::CompletionGroup group_;
+    std::exception_ptr exception_;
+};
+
+/// Usage: `co_await when_all(hand.finger(0).write_co<A>(x), hand.finger(1).write_co<A>(y));`
+/// The awaitables must outlive the co_await, which temporaries in the same expression do.
+template <typename... Awaitables>
+WhenAllAwaitable<sizeof...(Awaitables)> when_all(Awaitables&&... awaitables) {
+    static_assert(
+        (std::is_base_of_v<detail::SdoOperation, std::remove_cvref_t<Awaitables>> && ...),
+        "when_all() only accepts SDO awaitables (read_co/write_co)");
+    return WhenAllAwaitable<sizeof...(Awaitables)>{
+        std::array<detail::SdoOperation*, sizeof...(Awaitables)>{&awaitables...}};
+}
+
+} // namespace device
+} // namespace wujihandcpp
@@ -3,9 +3,13 @@
 #include <cstdint>
 
 #include <chrono>
+#include <memory>
 #include <type_traits>
+#include <utility>
 
+#include "wujihandcpp/device/cancellation.hpp"
 #include "wujihandcpp/device/latch.hpp"
+#include "wujihandcpp/device/subscription.hpp"
 #include "wujihandcpp/protocol/handler.hpp"
 
 #if __cplusplus >= 202002L
@@ -14,9 +18,20 @@
 # define SDK_CPP20_REQUIRES(...)
 #endif
 
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+# define WUJIHANDCPP_HAS_COROUTINE 1
+# include "wujihandcpp/device/coroutine.hpp"
+#endif
+
 namespace wujihandcpp {
 namespace device {
 
+/// Oldest cached value accepted by read(MaxAge, ...), measured from when the device last
+/// confirmed it. Example: `hand.read<data::hand::Temperature>(MaxAge{std::chrono::seconds(1)})`.
+struct MaxAge {
+    std::chrono::steady_clock::duration value;
+};
+
 template <typename T>
 class DataOperator {
     using Handler = protocol::Handler;
@@ -44,45 +59,80 @@ public:
         return std::chrono::milliseconds(500);
     }
 
+    // Every checked operation also takes an absolute deadline and a CancellationToken instead of
+    // a timeout. Share one deadline between the steps of a composed operation to bound the whole
+    // sequence; a cancelled operation fails within one SDO tick and throws CancelledError.
+
     template <typename Data>
     SDK_CPP20_REQUIRES(Data::readable)
     auto read(std::chrono::steady_clock::duration timeout = default_timeout()) ->
+        typename std::enable_if<
+            std::is_same<typename Data::Base, T>::value, typename Data::ValueType>::type {
+        return read<Data>(deadline_after(timeout));
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    auto read(
+        std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) ->
         typename std::enable_if<
             std::is_same<typename Data::Base, T>::value, typename Data::ValueType>::type {
         static_assert(Data::readable, "");
 
         Latch latch;
-        read_async<Data>(latch, timeout);
-        latch.wait();
+        read_async<Data>(latch, deadline, token);
+        wait(latch, token);
         return get<Data>();
     }
 
     template <typename Data>
     SDK_CPP20_REQUIRES(Data::readable)
     auto read(std::chrono::steady_clock::duration timeout = default_timeout()) ->
+        typename std::enable_if<!std::is_same<typename Data::Base, T>::value, void>::type {
+        read<Data>(deadline_after(timeout));
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    auto read(
+        std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) ->
         typename std::enable_if<!std::is_same<typename Data::Base, T>::value, void>::type {
         static_assert(Data::readable, "");
 
         Latch latch;
-        read_async<Data>(latch, timeout);
-        latch.wait();
+        read_async<Data>(latch, deadline, token);
+        wait(latch, token);
     }
 
     template <typename Data>
     SDK_CPP20_REQUIRES(Data::readable)
     void read_async(Latch& latch, std::chrono::steady_clock::duration timeout = default_timeout()) {
+        read_async<Data>(latch, deadline_after(timeout));
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    void read_async(
+        Latch& latch, std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
         static_assert(Data::readable, "");
 
         Handler& handler = static_cast<T*>(this)->handler_;
-        iterate<Data>([&](int storage_id) {
-            latch.count_up();
+        latch.count_up(storage_count<Data>());
 
-            Buffer8 callback_context{&latch};
-            handler.read_async(
-                storage_id, timeout.count(),
+        Buffer8 callback_context{&latch};
+        try {
+            handler.read_many(
+                storage_range<Data>(), deadline, token,
                 [](Buffer8 context, bool success) { (context.as<Latch*>())->count_down(success); },
                 callback_context);
-        });
+        } catch (...) {
+            // A rejected batch has no operation in flight: the latch still waits for the others
+            latch.count_up(-storage_count<Data>());
+            throw;
+        }
     }
 
     template <typename Data, typename F>
@@ -91,6 +141,17 @@ public:
         && std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>
         && requires(bool success, const F& f) { f(success); })
     void read_async(const F& f, std::chrono::steady_clock::duration timeout = default_timeout()) {
+        read_async<Data>(f, deadline_after(timeout));
+    }
+
+    template <typename Data, typename F>
+    SDK_CPP20_REQUIRES(
+        Data::readable && sizeof(F) <= 8 && alignof(F) <= 8
+        && std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>
+        && requires(bool success, const F& f) { f(success); })
+    void read_async(
+        const F& f, std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
         static_assert(Data::readable, "");
 
         static_assert(sizeof(F) <= 8, "");
@@ -99,12 +160,86 @@ public:
         static_assert(std::is_trivially_destructible<F>::value, "");
 
         Handler& handler = static_cast<T*>(this)->handler_;
-        iterate<Data>([&](int storage_id) {
-            Buffer8 callback_context{f};
-            handler.read_async(
-                storage_id, timeout.count(),
-                [](Buffer8 context, bool success) { context.as<F>()(success); }, callback_context);
-        });
+        Buffer8 callback_context{f};
+        handler.read_many(
+            storage_range<Data>(), deadline, token,
+            [](Buffer8 context, bool success) { context.as<F>()(success); }, callback_context);
+    }
+
+    // Cached reads: return at once if the cached value is recent enough, otherwise share a single
+    // SDO read with every concurrent cached read of the same data. Never fail as busy.
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    auto read(MaxAge max_age, std::chrono::steady_clock::duration timeout = default_timeout()) ->
+        typename std::enable_if<
+            std::is_same<typename Data::Base, T>::value, typename Data::ValueType>::type {
+        return read<Data>(max_age, deadline_after(timeout));
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    auto read(
+        MaxAge max_age, std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) ->
+        typename std::enable_if<
+            std::is_same<typename Data::Base, T>::value, typename Data::ValueType>::type {
+        static_assert(Data::readable, "");
+
+        Latch latch;
+        read_async<Data>(latch, max_age, deadline, token);
+        wait(latch, token);
+        return get<Data>();
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    auto read(MaxAge max_age, std::chrono::steady_clock::duration timeout = default_timeout()) ->
+        typename std::enable_if<!std::is_same<typename Data::Base, T>::value, void>::type {
+        read<Data>(max_age, deadline_after(timeout));
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    auto read(
+        MaxAge max_age, std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) ->
+        typename std::enable_if<!std::is_same<typename Data::Base, T>::value, void>::type {
+        static_assert(Data::readable, "");
+
+        Latch latch;
+        read_async<Data>(latch, max_age, deadline, token);
+        wait(latch, token);
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    void read_async(
+        Latch& latch, MaxAge max_age,
+        std::chrono::steady_clock::duration timeout = default_timeout()) {
+        read_async<Data>(latch, max_age, deadline_after(timeout));
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    void read_async(
+        Latch& latch, MaxAge max_age, std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
+        static_assert(Data::readable, "");
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        latch.count_up(storage_count<Data>());
+
+        Buffer8 callback_context{&latch};
+        try {
+            handler.read_many_cached(
+                storage_range<Data>(), max_age.value, deadline, token,
+                [](Buffer8 context, bool success) { (context.as<Latch*>())->count_down(success); },
+                callback_context);
+        } catch (...) {
+            latch.count_up(-storage_count<Data>());
+            throw;
+        }
     }
 
     template <typename Data>
@@ -129,16 +264,62 @@ public:
         return value;
     }
 
+    /// Fills `values` with the cached value of every unit covered by Data, sub-major
+    /// (e.g. [finger][joint] for a joint data read through Hand).
+    template <typename Data>
+    auto get_many(typename Data::ValueType* values) ->
+        typename std::enable_if<!std::is_same<typename Data::Base, T>::value, void>::type {
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        Buffer8 buffers[storage_count<Data>()];
+        handler.get_many(storage_range<Data>(), buffers);
+        for (int i = 0; i < storage_count<Data>(); i++)
+            values[i] = buffers[i].template as<typename Data::ValueType>();
+    }
+
+    /// Reads Data every `period` in the background, at a lower priority than any other SDO
+    /// operation (none of which fails as busy because of a subscription read), and calls
+    /// `callback(index, value)` on the SDO thread with the first known value of each unit and
+    /// then whenever it changes. `index` is sub-major as in get_many(), and 0
+    /// for a single unit. The callback must not block; it may reset its own Subscription.
+    /// Example: `auto s = hand.subscribe<data::joint::Temperature>(std::chrono::seconds(1),
+    ///     [](int index, float celsius) { ... });`
+    template <typename Data, typename F>
+    SDK_CPP20_REQUIRES(Data::readable)
+    Subscription subscribe(std::chrono::steady_clock::duration period, F&& callback) {
+        static_assert(Data::readable, "");
+        using Callback = typename std::decay<F>::type;
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        std::unique_ptr<Callback> holder(new Callback(std::forward<F>(callback)));
+        uint64_t id = handler.subscribe(
+            storage_range<Data>(), period,
+            [](Buffer8 context, int index, Buffer8 value) {
+                (*context.as<Callback*>())(index, value.as<typename Data::ValueType>());
+            },
+            [](Buffer8 context) { delete context.as<Callback*>(); }, Buffer8{holder.get()});
+        holder.release(); // Owned by the subscription from now on
+        return Subscription{handler, id};
+    }
+
     template <typename Data>
     SDK_CPP20_REQUIRES(Data::writable)
     void write(
         typename Data::ValueType value,
         std::chrono::steady_clock::duration timeout = default_timeout()) {
+        write<Data>(value, deadline_after(timeout));
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::writable)
+    void write(
+        typename Data::ValueType value, std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
         static_assert(Data::writable, "");
 
         Latch latch;
-        write_async<Data>(latch, value, timeout);
-        latch.wait();
+        write_async<Data>(latch, value, deadline, token);
+        wait(latch, token);
     }
 
     template <typename Data>
@@ -146,18 +327,32 @@ public:
     void write_async(
         Latch& latch, typename Data::ValueType value,
         std::chrono::steady_clock::duration timeout = default_timeout()) {
+        write_async<Data>(latch, value, deadline_after(timeout));
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::writable)
+    void write_async(
+        Latch& latch, typename Data::ValueType value,
+        std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
         static_assert(Data::writable, "");
 
-        Handler& handler = static_cast<T*>(this)->handler_;
-        iterate<Data>([&](int storage_id) {
-            latch.count_up();
+        Buffer8 buffers[storage_count<Data>()];
+        for (auto& buffer : buffers)
+            buffer = Buffer8{value};
+        write_many_internal<Data>(latch, buffers, deadline, token);
+    }
 
-            Buffer8 callback_context{&latch};
-            handler.write_async(
-                Buffer8{value}, storage_id, timeout.count(),
-                [](Buffer8 context, bool success) { (context.as<Latch*>())->count_down(success); },
-                callback_context);
-        });
+    template <typename Data, typename F>
+    SDK_CPP20_REQUIRES(
+        Data::writable && sizeof(F) <= 8 && alignof(F) <= 8
+        && std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>
+        && requires(bool success, const F& f) { f(success); })
+    void write_async(
+        const F& f, typename Data::ValueType value,
+        std::chrono::steady_clock::duration timeout = default_timeout()) {
+        write_async<Data>(f, value, deadline_after(timeout));
     }
 
     template <typename Data, typename F>
@@ -167,7 +362,65 @@ public:
         && requires(bool success, const F& f) { f(success); })
     void write_async(
         const F& f, typename Data::ValueType value,
+        std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
+        static_assert(Data::writable, "");
+
+        static_assert(sizeof(F) <= 8, "");
+        static_assert(alignof(F) <= 8, "");
+        static_assert(std::is_trivially_copyable<F>::value, "");
+        static_assert(std::is_trivially_destructible<F>::value, "");
+
+        Buffer8 buffers[storage_count<Data>()];
+        for (auto& buffer : buffers)
+            buffer = Buffer8{value};
+        write_many_internal<Data>(f, buffers, deadline, token);
+    }
+
+    /// Writes a distinct value to every unit covered by Data; `values` is laid out as in
+    /// get_many().
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::writable)
+    void write_many_async(
+        Latch& latch, const typename Data::ValueType* values,
         std::chrono::steady_clock::duration timeout = default_timeout()) {
+        write_many_async<Data>(latch, values, deadline_after(timeout));
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::writable)
+    void write_many_async(
+        Latch& latch, const typename Data::ValueType* values,
+        std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
+        static_assert(Data::writable, "");
+
+        Buffer8 buffers[storage_count<Data>()];
+        for (int i = 0; i < storage_count<Data>(); i++)
+            buffers[i] = Buffer8{values[i]};
+        write_many_internal<Data>(latch, buffers, deadline, token);
+    }
+
+    template <typename Data, typename F>
+    SDK_CPP20_REQUIRES(
+        Data::writable && sizeof(F) <= 8 && alignof(F) <= 8
+        && std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>
+        && requires(bool success, const F& f) { f(success); })
+    void write_many_async(
+        const F& f, const typename Data::ValueType* values,
+        std::chrono::steady_clock::duration timeout = default_timeout()) {
+        write_many_async<Data>(f, values, deadline_after(timeout));
+    }
+
+    template <typename Data, typename F>
+    SDK_CPP20_REQUIRES(
+        Data::writable && sizeof(F) <= 8 && alignof(F) <= 8
+        && std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>
+        && requires(bool success, const F& f) { f(success); })
+    void write_many_async(
+        const F& f, const typename Data::ValueType* values,
+        std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
         static_assert(Data::writable, "");
 
         static_assert(sizeof(F) <= 8, "");
@@ -175,13 +428,10 @@ public:
         static_assert(std::is_trivially_copyable<F>::value, "");
         static_assert(std::is_trivially_destructible<F>::value, "");
 
-        Handler& handler = static_cast<T*>(this)->handler_;
-        iterate<Data>([&](int storage_id) {
-            Buffer8 callback_context{f};
-            handler.write_async(
-                Buffer8{value}, storage_id, timeout.count(),
-                [](Buffer8 context, bool success) { context.as<F>()(success); }, callback_context);
-        });
+        Buffer8 buffers[storage_count<Data>()];
+        for (int i = 0; i < storage_count<Data>(); i++)
+            buffers[i] = Buffer8{values[i]};
+        write_many_internal<Data>(f, buffers, deadline, token);
     }
 
     template <typename Data>
@@ -197,7 +447,144 @@ public:
         });
     }
 
+#ifdef WUJIHANDCPP_HAS_COROUTINE
+    /// `co_await op.read_co<Data>()`: yields the value when Data names a single unit, void
+    /// otherwise. The coroutine is resumed through `executor` (inline on the SDO thread by
+    /// default).
+    template <typename Data>
+    requires(Data::readable)
+    auto read_co(
+        std::chrono::steady_clock::duration timeout = default_timeout(),
+        Executor& executor = inline_executor()) {
+        return read_co<Data>(deadline_after(timeout), CancellationToken(), executor);
+    }
+
+    template <typename Data>
+    requires(Data::readable)
+    auto read_co(
+        std::chrono::steady_clock::time_point deadline, CancellationToken token = {},
+        Executor& executor = inline_executor()) {
+        using Value = std::conditional_t<
+            std::is_same_v<typename Data::Base, T>, typename Data::ValueType, void>;
+        return ReadAwaitable<Value>{
+            static_cast<T*>(this)->handler_, storage_range<Data>(), deadline, token, executor};
+    }
+
+    template <typename Data>
+    requires(Data::writable)
+    auto write_co(
+        typename Data::ValueType value,
+        std::chrono::steady_clock::duration timeout = default_timeout(),
+        Executor& executor = inline_executor()) {
+        return write_co<Data>(value, deadline_after(timeout), CancellationToken(), executor);
+    }
+
+    template <typename Data>
+    requires(Data::writable)
+    auto write_co(
+        typename Data::ValueType value, std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = {}, Executor& executor = inline_executor()) {
+        return WriteAwaitable<storage_count<Data>()>{
+            static_cast<T*>(this)->handler_, storage_range<Data>(), deadline, token, executor,
+            Buffer8{value}};
+    }
+#endif
+
 private:
+    // Reports a failure caused by `token` as CancelledError rather than TimeoutError.
+    static void wait(Latch& latch, const CancellationToken& token) {
+        try {
+            latch.wait();
+        } catch (const TimeoutError&) {
+            token.throw_if_cancelled();
+            throw;
+        }
+    }
+
+    template <typename Data>
+    void write_many_internal(
+        Latch& latch, const Buffer8* buffers, std::chrono::steady_clock::time_point deadline,
+        CancellationToken token) {
+        Handler& handler = static_cast<T*>(this)->handler_;
+        latch.count_up(storage_count<Data>());
+
+        Buffer8 callback_context{&latch};
+        try {
+            handler.write_many(
+                buffers, storage_range<Data>(), deadline, token,
+                [](Buffer8 context, bool success) { (context.as<Latch*>())->count_down(success); },
+                callback_context);
+        } catch (...) {
+            latch.count_up(-storage_count<Data>());
+            throw;
+        }
+    }
+
+    template <typename Data, typename F>
+    void write_many_internal(
+        const F& f, const Buffer8* buffers, std::chrono::steady_clock::time_point deadline,
+        CancellationToken token) {
+        Handler& handler = static_cast<T*>(this)->handler_;
+        Buffer8 callback_context{f};
+        handler.write_many(
+            buffers, storage_range<Data>(), deadline, token,
+            [](Buffer8 context, bool success) { context.as<F>()(success); }, callback_context);
+    }
+
+    // Number of storage units covered by Data under this operator, and the distance between
+    // consecutive ones. Subs are laid out back to back, so the same data repeats every
+    // Sub::data_count() ids.
+    template <typename Data>
+    constexpr static typename std::enable_if<std::is_same<typename Data::Base, T>::value, int>::type
+        storage_count() {
+        return 1;
+    }
+
+    template <typename Data>
+    constexpr static
+        typename std::enable_if<!std::is_same<typename Data::Base, T>::value, int>::type
+        storage_count() {
+        return T::sub_count_ * T::Sub::template storage_count<Data>();
+    }
+
+    template <typename Data>
+    constexpr static typename std::enable_if<std::is_same<typename Data::Base, T>::value, int>::type
+        storage_stride() {
+        return 1;
+    }
+
+    template <typename Data>
+    constexpr static
+        typename std::enable_if<!std::is_same<typename Data::Base, T>::value, int>::type
+        storage_stride() {
+        return T::Sub::template storage_count<Data>() == 1
+                 ? T::Sub::data_count()
+                 : T::Sub::template storage_stride<Data>();
+    }
+
+    template <typename Data>
+    typename std::enable_if<std::is_same<typename Data::Base, T>::value, Handler::StorageRange>::type
+        storage_range() {
+        T& self = *static_cast<T*>(this);
+        return {self.storage_offset_ + T::Datas::template index<Data>(), 1, 1};
+    }
+
+    template <typename Data>
+    typename std::enable_if<!std::is_same<typename Data::Base, T>::value, Handler::StorageRange>::type
+        storage_range() {
+        using Sub = typename T::Sub;
+        static_assert(
+            Sub::template storage_count<Data>() == 1
+                || Sub::template storage_count<Data>() * Sub::template storage_stride<Data>()
+                       == Sub::data_count(),
+            "Storage ids of a bulk operation must be evenly strided");
+
+        T& self = *static_cast<T*>(this);
+        return {
+            self.sub(0).template storage_range<Data>().first, storage_count<Data>(),
+            storage_stride<Data>()};
+    }
+
     template <typename U>
     constexpr static decltype(std::declval<typename U::Sub>(), int()) data_count_internal(int) {
         return T::Datas::count + T::sub_count_ * T::Sub::data_count();
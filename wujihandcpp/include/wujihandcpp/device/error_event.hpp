@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+#include <chrono>
+
+namespace wujihandcpp {
+namespace device {
+
+/// A change of one joint's error code, as reported by the PDO feedback (TPDO 0x02).
+struct JointErrorEvent {
+    std::chrono::steady_clock::time_point timestamp; // When the frame was received
+    uint32_t error_code;                              // Error code after the change
+    uint32_t set_bits;                                // Bits raised by the change
+    uint32_t cleared_bits;                            // Bits cleared by the change
+    uint8_t finger;
+    uint8_t joint;
+};
+
+} // namespace device
+} // namespace wujihandcpp
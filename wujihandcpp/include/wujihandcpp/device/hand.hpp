@@ -5,6 +5,7 @@
 
 #include <array>
 #include <atomic>
+#include <future>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -17,6 +18,7 @@
 #include "wujihandcpp/device/controller.hpp"
 #include "wujihandcpp/device/data_operator.hpp"
 #include "wujihandcpp/device/data_tuple.hpp"
+#include "wujihandcpp/device/error_event.hpp"
 #include "wujihandcpp/device/finger.hpp"
 #include "wujihandcpp/filter/low_pass.hpp"
 #include "wujihandcpp/protocol/handler.hpp"
@@ -188,10 +190,63 @@ public:
         return handler_.realtime_get_joint_actual_effort();
     }
 
+    /// Error codes from the PDO feedback, updated at the PDO rate while a realtime controller
+    /// with upstream enabled is running.
+    auto realtime_get_joint_error_code() -> const std::atomic<uint32_t> (&)[5][4] {
+        return handler_.realtime_get_joint_error_code();
+    }
+
     void realtime_set_joint_target_position(const double (&positions)[5][4]) {
         handler_.realtime_set_joint_target_position(positions);
     }
 
+    /// Number of PDO feedback frames received so far (see Handler::realtime_feedback_version).
+    uint64_t realtime_feedback_version() const { return handler_.realtime_feedback_version(); }
+
+    /// Waits for a feedback frame newer than `version`, at most `timeout`; returns the version.
+    /// A consumer passing back the version it got sees every frame, or knows how many it missed.
+    uint64_t wait_realtime_feedback(uint64_t version, std::chrono::steady_clock::duration timeout) {
+        return handler_.wait_realtime_feedback(version, deadline_after(timeout));
+    }
+
+    /// Error code changes seen in the PDO feedback, oldest first. Lock-free and allocation-free,
+    /// so a supervisor may call this once per control period; one polling thread at a time.
+    size_t poll_joint_error_events(JointErrorEvent* events, size_t max_count) {
+        return handler_.poll_joint_error_events(events, max_count);
+    }
+
+    uint64_t dropped_joint_error_events() const { return handler_.dropped_joint_error_events(); }
+
+    /// Invoked on the SDO thread for every JointErrorEvent (see Handler::set_joint_error_callback).
+    void set_joint_error_callback(
+        void (*callback)(protocol::Handler::Buffer8 context, const JointErrorEvent& event),
+        protocol::Handler::Buffer8 context = protocol::Handler::Buffer8()) {
+        handler_.set_joint_error_callback(callback, context);
+    }
+
+    /// Receive path counters (frames, parse errors, callback time); see Handler::RxStatistics.
+    protocol::Handler::RxStatistics rx_statistics() const { return handler_.rx_statistics(); }
+
+    /// Scheduling lateness, step() time, RPDO submit time and overruns of the realtime loop; see
+    /// Handler::RealtimeStatistics. May be called from any thread while a controller runs.
+    protocol::Handler::RealtimeStatistics realtime_statistics() const {
+        return handler_.realtime_statistics();
+    }
+
+    /// Publishes PDO feedback to shared memory segment `name` for local readers in other
+    /// processes; see Handler::start_state_publisher and wujihandcpp/utility/shared_state.hpp.
+    void start_state_publisher(const char* name, size_t capacity = 1024) {
+        handler_.start_state_publisher(name, capacity);
+    }
+
+    void stop_state_publisher() { handler_.stop_state_publisher(); }
+
+    /// SDO round-trip latency of joint (`finger_id`, `joint_id`), or of the hand-level objects
+    /// if `finger_id` is -1; see Handler::SdoLatency.
+    protocol::Handler::SdoLatency sdo_latency(int finger_id, int joint_id = 0) const {
+        return handler_.sdo_latency(finger_id, joint_id);
+    }
+
     template <bool enable_upstream>
     std::unique_ptr<IController> realtime_controller(const filter::LowPass& filter) {
         if (feature_firmware_filter_) {
@@ -199,15 +254,8 @@ public:
 
             return std::unique_ptr<IController>(new CompatibleControllerOperator(*this));
         } else {
-            bool last_enabled[5][4];
-            save_and_enable_joints(last_enabled);
-            read<data::joint::ActualPosition>();
-            revert_enabled_joints(last_enabled);
-
             double positions[5][4];
-            for (int i = 0; i < 5; i++)
-                for (int j = 0; j < 4; j++)
-                    positions[i][j] = finger(i).joint(j).get<data::joint::ActualPosition>();
+            read_initial_positions(positions);
 
             typedef FilteredController<filter::LowPass, enable_upstream> ControllerType;
             typedef FilteredControllerOperator<filter::LowPass, enable_upstream> OperatorType;
@@ -220,6 +268,28 @@ public:
         }
     }
 
+    /// Runs `function` on the PDO thread every control period in place of a filter; see
+    /// StepFunction. The first call receives the current joint positions as previous targets.
+    /// `state` is passed through untouched and must outlive the controller. The returned
+    /// controller detaches when destroyed. Its set_joint_target_position() throws, as the
+    /// targets come from `function`.
+    std::unique_ptr<IController>
+        realtime_controller(StepFunction function, void* state, bool enable_upstream) {
+        if (!function)
+            throw std::invalid_argument("Step function must not be null.");
+
+        double positions[5][4];
+        read_initial_positions(positions);
+
+        std::unique_ptr<IRealtimeController> controller(
+            new StepFunctionController(positions, function, state));
+        std::unique_ptr<IController> controller_operator(
+            new StepFunctionControllerOperator(*this, enable_upstream));
+        attach_realtime_controller(std::move(controller), enable_upstream);
+
+        return controller_operator;
+    }
+
     void start_latency_test() {
         bool last_enabled[5][4];
         save_and_disable_joints(last_enabled);
@@ -308,6 +378,50 @@ public:
         handler_.raw_sdo_write(full_index, sub_index, data, size, timeout);
     }
 
+    std::vector<uint8_t> raw_sdo_read(
+        int finger_id, int joint_id, uint16_t index, uint8_t sub_index,
+        std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
+        uint16_t full_index = index + calculate_index_offset(finger_id, joint_id);
+        return handler_.raw_sdo_read(full_index, sub_index, deadline, token);
+    }
+
+    void raw_sdo_write(
+        int finger_id, int joint_id, uint16_t index, uint8_t sub_index, const void* data,
+        size_t size, std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
+        uint16_t full_index = index + calculate_index_offset(finger_id, joint_id);
+        handler_.raw_sdo_write(full_index, sub_index, data, size, deadline, token);
+    }
+
+    std::future<std::vector<uint8_t>> raw_sdo_read_async(
+        int finger_id, int joint_id, uint16_t index, uint8_t sub_index,
+        std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
+        uint16_t full_index = index + calculate_index_offset(finger_id, joint_id);
+        return handler_.raw_sdo_read_async(full_index, sub_index, deadline, token);
+    }
+
+    std::future<void> raw_sdo_write_async(
+        int finger_id, int joint_id, uint16_t index, uint8_t sub_index, const void* data,
+        size_t size, std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
+        uint16_t full_index = index + calculate_index_offset(finger_id, joint_id);
+        return handler_.raw_sdo_write_async(full_index, sub_index, data, size, deadline, token);
+    }
+
+    // Reads many objects of one finger/joint (or the hand) in a single batch, e.g. for a
+    // diagnostics sweep. Futures are returned in address order and fail independently.
+    std::vector<std::future<std::vector<uint8_t>>> raw_sdo_read_many(
+        int finger_id, int joint_id, std::vector<protocol::Handler::SdoAddress> addresses,
+        std::chrono::steady_clock::time_point deadline,
+        CancellationToken token = CancellationToken()) {
+        uint16_t offset = calculate_index_offset(finger_id, joint_id);
+        for (auto& address : addresses)
+            address.index = static_cast<uint16_t>(address.index + offset);
+        return handler_.raw_sdo_read_many(addresses.data(), addresses.size(), deadline, token);
+    }
+
 private:
     class CompatibleControllerOperator : public IController {
     public:
@@ -335,6 +449,48 @@ private:
         Hand& hand_;
     };
 
+    class StepFunctionControllerOperator : public IController {
+    public:
+        explicit StepFunctionControllerOperator(Hand& hand, bool upstream_enabled)
+            : hand_(hand)
+            , attached_(true)
+            , upstream_enabled_(upstream_enabled) {}
+
+        ~StepFunctionControllerOperator() override {
+            try {
+                detach();
+            } catch (...) {}
+        }
+
+        void detach() override {
+            if (!attached_)
+                return;
+            attached_ = false;
+            hand_.detach_realtime_controller();
+        }
+
+        auto get_joint_actual_position() -> const std::atomic<double> (&)[5][4] override {
+            if (!upstream_enabled_)
+                return IController::get_joint_actual_position();
+            return hand_.realtime_get_joint_actual_position();
+        }
+
+        auto get_joint_actual_effort() -> const std::atomic<double> (&)[5][4] override {
+            if (!upstream_enabled_)
+                return IController::get_joint_actual_effort();
+            return hand_.realtime_get_joint_actual_effort();
+        }
+
+        void set_joint_target_position(const double (&)[5][4]) override {
+            throw std::logic_error("Targets come from the step function.");
+        }
+
+    private:
+        Hand& hand_;
+        bool attached_;
+        bool upstream_enabled_;
+    };
+
     template <typename FilterT, bool upstream_enabled>
     class FilteredControllerOperator;
 
@@ -383,6 +539,8 @@ private:
             controller_->set(positions);
         }
 
+        TargetStatistics target_statistics() override { return controller_->target_statistics(); }
+
     private:
         Hand& hand_;
         FilteredController<FilterT, false>* controller_;
@@ -436,6 +594,8 @@ private:
             controller_->set(positions);
         }
 
+        TargetStatistics target_statistics() override { return controller_->target_statistics(); }
+
         auto get_joint_actual_effort() -> const std::atomic<double> (&)[5][4] override {
             return hand_.realtime_get_joint_actual_effort();
         }
@@ -445,6 +605,18 @@ private:
         FilteredController<FilterT, true>* controller_;
     };
 
+    // Joint positions to start a realtime controller from
+    void read_initial_positions(double (&positions)[5][4]) {
+        bool last_enabled[5][4];
+        save_and_enable_joints(last_enabled);
+        read<data::joint::ActualPosition>();
+        revert_enabled_joints(last_enabled);
+
+        for (int i = 0; i < 5; i++)
+            for (int j = 0; j < 4; j++)
+                positions[i][j] = finger(i).joint(j).get<data::joint::ActualPosition>();
+    }
+
     void attach_realtime_controller(
         std::unique_ptr<IRealtimeController> controller, bool enable_upstream) {
         if (!controller)
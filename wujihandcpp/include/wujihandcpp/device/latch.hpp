@@ -46,6 +46,7 @@ private:
     WUJIHANDCPP_API int try_wait_internal() noexcept;
 
     WUJIHANDCPP_API void count_up() noexcept;
+    WUJIHANDCPP_API void count_up(int count) noexcept;
     WUJIHANDCPP_API void count_down(bool success) noexcept;
 
     std::atomic<int> waiting_count_{0};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+#include "wujihandcpp/protocol/handler.hpp"
+
+namespace wujihandcpp {
+namespace device {
+
+/// Handle of a periodic read started by DataOperator::subscribe(). Unsubscribes when destroyed
+/// or reset; must not outlive the device it was created from.
+class Subscription {
+public:
+    Subscription() noexcept = default;
+
+    Subscription(protocol::Handler& handler, uint64_t id) noexcept
+        : handler_(&handler)
+        , id_(id) {}
+
+    Subscription(const Subscription&) = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+    Subscription(Subscription&& other) noexcept
+        : handler_(other.handler_)
+        , id_(other.id_) {
+        other.handler_ = nullptr;
+    }
+
+    Subscription& operator=(Subscription&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handler_ = other.handler_;
+            id_ = other.id_;
+            other.handler_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~Subscription() { reset(); }
+
+    bool active() const noexcept { return handler_ != nullptr; }
+
+    /// Once this returns, the callback no longer runs (see Handler::unsubscribe()).
+    void reset() noexcept {
+        if (handler_) {
+            handler_->unsubscribe(id_);
+            handler_ = nullptr;
+        }
+    }
+
+private:
+    protocol::Handler* handler_ = nullptr;
+    uint64_t id_ = 0;
+};
+
+} // namespace device
+} // namespace wujihandcpp
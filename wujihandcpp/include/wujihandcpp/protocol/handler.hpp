@@ -6,11 +6,14 @@
 
 #include <atomic>
 #include <chrono>
+#include <future>
 #include <string>
 #include <type_traits>
 #include <vector>
 
+#include "wujihandcpp/device/cancellation.hpp"
 #include "wujihandcpp/device/controller.hpp"
+#include "wujihandcpp/device/error_event.hpp"
 #include "wujihandcpp/utility/api.hpp"
 
 namespace wujihandcpp {
@@ -76,6 +79,20 @@ public:
         static_assert(sizeof(void*) == 8, "");
     };
 
+    /// Object dictionary address of a raw SDO operation.
+    struct SdoAddress {
+        uint16_t index;
+        uint8_t sub_index;
+    };
+
+    /// Evenly strided run of storage ids: first, first + stride, ..., count ids in total.
+    /// A joint-level data of a whole hand maps to one range with stride Joint::data_count().
+    struct StorageRange {
+        int first;
+        int count;
+        int stride;
+    };
+
     WUJIHANDCPP_API explicit Handler(
         uint16_t usb_vid, int32_t usb_pid, const char* serial_number, size_t storage_unit_count);
 
@@ -99,13 +116,143 @@ public:
         Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout,
         void (*callback)(Buffer8 context, bool success), Buffer8 callback_context);
 
+    // Bulk variants: one transport check per call, and every unit of the range enters the SDO
+    // scheduler in the same tick (so the requests share frames). The callback is invoked once per
+    // storage unit with the same context. A unit fails once `deadline` passes or `token` is
+    // cancelled, whichever comes first.
+
+    WUJIHANDCPP_API void read_many(
+        StorageRange range, std::chrono::steady_clock::time_point deadline,
+        device::CancellationToken token, void (*callback)(Buffer8 context, bool success),
+        Buffer8 callback_context);
+
+    /// `data` holds range.count values, in range order.
+    WUJIHANDCPP_API void write_many(
+        const Buffer8* data, StorageRange range, std::chrono::steady_clock::time_point deadline,
+        device::CancellationToken token, void (*callback)(Buffer8 context, bool success),
+        Buffer8 callback_context);
+
+    /// Like read_many(), but a unit whose cached value was confirmed by the device within
+    /// `max_age` completes at once, on the calling thread. Stale units never fail as busy:
+    /// concurrent cached reads of a unit share one SDO read, and a read or write already in
+    /// flight also refreshes the cache. Neither does the shared read make other operations
+    /// fail: a checked read or write of the unit takes it over.
+    WUJIHANDCPP_API void read_many_cached(
+        StorageRange range, std::chrono::steady_clock::duration max_age,
+        std::chrono::steady_clock::time_point deadline, device::CancellationToken token,
+        void (*callback)(Buffer8 context, bool success), Buffer8 callback_context);
+
+    /// Fills `out` with range.count values, in range order.
+    WUJIHANDCPP_API void get_many(StorageRange range, Buffer8* out);
+
+    /// Reads every unit of `range` once per `period` at low priority: sdo_thread spreads the
+    /// reads over the period, caps them per tick, and skips a unit while another operation holds
+    /// it; a checked read or write of a unit takes over a subscription read in flight.
+    /// `callback(context, i, value)` runs on sdo_thread, with i the position in the range, for
+    /// the first known value of a unit and then whenever it changes (whoever read it).
+    /// `release(context)` is called exactly once, when the subscription is gone.
+    /// Returns the id to pass to unsubscribe().
+    WUJIHANDCPP_API uint64_t subscribe(
+        StorageRange range, std::chrono::steady_clock::duration period,
+        void (*callback)(Buffer8 context, int index, Buffer8 value),
+        void (*release)(Buffer8 context), Buffer8 context);
+
+    /// Once this returns, the callback no longer runs. Called from the callback itself, the
+    /// subscription ends after the callback returns. Unknown ids are ignored.
+    WUJIHANDCPP_API void unsubscribe(uint64_t id);
+
     WUJIHANDCPP_API auto
         realtime_get_joint_actual_position() -> const std::atomic<double> (&)[5][4];
 
     WUJIHANDCPP_API auto realtime_get_joint_actual_effort() -> const std::atomic<double> (&)[5][4];
 
+    /// Error codes from the last PDO feedback frame; only updated while upstream is enabled.
+    WUJIHANDCPP_API auto realtime_get_joint_error_code() -> const std::atomic<uint32_t> (&)[5][4];
+
+    /// Number of PDO feedback frames received so far. Advances at the PDO rate while upstream is
+    /// enabled, after the realtime_get_* arrays have been updated with the frame.
+    WUJIHANDCPP_API uint64_t realtime_feedback_version() const;
+
+    /// Blocks until the feedback version differs from `version` or `deadline` passes, and
+    /// returns the version. Waiting costs the RX thread nothing while nobody waits.
+    WUJIHANDCPP_API uint64_t
+        wait_realtime_feedback(uint64_t version, std::chrono::steady_clock::time_point deadline);
+
     WUJIHANDCPP_API void realtime_set_joint_target_position(const double (&positions)[5][4]);
 
+    // Joint error events. The RX thread records every change of a joint's error code in two
+    // lock-free queues: one is polled by the application, the other is drained by sdo_thread,
+    // which logs the event and invokes the error callback.
+
+    /// Moves up to `max_count` pending events into `events`, oldest first, and returns how many.
+    /// Does not block or allocate. Only one thread may poll at a time. Events that arrive while
+    /// the queue is full are dropped and counted.
+    WUJIHANDCPP_API size_t
+        poll_joint_error_events(device::JointErrorEvent* events, size_t max_count);
+
+    /// Number of events dropped so far because the polled queue was full.
+    WUJIHANDCPP_API uint64_t dropped_joint_error_events() const;
+
+    /// `callback(context, event)` runs on sdo_thread for every event, right after it is logged.
+    /// Pass nullptr to remove it. Once this returns the previous callback no longer runs, so this
+    /// must not be called from the callback itself.
+    WUJIHANDCPP_API void set_joint_error_callback(
+        void (*callback)(Buffer8 context, const device::JointErrorEvent& event), Buffer8 context);
+
+    /// Description of a known error bit, or nullptr.
+    WUJIHANDCPP_API static const char* joint_error_description(int bit);
+
+    /// Counters of the USB receive path, cumulative since construction. Malformed frames are
+    /// counted and logged from sdo_thread rather than failing the receive callback.
+    struct RxStatistics {
+        uint64_t frame_count;             // Transfers handled by the receive callback
+        uint64_t parse_error_count;       // Malformed frames or responses to unknown objects
+        uint64_t dropped_log_event_count; // RX log records lost while the log queue was full
+        uint64_t callback_total_ns;       // Time spent in the receive callback
+        uint64_t callback_max_ns;
+    };
+
+    WUJIHANDCPP_API RxStatistics rx_statistics() const;
+
+    /// SDO round-trip latency of one target, cumulative since construction. Latency runs from
+    /// the first send of an operation to its confirmation by the device; operations completed
+    /// without a send (masked objects) are not counted. Quantiles are accurate to about 3%.
+    struct SdoLatency {
+        uint64_t count;         // Operations confirmed by the device
+        uint64_t timeout_count; // Operations that reached their deadline, sent or not
+        uint64_t mean_queue_ns; // Mean time from submit to the first send
+        uint64_t mean_ns;
+        uint64_t p50_ns;
+        uint64_t p90_ns;
+        uint64_t p99_ns;
+        uint64_t max_ns;
+    };
+
+    /// Latency of the objects of joint (`finger_id`, `joint_id`), or of the hand-level objects
+    /// if `finger_id` is -1. Throws std::invalid_argument for an out-of-range id.
+    WUJIHANDCPP_API SdoLatency sdo_latency(int finger_id, int joint_id) const;
+
+    /// Health of the realtime PDO loop since the current (or last) realtime controller was
+    /// attached. Always gathered: a tick costs three clock reads and a few relaxed atomic adds.
+    /// Durations are accurate to about 3%.
+    struct RealtimeStatistics {
+        struct Distribution {
+            uint64_t mean_ns;
+            uint64_t p50_ns;
+            uint64_t p99_ns;
+            uint64_t max_ns;
+        };
+
+        uint64_t period_ns;     // Control period, 0 if no controller was ever attached
+        uint64_t tick_count;    // Ticks run, i.e. step() calls
+        uint64_t overrun_count; // Periods skipped because a tick overran its deadline
+        Distribution lateness;  // Delay of each tick behind its scheduled time
+        Distribution step;      // IRealtimeController::step() execution time
+        Distribution submit;    // Time to encode and submit the RPDO frame
+    };
+
+    WUJIHANDCPP_API RealtimeStatistics realtime_statistics() const;
+
     WUJIHANDCPP_API void
         attach_realtime_controller(device::IRealtimeController* controller, bool enable_upstream);
 
@@ -120,11 +267,26 @@ public:
     WUJIHANDCPP_API void start_latency_test();
     WUJIHANDCPP_API void stop_latency_test();
 
+    /// Publishes every PDO feedback frame, with a history of the last `capacity` (a power of two)
+    /// snapshots, to the shared memory segment `name` for readers in other processes; see
+    /// wujihandcpp/utility/shared_state.hpp. Replaces a running publisher of this handler, and a
+    /// segment left under `name` by a publisher that is gone. Throws std::invalid_argument for a
+    /// bad name or capacity, std::runtime_error if another live publisher (of another handler or
+    /// process) owns `name`, and std::system_error (std::runtime_error off Linux) if the segment
+    /// cannot be created.
+    WUJIHANDCPP_API void start_state_publisher(const char* name, size_t capacity);
+
+    /// Removes the segment name; readers that still map it see it stop publishing.
+    WUJIHANDCPP_API void stop_state_publisher();
+
     WUJIHANDCPP_API Buffer8 get(int storage_id);
 
+    /// SDO reads/writes (including raw SDO) may be issued from any thread. This only lifts the
+    /// construction-thread restriction on realtime and latency test operations.
     WUJIHANDCPP_API void disable_thread_safe_check();
 
-    // Raw SDO operations for debugging
+    // Raw SDO operations for debugging. Any number of them may be in flight; operations on the
+    // same object (and direction) are sent one after another.
     WUJIHANDCPP_API std::vector<uint8_t> raw_sdo_read(
         uint16_t index, uint8_t sub_index, std::chrono::steady_clock::duration timeout);
 
@@ -132,6 +294,29 @@ public:
         uint16_t index, uint8_t sub_index, const void* data, size_t size,
         std::chrono::steady_clock::duration timeout);
 
+    /// Throw CancelledError when `token` is cancelled before the device answers.
+    WUJIHANDCPP_API std::vector<uint8_t> raw_sdo_read(
+        uint16_t index, uint8_t sub_index, std::chrono::steady_clock::time_point deadline,
+        device::CancellationToken token);
+
+    WUJIHANDCPP_API void raw_sdo_write(
+        uint16_t index, uint8_t sub_index, const void* data, size_t size,
+        std::chrono::steady_clock::time_point deadline, device::CancellationToken token);
+
+    /// The future holds the value bytes, or TimeoutError, CancelledError or ConnectionError.
+    WUJIHANDCPP_API std::future<std::vector<uint8_t>> raw_sdo_read_async(
+        uint16_t index, uint8_t sub_index, std::chrono::steady_clock::time_point deadline,
+        device::CancellationToken token);
+
+    WUJIHANDCPP_API std::future<void> raw_sdo_write_async(
+        uint16_t index, uint8_t sub_index, const void* data, size_t size,
+        std::chrono::steady_clock::time_point deadline, device::CancellationToken token);
+
+    /// Submits every read in one batch; returns one future per address, in order.
+    WUJIHANDCPP_API std::vector<std::future<std::vector<uint8_t>>> raw_sdo_read_many(
+        const SdoAddress* addresses, size_t count, std::chrono::steady_clock::time_point deadline,
+        device::CancellationToken token);
+
 private:
     // Library-internal accessor; not WUJIHANDCPP_API-exported. Available to
     // device::Hand (friend) for SN-registry bookkeeping. External consumers
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+#include <thread>
+
+namespace wujihandcpp {
+namespace utility {
+
+// Latest-wins mailbox between any number of producers and one consumer: a triple buffer.
+//
+// publish() writes the value into the producers' back buffer and swaps it with the middle one;
+// take() swaps the middle buffer with the consumer's front buffer if it holds a value not yet
+// taken. A value published while the previous one is still in the middle replaces it, and the
+// replaced value is counted as superseded, so the consumer only ever sees the newest value and
+// never a mix of two. take() is wait-free, for realtime threads. Producers are serialized by a
+// spin lock held for the copy of one value.
+template <typename T>
+class LatestMailbox {
+public:
+    struct Statistics {
+        uint64_t published;  // Values published
+        uint64_t taken;      // Values taken by the consumer
+        uint64_t superseded; // Values replaced by a newer one before the consumer took them
+    };
+
+    LatestMailbox()
+        : middle_(1)
+        , back_(2)
+        , front_(0)
+        , published_(0)
+        , taken_(0)
+        , superseded_(0) {
+        producer_lock_.clear();
+    }
+
+    LatestMailbox(const LatestMailbox&) = delete;
+    LatestMailbox& operator=(const LatestMailbox&) = delete;
+
+    // Call from any thread
+    void publish(const T& value) noexcept {
+        while (producer_lock_.test_and_set(std::memory_order_acquire))
+            std::this_thread::yield();
+
+        const uint64_t sequence = published_.load(std::memory_order_relaxed) + 1;
+        slots_[back_].value = value;
+        slots_[back_].sequence = sequence;
+        const uint32_t previous = middle_.exchange(back_ | fresh_bit, std::memory_order_acq_rel);
+        back_ = previous & index_mask;
+        published_.store(sequence, std::memory_order_relaxed);
+        if (previous & fresh_bit)
+            superseded_.fetch_add(1, std::memory_order_relaxed);
+
+        producer_lock_.clear(std::memory_order_release);
+    }
+
+    // Call from the consumer thread only. Returns the newest value not yet taken, with its
+    // sequence (1 for the first value published, then +1 per value), or null if there is none.
+    // The value stays valid until the next call.
+    const T* take(uint64_t* sequence = nullptr) noexcept {
+        if (!(middle_.load(std::memory_order_relaxed) & fresh_bit))
+            return nullptr;
+
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index_mask;
+        taken_.store(taken_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (sequence)
+            *sequence = slots_[front_].sequence;
+        return &slots_[front_].value;
+    }
+
+    // Call from any thread. The counters are read one by one, so they may be a value apart.
+    Statistics statistics() const noexcept {
+        Statistics result;
+        result.taken = taken_.load(std::memory_order_relaxed);
+        result.superseded = superseded_.load(std::memory_order_relaxed);
+        result.published = published_.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    static const uint32_t index_mask = 0x3;
+    static const uint32_t fresh_bit = 0x4; // The middle buffer holds a value not yet taken
+
+    struct Slot {
+        T value;
+        uint64_t sequence;
+    };
+    Slot slots_[3];
+
+    std::atomic<uint32_t> middle_; // Index, and fresh_bit
+    uint32_t back_;                // Owned by the producer holding the lock
+    uint32_t front_;               // Owned by the consumer
+
+    std::atomic_flag producer_lock_;
+
+    std::atomic<uint64_t> published_;
+    std::atomic<uint64_t> taken_;
+    std::atomic<uint64_t> superseded_;
+};
+
+} // namespace utility
+} // namespace wujihandcpp
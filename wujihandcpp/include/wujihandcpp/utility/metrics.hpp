@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include "wujihandcpp/utility/api.hpp"
+
+namespace wujihandcpp {
+namespace metrics {
+
+// Process-wide SDK health metrics: USB transfers and errors, SDO and raw SDO outcomes, PDO
+// deadline misses, RX parse errors, and frames or events dropped because a queue was full.
+// Hot paths update them lock-free, each thread in its own shard; a snapshot sums the shards.
+
+enum class Type : int {
+    COUNTER = 0,
+    GAUGE = 1,
+    HISTOGRAM = 2,
+};
+
+struct Sample {
+    const char* name;   // Prometheus metric name, e.g. "wujihand_sdo_operations_total"
+    const char* help;
+    const char* labels; // Label set without braces, e.g. `result="timeout"`; empty if none
+    Type type;
+
+    double value;   // Counter or gauge value; for histograms, the sum of all observations
+    uint64_t count; // Histograms only: number of observations
+
+    // Histograms only: bucket upper bounds, and the number of observations less than or
+    // equal to each bound (cumulative). The implicit +Inf bucket equals `count`.
+    std::vector<double> bucket_bounds;
+    std::vector<uint64_t> bucket_counts;
+};
+
+/// Reads every metric, sorted by name.
+WUJIHANDCPP_API std::vector<Sample> snapshot();
+
+/// Renders a snapshot in the Prometheus text exposition format (version 0.0.4).
+WUJIHANDCPP_API std::string prometheus_text();
+
+/// Starts a background thread exporting prometheus_text(), replacing any running exporter.
+/// `target` is either a file path, rewritten atomically every `period_seconds` (suitable for
+/// the node_exporter textfile collector), or `unix:<path>` to answer every connection to that
+/// Unix domain socket with a fresh snapshot (plain HTTP if the client sends a GET request,
+/// raw text otherwise). Throws std::runtime_error if the target cannot be set up.
+WUJIHANDCPP_API void start_exporter(const char* target, double period_seconds = 10.0);
+
+WUJIHANDCPP_API void stop_exporter() noexcept;
+
+} // namespace metrics
+} // namespace wujihandcpp
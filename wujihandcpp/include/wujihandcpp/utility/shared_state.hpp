@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+# include <cerrno>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace wujihandcpp {
+namespace shared_state {
+
+// Shared-memory publication of hand feedback, for any number of readers on the same machine.
+//
+// A Handler with the publisher started (Hand::start_state_publisher) writes every PDO feedback
+// frame into a POSIX shared memory segment (/dev/shm/<name> on Linux): a Header followed by a
+// ring of `capacity` Slots holding the most recent snapshots. Each slot is guarded by its own
+// seqlock, so the single writer never waits for readers and readers never block each other.
+// Feedback only flows while a realtime controller with upstream enabled is attached.
+//
+// The layout is fixed-size, little-endian and the same for C++ and Python
+// (wujihandpy.shared_state); `version` changes whenever it does. This header only depends on the
+// C++11 standard library and POSIX, so readers need not link against wujihandcpp.
+
+static const uint64_t magic = 0x0045544154534A57; // "WJSTATE\0"
+static const uint32_t version = 1;
+
+/// One feedback snapshot.
+struct HandState {
+    uint64_t sequence;       // 1 for the first snapshot of the segment, then +1 per snapshot
+    uint64_t steady_time_ns; // std::chrono::steady_clock (CLOCK_MONOTONIC) at publication
+    uint64_t system_time_ns; // std::chrono::system_clock at publication
+    uint32_t flags;          // HandState::Flags
+    uint32_t reserved;
+
+    enum Flags : uint32_t {
+        HAS_EFFORT_AND_ERROR_CODE = 1u << 0, // Otherwise the frame held positions only
+    };
+
+    double position[5][4];       // rad, as realtime_get_joint_actual_position()
+    double effort[5][4];         // As realtime_get_joint_actual_effort()
+    uint32_t error_code[5][4];   // As realtime_get_joint_error_code()
+};
+
+struct alignas(64) Slot {
+    // Seqlock word: 2 * sequence + 1 while the slot is being written, 2 * sequence afterwards.
+    std::atomic<uint64_t> lock;
+    HandState state;
+};
+
+struct alignas(64) Header {
+    std::atomic<uint64_t> magic;     // Stored last, with release, once the header is complete
+    uint32_t version;
+    uint32_t header_size;            // sizeof(Header), offset of the first slot
+    uint32_t slot_size;              // sizeof(Slot)
+    uint32_t capacity;               // Number of slots, a power of two
+    uint32_t publisher_pid;
+    std::atomic<uint32_t> publishing; // 1 while the publisher runs, 0 once it stopped
+    std::atomic<uint64_t> head;       // Snapshots published; the newest has sequence `head`
+};
+
+static_assert(sizeof(HandState) == 432, "");
+static_assert(sizeof(Slot) == 448, "");
+static_assert(sizeof(Header) == 64, "");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "");
+
+inline size_t segment_size(uint32_t capacity) {
+    return sizeof(Header) + static_cast<size_t>(capacity) * sizeof(Slot);
+}
+
+/// POSIX shared memory object name for `name`: a leading '/' is added if missing.
+inline std::string object_name(const char* name) {
+    std::string result = name ? name : "";
+    if (result.empty() || result[0] != '/')
+        result.insert(result.begin(), '/');
+    return result;
+}
+
+/// Seqlock read of the snapshot with the given sequence number from `slots`. Returns false if it
+/// is not published yet, was overwritten, or is being overwritten right now.
+inline bool read_slot(
+    const Header& header, const Slot* slots, uint64_t sequence, HandState& out) noexcept {
+    if (sequence == 0 || sequence > header.head.load(std::memory_order_acquire))
+        return false;
+
+    const Slot& slot = slots[(sequence - 1) & (header.capacity - 1)];
+    const uint64_t before = slot.lock.load(std::memory_order_acquire);
+    if (before != 2 * sequence)
+        return false;
+    std::memcpy(&out, &slot.state, sizeof(HandState));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.lock.load(std::memory_order_relaxed) == before;
+}
+
+#if defined(__linux__)
+
+/// Read-only view of a segment published by another (or the same) process. Reads never block,
+/// allocate or enter the kernel; a copy of a snapshot takes well under a microsecond.
+///
+/// A publisher that restarts creates a new segment under the same name; this reader keeps the
+/// old one, whose `publishing()` turns false. Open a new reader then.
+class SharedStateReader {
+public:
+    /// Throws std::runtime_error if the segment does not exist or is not a state segment.
+    explicit SharedStateReader(const char* name)
+        : mapping_(nullptr)
+        , size_(0) {
+        const std::string object = object_name(name);
+        const int fd = ::shm_open(object.c_str(), O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0)
+            throw std::runtime_error(
+                "Failed to open shared state " + object + ": " + std::strerror(errno));
+
+        struct stat status;
+        if (::fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(Header)) {
+            ::close(fd);
+            throw std::runtime_error("Shared state " + object + " is truncated");
+        }
+        size_ = static_cast<size_t>(status.st_size);
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+            throw std::runtime_error(
+                "Failed to map shared state " + object + ": " + std::strerror(errno));
+        mapping_ = mapping;
+
+        const Header& header = this->header();
+        if (header.magic.load(std::memory_order_acquire) != magic || header.version != version
+            || header.header_size != sizeof(Header) || header.slot_size != sizeof(Slot)
+            || header.capacity == 0 || (header.capacity & (header.capacity - 1)) != 0
+            || size_ < segment_size(header.capacity)) {
+            ::munmap(mapping_, size_);
+            throw std::runtime_error(
+                "Shared state " + object + " has an unsupported layout (version "
+                + std::to_string(header.version) + ")");
+        }
+    }
+
+    SharedStateReader(const SharedStateReader&) = delete;
+    SharedStateReader& operator=(const SharedStateReader&) = delete;
+
+    ~SharedStateReader() { ::munmap(mapping_, size_); }
+
+    const Header& header() const noexcept { return *static_cast<const Header*>(mapping_); }
+
+    /// Sequence number of the newest snapshot, 0 if none was published yet.
+    uint64_t head() const noexcept { return header().head.load(std::memory_order_acquire); }
+
+    uint32_t capacity() const noexcept { return header().capacity; }
+
+    bool publishing() const noexcept {
+        return header().publishing.load(std::memory_order_relaxed) != 0;
+    }
+
+    /// Copies the snapshot with the given sequence number; see read_slot().
+    bool read(uint64_t sequence, HandState& out) const noexcept {
+        return read_slot(header(), slots(), sequence, out);
+    }
+
+    /// Copies the newest snapshot. Returns false if none was published yet, or if no attempt
+    /// out of a bounded number succeeded: a publisher that dies while writing leaves its slot
+    /// locked for good, and with a capacity of 1 there is no other slot to read instead.
+    bool read_latest(HandState& out) const noexcept {
+        for (int attempt = 0; attempt < max_read_attempts; attempt++) {
+            const uint64_t sequence = head();
+            if (sequence == 0)
+                return false;
+            if (read(sequence, out))
+                return true;
+        }
+        return false;
+    }
+
+private:
+    // A write takes well under a microsecond, far less than this many failed attempts
+    static const int max_read_attempts = 1000;
+
+    const Slot* slots() const noexcept {
+        return reinterpret_cast<const Slot*>(static_cast<const char*>(mapping_) + sizeof(Header));
+    }
+
+    void* mapping_;
+    size_t size_;
+};
+
+#endif
+
+} // namespace shared_state
+} // namespace wujihandcpp
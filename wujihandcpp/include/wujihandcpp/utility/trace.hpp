@@ -0,0 +1,29 @@
+#pragma once
+
+#include "wujihandcpp/utility/api.hpp"
+
+namespace wujihandcpp {
+namespace trace {
+
+// Every SDK thread keeps its last 8192 hot-path events (SDO submits and completions, PDO ticks,
+// USB transfers, tactile frames) in a binary ring buffer. Recording is lock-free and does not
+// format anything, so it is enabled by default; set WUJI_TRACE=0 to start disabled. The SDK
+// dumps the buffers next to the log files on transport and frame parsing errors.
+//
+// Span mode additionally records begin and end spans of the USB receive callback, the SDO and
+// PDO ticks, the tactile reader and user callbacks, so that a dump shows how the threads
+// interleave. It is off by default; set WUJI_TRACE_SPANS=1 to start with it on.
+//
+// Decode a dump with `python -m wujihandpy.trace_decoder <file>` (text), or add
+// `--format chrome` for Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+
+WUJIHANDCPP_API void set_enabled(bool value) noexcept;
+
+/// Turns span mode on or off. Spans are only recorded while tracing is enabled as well.
+WUJIHANDCPP_API void set_spans_enabled(bool value) noexcept;
+
+/// Writes every thread's buffer to `path`. Returns false if the file could not be written.
+WUJIHANDCPP_API bool dump(const char* path) noexcept;
+
+} // namespace trace
+} // namespace wujihandcpp
@@ -3,6 +3,9 @@
 #include <chrono>
 #include <cstring>
 
+#include "metrics/metrics.hpp"
+#include "trace/trace.hpp"
+
 namespace wujihandcpp {
 namespace tactile {
 
@@ -27,6 +30,13 @@ inline uint16_t read_le16(const uint8_t* p) {
     return static_cast<uint16_t>(p[0] | (p[1] << 8));
 }
 
+inline uint32_t read_le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0])
+         | (static_cast<uint32_t>(p[1]) << 8)
+         | (static_cast<uint32_t>(p[2]) << 16)
+         | (static_cast<uint32_t>(p[3]) << 24);
+}
+
 inline void write_le16(uint8_t* p, uint16_t v) {
     p[0] = static_cast<uint8_t>(v & 0xFF);
     p[1] = static_cast<uint8_t>(v >> 8);
@@ -243,8 +253,16 @@ std::vector<uint8_t> FrameDemuxer::single_command(Cmd cmd, const uint8_t* payloa
 }
 
 void FrameDemuxer::handle_data_frame(const uint8_t* buf) {
+    trace::ScopedSpan span{trace::Span::TACTILE_FRAME};
+    trace::record(
+        trace::Event::TACTILE_FRAME, buf[protocol::OFFSET_HAND],
+        read_le16(buf + protocol::OFFSET_SEQUENCE), read_le32(buf + protocol::OFFSET_TIMESTAMP));
+    metrics::tactile_frames.add();
     std::lock_guard<std::mutex> lock(frame_mu_);
-    if (frame_queue_.size() >= MAX_QUEUE) frame_queue_.pop_front();
+    if (frame_queue_.size() >= MAX_QUEUE) {
+        frame_queue_.pop_front();
+        metrics::tactile_frames_dropped.add();
+    }
     frame_queue_.emplace_back();
     std::memcpy(frame_queue_.back().data(), buf, protocol::FRAME_SIZE);
     frame_cv_.notify_one();
@@ -358,12 +376,18 @@ void FrameDemuxer::reader_loop() {
             if (partial) continue;
 
             uint16_t length = read_le16(buf.data() + protocol::OFFSET_LENGTH);
-            if (length != protocol::EXPECTED_LENGTH) continue;
+            if (length != protocol::EXPECTED_LENGTH) {
+                metrics::tactile_frames_invalid.add();
+                continue;
+            }
             uint16_t expected_crc = read_le16(buf.data() + protocol::OFFSET_CRC);
             uint16_t computed_crc = protocol::crc16_ccitt(
                 buf.data() + protocol::OFFSET_LENGTH,
                 protocol::OFFSET_CRC - protocol::OFFSET_LENGTH);
-            if (expected_crc != computed_crc) continue;
+            if (expected_crc != computed_crc) {
+                metrics::tactile_frames_invalid.add();
+                continue;
+            }
             handle_data_frame(buf.data());
         } else if (b == 0x57) {
             uint8_t buf[FRAME_MAX];
@@ -17,6 +17,10 @@ WUJIHANDCPP_API void Latch::count_up() noexcept {
     waiting_count_.fetch_add(1, std::memory_order_relaxed);
 }
 
+WUJIHANDCPP_API void Latch::count_up(int count) noexcept {
+    waiting_count_.fetch_add(count, std::memory_order_relaxed);
+}
+
 WUJIHANDCPP_API void Latch::count_down(bool success) noexcept {
     if (!success)
         error_count_.fetch_add(1, std::memory_order_relaxed);
@@ -12,6 +12,7 @@
 #include "../transport/cdc_byte_stream.hpp"
 #include "../transport/cdc_transport.hpp"
 #include "frame_demuxer.hpp"
+#include "trace/trace.hpp"
 
 namespace wujihandcpp {
 namespace tactile {
@@ -207,6 +208,7 @@ struct Glove::Impl {
             }
             Frame frame = protocol::parse_frame(buf);
             try {
+                trace::ScopedSpan span{trace::Span::TACTILE_CALLBACK};
                 callback(frame);
             } catch (...) {
                 break;  // user callback raised; exit the consumer
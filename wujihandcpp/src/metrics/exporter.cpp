@@ -0,0 +1,268 @@
+#include <cerrno>
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#ifdef __linux__
+# include <poll.h>
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/un.h>
+# include <unistd.h>
+#endif
+
+#include <wujihandcpp/utility/api.hpp>
+#include <wujihandcpp/utility/metrics.hpp>
+
+#include "logging/logging.hpp"
+
+namespace wujihandcpp::metrics {
+
+namespace {
+
+constexpr std::string_view unix_prefix = "unix:";
+
+// Rewrites the file through a rename, so that collectors never read a partial snapshot.
+void write_file(const std::filesystem::path& path) {
+    auto temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+        file << prometheus_text();
+        file.close();
+        if (file.fail())
+            throw std::runtime_error("Failed to write " + temporary.string());
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+void file_exporter_main(
+    const std::stop_token& stop_token, const std::filesystem::path& path,
+    std::chrono::steady_clock::duration period) {
+    auto& logger = logging::get_logger();
+    bool failing = false;
+
+    std::mutex mutex;
+    std::condition_variable_any stopped;
+    std::unique_lock lock{mutex};
+    do {
+        try {
+            write_file(path);
+            failing = false;
+        } catch (const std::exception& ex) {
+            // Report once per failure streak rather than every period
+            if (!failing)
+                logger.error("Metrics export to {} failed: {}", path.string(), ex.what());
+            failing = true;
+        }
+    } while (!stopped.wait_for(
+        lock, stop_token, period, [&stop_token] { return stop_token.stop_requested(); }));
+}
+
+#ifdef __linux__
+
+class UnixSocketServer {
+public:
+    explicit UnixSocketServer(const std::string& path)
+        : path_(path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path))
+            throw std::runtime_error(std::format("Invalid Unix socket path: \"{}\"", path));
+        path.copy(address.sun_path, path.size());
+
+        remove_stale_socket(address);
+
+        fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd_ < 0)
+            throw_system_error("create socket");
+        if (::bind(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            auto error = errno;
+            ::close(fd_); // Not ours to unlink: the path may belong to another exporter
+            fd_ = -1;
+            errno = error;
+            throw_system_error("bind to " + path);
+        }
+        if (::listen(fd_, 8) != 0) {
+            auto error = errno;
+            ::close(fd_);
+            fd_ = -1;
+            ::unlink(path.c_str());
+            errno = error;
+            throw_system_error("listen on " + path);
+        }
+    }
+
+    UnixSocketServer(const UnixSocketServer&) = delete;
+    UnixSocketServer& operator=(const UnixSocketServer&) = delete;
+
+    ~UnixSocketServer() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            ::unlink(path_.c_str());
+        }
+    }
+
+    void serve(const std::stop_token& stop_token) {
+        constexpr int poll_interval_ms = 100;
+        while (!stop_token.stop_requested()) {
+            pollfd listening{.fd = fd_, .events = POLLIN, .revents = 0};
+            if (::poll(&listening, 1, poll_interval_ms) <= 0)
+                continue;
+
+            int client = ::accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0)
+                continue;
+            respond(client);
+            ::close(client);
+        }
+    }
+
+private:
+    // Removes the socket a previous exporter left at `address`. Refuses anything else at the
+    // path, and a socket a live process still accepts connections on.
+    static void remove_stale_socket(const sockaddr_un& address) {
+        const std::string path = address.sun_path;
+        struct stat status;
+        if (::lstat(path.c_str(), &status) != 0) {
+            if (errno == ENOENT)
+                return;
+            throw_system_error("stat " + path);
+        }
+        if (!S_ISSOCK(status.st_mode))
+            throw std::runtime_error(
+                std::format("Refusing to replace \"{}\": not a Unix socket", path));
+
+        int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (probe < 0)
+            throw_system_error("create socket");
+        int result =
+            ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        auto error = errno;
+        ::close(probe);
+        if (result == 0)
+            throw std::runtime_error(
+                std::format("Refusing to replace \"{}\": another process is serving on it", path));
+        if (error != ECONNREFUSED) {
+            errno = error;
+            throw_system_error("probe " + path);
+        }
+
+        if (::unlink(path.c_str()) != 0 && errno != ENOENT)
+            throw_system_error("remove stale socket " + path);
+    }
+
+    // Answers HTTP clients (curl --unix-socket, Prometheus behind a socket proxy) with an HTTP
+    // response, and anything that sends nothing within a short wait (socat, nc -U) with the
+    // bare text.
+    static void respond(int client) {
+        constexpr int request_wait_ms = 100;
+
+        char request[512];
+        ssize_t request_size = 0;
+        pollfd readable{.fd = client, .events = POLLIN, .revents = 0};
+        if (::poll(&readable, 1, request_wait_ms) > 0)
+            request_size = ::recv(client, request, sizeof(request), 0);
+
+        auto body = prometheus_text();
+        std::string response;
+        if (request_size >= 4 && std::string_view{request, 4} == "GET ")
+            response = std::format(
+                "HTTP/1.0 200 OK\r\n"
+                "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                "Content-Length: {}\r\n"
+                "Connection: close\r\n\r\n{}",
+                body.size(), body);
+        else
+            response = std::move(body);
+
+        const char* data = response.data();
+        size_t remaining = response.size();
+        while (remaining) {
+            auto sent = ::send(client, data, remaining, MSG_NOSIGNAL);
+            if (sent <= 0)
+                break;
+            data += sent;
+            remaining -= static_cast<size_t>(sent);
+        }
+    }
+
+    [[noreturn]] static void throw_system_error(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), "Failed to " + what);
+    }
+
+    std::string path_;
+    int fd_ = -1;
+};
+
+#endif
+
+class Exporter {
+public:
+    static Exporter& get_instance() {
+        // Never destroyed: the export thread may still run while the process exits
+        static auto* instance = new Exporter;
+        return *instance;
+    }
+
+    void start(std::string_view target, double period_seconds) {
+        std::lock_guard guard{mutex_};
+        thread_ = {};
+
+        if (target.starts_with(unix_prefix)) {
+#ifdef __linux__
+            auto server = std::make_shared<UnixSocketServer>(
+                std::string{target.substr(unix_prefix.size())});
+            thread_ = std::jthread{
+                [server](const std::stop_token& stop_token) { server->serve(stop_token); }};
+#else
+            throw std::runtime_error("Metrics export to a Unix socket is only supported on Linux");
+#endif
+        } else {
+            if (target.empty())
+                throw std::runtime_error("Metrics export target must not be empty");
+            if (!(period_seconds > 0))
+                throw std::runtime_error("Metrics export period must be positive");
+
+            std::filesystem::path path{target};
+            write_file(path); // Fail here, not in the background, if the path is unusable
+            auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(period_seconds));
+            thread_ = std::jthread{[path, period](const std::stop_token& stop_token) {
+                file_exporter_main(stop_token, path, period);
+            }};
+        }
+    }
+
+    void stop() noexcept {
+        std::lock_guard guard{mutex_};
+        thread_ = {};
+    }
+
+private:
+    Exporter() = default;
+
+    std::mutex mutex_;
+    std::jthread thread_;
+};
+
+} // namespace
+
+WUJIHANDCPP_API void start_exporter(const char* target, double period_seconds) {
+    Exporter::get_instance().start(target ? target : "", period_seconds);
+}
+
+WUJIHANDCPP_API void stop_exporter() noexcept { Exporter::get_instance().stop(); }
+
+} // namespace wujihandcpp::metrics
@@ -0,0 +1,290 @@
+#include <cstring>
+
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <wujihandcpp/utility/api.hpp>
+#include <wujihandcpp/utility/metrics.hpp>
+
+#include "metrics/metrics.hpp"
+
+namespace wujihandcpp::metrics {
+
+Counter usb_out_transfers{
+    "wujihand_usb_transfers_total", "USB transfers completed successfully", R"(direction="out")"};
+Counter usb_in_transfers{
+    "wujihand_usb_transfers_total", "USB transfers completed successfully", R"(direction="in")"};
+Counter usb_out_transfer_errors{
+    "wujihand_usb_transfer_errors_total", "USB transfers completed with an error status",
+    R"(direction="out")"};
+Counter usb_in_transfer_errors{
+    "wujihand_usb_transfer_errors_total", "USB transfers completed with an error status",
+    R"(direction="in")"};
+Counter usb_out_bytes{
+    "wujihand_usb_bytes_total", "Bytes transferred over USB", R"(direction="out")"};
+Counter usb_in_bytes{"wujihand_usb_bytes_total", "Bytes transferred over USB", R"(direction="in")"};
+Gauge usb_out_transfers_in_flight{
+    "wujihand_usb_transfers_in_flight", "USB transfers submitted and not yet completed",
+    R"(direction="out")"};
+Gauge usb_in_transfers_in_flight{
+    "wujihand_usb_transfers_in_flight", "USB transfers submitted and not yet completed",
+    R"(direction="in")"};
+Counter transport_errors{
+    "wujihand_transport_errors_total", "Transport failures that stopped a device connection"};
+
+Counter tx_frames_dropped{
+    "wujihand_tx_frames_dropped_total",
+    "Outgoing frames dropped because no transmit buffer was free"};
+
+RealtimeLoopCounter pdo_ticks{
+    "wujihand_pdo_ticks_total", "PDO control loop iterations", &RealtimeLoop::tick_count};
+RealtimeLoopCounter pdo_deadline_misses{
+    "wujihand_pdo_deadline_misses_total",
+    "PDO control loop periods skipped because an iteration overran",
+    &RealtimeLoop::overrun_count};
+RealtimeLoopHistogram pdo_tick_lateness{
+    "wujihand_pdo_tick_lateness_seconds",
+    "Delay of PDO control loop iterations behind their schedule", &RealtimeLoop::lateness_ns,
+    {10e-6, 20e-6, 50e-6, 100e-6, 200e-6, 500e-6, 1e-3, 2e-3, 5e-3}};
+RealtimeLoopHistogram pdo_step_duration{
+    "wujihand_pdo_step_duration_seconds", "Execution time of the realtime controller's step()",
+    &RealtimeLoop::step_ns,
+    {1e-6, 2e-6, 5e-6, 10e-6, 20e-6, 50e-6, 100e-6, 200e-6, 500e-6, 1e-3, 2e-3}};
+RealtimeLoopHistogram pdo_submit_duration{
+    "wujihand_pdo_submit_duration_seconds", "Time to encode and submit one RPDO frame",
+    &RealtimeLoop::submit_ns,
+    {1e-6, 2e-6, 5e-6, 10e-6, 20e-6, 50e-6, 100e-6, 200e-6, 500e-6, 1e-3}};
+
+RealtimeLoop::RealtimeLoop() noexcept {
+    std::lock_guard guard{mutex_};
+    next_ = head_;
+    if (next_)
+        next_->previous_ = this;
+    head_ = this;
+}
+
+RealtimeLoop::~RealtimeLoop() {
+    std::lock_guard guard{mutex_};
+    retire();
+    (previous_ ? previous_->next_ : head_) = next_;
+    if (next_)
+        next_->previous_ = previous_;
+}
+
+void RealtimeLoop::reset() noexcept {
+    std::lock_guard guard{mutex_};
+    retire();
+    tick_count.store(0, std::memory_order::relaxed);
+    overrun_count.store(0, std::memory_order::relaxed);
+    lateness_ns.reset();
+    step_ns.reset();
+    submit_ns.reset();
+}
+
+void RealtimeLoop::retire() noexcept {
+    for (auto counter : {&pdo_ticks, &pdo_deadline_misses})
+        counter->retired_ += (this->*counter->member_).load(std::memory_order::relaxed);
+    for (auto histogram : {&pdo_tick_lateness, &pdo_step_duration, &pdo_submit_duration}) {
+        auto snapshot = (this->*histogram->member_).snapshot();
+        for (size_t i = 0; i < snapshot.buckets.size(); i++)
+            histogram->retired_buckets_[i] += snapshot.buckets[i];
+        histogram->retired_sum_ns_ += snapshot.sum;
+    }
+}
+
+void RealtimeLoopCounter::collect(Sample& sample) const {
+    sample = make_sample();
+    std::lock_guard guard{RealtimeLoop::mutex_};
+    auto value = retired_;
+    for (auto loop = RealtimeLoop::head_; loop; loop = loop->next_)
+        value += (loop->*member_).load(std::memory_order::relaxed);
+    sample.value = static_cast<double>(value);
+}
+
+void RealtimeLoopHistogram::collect(Sample& sample) const {
+    using HdrHistogram = utility::HdrHistogram<>;
+    sample = make_sample();
+
+    std::array<uint64_t, HdrHistogram::bucket_count> buckets;
+    uint64_t sum_ns;
+    {
+        std::lock_guard guard{RealtimeLoop::mutex_};
+        buckets = retired_buckets_;
+        sum_ns = retired_sum_ns_;
+        for (auto loop = RealtimeLoop::head_; loop; loop = loop->next_) {
+            auto snapshot = (loop->*member_).snapshot();
+            for (size_t i = 0; i < buckets.size(); i++)
+                buckets[i] += snapshot.buckets[i];
+            sum_ns += snapshot.sum;
+        }
+    }
+
+    std::array<uint64_t, Histogram::max_bounds + 1> counts{};
+    for (size_t i = 0; i < buckets.size(); i++) {
+        if (!buckets[i])
+            continue;
+        auto lower = HdrHistogram::bucket_lower_bound(i);
+        auto middle = lower + (HdrHistogram::bucket_upper_bound(i) - lower) / 2;
+        size_t bound = 0;
+        while (bound < bound_count_ && static_cast<double>(middle) * 1e-9 > bounds_[bound])
+            bound++;
+        counts[bound] += buckets[i];
+    }
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < bound_count_; i++) {
+        cumulative += counts[i];
+        sample.bucket_bounds.push_back(bounds_[i]);
+        sample.bucket_counts.push_back(cumulative);
+    }
+    sample.count = cumulative + counts[bound_count_];
+    sample.value = static_cast<double>(sum_ns) * 1e-9;
+}
+
+Counter sdo_succeeded{
+    "wujihand_sdo_operations_total", "Completed SDO read and write operations",
+    R"(result="success")"};
+Counter sdo_timed_out{
+    "wujihand_sdo_operations_total", "Completed SDO read and write operations",
+    R"(result="timeout")"};
+Counter sdo_cancelled{
+    "wujihand_sdo_operations_total", "Completed SDO read and write operations",
+    R"(result="cancelled")"};
+Counter sdo_disconnected{
+    "wujihand_sdo_operations_total", "Completed SDO read and write operations",
+    R"(result="disconnected")"};
+
+SdoTargetMetrics::SdoTargetMetrics(const char* labels) noexcept
+    : latency{
+          "wujihand_sdo_latency_seconds",
+          "Time from sending an SDO operation to its confirmation by the device",
+          {500e-6, 1e-3, 2e-3, 5e-3, 10e-3, 20e-3, 50e-3, 100e-3, 200e-3, 500e-3, 1.0},
+          labels}
+    , timeouts{
+          "wujihand_sdo_timeouts_total", "SDO operations that reached their deadline", labels} {}
+
+// Hand-level objects carry no finger or joint label
+SdoTargetMetrics sdo_targets[sdo_target_count]{
+    "",
+    R"(finger="0",joint="0")", R"(finger="0",joint="1")", R"(finger="0",joint="2")",
+    R"(finger="0",joint="3")", R"(finger="1",joint="0")", R"(finger="1",joint="1")",
+    R"(finger="1",joint="2")", R"(finger="1",joint="3")", R"(finger="2",joint="0")",
+    R"(finger="2",joint="1")", R"(finger="2",joint="2")", R"(finger="2",joint="3")",
+    R"(finger="3",joint="0")", R"(finger="3",joint="1")", R"(finger="3",joint="2")",
+    R"(finger="3",joint="3")", R"(finger="4",joint="0")", R"(finger="4",joint="1")",
+    R"(finger="4",joint="2")", R"(finger="4",joint="3")",
+};
+
+Counter raw_sdo_succeeded{
+    "wujihand_raw_sdo_operations_total", "Completed raw SDO read and write operations",
+    R"(result="success")"};
+Counter raw_sdo_timed_out{
+    "wujihand_raw_sdo_operations_total", "Completed raw SDO read and write operations",
+    R"(result="timeout")"};
+Counter raw_sdo_cancelled{
+    "wujihand_raw_sdo_operations_total", "Completed raw SDO read and write operations",
+    R"(result="cancelled")"};
+Counter raw_sdo_disconnected{
+    "wujihand_raw_sdo_operations_total", "Completed raw SDO read and write operations",
+    R"(result="disconnected")"};
+
+Counter rx_frames{"wujihand_rx_frames_total", "USB frames received from hands"};
+Counter rx_parse_errors{
+    "wujihand_rx_parse_errors_total", "Received frames that could not be parsed completely"};
+Counter rx_log_events_dropped{
+    "wujihand_rx_log_events_dropped_total",
+    "Receive-side log records lost because the log queue was full"};
+Histogram rx_callback_duration{
+    "wujihand_rx_callback_duration_seconds", "Time spent handling one received USB transfer",
+    {1e-6, 2e-6, 5e-6, 10e-6, 20e-6, 50e-6, 100e-6, 200e-6, 500e-6, 1e-3}};
+
+Counter joint_error_events_dropped_poll{
+    "wujihand_joint_error_events_dropped_total",
+    "Joint error events lost because a queue was full", R"(queue="poll")"};
+Counter joint_error_events_dropped_log{
+    "wujihand_joint_error_events_dropped_total",
+    "Joint error events lost because a queue was full", R"(queue="log")"};
+
+Counter tactile_frames{"wujihand_tactile_frames_total", "Tactile data frames received"};
+Counter tactile_frames_dropped{
+    "wujihand_tactile_frames_dropped_total",
+    "Tactile data frames discarded unread because the frame queue was full"};
+Counter tactile_frames_invalid{
+    "wujihand_tactile_frames_invalid_total",
+    "Tactile data frames rejected for a bad length or CRC"};
+
+namespace {
+
+const char* type_name(Type type) {
+    if (type == Type::COUNTER)
+        return "counter";
+    else if (type == Type::GAUGE)
+        return "gauge";
+    else
+        return "histogram";
+}
+
+void append_series(
+    std::string& out, const Sample& sample, const char* suffix, const std::string& extra_label,
+    double value) {
+    out += sample.name;
+    out += suffix;
+    bool has_labels = *sample.labels != '\0';
+    if (has_labels || !extra_label.empty()) {
+        out += '{';
+        out += sample.labels;
+        if (has_labels && !extra_label.empty())
+            out += ',';
+        out += extra_label;
+        out += '}';
+    }
+    std::format_to(std::back_inserter(out), " {}\n", value);
+}
+
+} // namespace
+
+WUJIHANDCPP_API std::vector<Sample> snapshot() {
+    std::vector<Sample> samples;
+    for (auto metric = Metric::first(); metric; metric = metric->next())
+        metric->collect(samples.emplace_back());
+
+    // Registration prepends, so restore definition order before grouping families by name
+    std::reverse(samples.begin(), samples.end());
+    std::stable_sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) {
+        return std::strcmp(a.name, b.name) < 0;
+    });
+    return samples;
+}
+
+WUJIHANDCPP_API std::string prometheus_text() {
+    std::string out;
+    const char* family = nullptr;
+    for (auto& sample : snapshot()) {
+        if (!family || std::strcmp(family, sample.name) != 0) {
+            family = sample.name;
+            std::format_to(std::back_inserter(out), "# HELP {} {}\n", sample.name, sample.help);
+            std::format_to(
+                std::back_inserter(out), "# TYPE {} {}\n", sample.name, type_name(sample.type));
+        }
+
+        if (sample.type != Type::HISTOGRAM) {
+            append_series(out, sample, "", {}, sample.value);
+            continue;
+        }
+        for (size_t i = 0; i < sample.bucket_bounds.size(); i++)
+            append_series(
+                out, sample, "_bucket", std::format(R"(le="{}")", sample.bucket_bounds[i]),
+                static_cast<double>(sample.bucket_counts[i]));
+        append_series(
+            out, sample, "_bucket", R"(le="+Inf")", static_cast<double>(sample.count));
+        append_series(out, sample, "_sum", {}, sample.value);
+        append_series(out, sample, "_count", {}, static_cast<double>(sample.count));
+    }
+    return out;
+}
+
+} // namespace wujihandcpp::metrics
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <initializer_list>
+#include <mutex>
+
+#include <wujihandcpp/utility/metrics.hpp>
+
+#include "utility/hdr_histogram.hpp"
+
+namespace wujihandcpp::metrics {
+
+// Each thread updates its own cache-line-sized shard, so hot-path updates never contend.
+// Threads beyond shard_count share shards, which stays correct since the adds are atomic.
+inline constexpr size_t shard_count = 16;
+
+inline size_t current_shard() noexcept {
+    static constinit std::atomic<size_t> next_shard{0};
+    thread_local const size_t shard =
+        next_shard.fetch_add(1, std::memory_order::relaxed) % shard_count;
+    return shard;
+}
+
+// Metrics are static objects that link themselves into a global list on construction and are
+// never unlinked, so they must have static storage duration.
+class Metric {
+public:
+    Metric(const Metric&) = delete;
+    Metric& operator=(const Metric&) = delete;
+    Metric(Metric&&) = delete;
+    Metric& operator=(Metric&&) = delete;
+
+    static Metric* first() noexcept { return head_.load(std::memory_order::acquire); }
+    Metric* next() const noexcept { return next_; }
+
+    // Fills everything but the bucket vectors of non-histograms.
+    virtual void collect(Sample& sample) const = 0;
+
+protected:
+    Metric(const char* name, const char* help, const char* labels, Type type) noexcept
+        : name_(name)
+        , help_(help)
+        , labels_(labels)
+        , type_(type) {
+        next_ = head_.load(std::memory_order::relaxed);
+        while (!head_.compare_exchange_weak(
+            next_, this, std::memory_order::release, std::memory_order::relaxed)) {}
+    }
+
+    ~Metric() = default;
+
+    Sample make_sample() const {
+        return Sample{
+            .name = name_,
+            .help = help_,
+            .labels = labels_,
+            .type = type_,
+            .value = 0,
+            .count = 0,
+            .bucket_bounds = {},
+            .bucket_counts = {},
+        };
+    }
+
+private:
+    static constinit inline std::atomic<Metric*> head_{nullptr};
+
+    const char *name_, *help_, *labels_;
+    Type type_;
+    Metric* next_;
+};
+
+class Counter final : public Metric {
+public:
+    Counter(const char* name, const char* help, const char* labels = "") noexcept
+        : Metric(name, help, labels, Type::COUNTER) {}
+
+    void add(uint64_t value = 1) noexcept {
+        shards_[current_shard()].value.fetch_add(value, std::memory_order::relaxed);
+    }
+
+    uint64_t value() const noexcept {
+        uint64_t sum = 0;
+        for (auto& shard : shards_)
+            sum += shard.value.load(std::memory_order::relaxed);
+        return sum;
+    }
+
+    void collect(Sample& sample) const override {
+        sample = make_sample();
+        sample.value = static_cast<double>(value());
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, shard_count> shards_{};
+};
+
+// Gauges hold a current level rather than a rate, so they are not sharded.
+class Gauge final : public Metric {
+public:
+    Gauge(const char* name, const char* help, const char* labels = "") noexcept
+        : Metric(name, help, labels, Type::GAUGE) {}
+
+    void set(int64_t value) noexcept { value_.store(value, std::memory_order::relaxed); }
+    void add(int64_t value) noexcept { value_.fetch_add(value, std::memory_order::relaxed); }
+    void sub(int64_t value) noexcept { value_.fetch_sub(value, std::memory_order::relaxed); }
+
+    int64_t value() const noexcept { return value_.load(std::memory_order::relaxed); }
+
+    void collect(Sample& sample) const override {
+        sample = make_sample();
+        sample.value = static_cast<double>(value());
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> value_{0};
+};
+
+// Fixed-bucket histogram in the Prometheus sense: counts per upper bound plus a sum.
+class Histogram final : public Metric {
+public:
+    static constexpr size_t max_bounds = 15;
+
+    Histogram(
+        const char* name, const char* help, std::initializer_list<double> bounds,
+        const char* labels = "") noexcept
+        : Metric(name, help, labels, Type::HISTOGRAM) {
+        for (double bound : bounds)
+            if (bound_count_ < max_bounds)
+                bounds_[bound_count_++] = bound;
+    }
+
+    void observe(double value) noexcept {
+        size_t bucket = 0;
+        while (bucket < bound_count_ && value > bounds_[bucket])
+            bucket++;
+
+        auto& shard = shards_[current_shard()];
+        shard.buckets[bucket].fetch_add(1, std::memory_order::relaxed);
+        shard.sum.fetch_add(value, std::memory_order::relaxed);
+    }
+
+    void collect(Sample& sample) const override {
+        sample = make_sample();
+
+        std::array<uint64_t, max_bounds + 1> buckets{};
+        for (auto& shard : shards_) {
+            for (size_t i = 0; i <= bound_count_; i++)
+                buckets[i] += shard.buckets[i].load(std::memory_order::relaxed);
+            sample.value += shard.sum.load(std::memory_order::relaxed);
+        }
+
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < bound_count_; i++) {
+            cumulative += buckets[i];
+            sample.bucket_bounds.push_back(bounds_[i]);
+            sample.bucket_counts.push_back(cumulative);
+        }
+        sample.count = cumulative + buckets[bound_count_];
+    }
+
+private:
+    std::array<double, max_bounds> bounds_{};
+    size_t bound_count_ = 0;
+
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, max_bounds + 1> buckets{};
+        std::atomic<double> sum{0};
+    };
+    std::array<Shard, shard_count> shards_{};
+};
+
+// Health of one PDO control loop, recorded by the loop's thread and nowhere else. The owning
+// Handler reads it for realtime_statistics(); the pdo_* families below export the sum over
+// all live loops, plus what loops recorded before being reset or destroyed, so that the
+// exported series never go backwards. Loops register themselves for their lifetime.
+class RealtimeLoop {
+public:
+    RealtimeLoop() noexcept;
+    ~RealtimeLoop();
+
+    RealtimeLoop(const RealtimeLoop&) = delete;
+    RealtimeLoop& operator=(const RealtimeLoop&) = delete;
+    RealtimeLoop(RealtimeLoop&&) = delete;
+    RealtimeLoop& operator=(RealtimeLoop&&) = delete;
+
+    // Clears the loop's statistics. Call while no thread records.
+    void reset() noexcept;
+
+    std::atomic<uint64_t> tick_count{0};
+    std::atomic<uint64_t> overrun_count{0}; // Periods skipped after an iteration overran
+    utility::HdrHistogram<> lateness_ns, step_ns, submit_ns;
+
+private:
+    friend class RealtimeLoopCounter;
+    friend class RealtimeLoopHistogram;
+
+    void retire() noexcept; // mutex_
+
+    static constinit inline std::mutex mutex_;
+    static constinit inline RealtimeLoop* head_ = nullptr; // mutex_
+    RealtimeLoop *previous_ = nullptr, *next_ = nullptr;   // mutex_
+};
+
+// Exports one counter of every RealtimeLoop.
+class RealtimeLoopCounter final : public Metric {
+public:
+    using Member = std::atomic<uint64_t> RealtimeLoop::*;
+
+    RealtimeLoopCounter(const char* name, const char* help, Member member) noexcept
+        : Metric(name, help, "", Type::COUNTER)
+        , member_(member) {}
+
+    void collect(Sample& sample) const override;
+
+private:
+    friend class RealtimeLoop;
+
+    Member member_;
+    uint64_t retired_ = 0; // RealtimeLoop::mutex_
+};
+
+// Exports one nanosecond histogram of every RealtimeLoop as a Prometheus histogram in seconds.
+// A value is counted against the bounds by the midpoint of its HdrHistogram bucket, so counts
+// of values within the HdrHistogram precision (about 3%) of a bound may land on either side.
+class RealtimeLoopHistogram final : public Metric {
+public:
+    using Member = utility::HdrHistogram<> RealtimeLoop::*;
+
+    RealtimeLoopHistogram(
+        const char* name, const char* help, Member member,
+        std::initializer_list<double> bounds) noexcept
+        : Metric(name, help, "", Type::HISTOGRAM)
+        , member_(member) {
+        for (double bound : bounds)
+            if (bound_count_ < Histogram::max_bounds)
+                bounds_[bound_count_++] = bound;
+    }
+
+    void collect(Sample& sample) const override;
+
+private:
+    friend class RealtimeLoop;
+
+    Member member_;
+    std::array<double, Histogram::max_bounds> bounds_{};
+    size_t bound_count_ = 0;
+
+    // RealtimeLoop::mutex_
+    std::array<uint64_t, utility::HdrHistogram<>::bucket_count> retired_buckets_{};
+    uint64_t retired_sum_ns_ = 0;
+};
+
+// SDO round-trip latency and timeouts of one target, the hand or one joint. The constructor is
+// implicit so that an array of them can be initialized from label strings.
+struct SdoTargetMetrics {
+    SdoTargetMetrics(const char* labels) noexcept;
+
+    Histogram latency;
+    Counter timeouts;
+};
+
+// SDK metrics, defined in metrics.cpp.
+
+extern Counter usb_out_transfers, usb_in_transfers;
+extern Counter usb_out_transfer_errors, usb_in_transfer_errors;
+extern Counter usb_out_bytes, usb_in_bytes;
+extern Gauge usb_out_transfers_in_flight, usb_in_transfers_in_flight;
+extern Counter transport_errors;
+
+extern Counter tx_frames_dropped;
+
+extern RealtimeLoopCounter pdo_ticks, pdo_deadline_misses;
+extern RealtimeLoopHistogram pdo_tick_lateness, pdo_step_duration, pdo_submit_duration;
+
+extern Counter sdo_succeeded, sdo_timed_out, sdo_cancelled, sdo_disconnected;
+extern Counter raw_sdo_succeeded, raw_sdo_timed_out, raw_sdo_cancelled, raw_sdo_disconnected;
+
+// [0] for hand-level objects, [1 + 4 * finger_id + joint_id] for joints
+inline constexpr size_t sdo_target_count = 21;
+extern SdoTargetMetrics sdo_targets[sdo_target_count];
+
+extern Counter rx_frames, rx_parse_errors, rx_log_events_dropped;
+extern Histogram rx_callback_duration;
+
+extern Counter joint_error_events_dropped_poll, joint_error_events_dropped_log;
+
+extern Counter tactile_frames, tactile_frames_dropped, tactile_frames_invalid;
+
+} // namespace wujihandcpp::metrics
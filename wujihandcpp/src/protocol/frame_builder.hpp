@@ -12,6 +12,7 @@
 #include <spdlog/fmt/bin_to_hex.h>
 
 #include "logging/logging.hpp"
+#include "metrics/metrics.hpp"
 #include "protocol/protocol.hpp"
 #include "transport/transport.hpp"
 
@@ -49,6 +50,7 @@ public:
         if (!new_buffer) {
             reset_frame();
             dropped_frame_count_++;
+            metrics::tx_frames_dropped.add();
             return;
         }
 
@@ -10,6 +10,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <format>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -25,12 +26,24 @@
 #include <wujihandcpp/utility/api.hpp>
 
 #include "logging/logging.hpp"
+#include "metrics/metrics.hpp"
 #include "protocol/frame_builder.hpp"
 #include "protocol/latency_tester.hpp"
 #include "protocol/protocol.hpp"
+#include "protocol/raw_sdo.hpp"
+#include "protocol/rx_event.hpp"
+#include "protocol/state_publisher.hpp"
+#include "trace/trace.hpp"
 #include "transport/transport.hpp"
+#include "utility/hdr_histogram.hpp"
+#include "utility/mpsc_queue.hpp"
+#include "utility/ring_buffer.hpp"
 #include "utility/tick_executor.hpp"
 
+#ifdef WUJIHANDCPP_TESTING
+# include "protocol/handler_testing.hpp"
+#endif
+
 namespace wujihandcpp::protocol {
 
 class Handler::Impl {
@@ -40,9 +53,14 @@ public:
         , operation_thread_id_(std::this_thread::get_id())
         , storage_unit_count_(storage_unit_count)
         , storage_(std::make_unique<StorageUnit[]>(storage_unit_count))
+        , sdo_timing_(std::make_unique<SdoTiming[]>(storage_unit_count))
+        , request_queue_(storage_unit_count)
+        , cached_read_nodes_(std::make_unique<CachedReadNode[]>(storage_unit_count))
         , transport_(std::move(transport))
         , sdo_builder_(*transport_, 0x21)
-        , pdo_builder_(*transport_, 0x11) {}
+        , pdo_builder_(*transport_, 0x11) {
+        cached_read_units_.reserve(storage_unit_count);
+    }
 
     ~Impl() = default;
 
@@ -62,6 +80,9 @@ public:
                 transport_error_.store(true, std::memory_order::release);
             }
             logger_.error("Transport error: {}", message);
+            metrics::transport_errors.add();
+            trace::record(trace::Event::TRANSPORT_ERROR);
+            trace::dump_on_error("transport error");
             pdo_thread_.request_stop();
             // Do NOT request_stop on sdo_thread_ here: its loop checks stop_token
             // before transport_error_, so a stop request would skip
@@ -77,72 +98,239 @@ public:
             [this](const std::stop_token& stop_token) { sdo_thread_main(stop_token); }};
     }
 
-    void read_async_unchecked(int storage_id, std::chrono::steady_clock::duration::rep timeout) {
-        operation_thread_check();
+    // SDO submissions may come from any thread. A submitter claims the storage unit with a CAS
+    // (NONE or REFRESH -> QUEUED) and hands the rest of the request to sdo_thread through a
+    // lock-free MPSC queue; sdo_thread is the only writer of deadline/callback fields, and reports
+    // completion through each request's own callback.
 
-        if (storage_[storage_id].operation.load(std::memory_order::relaxed).mode
-            != Operation::Mode::NONE)
+    void read_async_unchecked(int storage_id, std::chrono::steady_clock::duration::rep timeout) {
+        if (!try_claim(storage_[storage_id], Operation::Mode::READ))
             return;
 
-        storage_[storage_id].timeout = std::chrono::steady_clock::duration(timeout);
-        storage_[storage_id].callback = nullptr;
-        storage_[storage_id].operation.store(
-            Operation{.mode = Operation::Mode::READ, .state = Operation::State::WAITING},
-            std::memory_order::release);
+        submit(Request{
+            .storage_id = storage_id,
+            .mode = Operation::Mode::READ,
+            .deadline = device::deadline_after(std::chrono::steady_clock::duration(timeout)),
+            .cancellation = {},
+            .callback = nullptr,
+            .callback_context = {},
+        });
     }
 
     void read_async(
         int storage_id, std::chrono::steady_clock::duration::rep timeout,
         void (*callback)(Buffer8 context, bool success), Buffer8 callback_context) {
-        operation_thread_check();
         throw_if_transport_error();
 
-        if (storage_[storage_id].operation.load(std::memory_order::relaxed).mode
-            != Operation::Mode::NONE) [[unlikely]]
+        if (!try_claim(storage_[storage_id], Operation::Mode::READ)) [[unlikely]]
             throw std::runtime_error("Illegal checked read: Data is being operated!");
 
-        storage_[storage_id].timeout = std::chrono::steady_clock::duration(timeout);
-        storage_[storage_id].callback = callback;
-        storage_[storage_id].callback_context = callback_context;
-        storage_[storage_id].operation.store(
-            Operation{.mode = Operation::Mode::READ, .state = Operation::State::WAITING},
-            std::memory_order::release);
+        submit(Request{
+            .storage_id = storage_id,
+            .mode = Operation::Mode::READ,
+            .deadline = device::deadline_after(std::chrono::steady_clock::duration(timeout)),
+            .cancellation = {},
+            .callback = callback,
+            .callback_context = callback_context,
+        });
     }
 
     void write_async_unchecked(
         Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout) {
-        operation_thread_check();
-
         store_data(storage_[storage_id], data);
 
-        if (storage_[storage_id].operation.load(std::memory_order::relaxed).mode
-            != Operation::Mode::NONE)
+        if (!try_claim(storage_[storage_id], Operation::Mode::WRITE))
             return;
+        // A refresh the claim took over may have stored the value it read after ours
+        store_data(storage_[storage_id], data);
 
-        storage_[storage_id].timeout = std::chrono::steady_clock::duration(timeout);
-        storage_[storage_id].callback = nullptr;
-        storage_[storage_id].operation.store(
-            Operation{.mode = Operation::Mode::WRITE, .state = Operation::State::WAITING},
-            std::memory_order::release);
+        submit(Request{
+            .storage_id = storage_id,
+            .mode = Operation::Mode::WRITE,
+            .deadline = device::deadline_after(std::chrono::steady_clock::duration(timeout)),
+            .cancellation = {},
+            .callback = nullptr,
+            .callback_context = {},
+        });
     }
 
     void write_async(
         Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout,
         void (*callback)(Buffer8 context, bool success), Buffer8 callback_context) {
-        operation_thread_check();
         throw_if_transport_error();
 
-        if (storage_[storage_id].operation.load(std::memory_order::relaxed).mode
-            != Operation::Mode::NONE) [[unlikely]]
+        if (!try_claim(storage_[storage_id], Operation::Mode::WRITE)) [[unlikely]]
             throw std::runtime_error("Illegal checked write: Data is being operated!");
 
         store_data(storage_[storage_id], data);
-        storage_[storage_id].timeout = std::chrono::steady_clock::duration(timeout);
-        storage_[storage_id].callback = callback;
-        storage_[storage_id].callback_context = callback_context;
-        storage_[storage_id].operation.store(
-            Operation{.mode = Operation::Mode::WRITE, .state = Operation::State::WAITING},
-            std::memory_order::release);
+        submit(Request{
+            .storage_id = storage_id,
+            .mode = Operation::Mode::WRITE,
+            .deadline = device::deadline_after(std::chrono::steady_clock::duration(timeout)),
+            .cancellation = {},
+            .callback = callback,
+            .callback_context = callback_context,
+        });
+    }
+
+    void read_many(
+        StorageRange range, std::chrono::steady_clock::time_point deadline,
+        device::CancellationToken token, void (*callback)(Buffer8 context, bool success),
+        Buffer8 callback_context) {
+        throw_if_transport_error();
+
+        // Claim the whole range first so that a busy unit rejects the batch as a whole
+        if (!try_claim_range(range, Operation::Mode::READ)) [[unlikely]]
+            throw std::runtime_error("Illegal checked read: Data is being operated!");
+
+        for (int i = 0, id = range.first; i < range.count; i++, id += range.stride)
+            submit(Request{
+                .storage_id = id,
+                .mode = Operation::Mode::READ,
+                .deadline = deadline,
+                .cancellation = token,
+                .callback = callback,
+                .callback_context = callback_context,
+            });
+    }
+
+    void write_many(
+        const Buffer8* data, StorageRange range, std::chrono::steady_clock::time_point deadline,
+        device::CancellationToken token, void (*callback)(Buffer8 context, bool success),
+        Buffer8 callback_context) {
+        throw_if_transport_error();
+
+        if (!try_claim_range(range, Operation::Mode::WRITE)) [[unlikely]]
+            throw std::runtime_error("Illegal checked write: Data is being operated!");
+
+        for (int i = 0, id = range.first; i < range.count; i++, id += range.stride) {
+            store_data(storage_[id], data[i]);
+            submit(Request{
+                .storage_id = id,
+                .mode = Operation::Mode::WRITE,
+                .deadline = deadline,
+                .cancellation = token,
+                .callback = callback,
+                .callback_context = callback_context,
+            });
+        }
+    }
+
+    void read_many_cached(
+        StorageRange range, std::chrono::steady_clock::duration max_age,
+        std::chrono::steady_clock::time_point deadline, device::CancellationToken token,
+        void (*callback)(Buffer8 context, bool success), Buffer8 callback_context) {
+        throw_if_transport_error();
+
+        // Refresh times are never 0 once set, so a never-read unit is stale for any max_age
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        auto fresh_after = max_age < std::chrono::steady_clock::duration::zero() || max_age > now
+                             ? std::chrono::steady_clock::rep{1}
+                             : (now - max_age).count();
+
+        // Fresh units complete after the lock is released, so the callback may submit again.
+        // Stale units fail there instead if the disconnect pass has already run: nobody would
+        // process them any more.
+        int fresh_count = 0, closed_count = 0;
+        {
+            std::unique_lock lock{cached_read_mutex_, std::defer_lock};
+            for (int i = 0, id = range.first; i < range.count; i++, id += range.stride) {
+                if (is_fresh(storage_[id], fresh_after)) {
+                    fresh_count++;
+                    continue;
+                }
+                if (!lock.owns_lock())
+                    lock.lock();
+                if (cached_reads_closed_) [[unlikely]] {
+                    closed_count++;
+                    continue;
+                }
+                auto& reads = cached_read_nodes_[id].reads;
+                if (reads.empty())
+                    cached_read_units_.push_back(id);
+                reads.push_back(CachedRead{
+                    .fresh_after = fresh_after,
+                    .deadline = deadline,
+                    .cancellation = token,
+                    .callback = callback,
+                    .callback_context = callback_context,
+                });
+            }
+            if (lock.owns_lock() && !cached_reads_closed_)
+                cached_reads_waiting_.store(true, std::memory_order::relaxed);
+        }
+        while (fresh_count--)
+            callback(callback_context, true);
+        while (closed_count--)
+            callback(callback_context, false);
+    }
+
+    void get_many(StorageRange range, Buffer8* out) {
+        for_each_storage(range, [&](StorageUnit& storage) { *out++ = load_data(storage); });
+    }
+
+    // Subscriptions belong to sdo_thread. subscribe() and unsubscribe() hand their changes over
+    // under subscription_mutex_, and sdo_thread applies them at the start of a tick, before any
+    // callback runs. An unsubscriber waits for that, so no callback of the subscription runs
+    // once unsubscribe() returns.
+    uint64_t subscribe(
+        StorageRange range, std::chrono::steady_clock::duration period,
+        void (*callback)(Buffer8 context, int index, Buffer8 value),
+        void (*release)(Buffer8 context), Buffer8 context) {
+        if (period <= std::chrono::steady_clock::duration::zero() || range.count <= 0)
+            throw std::invalid_argument("Subscription period and range must not be empty");
+        throw_if_transport_error();
+
+        auto id = next_subscription_id_.fetch_add(1, std::memory_order::relaxed);
+        auto subscription = std::make_unique<Subscription>(Subscription{
+            .id = id,
+            .range = range,
+            .period = period,
+            .callback = callback,
+            .release = release,
+            .context = context,
+            .units = std::vector<Subscription::Unit>(range.count),
+        });
+
+        // Spread the reads of the units evenly over the period, and offset each subscription
+        // by a different fraction of that spacing, so that no tick carries a burst
+        auto now = std::chrono::steady_clock::now();
+        auto spacing = period / range.count;
+        auto phase = static_cast<int>(static_cast<uint32_t>(id * 0x9E3779B1u) >> 24);
+        auto offset = spacing * phase / 256;
+        for (int i = 0; i < range.count; i++)
+            subscription->units[i].next_read = now + offset + spacing * i;
+
+        std::lock_guard guard{subscription_mutex_};
+        if (subscriptions_closed_) [[unlikely]] {
+            throw_if_transport_error();
+            throw std::logic_error("Subscribing to a handler that is shutting down");
+        }
+        subscription_additions_.push_back(std::move(subscription));
+        subscription_changes_.store(true, std::memory_order::relaxed);
+        return id;
+    }
+
+    void unsubscribe(uint64_t id) {
+        std::unique_lock lock{subscription_mutex_};
+        if (subscriptions_closed_) // Every subscription is released already
+            return;
+
+        subscription_removals_.push_back(id);
+        subscription_changes_.store(true, std::memory_order::relaxed);
+
+        if (std::this_thread::get_id() == sdo_thread_.get_id()) {
+            // From a callback: stop delivering now, release on the next tick
+            for (auto& subscription : subscriptions_)
+                if (subscription->id == id)
+                    subscription->removed = true;
+            return;
+        }
+
+        auto epoch = subscription_epoch_taken_ + 1;
+        subscription_applied_.wait(lock, [&] {
+            return subscription_epoch_applied_ >= epoch || subscriptions_closed_;
+        });
     }
 
     auto realtime_get_joint_actual_position() -> const std::atomic<double> (&)[5][4] {
@@ -153,6 +341,35 @@ public:
         return pdo_read_actual_effort_;
     }
 
+    auto realtime_get_joint_error_code() -> const std::atomic<uint32_t> (&)[5][4] {
+        return pdo_read_error_code_;
+    }
+
+    uint64_t realtime_feedback_version() const {
+        return pdo_read_result_version_.load(std::memory_order::acquire);
+    }
+
+    uint64_t
+        wait_realtime_feedback(uint64_t version, std::chrono::steady_clock::time_point deadline) {
+        uint64_t current = pdo_read_result_version_.load(std::memory_order::acquire);
+        if (current != version)
+            return current;
+
+        std::unique_lock lock{feedback_mutex_};
+        // Seen by the RX thread after it advances the version, or the version is seen here
+        feedback_waiter_count_.fetch_add(1, std::memory_order::seq_cst);
+        auto arrived = [&] {
+            current = pdo_read_result_version_.load(std::memory_order::seq_cst);
+            return current != version;
+        };
+        if (deadline == std::chrono::steady_clock::time_point::max())
+            feedback_arrived_.wait(lock, arrived);
+        else
+            feedback_arrived_.wait_until(lock, deadline, arrived);
+        feedback_waiter_count_.fetch_sub(1, std::memory_order::relaxed);
+        return current;
+    }
+
     void realtime_set_joint_target_position(const double (&positions)[5][4]) {
         operation_thread_check();
 
@@ -173,6 +390,7 @@ public:
             throw std::logic_error("Latency testing is underway.");
 
         realtime_controller_ = std::move(guard);
+        realtime_loop_.reset(); // No writer until the new PDO thread starts
         pdo_thread_ = std::jthread{[this, enable_upstream](const std::stop_token& stop_token) {
             pdo_thread_main(stop_token, enable_upstream);
         }};
@@ -190,6 +408,80 @@ public:
         return realtime_controller_.release();
     }
 
+    RealtimeStatistics realtime_statistics() const {
+        auto summarize = [](const utility::HdrHistogram<>& histogram) {
+            auto snapshot = histogram.snapshot();
+            return RealtimeStatistics::Distribution{
+                .mean_ns = snapshot.mean(),
+                .p50_ns = snapshot.quantile(0.5),
+                .p99_ns = snapshot.quantile(0.99),
+                .max_ns = snapshot.max,
+            };
+        };
+        return RealtimeStatistics{
+            .period_ns = realtime_period_ns_.load(std::memory_order::relaxed),
+            .tick_count = realtime_loop_.tick_count.load(std::memory_order::relaxed),
+            .overrun_count = realtime_loop_.overrun_count.load(std::memory_order::relaxed),
+            .lateness = summarize(realtime_loop_.lateness_ns),
+            .step = summarize(realtime_loop_.step_ns),
+            .submit = summarize(realtime_loop_.submit_ns),
+        };
+    }
+
+    size_t poll_joint_error_events(device::JointErrorEvent* events, size_t max_count) {
+        return joint_error_poll_queue_.pop_front_n(
+            [&events](device::JointErrorEvent&& event) { *events++ = event; }, max_count);
+    }
+
+    uint64_t dropped_joint_error_events() const {
+        return joint_error_poll_dropped_.load(std::memory_order::relaxed);
+    }
+
+    SdoLatency sdo_latency(int finger_id, int joint_id) const {
+        if (finger_id < -1 || finger_id > 4)
+            throw std::invalid_argument("finger_id must be -1 to 4");
+        if (finger_id != -1 && (joint_id < 0 || joint_id > 3))
+            throw std::invalid_argument("joint_id must be 0 to 3");
+
+        auto& statistics = sdo_latency_[finger_id == -1 ? 0 : 1 + 4 * finger_id + joint_id];
+        auto latency = statistics.latency_ns.snapshot();
+        auto total_queue_ns = statistics.total_queue_ns.load(std::memory_order::relaxed);
+        return SdoLatency{
+            .count = latency.count,
+            .timeout_count = statistics.timeout_count.load(std::memory_order::relaxed),
+            .mean_queue_ns = latency.count ? total_queue_ns / latency.count : 0,
+            .mean_ns = latency.mean(),
+            .p50_ns = latency.quantile(0.5),
+            .p90_ns = latency.quantile(0.9),
+            .p99_ns = latency.quantile(0.99),
+            .max_ns = latency.max,
+        };
+    }
+
+    RxStatistics rx_statistics() const {
+        return RxStatistics{
+            .frame_count = rx_frame_count_.load(std::memory_order::relaxed),
+            .parse_error_count = rx_parse_errors_.load(std::memory_order::relaxed),
+            .dropped_log_event_count = rx_event_dropped_.load(std::memory_order::relaxed),
+            .callback_total_ns = rx_callback_total_ns_.load(std::memory_order::relaxed),
+            .callback_max_ns = rx_callback_max_ns_.load(std::memory_order::relaxed),
+        };
+    }
+
+    void set_joint_error_callback(
+        void (*callback)(Buffer8 context, const device::JointErrorEvent& event), Buffer8 context) {
+        std::lock_guard guard{joint_error_callback_mutex_};
+        joint_error_callback_ = callback;
+        joint_error_callback_context_ = context;
+    }
+
+    static const char* joint_error_description(int bit) {
+        for (const auto& def : kErrorDefinitions)
+            if (def.bit == bit)
+                return def.description;
+        return nullptr;
+    }
+
     bool has_transport_error() const {
         return transport_error_.load(std::memory_order::acquire);
     }
@@ -234,119 +526,96 @@ public:
         }
     }
 
-    Buffer8 get(int storage_id) { return load_data(storage_[storage_id]); }
-
-    void disable_thread_safe_check() { operation_thread_id_ = std::thread::id{}; }
+    void start_state_publisher(const char* name, size_t capacity) {
+        std::lock_guard guard{state_publisher_mutex_};
+        // The old publisher must remove its segment before a new one may take the same name
+        state_publisher_.reset();
+        state_publisher_ = std::make_unique<StatePublisher>(name, capacity);
+        logger_.info(
+            "Publishing hand state to shared memory {} ({} snapshots of history)",
+            state_publisher_->name(), state_publisher_->capacity());
+    }
 
-    std::vector<uint8_t> raw_sdo_read(
-        uint16_t index, uint8_t sub_index, std::chrono::steady_clock::duration timeout) {
-        operation_thread_check();
-        throw_if_transport_error();
+    void stop_state_publisher() {
+        std::lock_guard guard{state_publisher_mutex_};
+        state_publisher_.reset();
+    }
 
-        // Find an available slot
-        RawSdoUnit* unit = nullptr;
-        for (auto& u : raw_sdo_units_) {
-            bool expected = false;
-            if (u.in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-                unit = &u;
-                break;
-            }
-        }
-        if (!unit)
-            throw std::runtime_error("No available raw SDO slot. Too many concurrent operations.");
+    Buffer8 get(int storage_id) { return load_data(storage_[storage_id]); }
 
-        // Setup the unit
-        {
-            std::lock_guard lock{unit->mutex};
-            unit->index = index;
-            unit->sub_index = sub_index;
-            unit->mode = RawSdoUnit::Mode::READ;
-            unit->state = RawSdoUnit::State::PENDING;
-            unit->read_result.clear();
-            unit->timeout_point = std::chrono::steady_clock::now() + timeout;
-        }
+    void disable_thread_safe_check() { operation_thread_id_ = std::thread::id{}; }
 
-        // Wait for completion
-        std::vector<uint8_t> result;
-        {
-            std::unique_lock lock{unit->mutex};
-            unit->cv.wait(lock, [&] {
-                return unit->state == RawSdoUnit::State::SUCCESS
-                    || unit->state == RawSdoUnit::State::FAILED;
-            });
+    // Raw SDO requests are pooled and handed to sdo_thread through an intrusive lock-free stack.
+    // sdo_thread sends them, tracks them in raw_sdo_table_ and fails them on deadline,
+    // cancellation or disconnect; the RX thread fulfills them.
 
-            if (unit->state == RawSdoUnit::State::SUCCESS) {
-                result = std::move(unit->read_result);
-            }
-            auto state = unit->state;
-            unit->state = RawSdoUnit::State::IDLE;
-            unit->mode = RawSdoUnit::Mode::NONE;
-            unit->in_use.store(false, std::memory_order_release);
-
-            if (state == RawSdoUnit::State::FAILED) {
-                throw_if_transport_error(); // throws ConnectionError if transport down
-                throw device::TimeoutError(std::format(
-                    "Raw SDO read timed out: index=0x{:04X}, sub_index={}", index, sub_index));
-            }
-        }
+    std::future<std::vector<uint8_t>> raw_sdo_read_async(
+        uint16_t index, uint8_t sub_index, std::chrono::steady_clock::time_point deadline,
+        device::CancellationToken token) {
+        throw_if_transport_error();
 
-        return result;
+        auto request =
+            make_raw_sdo_request(index, sub_index, RawSdoRequest::Mode::READ, deadline, token);
+        auto future = request->read_promise.get_future();
+        submit_raw_sdo(request, request);
+        return future;
     }
 
-    void raw_sdo_write(
+    std::future<void> raw_sdo_write_async(
         uint16_t index, uint8_t sub_index, const void* data, size_t size,
-        std::chrono::steady_clock::duration timeout) {
-        operation_thread_check();
+        std::chrono::steady_clock::time_point deadline, device::CancellationToken token) {
         throw_if_transport_error();
 
         if (size != 1 && size != 2 && size != 4 && size != 8)
             throw std::invalid_argument(
                 std::format("Raw SDO write data size must be 1, 2, 4, or 8 bytes, got {}", size));
 
-        // Find an available slot
-        RawSdoUnit* unit = nullptr;
-        for (auto& u : raw_sdo_units_) {
-            bool expected = false;
-            if (u.in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-                unit = &u;
-                break;
-            }
-        }
-        if (!unit)
-            throw std::runtime_error("No available raw SDO slot. Too many concurrent operations.");
+        auto request =
+            make_raw_sdo_request(index, sub_index, RawSdoRequest::Mode::WRITE, deadline, token);
+        std::memcpy(request->write_data.data(), data, size);
+        request->write_size = static_cast<uint8_t>(size);
+        auto future = request->write_promise.get_future();
+        submit_raw_sdo(request, request);
+        return future;
+    }
 
-        // Setup the unit with cached write data (actual send is done by sdo_thread)
-        {
-            std::lock_guard lock{unit->mutex};
-            unit->index = index;
-            unit->sub_index = sub_index;
-            unit->mode = RawSdoUnit::Mode::WRITE;
-            unit->state = RawSdoUnit::State::PENDING;
-            unit->timeout_point = std::chrono::steady_clock::now() + timeout;
-            // Cache write data for sdo_thread to send
-            std::memcpy(unit->write_data.data(), data, size);
-            unit->write_data_size = static_cast<uint8_t>(size);
-        }
+    std::vector<std::future<std::vector<uint8_t>>> raw_sdo_read_many(
+        const SdoAddress* addresses, size_t count, std::chrono::steady_clock::time_point deadline,
+        device::CancellationToken token) {
+        throw_if_transport_error();
 
-        // Wait for completion (sdo_thread will send the write request)
-        {
-            std::unique_lock lock{unit->mutex};
-            unit->cv.wait(lock, [&] {
-                return unit->state == RawSdoUnit::State::SUCCESS
-                    || unit->state == RawSdoUnit::State::FAILED;
-            });
+        std::vector<std::future<std::vector<uint8_t>>> futures;
+        if (!count)
+            return futures;
+        futures.reserve(count);
+
+        // Link the batch newest-first, as if pushed one by one, and publish it with a single CAS
+        RawSdoRequest* bottom = nullptr;
+        RawSdoRequest* top = nullptr;
+        for (size_t i = 0; i < count; i++) {
+            auto request = make_raw_sdo_request(
+                addresses[i].index, addresses[i].sub_index, RawSdoRequest::Mode::READ, deadline,
+                token);
+            futures.push_back(request->read_promise.get_future());
+            request->next = top;
+            top = request;
+            if (!bottom)
+                bottom = request;
+        }
+        submit_raw_sdo(top, bottom);
+        return futures;
+    }
 
-            auto state = unit->state;
-            unit->state = RawSdoUnit::State::IDLE;
-            unit->mode = RawSdoUnit::Mode::NONE;
-            unit->in_use.store(false, std::memory_order_release);
+    std::vector<uint8_t> raw_sdo_read(
+        uint16_t index, uint8_t sub_index, std::chrono::steady_clock::time_point deadline,
+        device::CancellationToken token) {
+        return raw_sdo_read_async(index, sub_index, deadline, token).get();
+    }
 
-            if (state == RawSdoUnit::State::FAILED) {
-                throw_if_transport_error(); // throws ConnectionError if transport down
-                throw device::TimeoutError(std::format(
-                    "Raw SDO write timed out: index=0x{:04X}, sub_index={}", index, sub_index));
-            }
-        }
+    void raw_sdo_write(
+        uint16_t index, uint8_t sub_index, const void* data, size_t size,
+        std::chrono::steady_clock::time_point deadline, device::CancellationToken token) {
+        raw_sdo_write_async(index, sub_index, data, size, deadline, token).get();
     }
 
     const std::string& selected_serial_number() const noexcept {
@@ -359,14 +628,17 @@ private:
             NONE = 0,
 
             READ,
-            WRITE
+            WRITE,
+            REFRESH, // Read started by sdo_thread for cached reads and subscriptions
         } mode;
         enum class State : uint16_t {
             SUCCESS = 0,
 
+            QUEUED, // Claimed by a submitter, request not yet taken by sdo_thread
             WAITING,
 
             READING,
+            COMPLETING, // REFRESH only: the RX thread is storing the value read
 
             WRITING,
             WRITING_CONFIRMING,
@@ -387,46 +659,79 @@ private:
         static_assert(decltype(StorageUnit::version)::is_always_lock_free);
         static_assert(decltype(StorageUnit::value)::is_always_lock_free);
 
-        union {
-            std::chrono::steady_clock::duration timeout;
-            std::chrono::steady_clock::time_point timeout_point;
-            static_assert(std::is_trivially_destructible_v<decltype(timeout)>);
-            static_assert(std::is_trivially_destructible_v<decltype(timeout_point)>);
-        };
+        std::chrono::steady_clock::time_point deadline;
+        device::CancellationToken cancellation;
 
         void (*callback)(Buffer8 context, bool success);
         Buffer8 callback_context;
+
+        // steady_clock time at which the device last confirmed the value, 0 if never
+        std::atomic<std::chrono::steady_clock::rep> refresh_time{0};
+        static_assert(decltype(StorageUnit::refresh_time)::is_always_lock_free);
     };
     static_assert(sizeof(StorageUnit) == 64);
 
-    // Raw SDO unit for debugging - allows arbitrary index/sub_index access
-    struct RawSdoUnit {
-        std::mutex mutex;
-        std::condition_variable cv;
+    // Upper bound of raw SDO requests sent per tick, so that a large batch is spread over several
+    // ticks instead of exhausting the transmit buffers at once
+    static constexpr size_t RAW_SDO_MAX_SENDS_PER_TICK = 64;
 
-        std::atomic<bool> in_use{false};
-        uint16_t index = 0;
-        uint8_t sub_index = 0;
+    struct Request {
+        int storage_id;
+        Operation::Mode mode;
+        std::chrono::steady_clock::time_point deadline;
+        device::CancellationToken cancellation;
+        void (*callback)(Buffer8 context, bool success);
+        Buffer8 callback_context;
+        std::chrono::steady_clock::time_point submit_time{}; // Stamped by submit()
+    };
 
-        enum class Mode : uint8_t { NONE, READ, WRITE } mode = Mode::NONE;
-        enum class State : uint8_t {
-            IDLE,
-            PENDING,
-            READING,
-            WRITING,
-            SUCCESS,
-            FAILED
-        } state = State::IDLE;
+    // Timestamps of the operation on a storage unit, sdo_thread only. Kept apart from
+    // StorageUnit, which is exactly one cache line.
+    struct SdoTiming {
+        std::chrono::steady_clock::rep submit_time;
+        std::chrono::steady_clock::rep send_time; // First send, 0 until then
+    };
 
-        std::vector<uint8_t> read_result;
-        std::chrono::steady_clock::time_point timeout_point;
+    // Upper bound of subscription reads started per tick, and the least time one may take
+    static constexpr size_t SUBSCRIPTION_MAX_READS_PER_TICK = 4;
+    static constexpr std::chrono::milliseconds SUBSCRIPTION_MIN_READ_TIMEOUT{100};
+
+    struct Subscription {
+        struct Unit {
+            std::chrono::steady_clock::time_point next_read;
+            uint32_t version = 0; // StorageUnit::version when last checked
+            bool notified = false;
+            Buffer8 value;        // Raw value last delivered
+        };
 
-        // Write data cache - used to defer write operations to sdo_thread
-        std::array<uint8_t, 8> write_data{};
-        uint8_t write_data_size = 0;
+        uint64_t id;
+        StorageRange range;
+        std::chrono::steady_clock::duration period;
+        void (*callback)(Buffer8 context, int index, Buffer8 value);
+        void (*release)(Buffer8 context);
+        Buffer8 context;
+        std::vector<Unit> units;
+        bool removed = false; // Unsubscribed from its own callback
     };
 
-    static constexpr size_t RAW_SDO_SLOT_COUNT = 4;
+    // A read(MaxAge) of one unit whose cached value was too old
+    struct CachedRead {
+        std::chrono::steady_clock::rep fresh_after;
+        std::chrono::steady_clock::time_point deadline;
+        device::CancellationToken cancellation;
+        void (*callback)(Buffer8 context, bool success);
+        Buffer8 callback_context;
+    };
+    // The cached reads waiting for one unit. Preallocated per unit; the vector keeps its
+    // capacity, so a unit only allocates when it sees more concurrent cached reads than ever.
+    struct CachedReadNode {
+        std::vector<CachedRead> reads;
+    };
+    struct CachedReadCompletion {
+        CachedRead read;
+        int storage_id;
+        bool success;
+    };
 
     struct ErrorDefinition {
         uint8_t bit;
@@ -464,12 +769,448 @@ private:
         if (operation_thread_id_ != std::this_thread::get_id()) [[unlikely]]
             throw std::runtime_error(
                 "Thread safety violation: \n"
-                "  Operation must be called from the construction thread by default. \n"
-                "  If you want to perform operations in multiple threads, call:\n"
+                "  Realtime and latency test operations must be called from the construction\n"
+                "  thread by default (SDO reads and writes may be issued from any thread).\n"
+                "  If you want to perform these operations in multiple threads, call:\n"
                 "      disable_thread_safe_check();\n"
                 "  And use mutex to ensure that ONLY ONE THREAD is operating at the same time.");
     }
 
+    // Claims an idle unit, or takes over a refresh: the claimed operation reads or writes the
+    // unit anyway, which is all the cached read or subscription behind the refresh waits for.
+    static bool try_claim(StorageUnit& storage, Operation::Mode mode) {
+        auto expected = storage.operation.load(std::memory_order::relaxed);
+        while (true) {
+            if (expected.mode == Operation::Mode::REFRESH
+                && expected.state == Operation::State::COMPLETING) {
+                // The RX thread is storing the value read, which takes a few instructions
+                std::this_thread::yield();
+                expected = storage.operation.load(std::memory_order::relaxed);
+                continue;
+            }
+            if (expected.mode != Operation::Mode::NONE
+                && expected.mode != Operation::Mode::REFRESH)
+                return false;
+            if (storage.operation.compare_exchange_weak(
+                    expected, Operation{.mode = mode, .state = Operation::State::QUEUED},
+                    std::memory_order::acquire, std::memory_order::relaxed))
+                return true;
+        }
+    }
+
+    // sdo_thread-side state change of a unit it found in flight. A CAS rather than a store: a
+    // claim may take a refresh over at any time, and the RX thread may complete the unit
+    // meanwhile. On failure, the unit is looked at again on the next tick.
+    static bool update(StorageUnit& storage, Operation from, Operation to) {
+        return storage.operation.compare_exchange_strong(
+            from, to, std::memory_order::release, std::memory_order::relaxed);
+    }
+
+    bool try_claim_range(StorageRange range, Operation::Mode mode) {
+        for (int i = 0, id = range.first; i < range.count; i++, id += range.stride) {
+            if (try_claim(storage_[id], mode))
+                continue;
+
+            // Roll back the units claimed so far
+            for (int j = 0, rollback_id = range.first; j < i; j++, rollback_id += range.stride)
+                storage_[rollback_id].operation.store(
+                    Operation{.mode = Operation::Mode::NONE, .state = Operation::State::SUCCESS},
+                    std::memory_order::release);
+            return false;
+        }
+        return true;
+    }
+
+    void submit(Request request) {
+        request.submit_time = std::chrono::steady_clock::now();
+        trace::record(
+            trace::Event::SDO_SUBMIT, request.mode == Operation::Mode::WRITE,
+            static_cast<uint32_t>(request.storage_id));
+        // Each queued request owns a claimed unit, so the queue (sized to the unit count) can
+        // never be full.
+        if (!request_queue_.push_back(request)) [[unlikely]]
+            std::terminate(); // Logically impossible, only for protection
+
+        // Pairs with the fence in close_requests(): either the final drain sees this request, or
+        // this sees the queue closed and fails the request itself.
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        if (requests_closed_.load(std::memory_order::relaxed)) [[unlikely]]
+            fail_closed_requests();
+    }
+
+    // Called from sdo_thread only, once a transport error is observed. From here on nobody drains
+    // the queue on a tick; fail_closed_requests() empties it instead.
+    void close_requests() {
+        requests_closed_.store(true, std::memory_order::relaxed);
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+    }
+
+    // Fails the requests queued after close_requests(). Whoever calls it (the final drain, then
+    // each submitter that finds the queue closed) is the queue's consumer while holding the mutex.
+    // Callbacks run without it, so that they may submit again.
+    void fail_closed_requests() {
+        while (true) {
+            Request request{};
+            {
+                std::lock_guard guard{closed_requests_mutex_};
+                if (!request_queue_.pop_front([&](Request&& popped) { request = popped; }))
+                    return;
+            }
+            storage_[request.storage_id].operation.store(
+                Operation{.mode = Operation::Mode::NONE, .state = Operation::State::SUCCESS},
+                std::memory_order::release);
+            trace::record(
+                trace::Event::SDO_COMPLETE, false, static_cast<uint32_t>(request.storage_id));
+            metrics::sdo_disconnected.add();
+            if (request.callback)
+                request.callback(request.callback_context, false);
+        }
+    }
+
+    // Called from sdo_thread only.
+    void drain_requests() {
+        request_queue_.pop_front_n([this](Request&& request) {
+            auto& storage = storage_[request.storage_id];
+            storage.deadline = request.deadline;
+            storage.cancellation = request.cancellation;
+            storage.callback = request.callback;
+            storage.callback_context = request.callback_context;
+            sdo_timing_[request.storage_id] = {
+                .submit_time = request.submit_time.time_since_epoch().count(), .send_time = 0};
+            storage.operation.store(
+                Operation{.mode = request.mode, .state = Operation::State::WAITING},
+                std::memory_order::release);
+        });
+    }
+
+    static bool is_fresh(const StorageUnit& storage, std::chrono::steady_clock::rep fresh_after) {
+        // Masked units are never read from the device, their cached value is all there is
+        return (storage.info.policy & StorageInfo::MASKED)
+            || storage.refresh_time.load(std::memory_order::acquire) >= fresh_after;
+    }
+
+    // Called from sdo_thread only, after drain_requests(). Concurrent cached reads of a unit
+    // share one refresh, which lasts until the latest of their deadlines, and wait for the
+    // refresh time to pass their threshold. A read or write already in flight counts too.
+    void process_cached_reads(std::chrono::steady_clock::time_point now) {
+        if (!cached_reads_waiting_.load(std::memory_order::relaxed))
+            return;
+
+        {
+            std::lock_guard guard{cached_read_mutex_};
+            std::erase_if(cached_read_units_, [&](int id) {
+                auto& storage = storage_[id];
+                auto& reads = cached_read_nodes_[id].reads;
+                auto refresh_deadline = std::chrono::steady_clock::time_point::min();
+                std::erase_if(reads, [&](const CachedRead& read) {
+                    bool success = is_fresh(storage, read.fresh_after);
+                    if (!success && now < read.deadline && !read.cancellation.cancelled()) {
+                        refresh_deadline = std::max(refresh_deadline, read.deadline);
+                        return false;
+                    }
+                    cached_read_completions_.push_back(CachedReadCompletion{
+                        .read = read, .storage_id = id, .success = success});
+                    return true;
+                });
+                if (reads.empty())
+                    return true;
+                try_start_background_read(storage, refresh_deadline);
+                return false;
+            });
+            if (cached_read_units_.empty())
+                cached_reads_waiting_.store(false, std::memory_order::relaxed);
+        }
+
+        // Outside the lock, so that a callback may submit again
+        for (const auto& completion : cached_read_completions_) {
+            trace::ScopedSpan span{
+                trace::Span::SDO_CALLBACK, static_cast<uint32_t>(completion.storage_id)};
+            completion.read.callback(completion.read.callback_context, completion.success);
+        }
+        cached_read_completions_.clear();
+    }
+
+    // Called from sdo_thread only. Starts a refresh of the unit if it is idle; it enters the
+    // scan loop of the same tick. A read or write submitted meanwhile takes it over.
+    bool try_start_background_read(
+        StorageUnit& storage, std::chrono::steady_clock::time_point deadline) {
+        auto expected = storage.operation.load(std::memory_order::relaxed);
+        if (expected.mode != Operation::Mode::NONE)
+            return false;
+
+        // No one else writes these fields of an idle unit, and a claim that wins the race below
+        // has them rewritten by drain_requests() before they are used.
+        storage.deadline = deadline;
+        storage.cancellation = {};
+        storage.callback = nullptr;
+        storage.callback_context = {};
+        sdo_timing_[&storage - storage_.get()] = {
+            .submit_time = std::chrono::steady_clock::now().time_since_epoch().count(),
+            .send_time = 0};
+        return storage.operation.compare_exchange_strong(
+            expected,
+            Operation{.mode = Operation::Mode::REFRESH, .state = Operation::State::WAITING},
+            std::memory_order::release, std::memory_order::relaxed);
+    }
+
+    // Called from sdo_thread only.
+    void apply_subscription_changes() {
+        if (!subscription_changes_.load(std::memory_order::relaxed))
+            return;
+
+        std::vector<std::unique_ptr<Subscription>> additions;
+        std::vector<uint64_t> removals;
+        uint64_t epoch;
+        {
+            std::lock_guard guard{subscription_mutex_};
+            subscription_changes_.store(false, std::memory_order::relaxed);
+            additions.swap(subscription_additions_);
+            removals.swap(subscription_removals_);
+            epoch = ++subscription_epoch_taken_;
+        }
+
+        for (auto& subscription : additions)
+            subscriptions_.push_back(std::move(subscription));
+        std::erase_if(subscriptions_, [&](const std::unique_ptr<Subscription>& subscription) {
+            if (std::find(removals.begin(), removals.end(), subscription->id) == removals.end())
+                return false;
+            subscription->release(subscription->context);
+            return true;
+        });
+
+        {
+            std::lock_guard guard{subscription_mutex_};
+            subscription_epoch_applied_ = epoch;
+        }
+        subscription_applied_.notify_all();
+    }
+
+    // Called from sdo_thread only, after drain_requests(). First delivers values that changed
+    // since the last tick, whoever read them, then starts the reads that are due. Subscription
+    // reads only take idle units and yield to every other operation: a busy unit is retried on
+    // the next tick, reads beyond the per-tick cap wait for later ticks, and a read or write
+    // submitted while a subscription read is in flight takes it over (see try_claim()).
+    void process_subscriptions(std::chrono::steady_clock::time_point now) {
+        apply_subscription_changes();
+
+        size_t reads = 0;
+        for (auto& subscription : subscriptions_) {
+            const auto& range = subscription->range;
+            for (int i = 0, id = range.first; i < range.count; i++, id += range.stride) {
+                if (subscription->removed)
+                    break;
+
+                auto& storage = storage_[id];
+                auto& unit = subscription->units[i];
+                bool masked = storage.info.policy & StorageInfo::MASKED;
+
+                // Version 0 means never read, except for masked units which never will be
+                auto version = storage.version.load(std::memory_order::acquire);
+                if (version != unit.version || (masked && !unit.notified)) {
+                    unit.version = version;
+                    auto value = storage.value.load(std::memory_order::relaxed);
+                    auto size = size_t{1} << static_cast<uint32_t>(storage.info.size);
+                    if (!unit.notified || std::memcmp(value.storage, unit.value.storage, size)) {
+                        unit.value = value;
+                        unit.notified = true;
+                        trace::ScopedSpan span{
+                            trace::Span::SUBSCRIPTION_CALLBACK, static_cast<uint32_t>(id)};
+                        subscription->callback(subscription->context, i, load_data(storage));
+                    }
+                }
+
+                if (masked || now < unit.next_read || reads >= SUBSCRIPTION_MAX_READS_PER_TICK)
+                    continue;
+                auto timeout = std::max<std::chrono::steady_clock::duration>(
+                    subscription->period, SUBSCRIPTION_MIN_READ_TIMEOUT);
+                if (!try_start_background_read(storage, now + timeout))
+                    continue;
+
+                reads++;
+                unit.next_read += subscription->period;
+                if (unit.next_read <= now) // Fell behind: skip the missed reads
+                    unit.next_read = now + subscription->period;
+            }
+        }
+    }
+
+    // Called from sdo_thread on exit. Releases every subscription and wakes unsubscribers.
+    void close_subscriptions() {
+        std::vector<std::unique_ptr<Subscription>> additions;
+        {
+            std::lock_guard guard{subscription_mutex_};
+            subscriptions_closed_ = true;
+            additions.swap(subscription_additions_);
+            subscription_removals_.clear();
+        }
+        subscription_applied_.notify_all();
+
+        for (auto& subscription : additions)
+            subscriptions_.push_back(std::move(subscription));
+        for (auto& subscription : subscriptions_)
+            subscription->release(subscription->context);
+        subscriptions_.clear();
+    }
+
+    RawSdoRequest* make_raw_sdo_request(
+        uint16_t index, uint8_t sub_index, RawSdoRequest::Mode mode,
+        std::chrono::steady_clock::time_point deadline, device::CancellationToken token) {
+        auto request = raw_sdo_pool_.acquire();
+        request->key.store(
+            RawSdoRequest::make_key(index, sub_index, mode), std::memory_order::relaxed);
+        request->mode = mode;
+        request->deadline = deadline;
+        request->cancellation = token;
+        if (mode == RawSdoRequest::Mode::READ)
+            request->read_promise = {};
+        else
+            request->write_promise = {};
+        request->state.store(RawSdoRequest::State::PENDING, std::memory_order::relaxed);
+        trace::record(
+            trace::Event::RAW_SDO_SUBMIT, mode == RawSdoRequest::Mode::WRITE,
+            uint32_t{index} << 8 | sub_index);
+        return request;
+    }
+
+    // Pushes the chain top -> ... -> bottom onto the submission stack. Once sdo_thread has
+    // closed the stack on disconnect, nobody would take the chain, so it is failed right here.
+    void submit_raw_sdo(RawSdoRequest* top, RawSdoRequest* bottom) {
+        auto head = raw_sdo_submissions_.load(std::memory_order::acquire);
+        do {
+            if (head == &raw_sdo_closed_) [[unlikely]] {
+                for (auto request = top;;) {
+                    auto next = request->next;
+                    fail_raw_sdo(*request);
+                    raw_sdo_pool_.release(request);
+                    if (request == bottom)
+                        break;
+                    request = next;
+                }
+                return;
+            }
+            bottom->next = head;
+        } while (!raw_sdo_submissions_.compare_exchange_weak(
+            head, top, std::memory_order::release, std::memory_order::acquire));
+    }
+
+    // Called from sdo_thread only. Appends new submissions to the backlog in submission order;
+    // with `close`, later submissions are failed by submit_raw_sdo() instead.
+    void take_raw_sdo_submissions(bool close = false) {
+        auto node = raw_sdo_submissions_.exchange(
+            close ? &raw_sdo_closed_ : nullptr, std::memory_order::acq_rel);
+        if (node == &raw_sdo_closed_)
+            return;
+        auto first = raw_sdo_backlog_.size();
+        for (; node; node = node->next)
+            raw_sdo_backlog_.push_back(node);
+        std::reverse(
+            raw_sdo_backlog_.begin() + static_cast<std::ptrdiff_t>(first), raw_sdo_backlog_.end());
+    }
+
+    static bool
+        raw_sdo_expired(const RawSdoRequest& request, std::chrono::steady_clock::time_point now) {
+        return now >= request.deadline || request.cancellation.cancelled();
+    }
+
+    void fail_raw_sdo(RawSdoRequest& request) {
+        std::exception_ptr failure;
+        const char* operation = request.mode == RawSdoRequest::Mode::READ ? "read" : "write";
+        if (has_transport_error()) {
+            metrics::raw_sdo_disconnected.add();
+            try {
+                throw_if_transport_error();
+            } catch (...) {
+                failure = std::current_exception();
+            }
+        } else if (request.cancellation.cancelled()) {
+            metrics::raw_sdo_cancelled.add();
+            failure = std::make_exception_ptr(device::CancelledError(std::format(
+                "Raw SDO {} cancelled: index=0x{:04X}, sub_index={}", operation, request.index(),
+                request.sub_index())));
+        } else {
+            metrics::raw_sdo_timed_out.add();
+            failure = std::make_exception_ptr(device::TimeoutError(std::format(
+                "Raw SDO {} timed out: index=0x{:04X}, sub_index={}", operation, request.index(),
+                request.sub_index())));
+        }
+
+        trace::record(
+            trace::Event::RAW_SDO_COMPLETE, false,
+            uint32_t{request.index()} << 8 | request.sub_index());
+        if (request.mode == RawSdoRequest::Mode::READ)
+            request.read_promise.set_exception(failure);
+        else
+            request.write_promise.set_exception(failure);
+        request.state.store(RawSdoRequest::State::DONE, std::memory_order::release);
+    }
+
+    void send_raw_sdo(const RawSdoRequest& request) {
+        if (request.mode == RawSdoRequest::Mode::READ) {
+            read_async_unchecked_internal(request.index(), request.sub_index());
+            return;
+        }
+
+        auto send = [&]<typename T>(T value) {
+            std::memcpy(&value, request.write_data.data(), sizeof(T));
+            write_async_unchecked_internal(value, request.index(), request.sub_index());
+        };
+        if (request.write_size == 1)
+            send(uint8_t{});
+        else if (request.write_size == 2)
+            send(uint16_t{});
+        else if (request.write_size == 4)
+            send(uint32_t{});
+        else if (request.write_size == 8)
+            send(uint64_t{});
+    }
+
+    // Called from sdo_thread once per tick.
+    void process_raw_sdo_requests(std::chrono::steady_clock::time_point now) {
+        take_raw_sdo_submissions();
+
+        // Retire answered requests, fail expired or cancelled ones
+        std::erase_if(raw_sdo_in_flight_, [&](RawSdoRequest* request) {
+            auto state = request->state.load(std::memory_order::acquire);
+            if (state == RawSdoRequest::State::SENT && raw_sdo_expired(*request, now)
+                && request->claim()) {
+                fail_raw_sdo(*request);
+                state = RawSdoRequest::State::DONE;
+            }
+            if (state != RawSdoRequest::State::DONE)
+                return false;
+
+            raw_sdo_table_.erase(request);
+            raw_sdo_pool_.release(request);
+            return true;
+        });
+
+        // Send the backlog in order. A request waits while another one with the same key is in
+        // flight, since their responses could not be told apart.
+        size_t sent = 0;
+        std::erase_if(raw_sdo_backlog_, [&](RawSdoRequest* request) {
+            if (raw_sdo_expired(*request, now)) {
+                fail_raw_sdo(*request);
+                raw_sdo_pool_.release(request);
+                return true;
+            }
+            if (sent == RAW_SDO_MAX_SENDS_PER_TICK || !raw_sdo_table_.insert(request))
+                return false;
+
+            // Only published as SENT once in the table, so a stale response can't claim it early
+            request->state.store(RawSdoRequest::State::SENT, std::memory_order::release);
+            send_raw_sdo(*request);
+            raw_sdo_in_flight_.push_back(request);
+            sent++;
+            return true;
+        });
+    }
+
+    template <typename F>
+    void for_each_storage(StorageRange range, F&& f) {
+        for (int i = 0, id = range.first; i < range.count; i++, id += range.stride)
+            f(storage_[id]);
+    }
+
     static void store_data(StorageUnit& storage, Buffer8 data) {
         if (storage.info.policy & StorageInfo::CONTROL_WORD) {
             storage.value.store(
@@ -516,197 +1257,349 @@ private:
         return angle * (2 * std::numbers::pi / std::numeric_limits<int32_t>::max());
     }
 
+    // RX thread (libusb event thread). Nothing here formats, throws or takes a lock: what needs
+    // logging is queued as RxEvents for sdo_thread, and malformed frames only bump a counter.
     void receive_transfer_completed_callback(const std::byte* buffer, size_t size) {
-        if (logger_.should_log(logging::Level::TRACE))
-            logger_.trace("RX [{} bytes] {:Xp}", size, spdlog::to_hex(buffer, buffer + size));
+        trace::ScopedSpan span{trace::Span::USB_RECEIVE, static_cast<uint32_t>(size)};
+        auto begin_time = std::chrono::steady_clock::now();
+        rx_frame_begin_ = buffer;
+        rx_frame_size_ = static_cast<uint32_t>(size);
+
+        if (logger_.should_log(logging::Level::TRACE)) {
+            push_rx_event(RxEvent{.type = RxEvent::Type::RECEIVED, .size = rx_frame_size_});
+            push_rx_frame_chunks(logging::Level::TRACE);
+        }
 
         auto pointer = buffer;
         auto sentinel = pointer + size;
 
-        try {
-            const auto& header = read_frame_struct<protocol::Header>(pointer, sentinel);
-            if (header.type == 0x21)
+        if (auto header = read_frame_struct<protocol::Header>(pointer, sentinel)) {
+            if (header->type == 0x21)
                 read_sdo_frame(pointer, sentinel);
-            else if (header.type == 0x11)
+            else if (header->type == 0x11)
                 read_pdo_frame(pointer, sentinel);
             else
-                throw std::runtime_error{std::format("Invalid header type: 0x{:02X}", header.type)};
-        } catch (const std::runtime_error& ex) {
-            logger_.error("RX Frame parsing failed at offset {}", pointer - buffer);
-            logger_.error(ex.what());
-            logger_.error(
-                "RX Frame dump [{} bytes] {:Xp}", size, spdlog::to_hex(buffer, buffer + size));
+                rx_parse_error(
+                    buffer, RxEvent::ParseError::INVALID_HEADER_TYPE, {.detail = header->type});
         }
+
+        rx_frame_count_.store(
+            rx_frame_count_.load(std::memory_order::relaxed) + 1, std::memory_order::relaxed);
+        metrics::rx_frames.add();
+        record_rx_callback_duration(std::chrono::steady_clock::now() - begin_time);
+    }
+
+    // RX thread is the only writer, so plain load/store pairs suffice.
+    void record_rx_callback_duration(std::chrono::steady_clock::duration duration) {
+        auto ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+        rx_callback_total_ns_.store(
+            rx_callback_total_ns_.load(std::memory_order::relaxed) + ns,
+            std::memory_order::relaxed);
+        if (ns > rx_callback_max_ns_.load(std::memory_order::relaxed))
+            rx_callback_max_ns_.store(ns, std::memory_order::relaxed);
+        metrics::rx_callback_duration.observe(std::chrono::duration<double>(duration).count());
     }
 
-    void read_sdo_frame(const std::byte*& pointer, const std::byte* sentinel) {
+    void push_rx_event(const RxEvent& event) {
+        if (!rx_event_queue_.push_back(event)) [[unlikely]] {
+            rx_event_dropped_.fetch_add(1, std::memory_order::relaxed);
+            metrics::rx_log_events_dropped.add();
+        }
+    }
+
+    // Copies the whole current frame into FRAME_CHUNK events.
+    void push_rx_frame_chunks(logging::Level level) {
+        for (uint32_t offset = 0; offset < rx_frame_size_; offset += RxEvent::data_capacity) {
+            RxEvent event{
+                .type = RxEvent::Type::FRAME_CHUNK,
+                .code = static_cast<uint8_t>(level),
+                .data_size = static_cast<uint16_t>(
+                    std::min<size_t>(RxEvent::data_capacity, rx_frame_size_ - offset)),
+                .size = rx_frame_size_,
+                .offset = offset,
+            };
+            std::memcpy(event.data, rx_frame_begin_ + offset, event.data_size);
+            push_rx_event(event);
+        }
+    }
+
+    // Counts the error and queues it, together with a dump of the frame, for logging.
+    // `event` carries the details (see RxEvent::ParseError); always returns false.
+    bool rx_parse_error(const std::byte* position, RxEvent::ParseError error, RxEvent event = {}) {
+        rx_parse_errors_.fetch_add(1, std::memory_order::relaxed);
+        metrics::rx_parse_errors.add();
+        event.type = RxEvent::Type::PARSE_ERROR;
+        event.code = static_cast<uint8_t>(error);
+        event.size = rx_frame_size_;
+        event.offset = static_cast<uint32_t>(position - rx_frame_begin_);
+        trace::record(trace::Event::RX_PARSE_ERROR, event.code, event.offset);
+        push_rx_event(event);
+        if (!logger_.should_log(logging::Level::TRACE)) // Otherwise already dumped
+            push_rx_frame_chunks(logging::Level::ERR);
+        return false;
+    }
+
+    bool read_sdo_frame(const std::byte*& pointer, const std::byte* sentinel) {
         while (pointer < sentinel) {
             auto control = static_cast<uint8_t>(*pointer);
+            bool success;
             if (control == 0x35)
-                read_sdo_operation_read_success<uint8_t>(pointer, sentinel);
+                success = read_sdo_operation_read_success<uint8_t>(pointer, sentinel);
             else if (control == 0x37)
-                read_sdo_operation_read_success<uint16_t>(pointer, sentinel);
+                success = read_sdo_operation_read_success<uint16_t>(pointer, sentinel);
             else if (control == 0x39)
-                read_sdo_operation_read_success<uint32_t>(pointer, sentinel);
+                success = read_sdo_operation_read_success<uint32_t>(pointer, sentinel);
             else if (control == 0x3D)
-                read_sdo_operation_read_success<uint64_t>(pointer, sentinel);
+                success = read_sdo_operation_read_success<uint64_t>(pointer, sentinel);
             else if (control == 0x33)
-                read_sdo_operation_read_failed(pointer, sentinel);
+                success = read_frame_struct<protocol::sdo::ReadResultError>(pointer, sentinel);
             else if (control == 0x21)
-                read_sdo_operation_write_success(pointer, sentinel);
+                success = read_sdo_operation_write_success(pointer, sentinel);
             else if (control == 0x23)
-                read_sdo_operation_write_failed(pointer, sentinel);
+                success = read_frame_struct<protocol::sdo::WriteResultError>(pointer, sentinel);
             else if (control == 0x00)
                 break;
             else
-                throw std::runtime_error(
-                    std::format("Invalid SDO command specifier: 0x{:02X}", control));
+                return rx_parse_error(
+                    pointer, RxEvent::ParseError::INVALID_SDO_COMMAND, {.detail = control});
+            if (!success)
+                return false;
         }
+        return true;
     }
 
     template <typename T>
-    void read_sdo_operation_read_success(const std::byte*& pointer, const std::byte* sentinel) {
-        const auto& data =
-            read_frame_struct<protocol::sdo::ReadResultSuccess<T>>(pointer, sentinel);
+    bool read_sdo_operation_read_success(const std::byte*& pointer, const std::byte* sentinel) {
+        auto position = pointer;
+        auto data = read_frame_struct<protocol::sdo::ReadResultSuccess<T>>(pointer, sentinel);
+        if (!data)
+            return false;
 
         // First check if this is a raw SDO operation response
-        if (handle_raw_sdo_read_response(data.header.index, data.header.sub_index, data.value))
-            return;
-
-        StorageUnit& storage = find_storage_by_index(data.header.index, data.header.sub_index);
-        auto operation = storage.operation.load(std::memory_order::acquire);
-
-        logger_.debug(
-            "SDO Read Success: 0x{:04X}.{} ({}), Mode={}, State={}",
-            static_cast<uint16_t>(data.header.index), data.header.sub_index,
-            static_cast<void*>(&storage), static_cast<int>(operation.mode),
-            static_cast<int>(operation.state));
+        if (handle_raw_sdo_read_response(data->header.index, data->header.sub_index, data->value))
+            return true;
+
+        StorageUnit* storage =
+            find_storage_by_index(position, data->header.index, data->header.sub_index);
+        if (!storage)
+            return true;
+        auto operation = storage->operation.load(std::memory_order::acquire);
+
+        if (logger_.should_log(logging::Level::DEBUG))
+            push_rx_event(RxEvent{
+                .type = RxEvent::Type::SDO_READ_SUCCESS,
+                .code = static_cast<uint8_t>(operation.mode),
+                .detail = static_cast<uint8_t>(operation.state),
+                .sub_index = data->header.sub_index,
+                .index = data->header.index,
+                .value = static_cast<uint32_t>(storage - storage_.get()),
+            });
 
         if (operation.mode == Operation::Mode::NONE) [[unlikely]]
-            return;
+            return true;
 
         if (operation.state == Operation::State::READING) {
-            storage.value.store(Buffer8{data.value}, std::memory_order::relaxed);
-            auto new_version = storage.version.load(std::memory_order::relaxed) + 1;
+            if (operation.mode == Operation::Mode::REFRESH) {
+                // Hold claims off while the value is stored: a write taking the refresh over
+                // would otherwise send the value read instead of its own
+                Operation completing{
+                    .mode = operation.mode, .state = Operation::State::COMPLETING};
+                if (!storage->operation.compare_exchange_strong(
+                        operation, completing, std::memory_order::acquire,
+                        std::memory_order::relaxed))
+                    return true; // Taken over
+                operation = completing;
+            }
+            storage->value.store(Buffer8{data->value}, std::memory_order::relaxed);
+            auto new_version = storage->version.load(std::memory_order::relaxed) + 1;
             if (new_version == 0)
                 new_version = 1;
-            storage.version.store(new_version, std::memory_order::release);
+            storage->version.store(new_version, std::memory_order::release);
+            stamp_refresh(*storage);
 
-            operation.state = Operation::State::SUCCESS;
-            storage.operation.store(operation, std::memory_order::release);
+            transition(*storage, operation, Operation::State::SUCCESS);
         } else if (operation.state == Operation::State::WRITING_CONFIRMING) {
-            if (data.value == storage.value.load(std::memory_order::relaxed).as<T>()) {
-                operation.state = Operation::State::SUCCESS;
-                storage.operation.store(operation, std::memory_order::relaxed);
-            } else {
-                operation.state = Operation::State::WRITING;
-                storage.operation.store(operation, std::memory_order::relaxed);
-            }
+            if (data->value == storage->value.load(std::memory_order::relaxed).as<T>()) {
+                stamp_refresh(*storage);
+                transition(*storage, operation, Operation::State::SUCCESS);
+            } else
+                transition(*storage, operation, Operation::State::WRITING);
         }
+        return true;
     }
 
-    static void
-        read_sdo_operation_read_failed(const std::byte*& pointer, const std::byte* sentinel) {
-        read_frame_struct<protocol::sdo::ReadResultError>(pointer, sentinel);
-    }
-
-    void read_sdo_operation_write_success(const std::byte*& pointer, const std::byte* sentinel) {
-        const auto& data = read_frame_struct<protocol::sdo::WriteResultSuccess>(pointer, sentinel);
+    bool read_sdo_operation_write_success(const std::byte*& pointer, const std::byte* sentinel) {
+        auto position = pointer;
+        auto data = read_frame_struct<protocol::sdo::WriteResultSuccess>(pointer, sentinel);
+        if (!data)
+            return false;
 
         // First check if this is a raw SDO operation response
-        if (handle_raw_sdo_write_response(data.header.index, data.header.sub_index))
-            return;
+        if (handle_raw_sdo_write_response(data->header.index, data->header.sub_index))
+            return true;
 
-        StorageUnit& storage = find_storage_by_index(data.header.index, data.header.sub_index);
+        StorageUnit* storage =
+            find_storage_by_index(position, data->header.index, data->header.sub_index);
+        if (!storage)
+            return true;
 
-        auto operation = storage.operation.load(std::memory_order::acquire);
+        auto operation = storage->operation.load(std::memory_order::acquire);
         if (operation.mode == Operation::Mode::NONE) [[unlikely]]
-            return;
+            return true;
 
         if (operation.state == Operation::State::WRITING) {
-            operation.state = Operation::State::SUCCESS;
-            storage.operation.store(operation, std::memory_order::relaxed);
+            stamp_refresh(*storage);
+            transition(*storage, operation, Operation::State::SUCCESS);
         }
+        return true;
     }
 
-    static void
-        read_sdo_operation_write_failed(const std::byte*& pointer, const std::byte* sentinel) {
-        read_frame_struct<protocol::sdo::WriteResultError>(pointer, sentinel);
+    // Records that the cached value now matches the device.
+    static void stamp_refresh(StorageUnit& storage) {
+        storage.refresh_time.store(
+            std::chrono::steady_clock::now().time_since_epoch().count(),
+            std::memory_order::release);
     }
 
-    StorageUnit& find_storage_by_index(uint16_t index, uint8_t sub_index) {
+    // RX-side state change. A CAS rather than a store, so that a unit which sdo_thread has
+    // meanwhile timed out (and another thread may already have claimed again) is left alone.
+    static void transition(StorageUnit& storage, Operation from, Operation::State state) {
+        Operation to = from;
+        to.state = state;
+        storage.operation.compare_exchange_strong(
+            from, to, std::memory_order::release, std::memory_order::relaxed);
+    }
+
+    // `position` is where the response starts, for the parse error report.
+    StorageUnit*
+        find_storage_by_index(const std::byte* position, uint16_t index, uint8_t sub_index) {
         auto it = index_storage_map_.find(
             std::bit_cast<uint32_t>(IndexMapKey{.index = index, .sub_index = sub_index}));
-        if (it == index_storage_map_.end())
-            throw std::runtime_error{std::format(
-                "SDO object not found: index=0x{:04X}, sub-index=0x{:02X}", index, sub_index)};
-        return *it->second;
+        if (it == index_storage_map_.end()) [[unlikely]] {
+            rx_parse_error(
+                position, RxEvent::ParseError::UNKNOWN_SDO_OBJECT,
+                {.sub_index = sub_index, .index = index});
+            return nullptr;
+        }
+        return it->second;
     }
 
-    // Thread-safe helper to handle raw SDO read response
+    // RX-side raw SDO matching: a single table probe, no lock. A response for a request that
+    // sdo_thread already failed, or retired and recycled since the probe, is still consumed, as
+    // it belongs to no storage unit either.
     template <typename T>
     bool handle_raw_sdo_read_response(uint16_t index, uint8_t sub_index, T value) {
-        for (auto& unit : raw_sdo_units_) {
-            if (!unit.in_use.load(std::memory_order_acquire))
-                continue;
-            std::lock_guard lock{unit.mutex};
-            if (unit.index == index && unit.sub_index == sub_index
-                && unit.state == RawSdoUnit::State::READING
-                && unit.mode == RawSdoUnit::Mode::READ) {
-                unit.read_result.resize(sizeof(T));
-                std::memcpy(unit.read_result.data(), &value, sizeof(T));
-                unit.state = RawSdoUnit::State::SUCCESS;
-                unit.cv.notify_one();
-                return true;
-            }
+        auto key = RawSdoRequest::make_key(index, sub_index, RawSdoRequest::Mode::READ);
+        auto request = raw_sdo_table_.find(key);
+        if (!request)
+            return false;
+        if (request->claim_response(key)) {
+            trace::record(trace::Event::RAW_SDO_COMPLETE, true, uint32_t{index} << 8 | sub_index);
+            metrics::raw_sdo_succeeded.add();
+            std::vector<uint8_t> result(sizeof(T));
+            std::memcpy(result.data(), &value, sizeof(T));
+            request->read_promise.set_value(std::move(result));
+            request->state.store(RawSdoRequest::State::DONE, std::memory_order::release);
         }
-        return false;
+        return true;
     }
 
-    // Thread-safe helper to handle raw SDO write response
     bool handle_raw_sdo_write_response(uint16_t index, uint8_t sub_index) {
-        for (auto& unit : raw_sdo_units_) {
-            if (!unit.in_use.load(std::memory_order_acquire))
-                continue;
-            std::lock_guard lock{unit.mutex};
-            if (unit.index == index && unit.sub_index == sub_index
-                && unit.state == RawSdoUnit::State::WRITING
-                && unit.mode == RawSdoUnit::Mode::WRITE) {
-                unit.state = RawSdoUnit::State::SUCCESS;
-                unit.cv.notify_one();
-                return true;
-            }
+        auto key = RawSdoRequest::make_key(index, sub_index, RawSdoRequest::Mode::WRITE);
+        auto request = raw_sdo_table_.find(key);
+        if (!request)
+            return false;
+        if (request->claim_response(key)) {
+            trace::record(trace::Event::RAW_SDO_COMPLETE, true, uint32_t{index} << 8 | sub_index);
+            metrics::raw_sdo_succeeded.add();
+            request->write_promise.set_value();
+            request->state.store(RawSdoRequest::State::DONE, std::memory_order::release);
         }
-        return false;
+        return true;
     }
 
     // Wake every pending storage and raw-SDO waiter, marking them failed.
     // Called from sdo_thread once a transport error is observed.
     void fail_all_pending_on_disconnect() {
+        drain_requests();
+        close_requests();
+        fail_closed_requests();
+
         for (size_t i = 0; i < storage_unit_count_; i++) {
             auto& storage = storage_[i];
             auto operation = storage.operation.load(std::memory_order::acquire);
-            if (operation.mode == Operation::Mode::NONE)
+            if (operation.mode == Operation::Mode::NONE
+                || operation.state == Operation::State::QUEUED
+                || operation.state == Operation::State::COMPLETING)
                 continue;
             auto callback = storage.callback;
             auto context = storage.callback_context;
-            operation.mode = Operation::Mode::NONE;
-            storage.operation.store(operation, std::memory_order::release);
+            if (!update(
+                    storage, operation,
+                    Operation{.mode = Operation::Mode::NONE, .state = operation.state}))
+                continue;
+            trace::record(trace::Event::SDO_COMPLETE, false, static_cast<uint32_t>(i));
+            metrics::sdo_disconnected.add();
             if (callback)
                 callback(context, false);
         }
 
-        for (auto& unit : raw_sdo_units_) {
-            if (!unit.in_use.load(std::memory_order_acquire))
-                continue;
-            std::lock_guard lock{unit.mutex};
-            if (unit.state == RawSdoUnit::State::PENDING
-                || unit.state == RawSdoUnit::State::READING
-                || unit.state == RawSdoUnit::State::WRITING) {
-                unit.state = RawSdoUnit::State::FAILED;
-                unit.cv.notify_one();
-            }
+        // Past every deadline, so that all pending cached reads fail. Reads registered from here
+        // on fail in read_many_cached() itself.
+        {
+            std::lock_guard guard{cached_read_mutex_};
+            cached_reads_closed_ = true;
         }
+        process_cached_reads(std::chrono::steady_clock::time_point::max());
+
+        take_raw_sdo_submissions(true);
+        for (auto request : raw_sdo_in_flight_)
+            if (request->claim())
+                fail_raw_sdo(*request);
+        for (auto request : raw_sdo_backlog_)
+            fail_raw_sdo(*request);
+        raw_sdo_backlog_.clear();
+    }
+
+    // Index of the SDO latency target of an object: 0 for hand-level objects, 1 + 4 * finger_id +
+    // joint_id for joints (see Hand::calculate_index_offset).
+    static size_t sdo_target(uint16_t index) {
+        if (index < 0x2000)
+            return 0;
+        size_t finger_id = (index - 0x2000) / 0x800, joint_id = (index - 0x2000) % 0x800 / 0x100;
+        return finger_id < 5 && joint_id < 4 ? 1 + 4 * finger_id + joint_id : 0;
+    }
+
+    static void stamp_first_send(SdoTiming& timing, std::chrono::steady_clock::time_point now) {
+        if (!timing.send_time)
+            timing.send_time = now.time_since_epoch().count();
+    }
+
+    // Called from sdo_thread only. The RX thread stamps refresh_time right before confirming.
+    void record_sdo_latency(const StorageUnit& storage, const SdoTiming& timing) {
+        if (!timing.send_time) // Masked, never sent
+            return;
+        auto to_ns = [](std::chrono::steady_clock::rep ticks) {
+            std::chrono::steady_clock::duration duration{std::max(ticks, decltype(ticks){0})};
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+        };
+        auto latency_ns =
+            to_ns(storage.refresh_time.load(std::memory_order::acquire) - timing.send_time);
+        auto queue_ns = to_ns(timing.send_time - timing.submit_time);
+
+        auto target = sdo_target(storage.info.index);
+        sdo_latency_[target].latency_ns.record(latency_ns);
+        sdo_latency_[target].total_queue_ns.fetch_add(queue_ns, std::memory_order::relaxed);
+        metrics::sdo_targets[target].latency.observe(static_cast<double>(latency_ns) * 1e-9);
+    }
+
+    void record_sdo_timeout(const StorageUnit& storage) {
+        auto target = sdo_target(storage.info.index);
+        sdo_latency_[target].timeout_count.fetch_add(1, std::memory_order::relaxed);
+        metrics::sdo_targets[target].timeouts.add();
+        metrics::sdo_timed_out.add();
     }
 
     void sdo_thread_main(const std::stop_token& stop_token) {
@@ -718,16 +1611,26 @@ private:
         while (!stop_token.stop_requested()) {
             if (transport_error_.load(std::memory_order::acquire)) [[unlikely]] {
                 fail_all_pending_on_disconnect();
-                return;
+                break;
             }
 
+            trace::begin_span(trace::Span::SDO_TICK);
+            drain_requests();
+
             auto now = std::chrono::steady_clock::now();
+            process_cached_reads(now);
+            process_subscriptions(now);
 
             for (size_t i = 0; i < storage_unit_count_; i++) {
                 auto& storage = storage_[i];
-                auto operation = storage.operation.load(std::memory_order::acquire);
-
-                if (operation.mode == Operation::Mode::NONE)
+                const auto current = storage.operation.load(std::memory_order::acquire);
+                auto operation = current;
+
+                // QUEUED units were claimed after the drain; they start on the next tick.
+                // COMPLETING ones are about to succeed.
+                if (operation.mode == Operation::Mode::NONE
+                    || operation.state == Operation::State::QUEUED
+                    || operation.state == Operation::State::COMPLETING)
                     continue;
 
                 if (storage.info.policy & Handler::StorageInfo::MASKED)
@@ -736,30 +1639,41 @@ private:
                     auto callback = storage.callback;
                     auto context = storage.callback_context;
                     operation.mode = Operation::Mode::NONE;
-                    storage.operation.store(operation, std::memory_order::release);
-                    if (callback)
+                    if (!update(storage, current, operation))
+                        continue;
+                    trace::record(trace::Event::SDO_COMPLETE, true, static_cast<uint32_t>(i));
+                    metrics::sdo_succeeded.add();
+                    record_sdo_latency(storage, sdo_timing_[i]);
+                    if (callback) {
+                        trace::ScopedSpan span{
+                            trace::Span::SDO_CALLBACK, static_cast<uint32_t>(i)};
                         callback(context, true);
+                    }
+                    continue;
                 }
 
-                if (operation.state == Operation::State::WAITING) {
-                    if (storage.timeout < std::chrono::steady_clock::duration::zero()
-                        || now > std::chrono::steady_clock::time_point::max() - storage.timeout)
-                        // Treat negative or overflowed timeout as never expires
-                        storage.timeout_point = std::chrono::steady_clock::time_point::max();
-                    else
-                        storage.timeout_point = now + storage.timeout;
-
-                    operation.state =
-                        (operation.mode == Operation::Mode::READ ? Operation::State::READING
-                                                                 : Operation::State::WRITING);
-                    storage.operation.store(operation, std::memory_order::relaxed);
-                } else if (now >= storage.timeout_point) {
+                // Expired or cancelled units leave the scheduler before sending anything more
+                if (now >= storage.deadline || storage.cancellation.cancelled()) {
                     auto callback = storage.callback;
                     auto context = storage.callback_context;
                     operation.mode = Operation::Mode::NONE;
-                    storage.operation.store(operation, std::memory_order::release);
-                    if (callback)
+                    if (!update(storage, current, operation))
+                        continue;
+                    trace::record(trace::Event::SDO_COMPLETE, false, static_cast<uint32_t>(i));
+                    if (storage.cancellation.cancelled())
+                        metrics::sdo_cancelled.add();
+                    else
+                        record_sdo_timeout(storage);
+                    if (callback) {
+                        trace::ScopedSpan span{
+                            trace::Span::SDO_CALLBACK, static_cast<uint32_t>(i)};
                         callback(context, false);
+                    }
+                } else if (operation.state == Operation::State::WAITING) {
+                    operation.state =
+                        (operation.mode == Operation::Mode::WRITE ? Operation::State::WRITING
+                                                                  : Operation::State::READING);
+                    update(storage, current, operation);
                 } else if (
                     operation.state == Operation::State::READING
                     || operation.state == Operation::State::WRITING_CONFIRMING) {
@@ -768,10 +1682,13 @@ private:
                         static_cast<uint16_t>(storage.info.index), storage.info.sub_index,
                         static_cast<void*>(&storage), static_cast<int>(operation.mode),
                         static_cast<int>(operation.state));
+                    stamp_first_send(sdo_timing_[i], now);
                     read_async_unchecked_internal(storage.info.index, storage.info.sub_index);
                 } else if (operation.state == Operation::State::WRITING) {
                     operation.state = Operation::State::WRITING_CONFIRMING;
-                    storage.operation.store(operation, std::memory_order::relaxed);
+                    if (!update(storage, current, operation))
+                        continue;
+                    stamp_first_send(sdo_timing_[i], now);
                     if (storage.info.size == StorageInfo::Size::_1)
                         write_async_unchecked_internal(
                             storage.value.load(std::memory_order::relaxed).as<uint8_t>(),
@@ -791,55 +1708,19 @@ private:
                 }
             }
 
-            // Process raw SDO operations
-            for (auto& unit : raw_sdo_units_) {
-                if (!unit.in_use.load(std::memory_order_acquire))
-                    continue;
-
-                std::lock_guard lock{unit.mutex};
-                // Check timeout for PENDING, READING, or WRITING states
-                if (unit.state == RawSdoUnit::State::PENDING
-                    || unit.state == RawSdoUnit::State::READING
-                    || unit.state == RawSdoUnit::State::WRITING) {
-                    if (now >= unit.timeout_point) {
-                        unit.state = RawSdoUnit::State::FAILED;
-                        unit.cv.notify_one();
-                        continue;
-                    }
-                }
-                // Only send request once when in PENDING state
-                if (unit.state == RawSdoUnit::State::PENDING) {
-                    if (unit.mode == RawSdoUnit::Mode::READ) {
-                        read_async_unchecked_internal(unit.index, unit.sub_index);
-                        unit.state = RawSdoUnit::State::READING;
-                    } else if (unit.mode == RawSdoUnit::Mode::WRITE) {
-                        // Send write request from sdo_thread (avoids data race on sdo_builder_)
-                        if (unit.write_data_size == 1) {
-                            uint8_t value;
-                            std::memcpy(&value, unit.write_data.data(), 1);
-                            write_async_unchecked_internal(value, unit.index, unit.sub_index);
-                        } else if (unit.write_data_size == 2) {
-                            uint16_t value;
-                            std::memcpy(&value, unit.write_data.data(), 2);
-                            write_async_unchecked_internal(value, unit.index, unit.sub_index);
-                        } else if (unit.write_data_size == 4) {
-                            uint32_t value;
-                            std::memcpy(&value, unit.write_data.data(), 4);
-                            write_async_unchecked_internal(value, unit.index, unit.sub_index);
-                        } else if (unit.write_data_size == 8) {
-                            uint64_t value;
-                            std::memcpy(&value, unit.write_data.data(), 8);
-                            write_async_unchecked_internal(value, unit.index, unit.sub_index);
-                        }
-                        unit.state = RawSdoUnit::State::WRITING;
-                    }
-                }
-            }
+            process_raw_sdo_requests(now);
 
             sdo_builder_.finalize();
 
+            dispatch_rx_events();
+            dispatch_joint_error_events();
+            trace::end_span(trace::Span::SDO_TICK);
+
             std::this_thread::sleep_for(update_period);
         }
+
+        close_subscriptions();
+        dispatch_rx_events();
     }
 
     void update_pdo_positions(const int32_t (&positions)[5][4]) {
@@ -862,27 +1743,127 @@ private:
             }
     }
 
+    // RX thread: only records changes, formatting and callbacks happen on sdo_thread
     void update_pdo_error_codes(const protocol::pdo::JointPosCurErr (&joint)[5][4]) {
+        std::chrono::steady_clock::time_point now{};
         for (int i = 0; i < 5; i++)
             for (int j = 0; j < 4; j++) {
                 auto new_code = joint[i][j].error_code;
                 auto previous =
                     pdo_read_error_code_[i][j].exchange(new_code, std::memory_order::relaxed);
-                handle_error_code_update(i, j, previous, new_code);
+                if (new_code == previous) [[likely]]
+                    continue;
+
+                if (now == std::chrono::steady_clock::time_point{})
+                    now = std::chrono::steady_clock::now();
+                push_joint_error_event(device::JointErrorEvent{
+                    .timestamp = now,
+                    .error_code = new_code,
+                    .set_bits = new_code & ~previous,
+                    .cleared_bits = previous & ~new_code,
+                    .finger = static_cast<uint8_t>(i),
+                    .joint = static_cast<uint8_t>(j),
+                });
             }
     }
 
+    // The RX thread is the single producer of both queues.
+    void push_joint_error_event(const device::JointErrorEvent& event) {
+        if (!joint_error_poll_queue_.push_back(event)) [[unlikely]] {
+            joint_error_poll_dropped_.fetch_add(1, std::memory_order::relaxed);
+            metrics::joint_error_events_dropped_poll.add();
+        }
+        if (!joint_error_log_queue_.push_back(event)) [[unlikely]] {
+            joint_error_log_dropped_.fetch_add(1, std::memory_order::relaxed);
+            metrics::joint_error_events_dropped_log.add();
+        }
+    }
+
     void update_pdo_efforts(const protocol::pdo::JointPosCurErr (&joint)[5][4]) {
         for (int i = 0; i < 5; i++)
             for (int j = 0; j < 4; j++)
                 pdo_read_actual_effort_[i][j].store(static_cast<double>(joint[i][j].effort_feedback), std::memory_order::relaxed);
     }
 
-    void handle_error_code_update(int finger, int joint, uint32_t previous, uint32_t current) {
-        if (current == previous)
+    // Called from sdo_thread once per tick.
+    void dispatch_joint_error_events() {
+        if (auto dropped = joint_error_log_dropped_.exchange(0, std::memory_order::relaxed))
+            [[unlikely]]
+            logger_.warn("{} joint error event(s) lost: event queue full", dropped);
+        if (!joint_error_log_queue_.readable()) [[likely]]
             return;
 
-        uint32_t newly_set = current & ~previous;
+        std::lock_guard guard{joint_error_callback_mutex_};
+        joint_error_log_queue_.pop_front_n([this](device::JointErrorEvent&& event) {
+            log_joint_error_event(event);
+            if (joint_error_callback_) {
+                trace::ScopedSpan span{
+                    trace::Span::JOINT_ERROR_CALLBACK,
+                    static_cast<uint32_t>(event.finger << 8 | event.joint)};
+                joint_error_callback_(joint_error_callback_context_, event);
+            }
+        });
+    }
+
+    // Called from sdo_thread once per tick; formats what the RX thread queued.
+    void dispatch_rx_events() {
+        auto dropped = rx_event_dropped_.load(std::memory_order::relaxed);
+        if (dropped != rx_event_dropped_reported_) [[unlikely]] {
+            logger_.warn(
+                "{} RX log event(s) lost: event queue full", dropped - rx_event_dropped_reported_);
+            rx_event_dropped_reported_ = dropped;
+        }
+        rx_event_queue_.pop_front_n([this](RxEvent&& event) { log_rx_event(event); });
+    }
+
+    void log_rx_event(const RxEvent& event) {
+        if (event.type == RxEvent::Type::RECEIVED)
+            logger_.trace("RX [{} bytes]", event.size);
+        else if (event.type == RxEvent::Type::FRAME_CHUNK)
+            logger_.log(
+                static_cast<logging::Level>(event.code), "RX Frame dump [{} bytes] +{}: {:Xp}",
+                event.size, event.offset,
+                spdlog::to_hex(event.data, event.data + event.data_size));
+        else if (event.type == RxEvent::Type::SDO_READ_SUCCESS)
+            logger_.debug(
+                "SDO Read Success: 0x{:04X}.{} (#{}), Mode={}, State={}", event.index,
+                event.sub_index, event.value, event.code, event.detail);
+        else if (event.type == RxEvent::Type::TPDO_RECEIVED)
+            logger_.debug("TPDO 0x{:02X} Received", event.detail);
+        else if (event.type == RxEvent::Type::PARSE_ERROR) {
+            log_rx_parse_error(event);
+            trace::dump_on_error("RX frame parsing failed");
+        }
+    }
+
+    void log_rx_parse_error(const RxEvent& event) {
+        auto error = static_cast<RxEvent::ParseError>(event.code);
+        if (error == RxEvent::ParseError::TRUNCATED)
+            logger_.error(
+                "RX Frame parsing failed at offset {}: truncated, requires {} bytes, but {} remain",
+                event.offset, event.value, event.size - event.offset);
+        else if (error == RxEvent::ParseError::INVALID_HEADER_TYPE)
+            logger_.error(
+                "RX Frame parsing failed at offset {}: Invalid header type: 0x{:02X}",
+                event.offset, event.detail);
+        else if (error == RxEvent::ParseError::INVALID_SDO_COMMAND)
+            logger_.error(
+                "RX Frame parsing failed at offset {}: Invalid SDO command specifier: 0x{:02X}",
+                event.offset, event.detail);
+        else if (error == RxEvent::ParseError::UNKNOWN_SDO_OBJECT)
+            logger_.error(
+                "RX Frame parsing failed at offset {}: SDO object not found: index=0x{:04X}, "
+                "sub-index=0x{:02X}",
+                event.offset, event.index, event.sub_index);
+        else if (error == RxEvent::ParseError::INVALID_PDO_READ_ID)
+            logger_.error(
+                "RX Frame parsing failed at offset {}: PDO frame invalid: read_id == 0x{:02X}",
+                event.offset, event.detail);
+    }
+
+    void log_joint_error_event(const device::JointErrorEvent& event) {
+        int finger = event.finger, joint = event.joint;
+        uint32_t newly_set = event.set_bits;
         if (newly_set == 0)
             return;
 
@@ -911,44 +1892,137 @@ private:
         logger_.log(def.level, "Hint: {}", def.remedy);
     }
 
-    void read_pdo_frame(const std::byte*& pointer, const std::byte* sentinel) {
-        const auto& header = read_frame_struct<protocol::pdo::Header>(pointer, sentinel);
-
-        if (header.read_id == 0x01) {
-            logger_.debug("TPDO 0x01 Received");
-            const auto& data = read_frame_struct<protocol::pdo::CommandResult>(pointer, sentinel);
-            update_pdo_positions(data.positions);
-
-            pdo_read_result_version_.store(
-                pdo_read_result_version_.load(std::memory_order::relaxed) + 1,
-                std::memory_order::release);
-        } else if (header.read_id == 0x02) {
-            logger_.debug("TPDO 0x02 Received");
-            const auto& data =
-                read_frame_struct<protocol::pdo::CommandResultPosCurErr>(pointer, sentinel);
-            update_pdo_positions(data.joint);
-            update_pdo_error_codes(data.joint);
-            update_pdo_efforts(data.joint);
-
-            pdo_read_result_version_.store(
-                pdo_read_result_version_.load(std::memory_order::relaxed) + 1,
-                std::memory_order::release);
-        } else if (header.read_id == 0xD0) {
-            const auto& data =
-                read_frame_struct<protocol::pdo::LatencyTestResult>(pointer, sentinel);
+    bool read_pdo_frame(const std::byte*& pointer, const std::byte* sentinel) {
+        auto header = read_frame_struct<protocol::pdo::Header>(pointer, sentinel);
+        if (!header)
+            return false;
+
+        if (header->read_id == 0x01) {
+            push_tpdo_received(header->read_id);
+            auto data = read_frame_struct<protocol::pdo::CommandResult>(pointer, sentinel);
+            if (!data)
+                return false;
+            update_pdo_positions(data->positions);
+            publish_state(false);
+            advance_feedback_version();
+        } else if (header->read_id == 0x02) {
+            push_tpdo_received(header->read_id);
+            auto data = read_frame_struct<protocol::pdo::CommandResultPosCurErr>(pointer, sentinel);
+            if (!data)
+                return false;
+            update_pdo_positions(data->joint);
+            update_pdo_error_codes(data->joint);
+            update_pdo_efforts(data->joint);
+            publish_state(true);
+            advance_feedback_version();
+        } else if (header->read_id == 0xD0) {
+            auto data = read_frame_struct<protocol::pdo::LatencyTestResult>(pointer, sentinel);
+            if (!data)
+                return false;
             std::unique_lock guard{latency_tester_mutex_, std::try_to_lock};
             if (guard.owns_lock()) {
                 if (latency_tester_)
-                    latency_tester_->read_result(data);
+                    latency_tester_->read_result(*data);
             }
         } else
-            throw std::runtime_error(
-                std::format("PDO frame invalid: read_id == 0x{:02X}", header.read_id));
+            return rx_parse_error(
+                pointer - sizeof(protocol::pdo::Header), RxEvent::ParseError::INVALID_PDO_READ_ID,
+                {.detail = header->read_id});
+        return true;
+    }
+
+    // RX thread. Wakes wait_realtime_feedback() callers; costs one RMW and one load otherwise.
+    void advance_feedback_version() {
+        pdo_read_result_version_.fetch_add(1, std::memory_order::seq_cst);
+        if (feedback_waiter_count_.load(std::memory_order::seq_cst)) [[unlikely]] {
+            // A waiter between its version check and its wait holds the mutex
+            { std::lock_guard guard{feedback_mutex_}; }
+            feedback_arrived_.notify_all();
+        }
+    }
+
+    // RX thread. Frames arriving while the publisher is being started or stopped are skipped.
+    void publish_state(bool has_effort_and_error_code) {
+        std::unique_lock guard{state_publisher_mutex_, std::try_to_lock};
+        if (!guard.owns_lock() || !state_publisher_) [[likely]]
+            return;
+
+        shared_state::HandState state{};
+        for (int i = 0; i < 5; i++)
+            for (int j = 0; j < 4; j++)
+                state.position[i][j] = pdo_read_position_[i][j].load(std::memory_order::relaxed);
+        if (has_effort_and_error_code) {
+            state.flags = shared_state::HandState::HAS_EFFORT_AND_ERROR_CODE;
+            for (int i = 0; i < 5; i++)
+                for (int j = 0; j < 4; j++) {
+                    state.effort[i][j] =
+                        pdo_read_actual_effort_[i][j].load(std::memory_order::relaxed);
+                    state.error_code[i][j] =
+                        pdo_read_error_code_[i][j].load(std::memory_order::relaxed);
+                }
+        }
+        state_publisher_->publish(state);
+    }
+
+    void push_tpdo_received(uint8_t read_id) {
+        if (logger_.should_log(logging::Level::DEBUG))
+            push_rx_event(RxEvent{.type = RxEvent::Type::TPDO_RECEIVED, .detail = read_id});
+    }
+
+    // `expected_index` is the frame index the next tick should have; a larger one means the
+    // executor skipped periods after an overrun.
+    void record_pdo_tick(const utility::TickContext& context, uint64_t& expected_index) {
+        auto lateness = std::max(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                context.now - context.scheduled_update_time),
+            std::chrono::nanoseconds::zero());
+        trace::record(
+            trace::Event::PDO_TICK, 0, static_cast<uint32_t>(context.frame_index),
+            static_cast<uint64_t>(lateness.count()));
+
+        realtime_loop_.tick_count.fetch_add(1, std::memory_order::relaxed);
+        realtime_loop_.lateness_ns.record(static_cast<uint64_t>(lateness.count()));
+        if (context.frame_index > expected_index)
+            realtime_loop_.overrun_count.fetch_add(
+                context.frame_index - expected_index, std::memory_order::relaxed);
+        expected_index = context.frame_index + 1;
+    }
+
+    // Runs the controller's step and sends its targets, timing both.
+    void run_pdo_step(
+        const utility::TickContext& context, bool upstream_enabled,
+        device::IRealtimeController::JointPositions* actual) {
+        using clock = std::chrono::steady_clock;
+        auto to_ns = [](clock::duration duration) {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+        };
+
+        auto step_begin = clock::now();
+        trace::begin_span(trace::Span::PDO_STEP);
+        auto target_positions = realtime_controller_->step(actual);
+        trace::end_span(trace::Span::PDO_STEP);
+
+        auto submit_begin = clock::now();
+        trace::begin_span(trace::Span::PDO_SUBMIT);
+        pdo_write_async_unchecked(
+            upstream_enabled, target_positions.value,
+            static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                      context.scheduled_update_time - context.begin_time)
+                                      .count()));
+        trace::end_span(trace::Span::PDO_SUBMIT);
+        auto submit_end = clock::now();
+
+        realtime_loop_.step_ns.record(to_ns(submit_begin - step_begin));
+        realtime_loop_.submit_ns.record(to_ns(submit_end - submit_begin));
     }
 
     void pdo_thread_main(const std::stop_token& stop_token, bool upstream_enabled) {
         constexpr double update_rate = 500.0;
         realtime_controller_->setup(update_rate);
+        realtime_period_ns_.store(
+            static_cast<uint64_t>(std::round(1e9 / update_rate)), std::memory_order::relaxed);
+        uint64_t expected_index = 0;
 
         if (upstream_enabled) {
             const uint64_t old_version = pdo_read_result_version_.load(std::memory_order::relaxed);
@@ -958,44 +2032,36 @@ private:
             }}.spin(update_rate, stop_token);
 
             utility::TickExecutor{[&](const utility::TickContext& context) {
+                record_pdo_tick(context, expected_index);
                 device::IRealtimeController::JointPositions positions;
                 for (int i = 0; i < 5; i++)
                     for (int j = 0; j < 4; j++)
                         positions.value[i][j] =
                             pdo_read_position_[i][j].load(std::memory_order::relaxed);
-
-                auto target_positions = realtime_controller_->step(&positions);
-
-                pdo_write_async_unchecked(
-                    true, target_positions.value,
-                    static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
-                                              context.scheduled_update_time - context.begin_time)
-                                              .count()));
+                run_pdo_step(context, true, &positions);
             }}.spin(update_rate, stop_token);
         } else {
             utility::TickExecutor{[&](const utility::TickContext& context) {
-                auto target_positions = realtime_controller_->step(nullptr);
-                pdo_write_async_unchecked(
-                    false, target_positions.value,
-                    static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
-                                              context.scheduled_update_time - context.begin_time)
-                                              .count()));
+                record_pdo_tick(context, expected_index);
+                run_pdo_step(context, false, nullptr);
             }}.spin(update_rate, stop_token);
         }
     }
 
+    // Returns nullptr, and reports a parse error, if fewer than sizeof(Struct) bytes remain.
     template <typename Struct>
-    static const Struct& read_frame_struct(const std::byte*& pointer, const std::byte* sentinel) {
+    const Struct* read_frame_struct(const std::byte*& pointer, const std::byte* sentinel) {
         static_assert(alignof(Struct) == 1);
         const std::size_t required = sizeof(Struct);
         const std::ptrdiff_t remaining = sentinel - pointer;
-        if (remaining < static_cast<std::ptrdiff_t>(required)) {
-            throw std::runtime_error(std::format(
-                "{} truncated: requires {} bytes, but {} remain", typeid(Struct).name(), required,
-                remaining));
+        if (remaining < static_cast<std::ptrdiff_t>(required)) [[unlikely]] {
+            rx_parse_error(
+                pointer, RxEvent::ParseError::TRUNCATED,
+                {.value = static_cast<uint32_t>(required)});
+            return nullptr;
         }
 
-        const auto& data = *reinterpret_cast<const Struct*>(pointer);
+        auto data = reinterpret_cast<const Struct*>(pointer);
         pointer += required;
         return data;
     }
@@ -1055,6 +2121,15 @@ private:
 
     size_t storage_unit_count_;
     std::unique_ptr<StorageUnit[]> storage_;
+    std::unique_ptr<SdoTiming[]> sdo_timing_; // sdo_thread only
+    struct SdoLatencyStatistics {
+        utility::HdrHistogram<> latency_ns;
+        std::atomic<uint64_t> total_queue_ns{0}, timeout_count{0};
+    };
+    std::array<SdoLatencyStatistics, metrics::sdo_target_count> sdo_latency_; // See sdo_target()
+    utility::MpscQueue<Request> request_queue_;
+    std::atomic<bool> requests_closed_{false}; // Set on disconnect, see close_requests()
+    std::mutex closed_requests_mutex_;
 
     struct IndexMapKey {
         uint16_t index;
@@ -1063,10 +2138,63 @@ private:
     };
     std::map<uint32_t, StorageUnit*> index_storage_map_;
 
+    std::unique_ptr<CachedReadNode[]> cached_read_nodes_;       // cached_read_mutex_
+    std::mutex cached_read_mutex_;
+    std::vector<int> cached_read_units_;                        // cached_read_mutex_
+    std::atomic<bool> cached_reads_waiting_{false};
+    bool cached_reads_closed_ = false;                          // cached_read_mutex_
+    std::vector<CachedReadCompletion> cached_read_completions_; // sdo_thread only
+
+    std::atomic<uint64_t> next_subscription_id_{1};
+    std::atomic<bool> subscription_changes_{false};
+    std::mutex subscription_mutex_;
+    std::condition_variable subscription_applied_;
+    std::vector<std::unique_ptr<Subscription>> subscription_additions_; // subscription_mutex_
+    std::vector<uint64_t> subscription_removals_;                       // subscription_mutex_
+    uint64_t subscription_epoch_taken_ = 0;                             // subscription_mutex_
+    uint64_t subscription_epoch_applied_ = 0;                           // subscription_mutex_
+    bool subscriptions_closed_ = false;                                 // subscription_mutex_
+    std::vector<std::unique_ptr<Subscription>> subscriptions_;          // sdo_thread only
+
+    // Declared before transport_ so that they outlive the RX thread
+    RawSdoPool raw_sdo_pool_;
+    RawSdoTable raw_sdo_table_;
+    std::atomic<RawSdoRequest*> raw_sdo_submissions_{nullptr};
+    RawSdoRequest raw_sdo_closed_; // Head of the submission stack once closed on disconnect
+    std::vector<RawSdoRequest*> raw_sdo_backlog_;   // sdo_thread only
+    std::vector<RawSdoRequest*> raw_sdo_in_flight_; // sdo_thread only
+
     std::atomic<double> pdo_read_position_[5][4]{};
     std::atomic<double> pdo_read_actual_effort_[5][4]{};
     std::atomic<uint32_t> pdo_read_error_code_[5][4]{};
+
+    // Declared before transport_ so that it outlives the RX thread, which publishes to it
+    std::unique_ptr<StatePublisher> state_publisher_;
+    std::mutex state_publisher_mutex_;
+
+    // Produced by the RX thread; see push_joint_error_event()
+    utility::RingBuffer<device::JointErrorEvent> joint_error_poll_queue_{256};
+    utility::RingBuffer<device::JointErrorEvent> joint_error_log_queue_{256}; // sdo_thread
+    std::atomic<uint64_t> joint_error_poll_dropped_ = 0;
+    std::atomic<uint64_t> joint_error_log_dropped_ = 0;
+    std::mutex joint_error_callback_mutex_;
+    void (*joint_error_callback_)(Buffer8 context, const device::JointErrorEvent& event) = nullptr;
+    Buffer8 joint_error_callback_context_;
+
+    // RX thread only, except the counters; see receive_transfer_completed_callback()
+    const std::byte* rx_frame_begin_ = nullptr;
+    uint32_t rx_frame_size_ = 0;
+    utility::RingBuffer<RxEvent> rx_event_queue_{1024}; // Consumed by sdo_thread
+    std::atomic<uint64_t> rx_event_dropped_ = 0;
+    uint64_t rx_event_dropped_reported_ = 0; // sdo_thread only
+    std::atomic<uint64_t> rx_frame_count_ = 0;
+    std::atomic<uint64_t> rx_parse_errors_ = 0;
+    std::atomic<uint64_t> rx_callback_total_ns_ = 0;
+    std::atomic<uint64_t> rx_callback_max_ns_ = 0;
     std::atomic<uint64_t> pdo_read_result_version_ = 0;
+    std::atomic<int> feedback_waiter_count_ = 0;
+    std::mutex feedback_mutex_;
+    std::condition_variable feedback_arrived_;
     static_assert(std::atomic<double>::is_always_lock_free);
     static_assert(std::atomic<uint32_t>::is_always_lock_free);
     static_assert(std::atomic<uint64_t>::is_always_lock_free);
@@ -1083,17 +2211,38 @@ private:
     std::unique_ptr<device::IRealtimeController> realtime_controller_;
     std::jthread pdo_thread_;
 
+    // Written by the PDO thread; see realtime_statistics(). The loop statistics are also the
+    // source of the pdo_* metrics.
+    std::atomic<uint64_t> realtime_period_ns_ = 0;
+    metrics::RealtimeLoop realtime_loop_;
+
     std::atomic<bool> transport_error_ = false;
     std::mutex transport_error_mutex_;
     std::string transport_error_message_;
-
-    std::array<RawSdoUnit, RAW_SDO_SLOT_COUNT> raw_sdo_units_;
 };
 
+#ifdef WUJIHANDCPP_TESTING
+namespace {
+// Handed by testing::create_handler() to the Handler constructor it runs on the same thread
+thread_local std::unique_ptr<transport::ITransport> test_transport;
+} // namespace
+
+std::unique_ptr<Handler> testing::create_handler(
+    std::unique_ptr<transport::ITransport> transport, size_t storage_unit_count) {
+    test_transport = std::move(transport);
+    return std::make_unique<Handler>(0, 0, nullptr, storage_unit_count);
+}
+#endif
+
 WUJIHANDCPP_API Handler::Handler(
     uint16_t usb_vid, int32_t usb_pid, const char* serial_number, size_t storage_unit_count) {
-    impl_ = new Impl{
-        transport::create_usb_transport(usb_vid, usb_pid, serial_number), storage_unit_count};
+    std::unique_ptr<transport::ITransport> transport;
+#ifdef WUJIHANDCPP_TESTING
+    transport = std::move(test_transport);
+    if (!transport)
+#endif
+        transport = transport::create_usb_transport(usb_vid, usb_pid, serial_number);
+    impl_ = new Impl{std::move(transport), storage_unit_count};
 }
 
 WUJIHANDCPP_API Handler::~Handler() { delete impl_; }
@@ -1130,6 +2279,40 @@ WUJIHANDCPP_API void Handler::write_async(
     impl_->write_async(data, storage_id, timeout, callback, callback_context);
 }
 
+WUJIHANDCPP_API void Handler::read_many(
+    StorageRange range, std::chrono::steady_clock::time_point deadline,
+    device::CancellationToken token, void (*callback)(Buffer8 context, bool success),
+    Buffer8 callback_context) {
+    impl_->read_many(range, deadline, token, callback, callback_context);
+}
+
+WUJIHANDCPP_API void Handler::write_many(
+    const Buffer8* data, StorageRange range, std::chrono::steady_clock::time_point deadline,
+    device::CancellationToken token, void (*callback)(Buffer8 context, bool success),
+    Buffer8 callback_context) {
+    impl_->write_many(data, range, deadline, token, callback, callback_context);
+}
+
+WUJIHANDCPP_API void Handler::read_many_cached(
+    StorageRange range, std::chrono::steady_clock::duration max_age,
+    std::chrono::steady_clock::time_point deadline, device::CancellationToken token,
+    void (*callback)(Buffer8 context, bool success), Buffer8 callback_context) {
+    impl_->read_many_cached(range, max_age, deadline, token, callback, callback_context);
+}
+
+WUJIHANDCPP_API void Handler::get_many(StorageRange range, Buffer8* out) {
+    impl_->get_many(range, out);
+}
+
+WUJIHANDCPP_API uint64_t Handler::subscribe(
+    StorageRange range, std::chrono::steady_clock::duration period,
+    void (*callback)(Buffer8 context, int index, Buffer8 value), void (*release)(Buffer8 context),
+    Buffer8 context) {
+    return impl_->subscribe(range, period, callback, release, context);
+}
+
+WUJIHANDCPP_API void Handler::unsubscribe(uint64_t id) { impl_->unsubscribe(id); }
+
 WUJIHANDCPP_API auto
     Handler::realtime_get_joint_actual_position() -> const std::atomic<double> (&)[5][4] {
     return impl_->realtime_get_joint_actual_position();
@@ -1139,10 +2322,54 @@ WUJIHANDCPP_API auto Handler::realtime_get_joint_actual_effort() -> const std::a
     return impl_->realtime_get_joint_actual_effort();
 }
 
+WUJIHANDCPP_API auto
+    Handler::realtime_get_joint_error_code() -> const std::atomic<uint32_t> (&)[5][4] {
+    return impl_->realtime_get_joint_error_code();
+}
+
+WUJIHANDCPP_API uint64_t Handler::realtime_feedback_version() const {
+    return impl_->realtime_feedback_version();
+}
+
+WUJIHANDCPP_API uint64_t Handler::wait_realtime_feedback(
+    uint64_t version, std::chrono::steady_clock::time_point deadline) {
+    return impl_->wait_realtime_feedback(version, deadline);
+}
+
 WUJIHANDCPP_API void Handler::realtime_set_joint_target_position(const double (&positions)[5][4]) {
     impl_->realtime_set_joint_target_position(positions);
 }
 
+WUJIHANDCPP_API size_t
+    Handler::poll_joint_error_events(device::JointErrorEvent* events, size_t max_count) {
+    return impl_->poll_joint_error_events(events, max_count);
+}
+
+WUJIHANDCPP_API uint64_t Handler::dropped_joint_error_events() const {
+    return impl_->dropped_joint_error_events();
+}
+
+WUJIHANDCPP_API void Handler::set_joint_error_callback(
+    void (*callback)(Buffer8 context, const device::JointErrorEvent& event), Buffer8 context) {
+    impl_->set_joint_error_callback(callback, context);
+}
+
+WUJIHANDCPP_API const char* Handler::joint_error_description(int bit) {
+    return Impl::joint_error_description(bit);
+}
+
+WUJIHANDCPP_API Handler::SdoLatency Handler::sdo_latency(int finger_id, int joint_id) const {
+    return impl_->sdo_latency(finger_id, joint_id);
+}
+
+WUJIHANDCPP_API Handler::RxStatistics Handler::rx_statistics() const {
+    return impl_->rx_statistics();
+}
+
+WUJIHANDCPP_API Handler::RealtimeStatistics Handler::realtime_statistics() const {
+    return impl_->realtime_statistics();
+}
+
 WUJIHANDCPP_API void Handler::attach_realtime_controller(
     device::IRealtimeController* controller, bool enable_upstream) {
     impl_->attach_realtime_controller(controller, enable_upstream);
@@ -1164,6 +2391,12 @@ WUJIHANDCPP_API void Handler::start_latency_test() { impl_->start_latency_test()
 
 WUJIHANDCPP_API void Handler::stop_latency_test() { impl_->stop_latency_test(); }
 
+WUJIHANDCPP_API void Handler::start_state_publisher(const char* name, size_t capacity) {
+    impl_->start_state_publisher(name, capacity);
+}
+
+WUJIHANDCPP_API void Handler::stop_state_publisher() { impl_->stop_state_publisher(); }
+
 WUJIHANDCPP_API Handler::Buffer8 Handler::get(int storage_id) { return impl_->get(storage_id); }
 
 WUJIHANDCPP_API void Handler::disable_thread_safe_check() {
@@ -1172,13 +2405,43 @@ WUJIHANDCPP_API void Handler::disable_thread_safe_check() {
 
 WUJIHANDCPP_API std::vector<uint8_t> Handler::raw_sdo_read(
     uint16_t index, uint8_t sub_index, std::chrono::steady_clock::duration timeout) {
-    return impl_->raw_sdo_read(index, sub_index, timeout);
+    return impl_->raw_sdo_read(index, sub_index, device::deadline_after(timeout), {});
 }
 
 WUJIHANDCPP_API void Handler::raw_sdo_write(
     uint16_t index, uint8_t sub_index, const void* data, size_t size,
     std::chrono::steady_clock::duration timeout) {
-    impl_->raw_sdo_write(index, sub_index, data, size, timeout);
+    impl_->raw_sdo_write(index, sub_index, data, size, device::deadline_after(timeout), {});
+}
+
+WUJIHANDCPP_API std::vector<uint8_t> Handler::raw_sdo_read(
+    uint16_t index, uint8_t sub_index, std::chrono::steady_clock::time_point deadline,
+    device::CancellationToken token) {
+    return impl_->raw_sdo_read(index, sub_index, deadline, token);
+}
+
+WUJIHANDCPP_API void Handler::raw_sdo_write(
+    uint16_t index, uint8_t sub_index, const void* data, size_t size,
+    std::chrono::steady_clock::time_point deadline, device::CancellationToken token) {
+    impl_->raw_sdo_write(index, sub_index, data, size, deadline, token);
+}
+
+WUJIHANDCPP_API std::future<std::vector<uint8_t>> Handler::raw_sdo_read_async(
+    uint16_t index, uint8_t sub_index, std::chrono::steady_clock::time_point deadline,
+    device::CancellationToken token) {
+    return impl_->raw_sdo_read_async(index, sub_index, deadline, token);
+}
+
+WUJIHANDCPP_API std::future<void> Handler::raw_sdo_write_async(
+    uint16_t index, uint8_t sub_index, const void* data, size_t size,
+    std::chrono::steady_clock::time_point deadline, device::CancellationToken token) {
+    return impl_->raw_sdo_write_async(index, sub_index, data, size, deadline, token);
+}
+
+WUJIHANDCPP_API std::vector<std::future<std::vector<uint8_t>>> Handler::raw_sdo_read_many(
+    const SdoAddress* addresses, size_t count, std::chrono::steady_clock::time_point deadline,
+    device::CancellationToken token) {
+    return impl_->raw_sdo_read_many(addresses, count, deadline, token);
 }
 
 } // namespace wujihandcpp::protocol
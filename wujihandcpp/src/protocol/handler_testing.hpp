@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+#include <memory>
+
+#include <wujihandcpp/protocol/handler.hpp>
+
+#include "transport/transport.hpp"
+
+// Unit test seam of Handler, built only into the test executable (WUJIHANDCPP_TESTING), which
+// compiles handler.cpp itself. Neither installed nor exported from the library.
+namespace wujihandcpp::protocol::testing {
+
+// Creates a Handler that drives `transport` instead of opening a USB device
+std::unique_ptr<Handler>
+    create_handler(std::unique_ptr<transport::ITransport> transport, size_t storage_unit_count);
+
+} // namespace wujihandcpp::protocol::testing
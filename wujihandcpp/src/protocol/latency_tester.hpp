@@ -15,7 +15,7 @@
 #include "protocol/frame_builder.hpp"
 #include "protocol/protocol.hpp"
 #include "utility/ring_buffer.hpp"
-#include "utility/tdigest.hpp"
+#include "utility/hdr_histogram.hpp"
 #include "utility/tick_executor.hpp"
 
 namespace wujihandcpp::protocol {
@@ -71,12 +71,11 @@ public:
         logger_.info(
             "RT Thread Scheduling ({:.0f}Hz, {:.0f}us period):", update_rate_, update_period_us);
 
-        context.jitter_statistics.merge();
-        double min_us = context.jitter_statistics.min(),
-               med_us = context.jitter_statistics.quantile(50),
-               p90_us = context.jitter_statistics.quantile(90),
-               p99_us = context.jitter_statistics.quantile(99),
-               max_us = context.jitter_statistics.max();
+        auto jitter = context.jitter_statistics.snapshot();
+        auto to_us = [](uint64_t ns) { return static_cast<double>(ns) / 1e3; };
+        double min_us = to_us(jitter.min), med_us = to_us(jitter.quantile(0.5)),
+               p90_us = to_us(jitter.quantile(0.9)), p99_us = to_us(jitter.quantile(0.99)),
+               max_us = to_us(jitter.max);
         logger_.info(
             "  Timing Jitter: Min {:.0f}us ({:.0f}%), Med {:.0f}us ({:.0f}%), P90 "
             "{:.0f}us ({:.0f}%), P99 {:.0f}us ({:.0f}%), Max {:.0f}us ({:.0f}%)",
@@ -151,14 +150,15 @@ public:
     }
 
     void log_device_statistics(uint64_t frame_index, uint64_t dropped_frame_count) {
-        rtt_statistics_.merge();
+        auto rtt = rtt_statistics_.snapshot();
+        auto to_ms = [](uint64_t ns) { return static_cast<double>(ns) / 1e6; };
 
         logger_.info("Device Communication:");
         logger_.info(
             "  Round Trip Time: Min {:.3f}ms, Med {:.3f}ms, P90 {:.3f}ms, P99 {:.3f}ms, Max "
             "{:.3f}ms",
-            rtt_statistics_.min(), rtt_statistics_.quantile(50), rtt_statistics_.quantile(90),
-            rtt_statistics_.quantile(99), rtt_statistics_.max());
+            to_ms(rtt.min), to_ms(rtt.quantile(0.5)), to_ms(rtt.quantile(0.9)),
+            to_ms(rtt.quantile(0.99)), to_ms(rtt.max));
 
         uint64_t frame_send_count = frame_index - warmup_frames_ - dropped_frame_count;
         uint64_t frame_loss_count = (timeout_count_ + joint_count_ - 1) / joint_count_;
@@ -218,8 +218,8 @@ private:
     }
 
     void record_value(const std::chrono::steady_clock::duration& round_trip_time) {
-        double rtt_ms = std::chrono::duration<double, std::milli>(round_trip_time).count();
-        rtt_statistics_.insert(rtt_ms);
+        rtt_statistics_.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(round_trip_time).count()));
     }
 
     logging::Logger& logger_;
@@ -235,7 +235,7 @@ private:
     std::pmr::unsynchronized_pool_resource pool_;
     std::pmr::map<uint32_t, Result> result_map_{&pool_};
 
-    utility::TDigest<double> rtt_statistics_{1000};
+    utility::HdrHistogram<> rtt_statistics_; // Nanoseconds
     uint64_t timeout_count_ = 0;
 };
 
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <wujihandcpp/device/cancellation.hpp>
+
+namespace wujihandcpp::protocol {
+
+// One raw SDO read or write. Requests are pooled and never freed while the owning Handler
+// lives, so the RX thread may safely dereference a pointer it loaded from RawSdoTable even if
+// the request completes and is recycled meanwhile; claim_response() then tells whether the
+// request is still the one the response was matched to.
+struct RawSdoRequest {
+    enum class Mode : uint8_t { READ, WRITE };
+    enum class State : uint8_t {
+        IDLE,       // In the pool
+        PENDING,    // Submitted, not yet sent
+        SENT,       // In the table, waiting for the response
+        COMPLETING, // Claimed by the thread that fulfills the promise
+        DONE,       // Promise fulfilled; sdo_thread may retire the request
+    };
+
+    // Responses of reads and writes carry different command specifiers, so the mode is part of
+    // the key and a read and a write of the same object may be in flight together.
+    static constexpr uint32_t make_key(uint16_t index, uint8_t sub_index, Mode mode) {
+        return (uint32_t{index} << 16) | (uint32_t{sub_index} << 8)
+             | static_cast<uint32_t>(mode);
+    }
+
+    uint16_t index() const {
+        return static_cast<uint16_t>(key.load(std::memory_order::relaxed) >> 16);
+    }
+    uint8_t sub_index() const {
+        return static_cast<uint8_t>(key.load(std::memory_order::relaxed) >> 8);
+    }
+
+    // Claims a SENT request for completion, racing sdo_thread's deadline check.
+    bool claim() {
+        auto expected = State::SENT;
+        return state.compare_exchange_strong(
+            expected, State::COMPLETING, std::memory_order::acquire, std::memory_order::relaxed);
+    }
+
+    // Claims the request for a response to `response_key`, after RawSdoTable::find() returned
+    // it. The lookup and the claim are two steps: in between, sdo_thread may retire the request
+    // and send it again for another object, and the claim alone would then complete that
+    // operation with this response. The key, published before the state SENT the claim
+    // acquires, tells the two apart. A request recycled for the same object is claimed, as the
+    // device's responses to the same object cannot be told apart anyway.
+    bool claim_response(uint32_t response_key) {
+        if (!claim())
+            return false;
+        if (key.load(std::memory_order::relaxed) == response_key)
+            return true;
+
+        // Not ours: hand it back untouched to the response it waits for
+        state.store(State::SENT, std::memory_order::release);
+        return false;
+    }
+
+    std::atomic<uint32_t> key{0};
+    std::atomic<State> state{State::IDLE};
+    Mode mode = Mode::READ;
+
+    // Write data, sent by sdo_thread
+    std::array<uint8_t, 8> write_data{};
+    uint8_t write_size = 0;
+
+    std::chrono::steady_clock::time_point deadline;
+    device::CancellationToken cancellation;
+
+    std::promise<std::vector<uint8_t>> read_promise;
+    std::promise<void> write_promise;
+
+    RawSdoRequest* next = nullptr; // Intrusive link of the submission stack
+};
+
+// Set-associative table of in-flight raw SDO requests keyed by RawSdoRequest::key.
+// Only sdo_thread inserts and erases; any thread may look up. A lookup reads a single bucket
+// (one cache line) and takes no lock, so a response that matches no raw request costs one
+// probe on the RX thread. There are no tombstones or relocations, so a concurrent lookup never
+// misses an entry that stays in the table.
+class RawSdoTable {
+public:
+    static constexpr size_t bucket_count = 256;
+    static constexpr size_t ways = 4;
+
+    // Fails if a request with the same key is already in flight (responses could not be told
+    // apart), or if the key's bucket is full. The caller retries on a later tick.
+    bool insert(RawSdoRequest* request) {
+        auto key = request->key.load(std::memory_order::relaxed);
+        auto& bucket = buckets_[bucket_of(key)];
+
+        std::atomic<RawSdoRequest*>* free_slot = nullptr;
+        for (auto& slot : bucket.slots) {
+            auto current = slot.load(std::memory_order::relaxed);
+            if (!current)
+                free_slot = free_slot ? free_slot : &slot;
+            else if (current->key.load(std::memory_order::relaxed) == key)
+                return false;
+        }
+        if (!free_slot)
+            return false;
+
+        free_slot->store(request, std::memory_order::release);
+        return true;
+    }
+
+    void erase(RawSdoRequest* request) {
+        auto& bucket = buckets_[bucket_of(request->key.load(std::memory_order::relaxed))];
+        for (auto& slot : bucket.slots)
+            if (slot.load(std::memory_order::relaxed) == request) {
+                slot.store(nullptr, std::memory_order::release);
+                return;
+            }
+    }
+
+    RawSdoRequest* find(uint32_t key) const {
+        const auto& bucket = buckets_[bucket_of(key)];
+        for (const auto& slot : bucket.slots) {
+            auto request = slot.load(std::memory_order::acquire);
+            if (request && request->key.load(std::memory_order::relaxed) == key)
+                return request;
+        }
+        return nullptr;
+    }
+
+private:
+    static size_t bucket_of(uint32_t key) {
+        // Fibonacci hashing: spreads neighbouring indices over different buckets
+        return static_cast<size_t>((key * 0x9E3779B1u) >> 24) & (bucket_count - 1);
+    }
+
+    struct alignas(64) Bucket {
+        std::array<std::atomic<RawSdoRequest*>, ways> slots{};
+    };
+    static_assert(bucket_count == 256, "bucket_of() takes the top 8 bits of the hash");
+
+    std::array<Bucket, bucket_count> buckets_{};
+};
+
+// Grows on demand, so the number of concurrent raw SDO requests is only bounded by memory.
+// Touched by submitters and sdo_thread, never by the RX thread.
+class RawSdoPool {
+public:
+    RawSdoRequest* acquire() {
+        std::lock_guard guard{mutex_};
+        if (free_.empty()) {
+            all_.push_back(std::make_unique<RawSdoRequest>());
+            return all_.back().get();
+        }
+        auto request = free_.back();
+        free_.pop_back();
+        return request;
+    }
+
+    void release(RawSdoRequest* request) {
+        request->state.store(RawSdoRequest::State::IDLE, std::memory_order::relaxed);
+        std::lock_guard guard{mutex_};
+        free_.push_back(request);
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<RawSdoRequest>> all_;
+    std::vector<RawSdoRequest*> free_;
+};
+
+} // namespace wujihandcpp::protocol
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wujihandcpp::protocol {
+
+// Compact record of something the RX thread wants logged. The RX thread only fills these in and
+// pushes them into an SPSC queue; formatting happens later on sdo_thread, so that the libusb
+// event thread can resubmit its transfer as soon as possible.
+struct RxEvent {
+    enum class Type : uint8_t {
+        RECEIVED,         // TRACE: a transfer of `size` bytes arrived; followed by FRAME_CHUNKs
+        FRAME_CHUNK,      // `data_size` bytes of the frame at `offset`; `code` is the log level
+        SDO_READ_SUCCESS, // DEBUG: index, sub_index, value = storage id, code/detail = mode/state
+        TPDO_RECEIVED,    // DEBUG: detail = PDO read id
+        PARSE_ERROR,      // code = ParseError at `offset`; followed by FRAME_CHUNKs
+    };
+
+    enum class ParseError : uint8_t {
+        TRUNCATED,           // value = bytes required
+        INVALID_HEADER_TYPE, // detail = header type
+        INVALID_SDO_COMMAND, // detail = command specifier
+        UNKNOWN_SDO_OBJECT,  // index, sub_index; the rest of the frame is still parsed
+        INVALID_PDO_READ_ID, // detail = read id
+    };
+
+    static constexpr size_t data_capacity = 44;
+
+    Type type = Type::PARSE_ERROR;
+    uint8_t code = 0;
+    uint8_t detail = 0;
+    uint8_t sub_index = 0;
+    uint16_t index = 0;
+    uint16_t data_size = 0;
+    uint32_t size = 0;   // Size of the received transfer
+    uint32_t offset = 0; // Position in the transfer
+    uint32_t value = 0;
+    std::byte data[data_capacity]{};
+};
+static_assert(sizeof(RxEvent) == 64);
+
+} // namespace wujihandcpp::protocol
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#ifdef __linux__
+# include <fcntl.h>
+# include <signal.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <wujihandcpp/utility/shared_state.hpp>
+
+namespace wujihandcpp::protocol {
+
+// Writer side of wujihandcpp/utility/shared_state.hpp. Owns the segment: creates it on
+// construction, replacing one that a publisher which is gone left under the same name but
+// refusing one that a live publisher (in this process or another) still publishes to. Removes
+// the name on destruction, so that readers still mapping it see `publishing` drop to 0.
+// publish() is wait-free and allocation-free; only one thread may call it.
+class StatePublisher {
+public:
+    StatePublisher(const char* name, size_t capacity)
+        : name_(shared_state::object_name(name)) {
+        if (name_.size() < 2 || name_.find('/', 1) != std::string::npos)
+            throw std::invalid_argument(std::format("Invalid shared state name: \"{}\"", name_));
+        if (capacity == 0 || capacity > (size_t{1} << 20) || !std::has_single_bit(capacity))
+            throw std::invalid_argument(
+                "Shared state capacity must be a power of two between 1 and 1048576");
+        capacity_ = static_cast<uint32_t>(capacity);
+        size_ = shared_state::segment_size(capacity_);
+
+#ifdef __linux__
+        // Readers of the previous segment keep their mapping and see it stop publishing
+        remove_stale_segment();
+        int fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd < 0)
+            throw_system_error("create shared state " + name_);
+        if (::ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+            auto error = errno;
+            ::close(fd);
+            ::shm_unlink(name_.c_str());
+            errno = error;
+            throw_system_error("resize shared state " + name_);
+        }
+        void* mapping = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            auto error = errno;
+            ::shm_unlink(name_.c_str());
+            errno = error;
+            throw_system_error("map shared state " + name_);
+        }
+        mapping_ = mapping;
+
+        // The segment starts zero-filled, which is a valid empty state for every atomic
+        auto& header = this->header();
+        header.version = shared_state::version;
+        header.header_size = sizeof(shared_state::Header);
+        header.slot_size = sizeof(shared_state::Slot);
+        header.capacity = capacity_;
+        header.publisher_pid = static_cast<uint32_t>(::getpid());
+        header.publishing.store(1, std::memory_order::relaxed);
+        header.magic.store(shared_state::magic, std::memory_order::release);
+#else
+        throw std::runtime_error("Shared state publication is only supported on Linux");
+#endif
+    }
+
+    StatePublisher(const StatePublisher&) = delete;
+    StatePublisher& operator=(const StatePublisher&) = delete;
+
+    ~StatePublisher() {
+#ifdef __linux__
+        header().publishing.store(0, std::memory_order::release);
+        ::munmap(mapping_, size_);
+        ::shm_unlink(name_.c_str());
+#endif
+    }
+
+    // Fills in the sequence number and timestamps of `state` and publishes it.
+    void publish(shared_state::HandState& state) noexcept {
+        auto sequence = ++sequence_;
+        state.sequence = sequence;
+        state.steady_time_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+        state.system_time_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count());
+
+        auto& slot = slots()[(sequence - 1) & (capacity_ - 1)];
+        slot.lock.store(2 * sequence + 1, std::memory_order::relaxed);
+        std::atomic_thread_fence(std::memory_order::release);
+        std::memcpy(&slot.state, &state, sizeof(state));
+        slot.lock.store(2 * sequence, std::memory_order::release);
+        header().head.store(sequence, std::memory_order::release);
+    }
+
+    const std::string& name() const noexcept { return name_; }
+    uint32_t capacity() const noexcept { return capacity_; }
+
+private:
+    shared_state::Header& header() noexcept {
+        return *static_cast<shared_state::Header*>(mapping_);
+    }
+
+    shared_state::Slot* slots() noexcept {
+        return reinterpret_cast<shared_state::Slot*>(
+            static_cast<char*>(mapping_) + sizeof(shared_state::Header));
+    }
+
+#ifdef __linux__
+    // Removes the segment left under name_ by a publisher that is gone, or by one that died
+    // before completing the header. Refuses anything else, and the segment of a live publisher.
+    void remove_stale_segment() {
+        int fd = ::shm_open(name_.c_str(), O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0) {
+            if (errno == ENOENT)
+                return;
+            throw_system_error("open shared state " + name_);
+        }
+
+        uint64_t magic = 0;
+        uint32_t publisher_pid = 0;
+        bool publishing = false;
+        struct stat status;
+        if (::fstat(fd, &status) == 0
+            && static_cast<size_t>(status.st_size) >= sizeof(shared_state::Header)) {
+            void* mapping =
+                ::mmap(nullptr, sizeof(shared_state::Header), PROT_READ, MAP_SHARED, fd, 0);
+            if (mapping != MAP_FAILED) {
+                auto& header = *static_cast<const shared_state::Header*>(mapping);
+                magic = header.magic.load(std::memory_order::acquire);
+                publisher_pid = header.publisher_pid;
+                publishing = header.publishing.load(std::memory_order::acquire) != 0;
+                ::munmap(mapping, sizeof(shared_state::Header));
+            }
+        }
+        ::close(fd);
+
+        if (magic != 0 && magic != shared_state::magic)
+            throw std::runtime_error(
+                std::format("Refusing to replace \"{}\": not a shared state segment", name_));
+        if (magic != 0 && publishing && process_alive(publisher_pid))
+            throw std::runtime_error(std::format(
+                "Refusing to replace shared state \"{}\": process {} still publishes to it",
+                name_, publisher_pid));
+
+        if (::shm_unlink(name_.c_str()) != 0 && errno != ENOENT)
+            throw_system_error("remove stale shared state " + name_);
+    }
+
+    static bool process_alive(uint32_t pid) {
+        if (pid == 0)
+            return false;
+        return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+    }
+#endif
+
+    [[noreturn]] static void throw_system_error(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), "Failed to " + what);
+    }
+
+    std::string name_;
+    uint32_t capacity_ = 0;
+    size_t size_ = 0;
+    void* mapping_ = nullptr;
+    uint64_t sequence_ = 0;
+};
+
+} // namespace wujihandcpp::protocol
@@ -0,0 +1,109 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <format>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include <wujihandcpp/utility/trace.hpp>
+
+#include "logging/logging.hpp"
+#include "trace/trace.hpp"
+
+namespace wujihandcpp::trace {
+
+namespace {
+
+void write_dump(const char* reason) noexcept {
+    auto& config = logging::get_config();
+    if (!config.log_to_file())
+        return;
+
+    auto& logger = logging::get_logger();
+    try {
+        auto path = config.log_path();
+        if (path.empty())
+            return;
+        path /= std::format(
+            "{:%Y%m%d_%H%M%S}_{}.wjtrace",
+            std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()),
+            current_process_id());
+
+        if (dump(path.string().c_str()))
+            logger.warn("Trace buffers dumped to {} ({})", path.string(), reason);
+        else
+            logger.error("Failed to dump trace buffers to {} ({})", path.string(), reason);
+    } catch (const std::exception& ex) {
+        logger.error("Failed to dump trace buffers: {}", ex.what());
+    }
+}
+
+// A dump copies up to every buffer and writes the file synchronously, far too slow for the
+// threads that detect the errors. Started on the first dump, after the logger it uses, so that
+// it is destroyed, and finishes a pending dump, before the logger.
+class DumpWorker {
+public:
+    static DumpWorker& get_instance() {
+        static DumpWorker instance;
+        return instance;
+    }
+
+    void request(const char* reason) {
+        {
+            std::lock_guard guard{mutex_};
+            reason_ = reason;
+        }
+        condition_.notify_one();
+    }
+
+private:
+    DumpWorker()
+        : thread_([this](const std::stop_token& stop_token) { run(stop_token); }) {}
+
+    void run(const std::stop_token& stop_token) {
+        std::unique_lock lock{mutex_};
+        while (condition_.wait(lock, stop_token, [this] { return reason_ != nullptr; })) {
+            auto reason = std::exchange(reason_, nullptr);
+            lock.unlock();
+            write_dump(reason);
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable_any condition_;
+    const char* reason_ = nullptr; // Pending dump, mutex_
+
+    std::jthread thread_; // Declared last: stopped and joined first
+};
+
+} // namespace
+
+void dump_on_error(const char* reason) noexcept {
+    constexpr auto min_interval = std::chrono::seconds(10);
+    static std::atomic<std::chrono::steady_clock::rep> last_dump{0};
+
+    if (!enabled.load(std::memory_order::relaxed))
+        return;
+
+    auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    auto last = last_dump.load(std::memory_order::relaxed);
+    if (last != 0 && now - last < std::chrono::steady_clock::duration(min_interval).count())
+        return;
+    if (!last_dump.compare_exchange_strong(last, now, std::memory_order::relaxed))
+        return;
+
+    auto& logger = logging::get_logger();
+    if (!logging::get_config().log_to_file())
+        return;
+    try {
+        DumpWorker::get_instance().request(reason);
+    } catch (const std::exception& ex) {
+        logger.error("Failed to start the trace dump thread: {}", ex.what());
+    }
+}
+
+} // namespace wujihandcpp::trace
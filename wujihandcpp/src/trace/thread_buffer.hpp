@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+
+namespace wujihandcpp::trace {
+
+// One hot-path event as stored in a dump file (little-endian, 32 bytes).
+struct Record {
+    uint64_t timestamp; // steady_clock, in nanoseconds
+    uint16_t event;
+    uint16_t a;
+    uint32_t b;
+    uint64_t c;
+    uint64_t d;
+};
+static_assert(sizeof(Record) == 32);
+
+// Flight recorder of one thread: a fixed ring of records that the owning thread overwrites
+// without ever blocking, and that any other thread may copy out at the same time.
+//
+// The writer announces each record in `begun_` before overwriting its slot, and publishes it in
+// `head_` afterwards. A reader copies the slots, then discards those that a concurrent write
+// may have touched, so it never returns a torn record.
+class ThreadBuffer {
+public:
+    static constexpr size_t capacity = 8192;
+    static_assert((capacity & (capacity - 1)) == 0);
+
+    ThreadBuffer() = default;
+
+    ThreadBuffer(const ThreadBuffer&) = delete;
+    ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+    ThreadBuffer(ThreadBuffer&&) = delete;
+    ThreadBuffer& operator=(ThreadBuffer&&) = delete;
+
+    // Owning thread only.
+    void write(uint16_t event, uint16_t a, uint32_t b, uint64_t c, uint64_t d) noexcept {
+        auto timestamp = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+
+        auto index = head_.load(std::memory_order::relaxed);
+        begun_.store(index + 1, std::memory_order::relaxed);
+        std::atomic_thread_fence(std::memory_order::release);
+
+        auto& slot = slots_[index & (capacity - 1)];
+        slot[0].store(timestamp, std::memory_order::relaxed);
+        slot[1].store(
+            uint64_t{event} | (uint64_t{a} << 16) | (uint64_t{b} << 32),
+            std::memory_order::relaxed);
+        slot[2].store(c, std::memory_order::relaxed);
+        slot[3].store(d, std::memory_order::relaxed);
+
+        head_.store(index + 1, std::memory_order::release);
+    }
+
+    // Copies the retained records, oldest first, into `out` (room for `capacity` records) and
+    // returns how many were copied. Safe to call from any thread while the owner writes.
+    size_t snapshot(Record* out) const noexcept {
+        auto head = head_.load(std::memory_order::acquire);
+        auto first = head > capacity ? head - capacity : 0;
+
+        for (auto index = first; index < head; index++) {
+            const auto& slot = slots_[index & (capacity - 1)];
+            auto& record = out[index - first];
+            record.timestamp = slot[0].load(std::memory_order::relaxed);
+            auto packed = slot[1].load(std::memory_order::relaxed);
+            record.event = static_cast<uint16_t>(packed);
+            record.a = static_cast<uint16_t>(packed >> 16);
+            record.b = static_cast<uint32_t>(packed >> 32);
+            record.c = slot[2].load(std::memory_order::relaxed);
+            record.d = slot[3].load(std::memory_order::relaxed);
+        }
+
+        // Slots of records older than begun - capacity may have been overwritten meanwhile
+        std::atomic_thread_fence(std::memory_order::acquire);
+        auto begun = begun_.load(std::memory_order::relaxed);
+        auto valid = begun > capacity ? begun - capacity : 0;
+        if (valid <= first)
+            return head - first;
+        if (valid >= head)
+            return 0;
+
+        auto skipped = valid - first;
+        for (auto i = skipped; i < head - first; i++)
+            out[i - skipped] = out[i];
+        return head - valid;
+    }
+
+    // Only while no thread writes.
+    void clear() noexcept {
+        head_.store(0, std::memory_order::relaxed);
+        begun_.store(0, std::memory_order::relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> head_{0}, begun_{0};
+    std::atomic<uint64_t> slots_[capacity][4]{};
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+};
+
+} // namespace wujihandcpp::trace
@@ -0,0 +1,236 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+# include <pthread.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+#include <wujihandcpp/utility/api.hpp>
+#include <wujihandcpp/utility/trace.hpp>
+
+#include "trace/thread_buffer.hpp"
+#include "trace/trace.hpp"
+
+namespace wujihandcpp::trace {
+
+namespace {
+
+// Dump file layout, little-endian:
+//   FileHeader, then per thread: ThreadHeader followed by record_count Records, oldest first.
+struct FileHeader {
+    char magic[8];            // "WJTRACE\0"
+    uint32_t version;         // 1
+    uint32_t record_size;     // sizeof(Record)
+    uint64_t steady_time_ns;  // steady_clock at dump time, same clock as Record::timestamp
+    uint64_t system_time_ns;  // system_clock (Unix epoch) at dump time
+    uint32_t process_id;
+    uint32_t thread_count;
+};
+static_assert(sizeof(FileHeader) == 40);
+
+struct ThreadHeader {
+    uint32_t thread_id;
+    uint32_t record_count;
+    char name[16];
+};
+static_assert(sizeof(ThreadHeader) == 24);
+
+// Buffers outlive their threads: an exited thread's events stay dumpable until a new thread
+// reuses its buffer. The count is bounded so that short-lived application threads calling into
+// the SDK cannot grow memory without limit; further threads simply go unrecorded.
+class Registry {
+public:
+    static constexpr size_t max_buffers = 64;
+
+    static Registry& get_instance() {
+        // Never destroyed: threads may still detach during static destruction
+        static auto* instance = new Registry;
+        return *instance;
+    }
+
+    ThreadBuffer* attach(uint32_t thread_id, const char* name) noexcept {
+        std::lock_guard guard{mutex_};
+
+        Slot* slot = nullptr;
+        for (auto& candidate : slots_)
+            if (!candidate.attached) {
+                slot = &candidate;
+                break;
+            }
+        if (!slot) {
+            if (slots_.size() >= max_buffers)
+                return nullptr;
+            try {
+                slots_.push_back(Slot{.buffer = std::make_unique<ThreadBuffer>()});
+            } catch (...) {
+                return nullptr;
+            }
+            slot = &slots_.back();
+        }
+
+        slot->buffer->clear();
+        slot->header = ThreadHeader{.thread_id = thread_id, .record_count = 0, .name = {}};
+        std::strncpy(slot->header.name, name, sizeof(slot->header.name) - 1);
+        slot->attached = true;
+        return slot->buffer.get();
+    }
+
+    void detach(ThreadBuffer* buffer) noexcept {
+        std::lock_guard guard{mutex_};
+        for (auto& slot : slots_)
+            if (slot.buffer.get() == buffer)
+                slot.attached = false;
+    }
+
+    bool dump(const std::filesystem::path& path) noexcept {
+        try {
+            // Copy everything first, so the dump reflects one moment and no lock is held
+            // during file I/O.
+            std::vector<ThreadHeader> headers;
+            std::vector<std::vector<Record>> records;
+            {
+                std::lock_guard guard{mutex_};
+                for (auto& slot : slots_) {
+                    auto& copy = records.emplace_back(ThreadBuffer::capacity);
+                    copy.resize(slot.buffer->snapshot(copy.data()));
+                    if (copy.empty()) {
+                        records.pop_back();
+                        continue;
+                    }
+                    auto& header = headers.emplace_back(slot.header);
+                    header.record_count = static_cast<uint32_t>(copy.size());
+                }
+            }
+
+            FileHeader header{
+                .magic = {'W', 'J', 'T', 'R', 'A', 'C', 'E', '\0'},
+                .version = 1,
+                .record_size = sizeof(Record),
+                .steady_time_ns = nanoseconds_since_epoch(std::chrono::steady_clock::now()),
+                .system_time_ns = nanoseconds_since_epoch(std::chrono::system_clock::now()),
+                .process_id = current_process_id(),
+                .thread_count = static_cast<uint32_t>(headers.size()),
+            };
+
+            std::ofstream file{path, std::ios::binary | std::ios::trunc};
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (size_t i = 0; i < headers.size(); i++) {
+                file.write(reinterpret_cast<const char*>(&headers[i]), sizeof(ThreadHeader));
+                file.write(
+                    reinterpret_cast<const char*>(records[i].data()),
+                    static_cast<std::streamsize>(records[i].size() * sizeof(Record)));
+            }
+            file.close();
+            return !file.fail();
+        } catch (...) {
+            return false;
+        }
+    }
+
+private:
+    struct Slot {
+        std::unique_ptr<ThreadBuffer> buffer;
+        ThreadHeader header{};
+        bool attached = false;
+    };
+
+    template <typename TimePoint>
+    static uint64_t nanoseconds_since_epoch(TimePoint time) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch())
+                .count());
+    }
+
+    std::mutex mutex_;
+    std::vector<Slot> slots_;
+};
+
+// Events recorded by thread_local destructors that run after the guard's are dropped
+thread_local constinit bool thread_exited = false;
+
+struct ThreadExitGuard {
+    ~ThreadExitGuard() {
+        if (current_thread_buffer) {
+            Registry::get_instance().detach(current_thread_buffer);
+            current_thread_buffer = nullptr;
+        }
+        thread_exited = true;
+    }
+};
+
+thread_local ThreadExitGuard thread_exit_guard;
+
+bool parse_enabled(const char* value, bool default_value) {
+    if (!value)
+        return default_value;
+    std::string str{value};
+    if (str == "0" || str == "false" || str == "off" || str == "no")
+        return false;
+    if (str == "1" || str == "true" || str == "on" || str == "yes")
+        return true;
+    return default_value;
+}
+
+const bool initially_enabled = [] {
+    enabled.store(parse_enabled(std::getenv("WUJI_TRACE"), true), std::memory_order::relaxed);
+    spans_enabled.store(
+        parse_enabled(std::getenv("WUJI_TRACE_SPANS"), false), std::memory_order::relaxed);
+    return true;
+}();
+
+} // namespace
+
+thread_local constinit ThreadBuffer* current_thread_buffer = nullptr;
+
+uint32_t current_process_id() noexcept {
+#ifdef __linux__
+    return static_cast<uint32_t>(::getpid());
+#else
+    return 0;
+#endif
+}
+
+ThreadBuffer* attach_current_thread() noexcept {
+    if (thread_exited)
+        return nullptr;
+
+    uint32_t thread_id = 0;
+    char name[16] = {};
+#ifdef __linux__
+    thread_id = static_cast<uint32_t>(::syscall(SYS_gettid));
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+#endif
+
+    current_thread_buffer = Registry::get_instance().attach(thread_id, name);
+    if (current_thread_buffer)
+        static_cast<void>(&thread_exit_guard); // Registers the guard's destructor
+    return current_thread_buffer;
+}
+
+WUJIHANDCPP_API void set_enabled(bool value) noexcept {
+    enabled.store(value, std::memory_order::relaxed);
+}
+
+WUJIHANDCPP_API void set_spans_enabled(bool value) noexcept {
+    spans_enabled.store(value, std::memory_order::relaxed);
+}
+
+WUJIHANDCPP_API bool dump(const char* path) noexcept {
+    if (!path)
+        return false;
+    return Registry::get_instance().dump(path);
+}
+
+} // namespace wujihandcpp::trace
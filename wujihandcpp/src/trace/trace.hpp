@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+
+#include "trace/thread_buffer.hpp"
+
+namespace wujihandcpp::trace {
+
+// Hot-path events. Ids are part of the dump format; keep them in sync with EVENTS in
+// wujihandpy/trace_decoder.py and only ever append.
+enum class Event : uint16_t {
+    SDO_SUBMIT = 1,       // a = mode (0 read, 1 write), b = storage id
+    SDO_COMPLETE = 2,     // a = success, b = storage id
+    RAW_SDO_SUBMIT = 3,   // a = mode (0 read, 1 write), b = index << 8 | sub-index
+    RAW_SDO_COMPLETE = 4, // a = success, b = index << 8 | sub-index
+    PDO_TICK = 5,         // b = frame index, c = lateness behind the schedule (ns)
+    USB_SUBMIT = 6,       // a = endpoint, b = length, c = transfer address
+    USB_COMPLETE = 7,     // a = endpoint, b = actual length, c = transfer address, d = status
+    TACTILE_FRAME = 8,    // a = hand, b = sequence, c = device timestamp (ms)
+    TRANSPORT_ERROR = 9,
+    RX_PARSE_ERROR = 10,  // a = RxEvent::ParseError, b = offset in the transfer
+    SPAN_BEGIN = 11,      // a = Span, b = span-specific detail
+    SPAN_END = 12,        // a = Span
+};
+
+// Thread timeline spans, recorded only in span mode. Ids are part of the dump format; keep them
+// in sync with SPANS in wujihandpy/trace_decoder.py and only ever append.
+enum class Span : uint16_t {
+    USB_RECEIVE = 1,           // Handling one received USB transfer, on the libusb event thread
+    SDO_TICK = 2,              // One SDO scheduler iteration, without its sleep
+    PDO_STEP = 3,              // IRealtimeController::step()
+    PDO_SUBMIT = 4,            // Encoding and submitting one RPDO frame
+    TACTILE_FRAME = 5,         // Queueing one tactile data frame, on the tactile reader thread
+    TACTILE_CALLBACK = 6,      // The user's tactile frame callback
+    SDO_CALLBACK = 7,          // Completion callback of an SDO operation; b = storage id
+    SUBSCRIPTION_CALLBACK = 8, // Subscription callback; b = storage id
+    JOINT_ERROR_CALLBACK = 9,  // Joint error callback; b = finger << 8 | joint
+};
+
+inline std::atomic<bool> enabled{true};
+inline std::atomic<bool> spans_enabled{false};
+
+extern thread_local constinit ThreadBuffer* current_thread_buffer;
+
+// Registers the calling thread; returns nullptr if no buffer could be allocated.
+ThreadBuffer* attach_current_thread() noexcept;
+
+// Appends an event to the calling thread's buffer. Never blocks; costs a clock read and four
+// relaxed stores, so it stays enabled in production.
+inline void record(
+    Event event, uint16_t a = 0, uint32_t b = 0, uint64_t c = 0, uint64_t d = 0) noexcept {
+    if (!enabled.load(std::memory_order::relaxed)) [[unlikely]]
+        return;
+
+    auto buffer = current_thread_buffer;
+    if (!buffer) [[unlikely]] {
+        buffer = attach_current_thread();
+        if (!buffer)
+            return;
+    }
+    buffer->write(static_cast<uint16_t>(event), a, b, c, d);
+}
+
+// Span mode is on with WUJI_TRACE_SPANS=1 or set_spans_enabled(true). When it is off, a span
+// costs one relaxed load and a branch.
+inline bool spans_active() noexcept {
+    return spans_enabled.load(std::memory_order::relaxed)
+        && enabled.load(std::memory_order::relaxed);
+}
+
+inline void begin_span(Span span, uint32_t detail = 0) noexcept {
+    if (spans_active()) [[unlikely]]
+        record(Event::SPAN_BEGIN, static_cast<uint16_t>(span), detail);
+}
+
+inline void end_span(Span span) noexcept {
+    if (spans_active()) [[unlikely]]
+        record(Event::SPAN_END, static_cast<uint16_t>(span));
+}
+
+// Records a span from construction to destruction.
+class ScopedSpan {
+public:
+    explicit ScopedSpan(Span span, uint32_t detail = 0) noexcept
+        : span_(span)
+        , active_(spans_active()) {
+        if (active_) [[unlikely]]
+            record(Event::SPAN_BEGIN, static_cast<uint16_t>(span_), detail);
+    }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    ~ScopedSpan() noexcept {
+        if (active_) [[unlikely]]
+            record(Event::SPAN_END, static_cast<uint16_t>(span_));
+    }
+
+private:
+    Span span_;
+    bool active_;
+};
+
+uint32_t current_process_id() noexcept;
+
+// Dumps every buffer next to the log files, at most once per 10 seconds, and logs the path.
+// Only hands the dump to a background thread, so error paths on the USB event and RX threads
+// may call it; `reason` must be a string literal. Defined apart from the buffers in
+// dump_on_error.cpp, so that trace.cpp does not depend on logging.
+void dump_on_error(const char* reason) noexcept;
+
+} // namespace wujihandcpp::trace
@@ -17,6 +17,8 @@
 #include "wujihandcpp/transport/usb_enumerate.hpp"
 
 #include "logging/logging.hpp"
+#include "metrics/metrics.hpp"
+#include "trace/trace.hpp"
 #include "transport/transport.hpp"
 #include "utility/cross_os.hpp"
 #include "utility/final_action.hpp"
@@ -173,8 +175,11 @@ public:
         auto& transfer = static_cast<TransferWrapper*>(buffer.get())->transfer_;
         transfer->length = static_cast<int>(size);
 
+        trace_transfer(trace::Event::USB_SUBMIT, transfer, transfer->length);
+        metrics::usb_out_transfers_in_flight.add(1);
         int ret = libusb_submit_transfer(transfer);
         if (ret != 0) [[unlikely]] {
+            metrics::usb_out_transfers_in_flight.sub(1);
             throw device::ConnectionError(
                 std::format(
                     "Failed to submit transmit transfer: {} ({})", ret, libusb_errname(ret)));
@@ -483,8 +488,10 @@ private:
                 this, 0);
             transfer->flags = libusb_transfer_flags::LIBUSB_TRANSFER_FREE_BUFFER;
 
+            metrics::usb_in_transfers_in_flight.add(1);
             int ret = libusb_submit_transfer(transfer);
             if (ret != 0) [[unlikely]] {
+                metrics::usb_in_transfers_in_flight.sub(1);
                 destroy_libusb_transfer(transfer);
                 throw device::ConnectionError(
                     std::format(
@@ -494,6 +501,10 @@ private:
     }
 
     void usb_transmit_complete_callback(TransferWrapper* wrapper) {
+        trace_transfer(
+            trace::Event::USB_COMPLETE, wrapper->transfer_, wrapper->transfer_->actual_length);
+        count_transfer_completed(wrapper->transfer_);
+
         // Share mutex with teardown so destructor can block callbacks before draining the queue
         std::lock_guard guard{transmit_transfer_push_mutex_};
 
@@ -506,17 +517,22 @@ private:
     }
 
     void usb_receive_complete_callback(libusb_transfer* transfer) {
+        count_transfer_completed(transfer);
         if (stop_handling_events_.load(std::memory_order::relaxed)) [[unlikely]] {
             destroy_libusb_transfer(transfer);
             return;
         }
 
+        trace_transfer(trace::Event::USB_COMPLETE, transfer, transfer->actual_length);
         if (transfer->actual_length > 0)
             receive_callback_(
                 reinterpret_cast<std::byte*>(transfer->buffer), transfer->actual_length);
 
+        trace_transfer(trace::Event::USB_SUBMIT, transfer, transfer->length);
+        metrics::usb_in_transfers_in_flight.add(1);
         int ret = libusb_submit_transfer(transfer);
         if (ret != 0) [[unlikely]] {
+            metrics::usb_in_transfers_in_flight.sub(1);
             if (ret == LIBUSB_ERROR_NO_DEVICE)
                 logger_.error(
                     "Failed to re-submit receive transfer: Device disconnected. "
@@ -539,6 +555,24 @@ private:
         }
     }
 
+    static void trace_transfer(trace::Event event, const libusb_transfer* transfer, int length) {
+        trace::record(
+            event, transfer->endpoint, static_cast<uint32_t>(length),
+            reinterpret_cast<uintptr_t>(transfer), static_cast<uint64_t>(transfer->status));
+    }
+
+    // Cancellation during teardown is not counted as an error.
+    static void count_transfer_completed(const libusb_transfer* transfer) {
+        const bool in = transfer->endpoint & LIBUSB_ENDPOINT_IN;
+        (in ? metrics::usb_in_transfers_in_flight : metrics::usb_out_transfers_in_flight).sub(1);
+        if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+            (in ? metrics::usb_in_transfers : metrics::usb_out_transfers).add();
+            (in ? metrics::usb_in_bytes : metrics::usb_out_bytes)
+                .add(static_cast<uint64_t>(transfer->actual_length));
+        } else if (transfer->status != LIBUSB_TRANSFER_CANCELLED)
+            (in ? metrics::usb_in_transfer_errors : metrics::usb_out_transfer_errors).add();
+    }
+
     libusb_transfer* create_libusb_transfer() {
         auto transfer = libusb_alloc_transfer(0);
         if (!transfer)
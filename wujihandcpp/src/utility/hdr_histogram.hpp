@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <limits>
+
+namespace wujihandcpp::utility {
+
+// Fixed-memory log-linear histogram of unsigned integers (in the spirit of HdrHistogram).
+// Values below 2^precision_bits have a bucket each; above that, every power of two is split into
+// 2^(precision_bits - 1) buckets, so a bucket is never wider than 2^-(precision_bits - 1) of its
+// values. Values of max_value_bits bits or more share the last bucket.
+//
+// record() is lock-free and never allocates, so it may run on realtime threads, and any number
+// of threads may record concurrently. snapshot() is wait-free; while recording goes on, it sees
+// each counter individually up to date rather than all of them at one instant.
+template <size_t precision_bits = 5, size_t max_value_bits = 40>
+class HdrHistogram {
+    static_assert(precision_bits >= 1 && precision_bits < max_value_bits && max_value_bits <= 64);
+
+public:
+    static constexpr size_t linear_bucket_count = size_t{1} << precision_bits;
+    static constexpr size_t sub_bucket_count = linear_bucket_count / 2;
+    static constexpr size_t bucket_count =
+        linear_bucket_count + (max_value_bits - precision_bits) * sub_bucket_count;
+
+    /*!
+     * \brief A copy of the counters, taken by snapshot()
+     */
+    struct Snapshot {
+        std::array<uint64_t, bucket_count> buckets;
+        uint64_t count, sum, min, max;
+
+        uint64_t mean() const noexcept { return count ? sum / count : 0; }
+
+        /*!
+         * \brief Value at quantile q
+         * \param q Quantile between 0 and 1; clamped otherwise
+         * \return Midpoint of the bucket holding the value of rank q * count (at least 1),
+         *         clamped to [min, max]; the maximum for q = 1; 0 if the histogram is empty
+         */
+        uint64_t quantile(double q) const noexcept {
+            uint64_t total = 0;
+            for (auto value : buckets)
+                total += value;
+            if (!total)
+                return 0;
+
+            auto rank =
+                static_cast<uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(total));
+            rank = std::clamp<uint64_t>(rank, 1, total);
+            if (rank == total)
+                return std::max(min, max);
+            uint64_t cumulative = 0;
+            size_t bucket = 0;
+            for (; bucket < buckets.size() - 1; bucket++) {
+                cumulative += buckets[bucket];
+                if (cumulative >= rank)
+                    break;
+            }
+
+            auto lower = bucket_lower_bound(bucket);
+            auto middle = lower + (bucket_upper_bound(bucket) - lower) / 2;
+            return std::clamp(middle, min, std::max(min, max));
+        }
+    };
+
+    HdrHistogram() = default;
+
+    HdrHistogram(const HdrHistogram&) = delete;
+    HdrHistogram& operator=(const HdrHistogram&) = delete;
+    HdrHistogram(HdrHistogram&&) = delete;
+    HdrHistogram& operator=(HdrHistogram&&) = delete;
+
+    void record(uint64_t value) noexcept {
+        buckets_[bucket_of(value)].fetch_add(1, std::memory_order::relaxed);
+        count_.fetch_add(1, std::memory_order::relaxed);
+        sum_.fetch_add(value, std::memory_order::relaxed);
+
+        auto min = min_.load(std::memory_order::relaxed);
+        while (value < min
+               && !min_.compare_exchange_weak(min, value, std::memory_order::relaxed)) {}
+        auto max = max_.load(std::memory_order::relaxed);
+        while (value > max
+               && !max_.compare_exchange_weak(max, value, std::memory_order::relaxed)) {}
+    }
+
+    Snapshot snapshot() const noexcept {
+        Snapshot snapshot;
+        for (size_t i = 0; i < bucket_count; i++)
+            snapshot.buckets[i] = buckets_[i].load(std::memory_order::relaxed);
+        snapshot.count = count_.load(std::memory_order::relaxed);
+        snapshot.sum = sum_.load(std::memory_order::relaxed);
+        snapshot.max = max_.load(std::memory_order::relaxed);
+        snapshot.min = snapshot.count ? min_.load(std::memory_order::relaxed) : 0;
+        return snapshot;
+    }
+
+    uint64_t count() const noexcept { return count_.load(std::memory_order::relaxed); }
+
+    /*!
+     * \brief Clears all counters
+     * \note Not atomic as a whole: values recorded concurrently may be partly lost.
+     */
+    void reset() noexcept {
+        for (auto& bucket : buckets_)
+            bucket.store(0, std::memory_order::relaxed);
+        count_.store(0, std::memory_order::relaxed);
+        sum_.store(0, std::memory_order::relaxed);
+        min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order::relaxed);
+        max_.store(0, std::memory_order::relaxed);
+    }
+
+    static constexpr size_t bucket_of(uint64_t value) noexcept {
+        if (value < linear_bucket_count)
+            return static_cast<size_t>(value);
+        auto msb = static_cast<size_t>(std::bit_width(value)) - 1; // At least precision_bits
+        auto sub =
+            static_cast<size_t>(value >> (msb - precision_bits + 1)) & (sub_bucket_count - 1);
+        return std::min(
+            linear_bucket_count + (msb - precision_bits) * sub_bucket_count + sub,
+            bucket_count - 1);
+    }
+
+    static constexpr uint64_t bucket_lower_bound(size_t bucket) noexcept {
+        if (bucket < linear_bucket_count)
+            return bucket;
+        auto msb = (bucket - linear_bucket_count) / sub_bucket_count + precision_bits;
+        auto sub = (bucket - linear_bucket_count) % sub_bucket_count;
+        return uint64_t{sub_bucket_count + sub} << (msb - precision_bits + 1);
+    }
+
+    // The last bucket also holds every larger value
+    static constexpr uint64_t bucket_upper_bound(size_t bucket) noexcept {
+        if (bucket == bucket_count - 1)
+            return std::numeric_limits<uint64_t>::max();
+        return bucket_lower_bound(bucket + 1) - 1;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, bucket_count> buckets_{};
+    std::atomic<uint64_t> count_{0}, sum_{0};
+    std::atomic<uint64_t> min_{std::numeric_limits<uint64_t>::max()}, max_{0};
+};
+
+} // namespace wujihandcpp::utility
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace wujihandcpp::utility {
+
+// Lock-free bounded Multi-Producer/Single-Consumer (MPSC) queue
+// Per-slot sequence numbers as in Dmitry Vyukov's bounded MPMC queue, with the
+// consumer side simplified to a plain index since only one thread pops.
+template <typename T>
+class MpscQueue {
+public:
+    /*!
+     * \brief Construct an MPSC queue
+     * \param size Minimum capacity requested. Actual capacity is rounded up
+     *        to the next power of two and clamped to at least 2.
+     * \note Any number of threads may push concurrently, but only one thread
+     *       may pop at a time.
+     */
+    explicit MpscQueue(size_t size) {
+        if (size <= 2)
+            size = 2;
+        else
+            size = round_up_to_next_power_of_2(size);
+        mask_ = size - 1;
+        slots_ = std::make_unique<Slot[]>(size);
+        for (size_t i = 0; i < size; i++)
+            slots_[i].sequence.store(i, std::memory_order::relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    MpscQueue(MpscQueue&&) = delete;
+    MpscQueue& operator=(MpscQueue&&) = delete;
+
+    /*!
+     * \brief Destructor
+     * Destroys all elements remaining in the queue.
+     */
+    ~MpscQueue() { clear(); }
+
+    /*!
+     * \brief Capacity of the queue
+     * \return Total number of slots (power of two)
+     */
+    size_t max_size() const { return mask_ + 1; }
+
+    /*!
+     * \brief Construct one element in-place at the tail (any producer)
+     * \return true if pushed, false if the queue is full
+     * \note Lock-free: a producer only retries when another producer claimed
+     *       the same slot first.
+     */
+    template <typename... Args>
+    bool emplace_back(Args&&... args) {
+        auto in = in_.load(std::memory_order::relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots_[in & mask_];
+            auto sequence = slot->sequence.load(std::memory_order::acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - in);
+            if (diff == 0) {
+                if (in_.compare_exchange_weak(in, in + 1, std::memory_order::relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                in = in_.load(std::memory_order::relaxed);
+            }
+        }
+
+        new (slot->data) T{std::forward<Args>(args)...};
+        slot->sequence.store(in + 1, std::memory_order::release);
+        return true;
+    }
+
+    /*!
+     * \brief Push a copy of value (any producer)
+     * \return true if pushed, false if the queue is full
+     */
+    bool push_back(const T& value) { return emplace_back(value); }
+
+    /*!
+     * \brief Push by moving value (any producer)
+     * \return true if pushed, false if the queue is full
+     */
+    bool push_back(T&& value) { return emplace_back(std::move(value)); }
+
+    /*!
+     * \brief Batch-pop published elements from the head (consumer)
+     * \tparam F Functor with signature `void(T)` receiving moved-out elements
+     * \param count Maximum number of elements to pop (defaults to all available)
+     * \return Number of elements actually popped
+     * \note Consumer-only. Stops at the first slot whose producer has claimed
+     *       but not yet published it, so elements are always seen in order.
+     */
+    template <typename F>
+    requires requires(F f, T t) { f(std::move(t)); }
+    size_t pop_front_n(F callback_functor, size_t count = std::numeric_limits<size_t>::max()) {
+        size_t popped = 0;
+        while (popped < count) {
+            Slot& slot = slots_[out_ & mask_];
+            if (slot.sequence.load(std::memory_order::acquire) != out_ + 1)
+                break;
+
+            auto& element = *std::launder(reinterpret_cast<T*>(slot.data));
+            callback_functor(std::move(element));
+            std::destroy_at(&element);
+
+            slot.sequence.store(out_ + max_size(), std::memory_order::release);
+            out_++;
+            popped++;
+        }
+        return popped;
+    }
+
+    /*!
+     * \brief Pop one element (consumer)
+     * \return true if an element was popped, false if empty
+     */
+    template <typename F>
+    requires requires(F f, T t) { f(std::move(t)); } bool pop_front(F&& callback_functor) {
+        return pop_front_n(std::forward<F>(callback_functor), 1);
+    }
+
+    /*!
+     * \brief Clear the queue by consuming all published elements (consumer)
+     * \return Number of elements that were erased
+     */
+    size_t clear() {
+        return pop_front_n([](T&&) {});
+    }
+
+private:
+    /*!
+     * \brief Round up to next power of two
+     * \note Assumes n > 0. Handles 32/64-bit size_t.
+     */
+    constexpr static size_t round_up_to_next_power_of_2(size_t n) {
+        n--;
+        n |= n >> 1;
+        n |= n >> 2;
+        n |= n >> 4;
+        n |= n >> 8;
+        n |= n >> 16;
+        if constexpr (sizeof(size_t) > 4)
+            n |= n >> 32;
+        n++;
+        return n;
+    }
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        alignas(T) std::byte data[sizeof(T)];
+    };
+
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(64) std::atomic<size_t> in_{0};
+    alignas(64) size_t out_ = 0;
+};
+
+} // namespace wujihandcpp::utility
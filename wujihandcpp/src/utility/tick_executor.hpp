@@ -9,7 +9,7 @@
 #include <type_traits>
 #include <utility>
 
-#include "utility/tdigest.hpp"
+#include "utility/hdr_histogram.hpp"
 
 namespace wujihandcpp::utility {
 
@@ -30,7 +30,7 @@ struct TickContext {
 
     mutable bool enable_statistics = false;
     mutable uint64_t skipped_frame_count;
-    mutable TDigest<> jitter_statistics{100};
+    mutable HdrHistogram<> jitter_statistics; // Nanoseconds
 };
 
 template <typename Functor>
@@ -67,11 +67,11 @@ public:
             }
 
             if (context_.enable_statistics) {
-                double jitter_us = std::abs(
-                    std::chrono::duration<double, std::micro>(
+                auto jitter_ns = std::abs(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
                         context_.now - context_.scheduled_update_time)
                         .count());
-                context_.jitter_statistics.insert(jitter_us);
+                context_.jitter_statistics.record(static_cast<uint64_t>(jitter_ns));
             }
 
             context_.scheduled_update_time += context_.update_period;
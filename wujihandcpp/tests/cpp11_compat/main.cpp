@@ -9,6 +9,7 @@
 #include <wujihandcpp/device/controller.hpp>
 #include <wujihandcpp/device/hand.hpp>
 #include <wujihandcpp/filter/low_pass.hpp>
+#include <wujihandcpp/utility/shared_state.hpp>
 
 int main() {
     using namespace wujihandcpp;
@@ -53,6 +54,24 @@ int main() {
         return 1;
     }
 
+    // Test 6: FilteredController applies the newest target through its mailbox
+    double initial[5][4] = {};
+    double target[5][4] = {};
+    target[4][3] = 1.0;
+    device::FilteredController<filter::LowPass, false> filtered(initial, lp);
+    filtered.setup(1000.0);
+    filtered.set(target);
+    filtered.set(target);
+    if (!(filtered.step(NULL).value[4][3] > 0.0)) {
+        std::printf("FAIL: FilteredController did not apply the target\n");
+        return 1;
+    }
+    device::TargetStatistics statistics = filtered.target_statistics();
+    if (statistics.published != 2 || statistics.applied != 1 || statistics.superseded != 1) {
+        std::printf("FAIL: FilteredController target statistics mismatch\n");
+        return 1;
+    }
+
     std::printf("OK: All C++11 compatibility tests passed\n");
     return 0;
 }
@@ -0,0 +1,48 @@
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "wujihandcpp/device/cancellation.hpp"
+
+using namespace std::chrono_literals;
+
+namespace wujihandcpp::device {
+
+TEST(CancellationTest, DefaultTokenIsNeverCancelled) {
+    CancellationToken token;
+    EXPECT_FALSE(token.cancelled());
+    EXPECT_NO_THROW(token.throw_if_cancelled());
+}
+
+TEST(CancellationTest, CancelIsVisibleThroughEveryToken) {
+    CancellationSource source;
+    auto first = source.token();
+    auto second = first;
+    EXPECT_FALSE(first.cancelled());
+
+    source.cancel();
+    EXPECT_TRUE(source.cancelled());
+    EXPECT_TRUE(first.cancelled());
+    EXPECT_TRUE(second.cancelled());
+    EXPECT_THROW(second.throw_if_cancelled(), CancelledError);
+}
+
+TEST(CancellationTest, DeadlineAfterAddsTimeoutToNow) {
+    auto before = std::chrono::steady_clock::now();
+    auto deadline = deadline_after(500ms);
+    EXPECT_GE(deadline, before + 500ms);
+    EXPECT_LE(deadline, std::chrono::steady_clock::now() + 500ms);
+}
+
+TEST(CancellationTest, NegativeTimeoutHasAlreadyExpired) {
+    auto deadline = deadline_after(-1ms);
+    EXPECT_LT(deadline, std::chrono::steady_clock::now());
+}
+
+TEST(CancellationTest, InfiniteOrOverflowingTimeoutNeverExpires) {
+    EXPECT_EQ(deadline_after(infinite_timeout), std::chrono::steady_clock::time_point::max());
+    EXPECT_EQ(
+        deadline_after(infinite_timeout - 1ms), std::chrono::steady_clock::time_point::max());
+}
+
+} // namespace wujihandcpp::device
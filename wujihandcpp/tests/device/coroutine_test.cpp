@@ -0,0 +1,188 @@
+#include <chrono>
+#include <coroutine>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../protocol/fake_device.hpp"
+#include "wujihandcpp/device/coroutine.hpp"
+
+namespace wujihandcpp::device {
+namespace {
+
+// Completes on a separate thread and resumes the awaiting coroutine through an executor,
+// mimicking how SDO completions arrive from the SDO thread.
+struct ThreadPostedAwaitable {
+    Executor& executor;
+    ResumeNode node;
+    std::thread worker;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> awaiting) {
+        node.handle = awaiting;
+        worker = std::thread([this] { executor.post(node); });
+    }
+    std::thread::id await_resume() {
+        worker.join();
+        return std::this_thread::get_id();
+    }
+};
+
+Task<int> add_one(int value) { co_return value + 1; }
+
+Task<int> add_two(int value) {
+    int first = co_await add_one(value);
+    co_return co_await add_one(first);
+}
+
+Task<> throw_logic_error() {
+    throw std::logic_error("expected");
+    co_return;
+}
+
+Task<std::thread::id> resume_thread(Executor& executor) {
+    co_return co_await ThreadPostedAwaitable{executor, {}, {}};
+}
+
+using protocol::FakeHand;
+using protocol::Handler;
+
+// Reads one unit, or writes it if given data: what read_co()/write_co() return for a single
+// unit, without a DataOperator around the handler
+class UnitOperation : public detail::SdoOperation {
+public:
+    UnitOperation(
+        Handler& handler, int storage_id, Executor& executor,
+        const Handler::Buffer8* data = nullptr)
+        : SdoOperation(
+              handler, {storage_id, 1, 1}, deadline_after(std::chrono::seconds(2)), {}, executor,
+              data) {}
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> awaiting) { return suspend(awaiting); }
+    void await_resume() { rethrow_if_failed(); }
+};
+
+} // namespace
+
+TEST(CoroutineTest, TaskIsLazyAndReturnsNestedResults) {
+    auto task = add_two(40);
+    EXPECT_FALSE(task.done());
+
+    task.start();
+    ASSERT_TRUE(task.done());
+    EXPECT_EQ(task.get(), 42);
+}
+
+TEST(CoroutineTest, TaskRethrowsException) {
+    auto task = throw_logic_error();
+    task.start();
+    ASSERT_TRUE(task.done());
+    EXPECT_THROW(task.get(), std::logic_error);
+}
+
+TEST(CoroutineTest, LoopExecutorResumesOnOwnerThread) {
+    LoopExecutor executor;
+    auto task = resume_thread(executor);
+    task.start();
+
+    executor.run_until([&] { return task.done(); });
+    EXPECT_EQ(task.get(), std::this_thread::get_id());
+}
+
+TEST(CoroutineTest, LoopExecutorResumesInPostingOrder) {
+    struct ManualAwaitable {
+        ResumeNode& node;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> awaiting) noexcept { node.handle = awaiting; }
+        void await_resume() const noexcept {}
+    };
+
+    LoopExecutor executor;
+    std::vector<int> order;
+    ResumeNode nodes[3];
+
+    auto make = [&](int id) -> Task<> {
+        co_await ManualAwaitable{nodes[id]};
+        order.push_back(id);
+    };
+
+    std::vector<Task<>> tasks;
+    for (int i = 0; i < 3; i++) {
+        tasks.push_back(make(i));
+        tasks.back().start();
+    }
+
+    EXPECT_EQ(executor.poll(), 0u);
+    executor.post(nodes[2]);
+    executor.post(nodes[0]);
+    executor.post(nodes[1]);
+    EXPECT_TRUE(order.empty());
+
+    EXPECT_EQ(executor.poll(), 3u);
+    EXPECT_EQ(order, (std::vector<int>{2, 0, 1}));
+    for (auto& task : tasks)
+        EXPECT_TRUE(task.done());
+}
+
+// Every step of the coroutine resumes on the thread running the loop, which also sees the
+// coroutine finish: run_until() only checks done() when something is posted.
+TEST(CoroutineTest, SdoOperationsResumeOnLoopExecutor) {
+    FakeHand hand{4};
+    hand.device->set_object(FakeHand::index(3), 1, 4, 42);
+
+    LoopExecutor executor;
+    std::vector<std::thread::id> resumed_on;
+    auto configure = [&]() -> Task<uint32_t> {
+        const Handler::Buffer8 one{uint32_t{1}}, two{uint32_t{2}};
+        co_await UnitOperation{*hand.handler, 0, executor, &one};
+        resumed_on.push_back(std::this_thread::get_id());
+
+        co_await when_all(
+            UnitOperation{*hand.handler, 1, executor, &two},
+            UnitOperation{*hand.handler, 2, executor, &two});
+        resumed_on.push_back(std::this_thread::get_id());
+
+        co_await UnitOperation{*hand.handler, 3, executor};
+        resumed_on.push_back(std::this_thread::get_id());
+        co_return hand.handler->get(3).as<uint32_t>();
+    };
+
+    auto task = configure();
+    task.start();
+    executor.run_until([&] { return task.done(); });
+
+    EXPECT_EQ(task.get(), 42u);
+    EXPECT_EQ(
+        resumed_on, std::vector<std::thread::id>(3, std::this_thread::get_id()));
+    EXPECT_EQ(hand.device->object(FakeHand::index(0), 1), 1u);
+    EXPECT_EQ(hand.device->object(FakeHand::index(1), 1), 2u);
+    EXPECT_EQ(hand.device->object(FakeHand::index(2), 1), 2u);
+}
+
+// An operation that cannot start fails the whole when_all, but only once the operations already
+// started are done, as they complete into the awaitable.
+TEST(CoroutineTest, WhenAllWaitsForStartedOperationsBeforeRethrowing) {
+    FakeHand hand{2};
+    hand.device->hold_responses();
+    hand.handler->read_async_unchecked(1, std::chrono::nanoseconds(std::chrono::seconds(2)).count());
+
+    LoopExecutor executor;
+    auto read_both = [&]() -> Task<> {
+        co_await when_all(
+            UnitOperation{*hand.handler, 0, executor}, UnitOperation{*hand.handler, 1, executor});
+    };
+    auto task = read_both();
+    task.start();
+    EXPECT_FALSE(task.done());
+
+    hand.device->release_responses();
+    executor.run_until([&] { return task.done(); });
+    EXPECT_THROW(task.get(), std::runtime_error);
+    EXPECT_EQ(hand.device->read_count(FakeHand::index(0), 1), 1);
+}
+
+} // namespace wujihandcpp::device
@@ -0,0 +1,63 @@
+#include "wujihandcpp/device/controller.hpp"
+
+#include <gtest/gtest.h>
+
+namespace wujihandcpp::device {
+
+namespace {
+
+struct Gain {
+    double kp;
+    int calls;
+};
+
+// Moves each target a fraction `kp` of the way towards the position read back
+void proportional_step(const double* actual, double* target, void* state) {
+    auto& gain = *static_cast<Gain*>(state);
+    gain.calls++;
+    if (!actual)
+        return;
+    for (int k = 0; k < 20; k++)
+        target[k] += gain.kp * (actual[k] - target[k]);
+}
+
+void initial(double (&positions)[5][4], double value) {
+    for (auto& finger : positions)
+        for (auto& joint : finger)
+            joint = value;
+}
+
+} // namespace
+
+TEST(StepFunctionControllerTest, StartsFromInitialPositionsWithoutUpstream) {
+    double positions[5][4];
+    initial(positions, 0.25);
+    Gain gain{.kp = 0.5, .calls = 0};
+    StepFunctionController controller{positions, proportional_step, &gain};
+    controller.setup(500.0);
+
+    auto target = controller.step(nullptr);
+    EXPECT_EQ(gain.calls, 1);
+    for (auto& finger : target.value)
+        for (auto joint : finger)
+            EXPECT_DOUBLE_EQ(joint, 0.25);
+}
+
+TEST(StepFunctionControllerTest, TargetsPersistAcrossSteps) {
+    double positions[5][4];
+    initial(positions, 0.0);
+    Gain gain{.kp = 0.5, .calls = 0};
+    StepFunctionController controller{positions, proportional_step, &gain};
+
+    IRealtimeController::JointPositions actual;
+    initial(actual.value, 1.0);
+    actual.value[4][3] = -1.0;
+
+    controller.step(&actual);
+    auto target = controller.step(&actual);
+    EXPECT_EQ(gain.calls, 2);
+    EXPECT_DOUBLE_EQ(target.value[0][0], 0.75);
+    EXPECT_DOUBLE_EQ(target.value[4][3], -0.75);
+}
+
+} // namespace wujihandcpp::device
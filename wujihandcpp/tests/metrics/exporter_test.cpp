@@ -0,0 +1,72 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <wujihandcpp/utility/metrics.hpp>
+
+namespace wujihandcpp::metrics {
+
+namespace {
+
+std::filesystem::path unique_path(const char* suffix) {
+    return std::filesystem::temp_directory_path()
+         / ("wujihand-exporter-test-" + std::to_string(::getpid()) + suffix);
+}
+
+} // namespace
+
+TEST(ExporterTest, UnixSocketTargetKeepsNonSocketFiles) {
+    auto path = unique_path(".txt");
+    std::ofstream{path} << "not a socket";
+
+    EXPECT_THROW(start_exporter(("unix:" + path.string()).c_str()), std::runtime_error);
+
+    std::ifstream file{path};
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>{file}, {}), "not a socket");
+    std::filesystem::remove(path);
+}
+
+TEST(ExporterTest, UnixSocketTargetReplacesStaleSocket) {
+    auto path = unique_path(".sock");
+
+    // Left behind by a process that exited without unlinking it
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.string().copy(address.sun_path, sizeof(address.sun_path) - 1);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    ::close(fd);
+
+    EXPECT_NO_THROW(start_exporter(("unix:" + path.string()).c_str()));
+    stop_exporter();
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(ExporterTest, UnixSocketTargetLeavesLiveSocketAlone) {
+    auto path = unique_path("-live.sock");
+
+    // Still served by another process
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.string().copy(address.sun_path, sizeof(address.sun_path) - 1);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(::listen(fd, 1), 0);
+
+    EXPECT_THROW(start_exporter(("unix:" + path.string()).c_str()), std::runtime_error);
+    EXPECT_TRUE(std::filesystem::exists(path));
+
+    ::close(fd);
+    std::filesystem::remove(path);
+}
+
+} // namespace wujihandcpp::metrics
@@ -0,0 +1,140 @@
+#include <cstdint>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <wujihandcpp/utility/metrics.hpp>
+
+#include "metrics/metrics.hpp"
+
+namespace wujihandcpp::metrics {
+
+namespace {
+
+// Metrics register themselves for good, so test metrics need static storage duration too.
+Counter test_counter{"wujihand_test_counter_total", "Counter under test"};
+Gauge test_gauge{"wujihand_test_gauge", "Gauge under test"};
+Histogram test_histogram{"wujihand_test_histogram", "Histogram under test", {1.0, 2.0, 5.0}};
+
+} // namespace
+
+TEST(MetricsTest, CounterSumsUpdatesFromAllThreads) {
+    auto before = test_counter.value();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+        threads.emplace_back([] {
+            for (int j = 0; j < 1000; j++)
+                test_counter.add();
+        });
+    for (auto& thread : threads)
+        thread.join();
+    test_counter.add(5);
+
+    EXPECT_EQ(test_counter.value() - before, 4005u);
+
+    Sample sample;
+    test_counter.collect(sample);
+    EXPECT_STREQ(sample.name, "wujihand_test_counter_total");
+    EXPECT_EQ(sample.type, Type::COUNTER);
+    EXPECT_EQ(sample.value, static_cast<double>(test_counter.value()));
+}
+
+TEST(MetricsTest, GaugeTracksLevel) {
+    test_gauge.set(3);
+    test_gauge.add(4);
+    test_gauge.sub(5);
+    EXPECT_EQ(test_gauge.value(), 2);
+
+    Sample sample;
+    test_gauge.collect(sample);
+    EXPECT_EQ(sample.type, Type::GAUGE);
+    EXPECT_EQ(sample.value, 2.0);
+}
+
+TEST(MetricsTest, HistogramReportsCumulativeBuckets) {
+    for (double value : {0.5, 1.0, 1.5, 4.0, 10.0})
+        test_histogram.observe(value);
+
+    Sample sample;
+    test_histogram.collect(sample);
+    EXPECT_EQ(sample.type, Type::HISTOGRAM);
+    EXPECT_EQ(sample.bucket_bounds, (std::vector<double>{1.0, 2.0, 5.0}));
+    EXPECT_EQ(sample.bucket_counts, (std::vector<uint64_t>{2, 3, 4}));
+    EXPECT_EQ(sample.count, 5u);
+    EXPECT_DOUBLE_EQ(sample.value, 17.0);
+}
+
+TEST(MetricsTest, PrometheusTextContainsSdkFamilies) {
+    auto text = prometheus_text();
+
+    EXPECT_NE(text.find("# TYPE wujihand_sdo_operations_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("wujihand_sdo_operations_total{result=\"timeout\"} "), std::string::npos);
+    EXPECT_NE(text.find("# TYPE wujihand_usb_transfers_in_flight gauge\n"), std::string::npos);
+    EXPECT_NE(
+        text.find("# TYPE wujihand_rx_callback_duration_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(
+        text.find("wujihand_rx_callback_duration_seconds_bucket{le=\"+Inf\"} "),
+        std::string::npos);
+    EXPECT_NE(text.find("wujihand_rx_callback_duration_seconds_count "), std::string::npos);
+    EXPECT_NE(
+        text.find("# TYPE wujihand_pdo_step_duration_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(
+        text.find("wujihand_sdo_latency_seconds_count{finger=\"3\",joint=\"2\"} "),
+        std::string::npos);
+    EXPECT_NE(text.find("wujihand_sdo_timeouts_total 0\n"), std::string::npos);
+
+    // One HELP line per family, even with several label sets
+    auto help = text.find("# HELP wujihand_sdo_operations_total ");
+    ASSERT_NE(help, std::string::npos);
+    EXPECT_EQ(text.find("# HELP wujihand_sdo_operations_total ", help + 1), std::string::npos);
+}
+
+TEST(MetricsTest, RealtimeLoopFamiliesSumLiveAndRetiredLoops) {
+    auto ticks = [] {
+        Sample sample;
+        pdo_ticks.collect(sample);
+        return sample.value;
+    };
+    auto step_count = [] {
+        Sample sample;
+        pdo_step_duration.collect(sample);
+        return sample.count;
+    };
+    auto before_ticks = ticks();
+    auto before_steps = step_count();
+
+    RealtimeLoop kept;
+    kept.tick_count.fetch_add(3);
+    {
+        RealtimeLoop destroyed;
+        destroyed.tick_count.fetch_add(4);
+        destroyed.step_ns.record(1'500); // 1.5 us, in the 2 us bucket
+        EXPECT_EQ(ticks() - before_ticks, 7.0);
+
+        Sample sample;
+        pdo_step_duration.collect(sample);
+        ASSERT_GE(sample.bucket_counts.size(), 2u);
+        EXPECT_EQ(sample.bucket_bounds[1], 2e-6);
+        EXPECT_EQ(sample.bucket_counts[1] - sample.bucket_counts[0], 1u);
+    }
+
+    // Neither destroying nor resetting a loop takes back what it exported
+    EXPECT_EQ(ticks() - before_ticks, 7.0);
+    kept.reset();
+    EXPECT_EQ(kept.tick_count.load(), 0u);
+    EXPECT_EQ(ticks() - before_ticks, 7.0);
+    EXPECT_EQ(step_count() - before_steps, 1u);
+}
+
+TEST(MetricsTest, SnapshotIsSortedByName) {
+    auto samples = snapshot();
+    ASSERT_FALSE(samples.empty());
+    for (size_t i = 1; i < samples.size(); i++)
+        EXPECT_LE(std::string{samples[i - 1].name}, std::string{samples[i].name});
+}
+
+} // namespace wujihandcpp::metrics
@@ -0,0 +1,155 @@
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "fake_device.hpp"
+#include "wujihandcpp/device/latch.hpp"
+
+namespace wujihandcpp::protocol {
+namespace {
+
+using namespace std::chrono_literals;
+
+auto deadline() { return std::chrono::steady_clock::now() + 2s; }
+
+} // namespace
+
+TEST(CachedReadTest, FreshUnitCompletesOnCallingThreadWithoutDeviceRead) {
+    FakeHand hand{1};
+    hand.device->set_object(FakeHand::index(0), 1, 4, 5);
+
+    Completions first;
+    hand.handler->read_many_cached({0, 1, 1}, 10s, deadline(), {}, first.callback, first.context());
+    ASSERT_TRUE(first.wait(1));
+    EXPECT_EQ(first.succeeded, 1);
+    EXPECT_EQ(hand.device->read_count(FakeHand::index(0), 1), 1);
+    EXPECT_EQ(hand.handler->get(0).as<uint32_t>(), 5u);
+
+    Completions second;
+    hand.handler->read_many_cached(
+        {0, 1, 1}, 10s, deadline(), {}, second.callback, second.context());
+    EXPECT_EQ(second.succeeded, 1); // Before read_many_cached() returned
+    EXPECT_EQ(hand.device->read_count(FakeHand::index(0), 1), 1);
+}
+
+TEST(CachedReadTest, UnitOlderThanMaxAgeIsReadAgain) {
+    FakeHand hand{1};
+    hand.device->set_object(FakeHand::index(0), 1, 4, 5);
+
+    Completions first;
+    hand.handler->read_many_cached({0, 1, 1}, 10s, deadline(), {}, first.callback, first.context());
+    ASSERT_TRUE(first.wait(1));
+
+    hand.device->set_object(FakeHand::index(0), 1, 4, 7);
+    std::this_thread::sleep_for(20ms);
+
+    // Still younger than 10 s: the old value stands
+    Completions cached;
+    hand.handler->read_many_cached(
+        {0, 1, 1}, 10s, deadline(), {}, cached.callback, cached.context());
+    EXPECT_EQ(cached.succeeded, 1);
+    EXPECT_EQ(hand.handler->get(0).as<uint32_t>(), 5u);
+
+    Completions refreshed;
+    hand.handler->read_many_cached(
+        {0, 1, 1}, 10ms, deadline(), {}, refreshed.callback, refreshed.context());
+    ASSERT_TRUE(refreshed.wait(1));
+    EXPECT_EQ(refreshed.succeeded, 1);
+    EXPECT_EQ(hand.device->read_count(FakeHand::index(0), 1), 2);
+    EXPECT_EQ(hand.handler->get(0).as<uint32_t>(), 7u);
+}
+
+// Both wait in the unit's node for the same refresh
+TEST(CachedReadTest, ConcurrentCachedReadsOfOneUnitAllComplete) {
+    FakeHand hand{1};
+    hand.device->hold_responses();
+
+    Completions first, second;
+    hand.handler->read_many_cached({0, 1, 1}, 1s, deadline(), {}, first.callback, first.context());
+    ASSERT_TRUE(wait_for_reads(*hand.device, FakeHand::index(0), 1));
+    hand.handler->read_many_cached(
+        {0, 1, 1}, 1s, deadline(), {}, second.callback, second.context());
+    std::this_thread::sleep_for(20ms);
+    hand.device->release_responses();
+
+    ASSERT_TRUE(first.wait(1));
+    ASSERT_TRUE(second.wait(1));
+    EXPECT_EQ(first.succeeded + second.succeeded, 2);
+}
+
+TEST(CachedReadTest, StaleUnitFailsAtDeadline) {
+    FakeHand hand{1};
+    hand.device->hold_responses();
+
+    Completions completions;
+    hand.handler->read_many_cached(
+        {0, 1, 1}, 1s, std::chrono::steady_clock::now() + 50ms, {}, completions.callback,
+        completions.context());
+    ASSERT_TRUE(completions.wait(1));
+    EXPECT_EQ(completions.failed, 1);
+}
+
+// The read a cached read started must not make checked operations of the unit fail as busy
+TEST(CachedReadTest, CheckedOperationsTakeOverRefreshInFlight) {
+    FakeHand hand{2};
+    hand.device->set_object(FakeHand::index(1), 1, 4, 9);
+    hand.device->hold_responses();
+
+    Completions cached;
+    hand.handler->read_many_cached(
+        {0, 2, 1}, 1s, deadline(), {}, cached.callback, cached.context());
+    ASSERT_TRUE(wait_for_reads(*hand.device, FakeHand::index(0), 1));
+    ASSERT_TRUE(wait_for_reads(*hand.device, FakeHand::index(1), 1));
+
+    Completions checked;
+    ASSERT_NO_THROW(hand.handler->write_async(
+        Handler::Buffer8{uint32_t{3}}, 0, std::chrono::steady_clock::duration{2s}.count(),
+        checked.callback, checked.context()));
+    ASSERT_NO_THROW(hand.handler->read_async(
+        1, std::chrono::steady_clock::duration{2s}.count(), checked.callback, checked.context()));
+    hand.device->release_responses();
+
+    ASSERT_TRUE(checked.wait(2));
+    EXPECT_EQ(checked.succeeded, 2);
+    ASSERT_TRUE(cached.wait(2));
+    EXPECT_EQ(cached.succeeded, 2);
+    EXPECT_EQ(hand.device->object(FakeHand::index(0), 1), 3u);
+    EXPECT_EQ(hand.handler->get(0).as<uint32_t>(), 3u);
+    EXPECT_EQ(hand.handler->get(1).as<uint32_t>(), 9u);
+}
+
+// A stale read registered after the disconnect pass fails at once instead of waiting forever for
+// a sdo_thread that has exited, wherever it lands relative to that pass
+TEST(CachedReadTest, EveryAcceptedReadCompletesAcrossDisconnect) {
+    for (int round = 0; round < 20; round++) {
+        FakeHand hand{4};
+        hand.device->hold_responses();
+
+        Completions completions;
+        int accepted = 0;
+        std::thread reader{[&] {
+            while (true) {
+                try {
+                    // A max age of zero keeps every unit stale, and held responses keep it so
+                    hand.handler->read_many_cached(
+                        {0, 4, 1}, 0s, std::chrono::steady_clock::now() + 10s, {},
+                        completions.callback, completions.context());
+                } catch (const device::ConnectionError&) {
+                    return;
+                }
+                accepted += 4;
+            }
+        }};
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(round % 5));
+        hand.device->disconnect();
+        reader.join();
+
+        ASSERT_TRUE(completions.wait(accepted)) << "round " << round;
+        std::lock_guard guard{completions.mutex};
+        EXPECT_EQ(completions.succeeded + completions.failed, accepted);
+    }
+}
+
+} // namespace wujihandcpp::protocol
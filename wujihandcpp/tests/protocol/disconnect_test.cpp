@@ -0,0 +1,80 @@
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fake_device.hpp"
+#include "wujihandcpp/device/latch.hpp"
+
+namespace wujihandcpp::protocol {
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr auto timeout = std::chrono::steady_clock::duration{10s}.count();
+
+} // namespace
+
+TEST(DisconnectTest, SubmitAfterDisconnectFailsPromptly) {
+    FakeHand hand{1};
+    hand.device->disconnect();
+    ASSERT_TRUE(hand.handler->has_transport_error());
+    std::this_thread::sleep_for(50ms); // sdo_thread has failed what was pending and exited
+
+    // Claimed and queued with nobody left to drain the queue: submit() releases it right away
+    hand.handler->read_async_unchecked(0, timeout);
+
+    Completions completions;
+    EXPECT_THROW(
+        hand.handler->read_async(0, timeout, completions.callback, completions.context()),
+        device::ConnectionError);
+    EXPECT_THROW(
+        hand.handler->write_async(
+            Handler::Buffer8{uint32_t{1}}, 0, timeout, completions.callback,
+            completions.context()),
+        device::ConnectionError);
+}
+
+// Operations accepted while the disconnect is being handled complete (as failures) no matter
+// where they land relative to the final drain
+TEST(DisconnectTest, EveryAcceptedOperationCompletesAcrossDisconnect) {
+    for (int round = 0; round < 20; round++) {
+        FakeHand hand{4};
+        hand.device->hold_responses();
+
+        std::vector<std::unique_ptr<Completions>> completions(4);
+        std::vector<int> accepted(4, 0);
+        std::vector<std::thread> submitters;
+        for (int id = 0; id < 4; id++) {
+            completions[id] = std::make_unique<Completions>();
+            submitters.emplace_back([&, id] {
+                auto& own = *completions[id];
+                while (true) {
+                    try {
+                        hand.handler->read_async(id, timeout, own.callback, own.context());
+                    } catch (const device::ConnectionError&) {
+                        return;
+                    }
+                    accepted[id]++;
+                    if (!own.wait(accepted[id]))
+                        return; // Reported below
+                }
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(round % 5));
+        hand.device->disconnect();
+        for (auto& submitter : submitters)
+            submitter.join();
+
+        for (int id = 0; id < 4; id++) {
+            ASSERT_TRUE(completions[id]->wait(accepted[id])) << "round " << round;
+            std::lock_guard guard{completions[id]->mutex};
+            EXPECT_EQ(completions[id]->succeeded + completions[id]->failed, accepted[id]);
+        }
+    }
+}
+
+} // namespace wujihandcpp::protocol
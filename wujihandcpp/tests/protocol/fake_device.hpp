@@ -0,0 +1,294 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "protocol/handler_testing.hpp"
+#include "protocol/protocol.hpp"
+#include "transport/transport.hpp"
+#include "wujihandcpp/protocol/handler.hpp"
+
+namespace wujihandcpp::protocol {
+
+// Simulated device behind a Handler: answers SDO reads and writes of its object dictionary from
+// a thread of its own, as the USB event thread would, and delivers frames the test builds.
+// Objects not in the dictionary read as 4-byte zeros.
+class FakeDevice final : public transport::ITransport {
+public:
+    FakeDevice()
+        : rx_thread_([this](const std::stop_token& stop_token) { rx_main(stop_token); }) {}
+
+    ~FakeDevice() noexcept override {
+        rx_thread_.request_stop();
+        rx_thread_.join();
+    }
+
+    void set_object(uint16_t index, uint8_t sub_index, size_t size, uint64_t value) {
+        std::lock_guard guard{mutex_};
+        objects_[key(index, sub_index)] = Object{.size = size, .value = value};
+    }
+
+    uint64_t object(uint16_t index, uint8_t sub_index) {
+        std::lock_guard guard{mutex_};
+        return objects_[key(index, sub_index)].value;
+    }
+
+    // SDO read requests received for an object so far
+    int read_count(uint16_t index, uint8_t sub_index) {
+        std::lock_guard guard{mutex_};
+        return read_counts_[key(index, sub_index)];
+    }
+
+    int write_count(uint16_t index, uint8_t sub_index) {
+        std::lock_guard guard{mutex_};
+        return write_counts_[key(index, sub_index)];
+    }
+
+    // While held, requests are recorded but responses are kept back until release_responses()
+    void hold_responses() {
+        std::lock_guard guard{mutex_};
+        holding_ = true;
+    }
+
+    void release_responses() {
+        {
+            std::lock_guard guard{mutex_};
+            holding_ = false;
+            for (auto& frame : held_)
+                pending_.push_back(std::move(frame));
+            held_.clear();
+        }
+        pending_changed_.notify_one();
+    }
+
+    // Delivers `frame` to the Handler from the device's RX thread
+    void deliver(std::vector<std::byte> frame) {
+        {
+            std::lock_guard guard{mutex_};
+            pending_.push_back(std::move(frame));
+        }
+        pending_changed_.notify_one();
+    }
+
+    // Unrecoverable transport error, as a USB disconnect reports it
+    void disconnect(const std::string& message = "Device disconnected") {
+        std::function<void(const std::string&)> callback;
+        {
+            std::lock_guard guard{mutex_};
+            callback = error_callback_;
+        }
+        if (callback)
+            callback(message);
+    }
+
+    std::unique_ptr<transport::IBuffer> request_transmit_buffer() noexcept override {
+        return std::make_unique<Buffer>();
+    }
+
+    void transmit(std::unique_ptr<transport::IBuffer> buffer, size_t size) override {
+        auto frame = buffer->data();
+        if (size < sizeof(Header) || reinterpret_cast<const Header*>(frame)->type != 0x21)
+            return; // PDO frames go unanswered
+
+        std::vector<std::byte> response;
+        Header header;
+        header.type = 0x21;
+        append_struct(response, header);
+
+        std::lock_guard guard{mutex_};
+        for (size_t offset = sizeof(Header); offset + 4 <= size;) {
+            auto control = static_cast<uint8_t>(frame[offset]);
+            auto index = static_cast<uint16_t>(
+                static_cast<uint16_t>(frame[offset + 1]) << 8
+                | static_cast<uint16_t>(frame[offset + 2]));
+            auto sub_index = static_cast<uint8_t>(frame[offset + 3]);
+            auto& object = objects_[key(index, sub_index)];
+
+            if (control == 0x30) {
+                read_counts_[key(index, sub_index)]++;
+                append_read_result(response, index, sub_index, object);
+                offset += 4;
+            } else if (auto value_size = write_size(control)) {
+                write_counts_[key(index, sub_index)]++;
+                object.size = value_size;
+                object.value = 0;
+                std::memcpy(&object.value, frame + offset + 4, value_size);
+                sdo::WriteResultSuccess result;
+                result.header.control = 0x21;
+                result.header.index = index;
+                result.header.sub_index = sub_index;
+                append_struct(response, result);
+                offset += 4 + value_size;
+            } else
+                break; // Padding
+        }
+        (holding_ ? held_ : pending_).push_back(std::move(response));
+        pending_changed_.notify_one();
+    }
+
+    void receive(std::function<void(const std::byte* buffer, size_t size)> callback) override {
+        std::lock_guard guard{mutex_};
+        receive_callback_ = std::move(callback);
+    }
+
+    void on_error(std::function<void(const std::string& message)> callback) override {
+        std::lock_guard guard{mutex_};
+        error_callback_ = std::move(callback);
+    }
+
+    const std::string& selected_serial_number() const noexcept override {
+        return serial_number_;
+    }
+
+private:
+    struct Object {
+        size_t size = 4;
+        uint64_t value = 0;
+    };
+
+    class Buffer final : public transport::IBuffer {
+    public:
+        std::byte* data() noexcept override { return storage_.data(); }
+        size_t size() const noexcept override { return storage_.size(); }
+
+    private:
+        alignas(8) std::array<std::byte, 512> storage_{};
+    };
+
+    static uint32_t key(uint16_t index, uint8_t sub_index) {
+        return uint32_t{index} << 8 | sub_index;
+    }
+
+    static size_t write_size(uint8_t control) {
+        switch (control) {
+        case 0x20: return 1;
+        case 0x22: return 2;
+        case 0x24: return 4;
+        case 0x28: return 8;
+        default: return 0;
+        }
+    }
+
+    template <typename T>
+    static void append_struct(std::vector<std::byte>& frame, const T& value) {
+        auto offset = frame.size();
+        frame.resize(offset + sizeof(T));
+        std::memcpy(frame.data() + offset, &value, sizeof(T));
+    }
+
+    static void append_read_result(
+        std::vector<std::byte>& frame, uint16_t index, uint8_t sub_index, const Object& object) {
+        auto append_value = [&]<typename T>(uint8_t control, T value) {
+            sdo::ReadResultSuccess<T> result;
+            result.header.control = control;
+            result.header.index = index;
+            result.header.sub_index = sub_index;
+            result.value = value;
+            append_struct(frame, result);
+        };
+        if (object.size == 1)
+            append_value(0x35, static_cast<uint8_t>(object.value));
+        else if (object.size == 2)
+            append_value(0x37, static_cast<uint16_t>(object.value));
+        else if (object.size == 4)
+            append_value(0x39, static_cast<uint32_t>(object.value));
+        else
+            append_value(0x3D, object.value);
+    }
+
+    void rx_main(const std::stop_token& stop_token) {
+        std::unique_lock lock{mutex_};
+        while (true) {
+            pending_changed_.wait(lock, stop_token, [this] { return !pending_.empty(); });
+            if (stop_token.stop_requested())
+                return;
+
+            auto frame = std::move(pending_.front());
+            pending_.pop_front();
+            auto callback = receive_callback_;
+            lock.unlock();
+            if (callback)
+                callback(frame.data(), frame.size());
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable_any pending_changed_;
+    std::map<uint32_t, Object> objects_;
+    std::map<uint32_t, int> read_counts_;
+    std::map<uint32_t, int> write_counts_;
+    bool holding_ = false;
+    std::deque<std::vector<std::byte>> pending_;
+    std::deque<std::vector<std::byte>> held_;
+    std::function<void(const std::byte*, size_t)> receive_callback_;
+    std::function<void(const std::string&)> error_callback_;
+    std::string serial_number_;
+
+    std::jthread rx_thread_; // Last, so that it stops before the members it uses go
+};
+
+// Handler of `unit_count` 4-byte objects 0x2000 + i, sub-index 1, served by a FakeDevice
+struct FakeHand {
+    explicit FakeHand(int unit_count)
+        : device(new FakeDevice)
+        , handler(testing::create_handler(
+              std::unique_ptr<transport::ITransport>{device}, unit_count)) {
+        for (int i = 0; i < unit_count; i++)
+            handler->init_storage_info(i, Handler::StorageInfo{4, index(i), 1});
+        handler->start_transmit_receive();
+    }
+
+    static uint16_t index(int storage_id) { return static_cast<uint16_t>(0x2000 + storage_id); }
+
+    FakeDevice* device; // Owned by the handler
+    std::unique_ptr<Handler> handler;
+};
+
+// Counts the completions of SDO operations submitted with callback() and this as the context
+struct Completions {
+    static void callback(Handler::Buffer8 context, bool success) {
+        auto self = context.as<Completions*>();
+        std::lock_guard guard{self->mutex};
+        (success ? self->succeeded : self->failed)++;
+        self->completed.notify_all();
+    }
+
+    Handler::Buffer8 context() { return Handler::Buffer8{this}; }
+
+    bool wait(int count) {
+        std::unique_lock lock{mutex};
+        return completed.wait_for(
+            lock, std::chrono::seconds(2), [&] { return succeeded + failed >= count; });
+    }
+
+    std::mutex mutex;
+    std::condition_variable completed;
+    int succeeded = 0, failed = 0;
+};
+
+// Waits until the device has received `count` read requests for the object
+inline bool wait_for_reads(FakeDevice& device, uint16_t index, int count) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (device.read_count(index, 1) < count) {
+        if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace wujihandcpp::protocol
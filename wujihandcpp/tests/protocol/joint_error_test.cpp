@@ -0,0 +1,172 @@
+#include <cstdint>
+#include <cstring>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fake_device.hpp"
+
+namespace wujihandcpp::protocol {
+namespace {
+
+using namespace std::chrono_literals;
+
+// PDO feedback frame (position, effort and error code of every joint) with the given codes
+std::vector<std::byte> feedback_frame(const uint32_t (&codes)[5][4]) {
+    Header header;
+    header.type = 0x11;
+    pdo::Header pdo_header{.write_id = 0x00, .read_id = 0x02};
+    pdo::CommandResultPosCurErr result{};
+    for (int i = 0; i < 5; i++)
+        for (int j = 0; j < 4; j++)
+            result.joint[i][j].error_code = codes[i][j];
+
+    std::vector<std::byte> frame(sizeof(header) + sizeof(pdo_header) + sizeof(result));
+    std::memcpy(frame.data(), &header, sizeof(header));
+    std::memcpy(frame.data() + sizeof(header), &pdo_header, sizeof(pdo_header));
+    std::memcpy(frame.data() + sizeof(header) + sizeof(pdo_header), &result, sizeof(result));
+    return frame;
+}
+
+// Error codes of a frame, by finger * 4 + joint; joints not listed report 0
+using FrameCodes = std::vector<uint32_t>;
+
+FrameCodes only(size_t joint_index, uint32_t code) {
+    FrameCodes codes(joint_index + 1, 0);
+    codes[joint_index] = code;
+    return codes;
+}
+
+// Delivers one feedback frame per element of `frames` and waits until the handler has taken them
+void deliver_all(FakeHand& hand, const std::vector<FrameCodes>& frames) {
+    auto version = hand.handler->realtime_feedback_version();
+    for (const auto& frame_codes : frames) {
+        uint32_t codes[5][4]{};
+        for (size_t k = 0; k < frame_codes.size(); k++)
+            codes[k / 4][k % 4] = frame_codes[k];
+        hand.device->deliver(feedback_frame(codes));
+    }
+
+    auto target = version + frames.size();
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    for (auto current = version; current < target;) {
+        ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+        current = hand.handler->wait_realtime_feedback(current, deadline);
+    }
+}
+
+std::vector<device::JointErrorEvent> poll_all(Handler& handler) {
+    std::vector<device::JointErrorEvent> events(1024);
+    events.resize(handler.poll_joint_error_events(events.data(), events.size()));
+    return events;
+}
+
+} // namespace
+
+TEST(JointErrorTest, RecordsEveryChangeInOrder) {
+    FakeHand hand{1};
+
+    // Joint (0, 1) raises bits 0 and 1, clears bit 1, then bit 0 as joint (4, 3) raises bit 13
+    deliver_all(hand, {only(1, 0x3), only(1, 0x1), only(19, 1u << 13)});
+
+    auto events = poll_all(*hand.handler);
+    ASSERT_EQ(events.size(), 4u);
+
+    EXPECT_EQ(events[0].finger, 0);
+    EXPECT_EQ(events[0].joint, 1);
+    EXPECT_EQ(events[0].error_code, 0x3u);
+    EXPECT_EQ(events[0].set_bits, 0x3u);
+    EXPECT_EQ(events[0].cleared_bits, 0u);
+
+    EXPECT_EQ(events[1].error_code, 0x1u);
+    EXPECT_EQ(events[1].set_bits, 0u);
+    EXPECT_EQ(events[1].cleared_bits, 0x2u);
+
+    EXPECT_EQ(events[2].error_code, 0u);
+    EXPECT_EQ(events[2].cleared_bits, 0x1u);
+
+    EXPECT_EQ(events[3].finger, 4);
+    EXPECT_EQ(events[3].joint, 3);
+    EXPECT_EQ(events[3].set_bits, 1u << 13);
+
+    for (size_t i = 1; i < events.size(); i++)
+        EXPECT_LE(events[i - 1].timestamp, events[i].timestamp);
+
+    const auto& codes = hand.handler->realtime_get_joint_error_code();
+    EXPECT_EQ(codes[0][1].load(), 0u);
+    EXPECT_EQ(codes[4][3].load(), 1u << 13);
+    EXPECT_EQ(hand.handler->dropped_joint_error_events(), 0u);
+}
+
+TEST(JointErrorTest, FullPollQueueKeepsOldestEventsAndCountsDrops) {
+    FakeHand hand{1};
+
+    std::vector<FrameCodes> frames;
+    for (uint32_t k = 1; k <= 300; k++)
+        frames.push_back({k});
+    deliver_all(hand, frames);
+
+    auto events = poll_all(*hand.handler);
+    ASSERT_EQ(events.size(), 256u);
+    for (uint32_t k = 0; k < 256; k++)
+        EXPECT_EQ(events[k].error_code, k + 1);
+    EXPECT_EQ(hand.handler->dropped_joint_error_events(), 44u);
+    EXPECT_EQ(hand.handler->realtime_get_joint_error_code()[0][0].load(), 300u);
+
+    // Room again once polled
+    deliver_all(hand, {{0}});
+    events = poll_all(*hand.handler);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].cleared_bits, 300u);
+    EXPECT_EQ(hand.handler->dropped_joint_error_events(), 44u);
+}
+
+TEST(JointErrorTest, CallbackRunsOnSdoThreadForEveryEventUntilRemoved) {
+    FakeHand hand{1};
+
+    struct Received {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::vector<uint32_t> codes;
+        std::vector<std::thread::id> threads;
+    } received;
+    hand.handler->set_joint_error_callback(
+        [](Handler::Buffer8 context, const device::JointErrorEvent& event) {
+            auto self = context.as<Received*>();
+            {
+                std::lock_guard guard{self->mutex};
+                self->codes.push_back(event.error_code);
+                self->threads.push_back(std::this_thread::get_id());
+            }
+            self->changed.notify_all();
+        },
+        Handler::Buffer8{&received});
+
+    deliver_all(hand, {{1}, {3}, {2}});
+    {
+        std::unique_lock lock{received.mutex};
+        ASSERT_TRUE(
+            received.changed.wait_for(lock, 2s, [&] { return received.codes.size() >= 3; }));
+        EXPECT_EQ(received.codes, (std::vector<uint32_t>{1, 3, 2}));
+        for (auto id : received.threads) {
+            EXPECT_NE(id, std::this_thread::get_id());
+            EXPECT_EQ(id, received.threads[0]);
+        }
+    }
+
+    // Delivery to the callback does not consume the polled queue
+    EXPECT_EQ(poll_all(*hand.handler).size(), 3u);
+
+    hand.handler->set_joint_error_callback(nullptr, {});
+    deliver_all(hand, {{0}});
+    std::this_thread::sleep_for(50ms); // A few SDO ticks
+    std::lock_guard guard{received.mutex};
+    EXPECT_EQ(received.codes.size(), 3u);
+}
+
+} // namespace wujihandcpp::protocol
@@ -0,0 +1,108 @@
+#include <cstdint>
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "protocol/raw_sdo.hpp"
+
+namespace wujihandcpp::protocol {
+namespace {
+
+using Mode = RawSdoRequest::Mode;
+
+std::unique_ptr<RawSdoRequest> make_request(uint16_t index, uint8_t sub_index, Mode mode) {
+    auto request = std::make_unique<RawSdoRequest>();
+    request->key.store(RawSdoRequest::make_key(index, sub_index, mode));
+    request->mode = mode;
+    return request;
+}
+
+} // namespace
+
+TEST(RawSdoTableTest, FindsInsertedRequestsUntilErased) {
+    RawSdoTable table;
+    auto read = make_request(0x2011, 3, Mode::READ);
+    auto write = make_request(0x2011, 3, Mode::WRITE);
+
+    EXPECT_EQ(table.find(read->key.load()), nullptr);
+    ASSERT_TRUE(table.insert(read.get()));
+    ASSERT_TRUE(table.insert(write.get()));
+    EXPECT_EQ(table.find(RawSdoRequest::make_key(0x2011, 3, Mode::READ)), read.get());
+    EXPECT_EQ(table.find(RawSdoRequest::make_key(0x2011, 3, Mode::WRITE)), write.get());
+    EXPECT_EQ(table.find(RawSdoRequest::make_key(0x2011, 4, Mode::READ)), nullptr);
+
+    table.erase(read.get());
+    EXPECT_EQ(table.find(read->key.load()), nullptr);
+    EXPECT_EQ(table.find(write->key.load()), write.get());
+}
+
+TEST(RawSdoTableTest, RejectsDuplicateKeyUntilErased) {
+    RawSdoTable table;
+    auto first = make_request(0x5090, 0, Mode::READ);
+    auto second = make_request(0x5090, 0, Mode::READ);
+
+    ASSERT_TRUE(table.insert(first.get()));
+    EXPECT_FALSE(table.insert(second.get()));
+
+    table.erase(first.get());
+    EXPECT_TRUE(table.insert(second.get()));
+    EXPECT_EQ(table.find(second->key.load()), second.get());
+}
+
+TEST(RawSdoTableTest, RejectsInsertIntoFullBucketAndKeepsOtherEntries) {
+    RawSdoTable table;
+
+    // Insert distinct objects until one is rejected: that happens only once its bucket is full
+    std::vector<std::unique_ptr<RawSdoRequest>> inserted;
+    std::unique_ptr<RawSdoRequest> rejected;
+    for (uint32_t i = 0; i < RawSdoTable::bucket_count * RawSdoTable::ways + 1; i++) {
+        auto request = make_request(static_cast<uint16_t>(0x2000 + i), 0, Mode::READ);
+        if (!table.insert(request.get())) {
+            rejected = std::move(request);
+            break;
+        }
+        inserted.push_back(std::move(request));
+    }
+    ASSERT_NE(rejected, nullptr);
+    EXPECT_EQ(table.find(rejected->key.load()), nullptr);
+    for (auto& request : inserted)
+        EXPECT_EQ(table.find(request->key.load()), request.get());
+
+    // Freeing any entry of the full bucket makes room again
+    for (auto& request : inserted) {
+        table.erase(request.get());
+        if (table.insert(rejected.get()))
+            break;
+        ASSERT_TRUE(table.insert(request.get()));
+    }
+    EXPECT_EQ(table.find(rejected->key.load()), rejected.get());
+}
+
+// A response matched to a request that was retired and sent again for another object meanwhile
+// must leave the new operation alone.
+TEST(RawSdoTableTest, ResponseDoesNotClaimRecycledRequest) {
+    RawSdoTable table;
+    auto request = make_request(0x2011, 3, Mode::READ);
+    request->state.store(RawSdoRequest::State::SENT);
+    ASSERT_TRUE(table.insert(request.get()));
+
+    // The RX thread finds the request for a response...
+    auto key = RawSdoRequest::make_key(0x2011, 3, Mode::READ);
+    auto found = table.find(key);
+    ASSERT_EQ(found, request.get());
+
+    // ...while sdo_thread retires it and sends it again for another object
+    table.erase(request.get());
+    request->key.store(RawSdoRequest::make_key(0x5090, 0, Mode::READ));
+    ASSERT_TRUE(table.insert(request.get()));
+
+    EXPECT_FALSE(found->claim_response(key));
+    EXPECT_EQ(request->state.load(), RawSdoRequest::State::SENT);
+    EXPECT_TRUE(found->claim_response(request->key.load()));
+    EXPECT_EQ(request->state.load(), RawSdoRequest::State::COMPLETING);
+    EXPECT_FALSE(found->claim_response(request->key.load()));
+}
+
+} // namespace wujihandcpp::protocol
@@ -0,0 +1,192 @@
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <wujihandcpp/utility/shared_state.hpp>
+
+#include "protocol/state_publisher.hpp"
+
+namespace wujihandcpp::protocol {
+
+namespace {
+
+std::string unique_name() { return "wujihand-test-" + std::to_string(::getpid()); }
+
+shared_state::HandState make_state(double position) {
+    shared_state::HandState state{};
+    for (int i = 0; i < 5; i++)
+        for (int j = 0; j < 4; j++) {
+            state.position[i][j] = position;
+            state.effort[i][j] = -position;
+            state.error_code[i][j] = static_cast<uint32_t>(4 * i + j);
+        }
+    state.flags = shared_state::HandState::HAS_EFFORT_AND_ERROR_CODE;
+    return state;
+}
+
+} // namespace
+
+TEST(StatePublisherTest, ReaderSeesPublishedSnapshots) {
+    auto name = unique_name();
+    StatePublisher publisher{name.c_str(), 4};
+    shared_state::SharedStateReader reader{name.c_str()};
+    EXPECT_EQ(reader.capacity(), 4u);
+    EXPECT_TRUE(reader.publishing());
+    EXPECT_EQ(reader.header().publisher_pid, static_cast<uint32_t>(::getpid()));
+
+    shared_state::HandState state;
+    EXPECT_FALSE(reader.read_latest(state));
+
+    for (int i = 1; i <= 6; i++) {
+        auto published = make_state(i);
+        publisher.publish(published);
+    }
+    EXPECT_EQ(reader.head(), 6u);
+
+    ASSERT_TRUE(reader.read_latest(state));
+    EXPECT_EQ(state.sequence, 6u);
+    EXPECT_EQ(state.position[4][3], 6.0);
+    EXPECT_EQ(state.effort[0][0], -6.0);
+    EXPECT_EQ(state.error_code[2][1], 9u);
+    EXPECT_NE(state.steady_time_ns, 0u);
+
+    // History: the ring holds the last 4 snapshots
+    ASSERT_TRUE(reader.read(3, state));
+    EXPECT_EQ(state.position[0][0], 3.0);
+    EXPECT_FALSE(reader.read(2, state)); // Overwritten
+    EXPECT_FALSE(reader.read(7, state)); // Not published yet
+    EXPECT_FALSE(reader.read(0, state));
+}
+
+TEST(StatePublisherTest, StoppingAndRestartingReplacesTheSegment) {
+    auto name = unique_name();
+    auto publisher = std::make_unique<StatePublisher>(name.c_str(), 8);
+    shared_state::SharedStateReader old_reader{name.c_str()};
+
+    // Stopping removes the name; a reader keeps the old segment, which no longer publishes
+    publisher.reset();
+    EXPECT_FALSE(old_reader.publishing());
+    EXPECT_THROW(shared_state::SharedStateReader{name.c_str()}, std::runtime_error);
+
+    publisher = std::make_unique<StatePublisher>(name.c_str(), 8);
+    shared_state::SharedStateReader new_reader{name.c_str()};
+    auto state = make_state(1);
+    publisher->publish(state);
+    EXPECT_EQ(new_reader.head(), 1u);
+    EXPECT_EQ(old_reader.head(), 0u);
+}
+
+// Two hands publishing under the same name: the second must not take the segment over
+TEST(StatePublisherTest, RefusesSegmentOfLivePublisher) {
+    auto name = unique_name();
+    StatePublisher publisher{name.c_str(), 4};
+    EXPECT_THROW(StatePublisher(name.c_str(), 4), std::runtime_error);
+
+    shared_state::SharedStateReader reader{name.c_str()};
+    auto state = make_state(1);
+    publisher.publish(state);
+    EXPECT_EQ(reader.head(), 1u);
+}
+
+TEST(StatePublisherTest, ReplacesSegmentOfDeadPublisher) {
+    // The pid of a process that has exited
+    pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0)
+        ::_exit(0);
+    ASSERT_EQ(::waitpid(child, nullptr, 0), child);
+
+    // Left behind by a publisher that crashed while publishing
+    auto name = unique_name();
+    auto object = shared_state::object_name(name.c_str());
+    int fd = ::shm_open(object.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    ASSERT_GE(fd, 0);
+    auto size = shared_state::segment_size(1);
+    ASSERT_EQ(::ftruncate(fd, static_cast<off_t>(size)), 0);
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    ASSERT_NE(mapping, MAP_FAILED);
+    auto header = static_cast<shared_state::Header*>(mapping);
+    header->capacity = 1;
+    header->publisher_pid = static_cast<uint32_t>(child);
+    header->publishing.store(1);
+    header->magic.store(shared_state::magic);
+    ::munmap(mapping, size);
+
+    StatePublisher publisher{name.c_str(), 4};
+    shared_state::SharedStateReader reader{name.c_str()};
+    EXPECT_EQ(reader.capacity(), 4u);
+    EXPECT_EQ(reader.header().publisher_pid, static_cast<uint32_t>(::getpid()));
+}
+
+TEST(StatePublisherTest, RejectsInvalidArguments) {
+    EXPECT_THROW(StatePublisher("", 8), std::invalid_argument);
+    EXPECT_THROW(StatePublisher("a/b", 8), std::invalid_argument);
+    EXPECT_THROW(StatePublisher("wujihand-test", 0), std::invalid_argument);
+    EXPECT_THROW(StatePublisher("wujihand-test", 6), std::invalid_argument);
+}
+
+// A publisher that dies between locking a slot and unlocking it leaves the lock odd for good.
+TEST(StatePublisherTest, ReadLatestGivesUpOnSlotLeftLockedByDeadPublisher) {
+    auto name = unique_name();
+    StatePublisher publisher{name.c_str(), 1};
+    shared_state::SharedStateReader reader{name.c_str()};
+    auto state = make_state(1);
+    publisher.publish(state);
+    ASSERT_TRUE(reader.read_latest(state));
+
+    auto object = shared_state::object_name(name.c_str());
+    int fd = ::shm_open(object.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    auto size = shared_state::segment_size(1);
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    ASSERT_NE(mapping, MAP_FAILED);
+    auto slot = reinterpret_cast<shared_state::Slot*>(
+        static_cast<char*>(mapping) + sizeof(shared_state::Header));
+    slot->lock.store(2 * 2 + 1); // Writing snapshot 2
+
+    EXPECT_FALSE(reader.read_latest(state));
+    ::munmap(mapping, size);
+}
+
+// Every snapshot has all positions equal to its sequence number; a torn read would mix them.
+TEST(StatePublisherTest, ConcurrentReadsNeverSeeTornSnapshots) {
+    auto name = unique_name();
+    StatePublisher publisher{name.c_str(), 2};
+    shared_state::SharedStateReader reader{name.c_str()};
+    std::atomic<bool> stop = false;
+
+    std::thread writer{[&] {
+        for (uint64_t i = 1; !stop.load(std::memory_order::relaxed); i++) {
+            auto state = make_state(static_cast<double>(i));
+            publisher.publish(state);
+        }
+    }};
+
+    while (reader.head() == 0)
+        std::this_thread::yield();
+    for (int i = 0; i < 200'000; i++) {
+        shared_state::HandState state;
+        ASSERT_TRUE(reader.read_latest(state));
+        for (int f = 0; f < 5; f++)
+            for (int j = 0; j < 4; j++) {
+                ASSERT_EQ(state.position[f][j], static_cast<double>(state.sequence));
+                ASSERT_EQ(state.effort[f][j], -static_cast<double>(state.sequence));
+            }
+    }
+    stop = true;
+    writer.join();
+}
+
+} // namespace wujihandcpp::protocol
@@ -0,0 +1,164 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fake_device.hpp"
+
+namespace wujihandcpp::protocol {
+namespace {
+
+using namespace std::chrono_literals;
+
+// Records the values a subscription delivers. With unsubscribe_at set, the callback unsubscribes
+// when it receives that many values.
+struct Subscriber {
+    static void callback(Handler::Buffer8 context, int index, Handler::Buffer8 value) {
+        auto self = context.as<Subscriber*>();
+        size_t count;
+        {
+            std::lock_guard guard{self->mutex};
+            self->indices.push_back(index);
+            self->values.push_back(value.as<uint32_t>());
+            count = self->values.size();
+        }
+        self->changed.notify_all();
+        if (count == self->unsubscribe_at)
+            self->handler->unsubscribe(self->id.load());
+    }
+
+    static void release(Handler::Buffer8 context) {
+        auto self = context.as<Subscriber*>();
+        {
+            std::lock_guard guard{self->mutex};
+            self->released++;
+        }
+        self->changed.notify_all();
+    }
+
+    void subscribe(Handler::StorageRange range, std::chrono::steady_clock::duration period) {
+        id = handler->subscribe(range, period, callback, release, Handler::Buffer8{this});
+    }
+
+    bool wait_for_values(size_t count) {
+        std::unique_lock lock{mutex};
+        return changed.wait_for(lock, 2s, [&] { return values.size() >= count; });
+    }
+
+    bool wait_for_release() {
+        std::unique_lock lock{mutex};
+        return changed.wait_for(lock, 2s, [&] { return released > 0; });
+    }
+
+    std::vector<uint32_t> snapshot() {
+        std::lock_guard guard{mutex};
+        return values;
+    }
+
+    Handler* handler = nullptr;
+    size_t unsubscribe_at = 0;
+    std::atomic<uint64_t> id{0};
+
+    std::mutex mutex{};
+    std::condition_variable changed{};
+    std::vector<int> indices{};
+    std::vector<uint32_t> values{};
+    int released = 0;
+};
+
+} // namespace
+
+TEST(SubscriptionTest, DeliversFirstValueThenOnlyChanges) {
+    FakeHand hand{2};
+    hand.device->set_object(FakeHand::index(0), 1, 4, 5);
+    hand.device->set_object(FakeHand::index(1), 1, 4, 6);
+
+    Subscriber subscriber{.handler = hand.handler.get()};
+    subscriber.subscribe({0, 2, 1}, 20ms);
+    ASSERT_TRUE(subscriber.wait_for_values(2));
+
+    // Several periods without a change deliver nothing more
+    ASSERT_TRUE(wait_for_reads(*hand.device, FakeHand::index(0), 4));
+    EXPECT_EQ(subscriber.snapshot().size(), 2u);
+
+    hand.device->set_object(FakeHand::index(1), 1, 4, 8);
+    ASSERT_TRUE(subscriber.wait_for_values(3));
+
+    hand.handler->unsubscribe(subscriber.id);
+    std::lock_guard guard{subscriber.mutex};
+    EXPECT_EQ(subscriber.released, 1);
+    ASSERT_EQ(subscriber.values.size(), 3u);
+    EXPECT_EQ(subscriber.values[2], 8u);
+    EXPECT_EQ(subscriber.indices[2], 1);
+    // One first value per unit, in whichever order they were read
+    EXPECT_EQ(subscriber.values[0] + subscriber.values[1], 11u);
+    EXPECT_NE(subscriber.indices[0], subscriber.indices[1]);
+}
+
+TEST(SubscriptionTest, ReadsEachUnitOncePerPeriod) {
+    FakeHand hand{1};
+
+    Subscriber subscriber{.handler = hand.handler.get()};
+    auto start = std::chrono::steady_clock::now();
+    subscriber.subscribe({0, 1, 1}, 50ms);
+    std::this_thread::sleep_for(500ms);
+    hand.handler->unsubscribe(subscriber.id);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Reads start on 5 ms ticks, so allow for a period of jitter at either end
+    auto periods = static_cast<int>(elapsed / 50ms);
+    auto reads = hand.device->read_count(FakeHand::index(0), 1);
+    EXPECT_GE(reads, periods - 1);
+    EXPECT_LE(reads, periods + 1);
+}
+
+TEST(SubscriptionTest, UnsubscribeFromCallbackStopsDelivery) {
+    FakeHand hand{1};
+    hand.device->set_object(FakeHand::index(0), 1, 4, 1);
+
+    Subscriber subscriber{.handler = hand.handler.get(), .unsubscribe_at = 2};
+    subscriber.subscribe({0, 1, 1}, 10ms);
+    ASSERT_TRUE(subscriber.wait_for_values(1));
+
+    hand.device->set_object(FakeHand::index(0), 1, 4, 2);
+    ASSERT_TRUE(subscriber.wait_for_release());
+
+    // Changes after the unsubscribe are no longer read nor delivered
+    auto reads = hand.device->read_count(FakeHand::index(0), 1);
+    hand.device->set_object(FakeHand::index(0), 1, 4, 3);
+    std::this_thread::sleep_for(100ms);
+    EXPECT_EQ(hand.device->read_count(FakeHand::index(0), 1), reads);
+    EXPECT_EQ(subscriber.snapshot(), (std::vector<uint32_t>{1, 2}));
+
+    // Already gone: ignored
+    hand.handler->unsubscribe(subscriber.id);
+    std::lock_guard guard{subscriber.mutex};
+    EXPECT_EQ(subscriber.released, 1);
+}
+
+// A subscription read in flight must not make checked operations of the unit fail as busy
+TEST(SubscriptionTest, CheckedOperationsTakeOverSubscriptionRead) {
+    FakeHand hand{1};
+    hand.device->hold_responses();
+
+    Subscriber subscriber{.handler = hand.handler.get()};
+    subscriber.subscribe({0, 1, 1}, 1s);
+    ASSERT_TRUE(wait_for_reads(*hand.device, FakeHand::index(0), 1));
+
+    Completions completions;
+    ASSERT_NO_THROW(hand.handler->write_async(
+        Handler::Buffer8{uint32_t{4}}, 0, std::chrono::steady_clock::duration{2s}.count(),
+        completions.callback, completions.context()));
+    hand.device->release_responses();
+
+    ASSERT_TRUE(completions.wait(1));
+    hand.handler->unsubscribe(subscriber.id);
+    EXPECT_EQ(completions.succeeded, 1);
+    EXPECT_EQ(hand.device->object(FakeHand::index(0), 1), 4u);
+}
+
+} // namespace wujihandcpp::protocol
@@ -0,0 +1,81 @@
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "trace/thread_buffer.hpp"
+
+namespace wujihandcpp::trace {
+
+TEST(ThreadBufferTest, SnapshotReturnsRecordsInOrder) {
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->write(1, 2, 3, 4, 5);
+    buffer->write(6, 7, 0xFFFFFFFF, 9, 10);
+
+    std::vector<Record> records(ThreadBuffer::capacity);
+    ASSERT_EQ(buffer->snapshot(records.data()), 2u);
+
+    EXPECT_EQ(records[0].event, 1);
+    EXPECT_EQ(records[0].a, 2);
+    EXPECT_EQ(records[0].b, 3u);
+    EXPECT_EQ(records[0].c, 4u);
+    EXPECT_EQ(records[0].d, 5u);
+    EXPECT_EQ(records[1].event, 6);
+    EXPECT_EQ(records[1].b, 0xFFFFFFFFu);
+    EXPECT_LE(records[0].timestamp, records[1].timestamp);
+}
+
+TEST(ThreadBufferTest, KeepsOnlyTheNewestRecordsAfterWrapping) {
+    auto buffer = std::make_unique<ThreadBuffer>();
+    constexpr uint64_t total = ThreadBuffer::capacity * 2 + 5;
+    for (uint64_t i = 0; i < total; i++)
+        buffer->write(1, 0, 0, i, 0);
+
+    std::vector<Record> records(ThreadBuffer::capacity);
+    auto count = buffer->snapshot(records.data());
+    ASSERT_GT(count, 0u);
+    ASSERT_LE(count, ThreadBuffer::capacity);
+    EXPECT_EQ(records[count - 1].c, total - 1);
+    for (size_t i = 1; i < count; i++)
+        EXPECT_EQ(records[i].c, records[i - 1].c + 1);
+}
+
+TEST(ThreadBufferTest, ClearDropsRecords) {
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->write(1, 0, 0, 0, 0);
+    buffer->clear();
+
+    std::vector<Record> records(ThreadBuffer::capacity);
+    EXPECT_EQ(buffer->snapshot(records.data()), 0u);
+}
+
+// Every record written has c == d; a torn record would break that or the sequence.
+TEST(ThreadBufferTest, ConcurrentSnapshotsNeverSeeTornRecords) {
+    auto buffer = std::make_unique<ThreadBuffer>();
+    std::atomic<bool> stop = false;
+
+    std::thread writer{[&] {
+        for (uint64_t i = 0; !stop.load(std::memory_order::relaxed); i++)
+            buffer->write(1, 0, 0, i, i);
+    }};
+
+    std::vector<Record> records(ThreadBuffer::capacity);
+    for (int round = 0; round < 200; round++) {
+        auto count = buffer->snapshot(records.data());
+        for (size_t i = 0; i < count; i++) {
+            ASSERT_EQ(records[i].c, records[i].d);
+            if (i > 0) {
+                ASSERT_EQ(records[i].c, records[i - 1].c + 1);
+            }
+        }
+    }
+
+    stop.store(true, std::memory_order::relaxed);
+    writer.join();
+}
+
+} // namespace wujihandcpp::trace
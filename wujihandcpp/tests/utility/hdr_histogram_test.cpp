@@ -0,0 +1,119 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utility/hdr_histogram.hpp"
+
+namespace wujihandcpp::utility {
+namespace {
+
+// Round-trip-time-like samples in nanoseconds: log-normal around 1 ms with a long tail
+std::vector<uint64_t> make_samples(size_t count) {
+    std::mt19937_64 generator{42};
+    std::lognormal_distribution<double> distribution{std::log(1e6), 0.5};
+    std::vector<uint64_t> samples(count);
+    for (auto& sample : samples)
+        sample = static_cast<uint64_t>(distribution(generator));
+    return samples;
+}
+
+double relative_error(double actual, double expected) {
+    return std::abs(actual - expected) / expected;
+}
+
+} // namespace
+
+TEST(HdrHistogramTest, BucketsCoverValuesContiguously) {
+    using Histogram = HdrHistogram<5, 40>;
+
+    for (uint64_t value = 0; value < Histogram::linear_bucket_count; value++)
+        EXPECT_EQ(Histogram::bucket_of(value), value);
+
+    for (size_t bucket = 0; bucket < Histogram::bucket_count - 1; bucket++) {
+        auto lower = Histogram::bucket_lower_bound(bucket);
+        auto upper = Histogram::bucket_upper_bound(bucket);
+        ASSERT_LE(lower, upper);
+        EXPECT_EQ(Histogram::bucket_of(lower), bucket);
+        EXPECT_EQ(Histogram::bucket_of(upper), bucket);
+        EXPECT_EQ(Histogram::bucket_lower_bound(bucket + 1), upper + 1);
+        EXPECT_LE(upper - lower, lower / Histogram::sub_bucket_count);
+    }
+
+    EXPECT_EQ(Histogram::bucket_of(uint64_t{1} << 40), Histogram::bucket_count - 1);
+    EXPECT_EQ(
+        Histogram::bucket_of(std::numeric_limits<uint64_t>::max()), Histogram::bucket_count - 1);
+}
+
+TEST(HdrHistogramTest, EmptySnapshotReportsZero) {
+    HdrHistogram<> histogram;
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 0u);
+    EXPECT_EQ(snapshot.min, 0u);
+    EXPECT_EQ(snapshot.max, 0u);
+    EXPECT_EQ(snapshot.mean(), 0u);
+    EXPECT_EQ(snapshot.quantile(0.99), 0u);
+}
+
+TEST(HdrHistogramTest, QuantilesMatchExactQuantiles) {
+    auto samples = make_samples(200'000);
+
+    HdrHistogram<> histogram;
+    for (auto sample : samples)
+        histogram.record(sample);
+
+    auto sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, samples.size());
+    EXPECT_EQ(snapshot.min, sorted.front());
+    EXPECT_EQ(snapshot.max, sorted.back());
+
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+        auto rank = static_cast<size_t>(q * static_cast<double>(sorted.size()));
+        auto exact = static_cast<double>(sorted[rank - 1]);
+
+        // Half a bucket, at most 1/32 of the value with the default precision
+        EXPECT_LE(relative_error(static_cast<double>(snapshot.quantile(q)), exact), 1.0 / 32)
+            << "q = " << q;
+    }
+    EXPECT_EQ(snapshot.quantile(1.0), sorted.back());
+}
+
+TEST(HdrHistogramTest, ConcurrentRecordsAreAllCounted) {
+    HdrHistogram<> histogram;
+    constexpr int thread_count = 4;
+    constexpr uint64_t records_per_thread = 100'000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++)
+        threads.emplace_back([&histogram] {
+            for (uint64_t i = 1; i <= records_per_thread; i++)
+                histogram.record(i);
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, thread_count * records_per_thread);
+    EXPECT_EQ(snapshot.sum, thread_count * records_per_thread * (records_per_thread + 1) / 2);
+    EXPECT_EQ(snapshot.min, 1u);
+    EXPECT_EQ(snapshot.max, records_per_thread);
+
+    uint64_t bucket_total = 0;
+    for (auto count : snapshot.buckets)
+        bucket_total += count;
+    EXPECT_EQ(bucket_total, snapshot.count);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.snapshot().count, 0u);
+}
+
+} // namespace wujihandcpp::utility
@@ -0,0 +1,101 @@
+#include <cstdint>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "wujihandcpp/utility/latest_mailbox.hpp"
+
+namespace wujihandcpp::utility {
+
+TEST(LatestMailboxTest, EmptyUntilPublished) {
+    LatestMailbox<int> mailbox;
+    EXPECT_EQ(mailbox.take(), nullptr);
+
+    mailbox.publish(7);
+    uint64_t sequence = 0;
+    auto value = mailbox.take(&sequence);
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 7);
+    EXPECT_EQ(sequence, 1u);
+    EXPECT_EQ(mailbox.take(), nullptr);
+}
+
+TEST(LatestMailboxTest, NewestValueWinsAndReplacedOnesAreSuperseded) {
+    LatestMailbox<int> mailbox;
+    for (int i = 1; i <= 5; i++)
+        mailbox.publish(i);
+
+    uint64_t sequence = 0;
+    auto value = mailbox.take(&sequence);
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 5);
+    EXPECT_EQ(sequence, 5u);
+
+    mailbox.publish(6);
+    value = mailbox.take(&sequence);
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 6);
+    EXPECT_EQ(sequence, 6u);
+
+    auto statistics = mailbox.statistics();
+    EXPECT_EQ(statistics.published, 6u);
+    EXPECT_EQ(statistics.taken, 2u);
+    EXPECT_EQ(statistics.superseded, 4u);
+}
+
+// Producers publish arrays filled with one value each; the consumer must never see a mix of two
+// arrays, must see increasing sequences, and every value must be either taken or superseded.
+TEST(LatestMailboxTest, ConcurrentProducersNeverTearValues) {
+    struct Values {
+        uint64_t value[20];
+    };
+    constexpr uint32_t producers = 4;
+    constexpr uint32_t per_producer = 20000;
+
+    LatestMailbox<Values> mailbox;
+    std::atomic<uint32_t> finished{0};
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++)
+        threads.emplace_back([&, p] {
+            Values values;
+            for (uint32_t i = 0; i < per_producer; i++) {
+                for (auto& v : values.value)
+                    v = (uint64_t{p} << 32) | i;
+                mailbox.publish(values);
+            }
+            finished.fetch_add(1, std::memory_order::release);
+        });
+
+    bool torn = false, ordered = true;
+    uint64_t last_sequence = 0;
+    auto check = [&](const Values* values, uint64_t sequence) {
+        for (auto v : values->value)
+            torn |= v != values->value[0];
+        ordered &= sequence > last_sequence;
+        last_sequence = sequence;
+    };
+    while (finished.load(std::memory_order::acquire) < producers) {
+        uint64_t sequence;
+        if (auto values = mailbox.take(&sequence))
+            check(values, sequence);
+    }
+    for (auto& thread : threads)
+        thread.join();
+    uint64_t sequence;
+    if (auto values = mailbox.take(&sequence))
+        check(values, sequence);
+
+    EXPECT_FALSE(torn);
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(last_sequence, uint64_t{producers} * per_producer);
+
+    auto statistics = mailbox.statistics();
+    EXPECT_EQ(statistics.published, uint64_t{producers} * per_producer);
+    EXPECT_EQ(statistics.taken + statistics.superseded, statistics.published);
+}
+
+} // namespace wujihandcpp::utility
@@ -0,0 +1,81 @@
+#include <cstdint>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utility/mpsc_queue.hpp"
+
+namespace wujihandcpp::utility {
+
+TEST(MpscQueueTest, CapacityRoundsUpToPowerOfTwo) {
+    EXPECT_EQ(MpscQueue<int>(1).max_size(), 2u);
+    EXPECT_EQ(MpscQueue<int>(5).max_size(), 8u);
+    EXPECT_EQ(MpscQueue<int>(341).max_size(), 512u);
+}
+
+TEST(MpscQueueTest, PushFailsWhenFullAndRecoversAfterPop) {
+    MpscQueue<int> queue(4);
+    for (int i = 0; i < 4; i++)
+        EXPECT_TRUE(queue.push_back(i));
+    EXPECT_FALSE(queue.push_back(4));
+
+    int value = -1;
+    EXPECT_TRUE(queue.pop_front([&](int v) { value = v; }));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(queue.push_back(4));
+
+    std::vector<int> drained;
+    EXPECT_EQ(queue.pop_front_n([&](int v) { drained.push_back(v); }), 4u);
+    EXPECT_EQ(drained, (std::vector<int>{1, 2, 3, 4}));
+    EXPECT_FALSE(queue.pop_front([](int) {}));
+}
+
+// Every producer pushes an increasing sequence tagged with its id; the single consumer must see
+// each producer's elements exactly once and in order, for every producer count from 1 to 8.
+TEST(MpscQueueTest, ConcurrentProducersPreservePerProducerOrder) {
+    constexpr uint32_t per_producer = 5000;
+
+    for (uint32_t producers = 1; producers <= 8; producers++) {
+        MpscQueue<uint64_t> queue(256);
+        std::atomic<bool> start{false};
+
+        std::vector<std::thread> threads;
+        for (uint32_t p = 0; p < producers; p++)
+            threads.emplace_back([&, p] {
+                while (!start.load(std::memory_order::acquire))
+                    std::this_thread::yield();
+                for (uint32_t i = 0; i < per_producer; i++)
+                    while (!queue.push_back((uint64_t{p} << 32) | i))
+                        std::this_thread::yield();
+            });
+
+        std::vector<uint32_t> next(producers, 0);
+        uint64_t received = 0;
+        bool ordered = true;
+        start.store(true, std::memory_order::release);
+        while (received < uint64_t{producers} * per_producer) {
+            auto popped = queue.pop_front_n([&](uint64_t value) {
+                auto p = static_cast<uint32_t>(value >> 32);
+                auto i = static_cast<uint32_t>(value);
+                ordered &= (p < producers && next[p] == i);
+                if (p < producers)
+                    next[p] = i + 1;
+            });
+            if (!popped)
+                std::this_thread::yield();
+            received += popped;
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        EXPECT_TRUE(ordered) << producers << " producers";
+        for (uint32_t p = 0; p < producers; p++)
+            EXPECT_EQ(next[p], per_producer) << producers << " producers";
+    }
+}
+
+} // namespace wujihandcpp::utility